@@ -0,0 +1,387 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/bst_compare.c
+ *
+ * \brief An application to compare recursive and iterative lookups in deep
+ *  binary search trees, and lookups in B-trees.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/bst.h>
+#include <upo/btree.h>
+#include <upo/error.h>
+#include <upo/hires_timer.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 10000
+#define DEFAULT_OPT_NUM_LOOKUPS (size_t) 2000
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+
+
+/**
+ * \brief Defines the nodes of the reference tree, whose lookups are
+ *  recursive like the ones the BST module used to perform.
+ */
+typedef struct ref_node_s {
+            int* key;
+            void* value;
+            struct ref_node_s* left;
+            struct ref_node_s* right;
+        } ref_node_t;
+
+
+/** \brief Compares two integer keys. */
+static int int_compare(const void* a, const void* b);
+
+/** \brief Looks for the given key in the given reference tree, recursively. */
+static ref_node_t* ref_get(ref_node_t* root, const void* key, upo_bst_comparator_t key_cmp);
+
+/** \brief Counts the visited keys. */
+static void count_visit(void* key, void* value, void* count);
+
+/** \brief Returns the runtime (in nanoseconds) per lookup in the reference tree. */
+static double ref_runtime(ref_node_t* root, int** lookups, size_t m);
+
+/** \brief Returns the runtime (in nanoseconds) per lookup in the given tree. */
+static double bst_runtime(upo_bst_t tree, int** lookups, size_t m);
+
+/** \brief Returns the runtime (in nanoseconds) per lookup in the given B-tree. */
+static double btree_runtime(upo_btree_t tree, int** lookups, size_t m);
+
+/** \brief Compares lookups in trees with sorted (i.e., deep) and random keys. */
+static void compare_lookups(size_t n, size_t m, unsigned int seed);
+
+/** \brief Displays a help message. */
+static void usage(const char* progname);
+
+
+int int_compare(const void* a, const void* b)
+{
+    const int* aa = a;
+    const int* bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+ref_node_t* ref_get(ref_node_t* root, const void* key, upo_bst_comparator_t key_cmp)
+{
+    if (root == NULL)
+    {
+        return NULL;
+    }
+    else if (key_cmp(key, root->key) < 0)
+    {
+        return ref_get(root->left, key, key_cmp);
+    }
+    else if (key_cmp(key, root->key) > 0)
+    {
+        return ref_get(root->right, key, key_cmp);
+    }
+    else
+    {
+        return root;
+    }
+}
+
+void count_visit(void* key, void* value, void* count)
+{
+    size_t* n = count;
+
+    (void) key;
+    (void) value;
+
+    *n += 1;
+}
+
+double ref_runtime(ref_node_t* root, int** lookups, size_t m)
+{
+    upo_hires_timer_t timer;
+    double elapsed = 0;
+    size_t i;
+
+    timer = upo_hires_timer_create();
+    upo_hires_timer_start(timer);
+    for (i = 0; i < m; ++i)
+    {
+        if (ref_get(root, lookups[i], int_compare) == NULL)
+        {
+            abort();
+        }
+    }
+    upo_hires_timer_stop(timer);
+    elapsed = upo_hires_timer_elapsed(timer);
+    upo_hires_timer_destroy(timer);
+
+    return elapsed*1e9/m;
+}
+
+double bst_runtime(upo_bst_t tree, int** lookups, size_t m)
+{
+    upo_hires_timer_t timer;
+    double elapsed = 0;
+    size_t i;
+
+    timer = upo_hires_timer_create();
+    upo_hires_timer_start(timer);
+    for (i = 0; i < m; ++i)
+    {
+        if (upo_bst_get(tree, lookups[i]) == NULL)
+        {
+            abort();
+        }
+    }
+    upo_hires_timer_stop(timer);
+    elapsed = upo_hires_timer_elapsed(timer);
+    upo_hires_timer_destroy(timer);
+
+    return elapsed*1e9/m;
+}
+
+double btree_runtime(upo_btree_t tree, int** lookups, size_t m)
+{
+    upo_hires_timer_t timer;
+    double elapsed = 0;
+    size_t i;
+
+    timer = upo_hires_timer_create();
+    upo_hires_timer_start(timer);
+    for (i = 0; i < m; ++i)
+    {
+        if (upo_btree_get(tree, lookups[i]) == NULL)
+        {
+            abort();
+        }
+    }
+    upo_hires_timer_stop(timer);
+    elapsed = upo_hires_timer_elapsed(timer);
+    upo_hires_timer_destroy(timer);
+
+    return elapsed*1e9/m;
+}
+
+void compare_lookups(size_t n, size_t m, unsigned int seed)
+{
+    int* keys = NULL;
+    int** lookups = NULL;
+    ref_node_t* nodes = NULL;
+    size_t s;
+    size_t i;
+
+    srand(seed);
+
+    keys = malloc(n*sizeof(int));
+    lookups = malloc(m*sizeof(int*));
+    nodes = malloc(n*sizeof(ref_node_t));
+    if (keys == NULL || lookups == NULL || nodes == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    printf("Keys: %lu, lookups: %lu\n", (unsigned long) n, (unsigned long) m);
+    printf("%-8s %-11s %8s %14s %14s %10s\n", "keys", "tree", "height", "recursive ns", "iterative ns", "speedup");
+    for (s = 0; s < 2; ++s)
+    {
+        upo_btree_t btree = NULL;
+        size_t b;
+
+        /* Sorted keys build a path, random keys a tree of logarithmic height */
+        for (i = 0; i < n; ++i)
+        {
+            keys[i] = (int) i;
+        }
+        if (s == 1)
+        {
+            for (i = n-1; i > 0; --i)
+            {
+                size_t j = (size_t) rand() % (i+1);
+                int tmp = keys[i];
+
+                keys[i] = keys[j];
+                keys[j] = tmp;
+            }
+        }
+        for (i = 0; i < m; ++i)
+        {
+            lookups[i] = &keys[(size_t) rand() % n];
+        }
+
+        for (b = 0; b < 2; ++b)
+        {
+            int balance = (b == 0) ? UPO_BST_UNBALANCED : UPO_BST_AVL;
+            upo_bst_t tree = upo_bst_create_balanced(int_compare, balance);
+            ref_node_t* root = NULL;
+            size_t count = 0;
+            double ref_ns = 0;
+            double bst_ns = 0;
+
+            for (i = 0; i < n; ++i)
+            {
+                upo_bst_put(tree, &keys[i], &keys[i]);
+            }
+
+            /* Inserting in the same order gives the reference tree the same
+             * shape, as long as no balancing takes place */
+            if (balance == UPO_BST_UNBALANCED)
+            {
+                for (i = 0; i < n; ++i)
+                {
+                    ref_node_t** link = &root;
+
+                    while (*link != NULL)
+                    {
+                        link = (keys[i] < *(*link)->key) ? &(*link)->left : &(*link)->right;
+                    }
+                    nodes[i].key = &keys[i];
+                    nodes[i].value = &keys[i];
+                    nodes[i].left = NULL;
+                    nodes[i].right = NULL;
+                    *link = &nodes[i];
+                }
+                ref_ns = ref_runtime(root, lookups, m);
+            }
+            bst_ns = bst_runtime(tree, lookups, m);
+
+            /* Traversing and clearing deep trees needs no deep call stack */
+            upo_bst_traverse_in_order(tree, count_visit, &count);
+            assert( count == n );
+
+            if (root != NULL)
+            {
+                printf("%-8s %-11s %8lu %14.2f %14.2f %9.2fx\n",
+                       (s == 0) ? "sorted" : "random",
+                       "unbalanced",
+                       (unsigned long) upo_bst_height(tree),
+                       ref_ns,
+                       bst_ns,
+                       ref_ns/bst_ns);
+            }
+            else
+            {
+                printf("%-8s %-11s %8lu %14s %14.2f %10s\n",
+                       (s == 0) ? "sorted" : "random",
+                       "avl",
+                       (unsigned long) upo_bst_height(tree),
+                       "-",
+                       bst_ns,
+                       "-");
+            }
+
+            upo_bst_destroy(tree, 0);
+        }
+
+        /* Wide nodes keep B-trees shallow, whatever the order of keys */
+        btree = upo_btree_create(int_compare);
+        for (i = 0; i < n; ++i)
+        {
+            upo_btree_put(btree, &keys[i], &keys[i]);
+        }
+        printf("%-8s %-11s %8lu %14s %14.2f %10s\n",
+               (s == 0) ? "sorted" : "random",
+               "btree",
+               (unsigned long) upo_btree_height(btree),
+               "-",
+               btree_runtime(btree, lookups, m),
+               "-");
+        upo_btree_destroy(btree, 0);
+    }
+
+    free(nodes);
+    free(lookups);
+    free(keys);
+}
+
+void usage(const char* progname)
+{
+    fprintf(stderr, "Usage: %s <options>\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-m <value>: Specifies the number of lookups.\n"
+                    "            [default: %lu]\n", (unsigned long) DEFAULT_OPT_NUM_LOOKUPS);
+    fprintf(stderr, "-n <value>: Specifies the number of keys (i.e., the height of the deepest tree).\n"
+                    "            [default: %lu]\n", (unsigned long) DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+}
+
+int main(int argc, char* argv[])
+{
+    size_t opt_n = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_m = DEFAULT_OPT_NUM_LOOKUPS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int arg;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-h", argv[arg]))
+        {
+            usage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+        else if (!strcmp("-m", argv[arg]) || !strcmp("-n", argv[arg]) || !strcmp("-s", argv[arg]))
+        {
+            const char* opt = argv[arg];
+
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected value for option '%s'.\n", opt);
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            if (opt[1] == 'm')
+            {
+                opt_m = atol(argv[arg]);
+            }
+            else if (opt[1] == 'n')
+            {
+                opt_n = atol(argv[arg]);
+            }
+            else
+            {
+                opt_seed = atoi(argv[arg]);
+            }
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: unknown option '%s'.\n", argv[arg]);
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (opt_n == 0 || opt_m == 0)
+    {
+        fprintf(stderr, "ERROR: the number of keys and of lookups must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    compare_lookups(opt_n, opt_m, opt_seed);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,452 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/hash_compare.c
+ *
+ * \brief An application to compare the quality and the speed of the hash
+ *  functions provided by the hash table module.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+#include <upo/hires_timer.h>
+#include <upo/random.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 100000
+#define DEFAULT_OPT_NUM_BUCKETS (size_t) 1024
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define MAX_AVALANCHE_KEYS (size_t) 2000
+#define STR_KEY_MIN_LEN 8
+#define STR_KEY_MAX_LEN 24
+#define INT_KEY_BITS (sizeof(int)*CHAR_BIT)
+#define STR_KEY_AVALANCHE_BITS (STR_KEY_MIN_LEN*CHAR_BIT)
+#define HASH_BITS (sizeof(size_t)*CHAR_BIT)
+
+
+/** \brief Defines the type of the keys a hash function applies to. */
+typedef enum {
+            int_key_type,
+            str_key_type
+        } key_type_t;
+
+/** \brief Defines a named hash function. */
+typedef struct {
+            const char* name;
+            upo_ht_hasher_t hasher;
+            key_type_t key_type;
+        } hash_func_t;
+
+/** \brief Defines a named set of keys. */
+typedef struct {
+            const char* name;
+            key_type_t key_type;
+            void** keys;
+            size_t n;
+        } key_set_t;
+
+
+/** \brief The compared hash functions. */
+static const hash_func_t hash_funcs[] = {
+            {"int_div", upo_ht_hash_int_div, int_key_type},
+            {"int_mult_knuth", upo_ht_hash_int_mult_knuth, int_key_type},
+            {"int_mix", upo_ht_hash_int_mix, int_key_type},
+            {"str_djb2", upo_ht_hash_str_djb2, str_key_type},
+            {"str_djb2a", upo_ht_hash_str_djb2a, str_key_type},
+            {"str_java", upo_ht_hash_str_java, str_key_type},
+            {"str_kr2e", upo_ht_hash_str_kr2e, str_key_type},
+            {"str_sgistl", upo_ht_hash_str_sgistl, str_key_type},
+            {"str_xx64", upo_ht_hash_str_xx64, str_key_type}
+        };
+
+
+/** \brief Creates the sets of keys used for the comparison. */
+static key_set_t* make_key_sets(size_t n, size_t* num_sets);
+
+/** \brief Destroys the given sets of keys. */
+static void destroy_key_sets(key_set_t* sets, size_t num_sets);
+
+/** \brief Returns the runtime (in nanoseconds) per hashed key. */
+static double hash_runtime(const hash_func_t* func, const key_set_t* set, size_t m);
+
+/** \brief Returns the chi-square statistic of the bucket distribution, normalized by its degrees of freedom. */
+static double chi_square(const hash_func_t* func, const key_set_t* set, size_t m);
+
+/** \brief Computes the mean and the worst bias of the avalanche matrix. */
+static void avalanche(const hash_func_t* func, const key_set_t* set, double* mean_bias, double* worst_bias);
+
+/** \brief Compares hash functions. */
+static void compare_hash_funcs(size_t n, size_t m, unsigned int seed);
+
+/** \brief Displays a help message. */
+static void usage(const char* progname);
+
+
+key_set_t* make_key_sets(size_t n, size_t* num_sets)
+{
+    key_set_t* sets = NULL;
+    size_t i;
+    size_t k;
+
+    *num_sets = 4;
+    sets = malloc(*num_sets*sizeof(key_set_t));
+    if (sets == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for key sets");
+    }
+
+    sets[0].name = "sequential int";
+    sets[0].key_type = int_key_type;
+    sets[1].name = "random int";
+    sets[1].key_type = int_key_type;
+    sets[2].name = "sequential str";
+    sets[2].key_type = str_key_type;
+    sets[3].name = "random str";
+    sets[3].key_type = str_key_type;
+
+    for (k = 0; k < *num_sets; ++k)
+    {
+        sets[k].n = n;
+        sets[k].keys = malloc(n*sizeof(void*));
+        if (sets[k].keys == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for keys");
+        }
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        int* ikey = NULL;
+        char* skey = NULL;
+        size_t len = upo_random_uniform_int(STR_KEY_MIN_LEN, STR_KEY_MAX_LEN+1);
+
+        ikey = malloc(sizeof(int));
+        if (ikey == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for a key");
+        }
+        *ikey = (int) i;
+        sets[0].keys[i] = ikey;
+
+        ikey = malloc(sizeof(int));
+        if (ikey == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for a key");
+        }
+        *ikey = rand();
+        sets[1].keys[i] = ikey;
+
+        skey = malloc(STR_KEY_MAX_LEN+1);
+        if (skey == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for a key");
+        }
+        sprintf(skey, "key%08lu", (unsigned long) i);
+        sets[2].keys[i] = skey;
+
+        skey = malloc(STR_KEY_MAX_LEN+1);
+        if (skey == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for a key");
+        }
+        upo_random_string(skey, len);
+        sets[3].keys[i] = skey;
+    }
+
+    return sets;
+}
+
+void destroy_key_sets(key_set_t* sets, size_t num_sets)
+{
+    size_t k;
+
+    for (k = 0; k < num_sets; ++k)
+    {
+        size_t i;
+
+        for (i = 0; i < sets[k].n; ++i)
+        {
+            free(sets[k].keys[i]);
+        }
+        free(sets[k].keys);
+    }
+    free(sets);
+}
+
+double hash_runtime(const hash_func_t* func, const key_set_t* set, size_t m)
+{
+    upo_hires_timer_t timer;
+    size_t sum = 0;
+    size_t i;
+    double runtime = 0;
+
+    timer = upo_hires_timer_create();
+    upo_hires_timer_start(timer);
+    for (i = 0; i < set->n; ++i)
+    {
+        sum += func->hasher(set->keys[i], m);
+    }
+    upo_hires_timer_stop(timer);
+    runtime = upo_hires_timer_elapsed(timer);
+    upo_hires_timer_destroy(timer);
+
+    /* Prevents the compiler from dropping the loop */
+    if (sum == (size_t) -1)
+    {
+        putchar(' ');
+    }
+
+    return runtime*1e+9/set->n;
+}
+
+double chi_square(const hash_func_t* func, const key_set_t* set, size_t m)
+{
+    size_t* counts = NULL;
+    double expected = set->n/((double) m);
+    double chi2 = 0;
+    size_t i;
+
+    counts = calloc(m, sizeof(size_t));
+    if (counts == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for bucket counters");
+    }
+
+    for (i = 0; i < set->n; ++i)
+    {
+        counts[func->hasher(set->keys[i], m)] += 1;
+    }
+    for (i = 0; i < m; ++i)
+    {
+        double d = counts[i] - expected;
+
+        chi2 += d*d/expected;
+    }
+
+    free(counts);
+
+    /* The expected value of the statistic is the number of degrees of
+     * freedom, so a uniform distribution yields a value close to 1 */
+    return chi2/(m > 1 ? m-1 : 1);
+}
+
+void avalanche(const hash_func_t* func, const key_set_t* set, double* mean_bias, double* worst_bias)
+{
+    size_t in_bits = (set->key_type == int_key_type) ? INT_KEY_BITS : STR_KEY_AVALANCHE_BITS;
+    size_t n = set->n < MAX_AVALANCHE_KEYS ? set->n : MAX_AVALANCHE_KEYS;
+    size_t* flips = NULL;
+    size_t* trials = NULL;
+    size_t i;
+    size_t b;
+
+    flips = calloc(in_bits*HASH_BITS, sizeof(size_t));
+    trials = calloc(in_bits, sizeof(size_t));
+    if (flips == NULL || trials == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the avalanche matrix");
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        size_t h0 = func->hasher(set->keys[i], UPO_HT_HASH_FULL_RANGE);
+
+        for (b = 0; b < in_bits; ++b)
+        {
+            size_t h1 = 0;
+            size_t diff = 0;
+            size_t j;
+
+            if (set->key_type == int_key_type)
+            {
+                int key = *((int*) set->keys[i]);
+
+                key = (int) ((unsigned int) key ^ (1U << b));
+                h1 = func->hasher(&key, UPO_HT_HASH_FULL_RANGE);
+            }
+            else
+            {
+                char key[STR_KEY_MAX_LEN+1];
+
+                strcpy(key, set->keys[i]);
+                key[b/CHAR_BIT] ^= (char) (1U << (b % CHAR_BIT));
+                if (key[b/CHAR_BIT] == '\0')
+                {
+                    /* Flipping this bit would shorten the string */
+                    continue;
+                }
+                h1 = func->hasher(key, UPO_HT_HASH_FULL_RANGE);
+            }
+
+            trials[b] += 1;
+            diff = h0 ^ h1;
+            for (j = 0; j < HASH_BITS; ++j)
+            {
+                flips[b*HASH_BITS+j] += (diff >> j) & 1U;
+            }
+        }
+    }
+
+    *mean_bias = 0;
+    *worst_bias = 0;
+    for (b = 0; b < in_bits; ++b)
+    {
+        size_t j;
+
+        for (j = 0; j < HASH_BITS; ++j)
+        {
+            /* 0 means that the output bit flips half of the times (ideal),
+             * 1 means that it always or never flips */
+            double p = trials[b] > 0 ? flips[b*HASH_BITS+j]/((double) trials[b]) : 0;
+            double bias = p > 0.5 ? 2*p-1 : 1-2*p;
+
+            *mean_bias += bias;
+            if (bias > *worst_bias)
+            {
+                *worst_bias = bias;
+            }
+        }
+    }
+    *mean_bias /= in_bits*HASH_BITS;
+
+    free(trials);
+    free(flips);
+}
+
+void compare_hash_funcs(size_t n, size_t m, unsigned int seed)
+{
+    key_set_t* sets = NULL;
+    size_t num_sets = 0;
+    size_t k;
+
+    srand(seed);
+
+    sets = make_key_sets(n, &num_sets);
+
+    printf("Keys: %lu, buckets: %lu\n", (unsigned long) n, (unsigned long) m);
+    printf("(chi2/df close to 1 means uniform buckets; avalanche bias close to 0 means good mixing)\n");
+    for (k = 0; k < num_sets; ++k)
+    {
+        size_t f;
+
+        printf("\n%s keys\n", sets[k].name);
+        printf("%-16s %10s %10s %14s %14s\n", "hash function", "ns/key", "chi2/df", "mean avalanche", "worst avalanche");
+        for (f = 0; f < sizeof hash_funcs/sizeof hash_funcs[0]; ++f)
+        {
+            double mean_bias = 0;
+            double worst_bias = 0;
+
+            if (hash_funcs[f].key_type != sets[k].key_type)
+            {
+                continue;
+            }
+
+            avalanche(&hash_funcs[f], &sets[k], &mean_bias, &worst_bias);
+            printf("%-16s %10.2f %10.3f %14.3f %14.3f\n",
+                   hash_funcs[f].name,
+                   hash_runtime(&hash_funcs[f], &sets[k], m),
+                   chi_square(&hash_funcs[f], &sets[k], m),
+                   mean_bias,
+                   worst_bias);
+        }
+    }
+
+    destroy_key_sets(sets, num_sets);
+}
+
+void usage(const char* progname)
+{
+    fprintf(stderr, "Usage: %s <options>\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-m <value>: Specifies the number of buckets (i.e., possible hash values).\n"
+                    "            [default: %lu]\n", (unsigned long) DEFAULT_OPT_NUM_BUCKETS);
+    fprintf(stderr, "-n <value>: Specifies the number of keys to hash.\n"
+                    "            [default: %lu]\n", (unsigned long) DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+}
+
+
+int main(int argc, char* argv[])
+{
+    size_t opt_n = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_m = DEFAULT_OPT_NUM_BUCKETS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int arg;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-h", argv[arg]))
+        {
+            usage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+        else if (!strcmp("-m", argv[arg]) || !strcmp("-n", argv[arg]) || !strcmp("-s", argv[arg]))
+        {
+            const char* opt = argv[arg];
+
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected value for option '%s'.\n", opt);
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            if (opt[1] == 'm')
+            {
+                opt_m = atol(argv[arg]);
+            }
+            else if (opt[1] == 'n')
+            {
+                opt_n = atol(argv[arg]);
+            }
+            else
+            {
+                opt_seed = atoi(argv[arg]);
+            }
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: unknown option '%s'.\n", argv[arg]);
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (opt_n == 0 || opt_m == 0)
+    {
+        fprintf(stderr, "ERROR: the number of keys and of buckets must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    compare_hash_funcs(opt_n, opt_m, opt_seed);
+
+    return EXIT_SUCCESS;
+}
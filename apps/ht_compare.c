@@ -0,0 +1,833 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/ht_compare.c
+ *
+ * \brief An application to compare the speed of the single-threaded hash
+ *  tables.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* mkstemp() and close() are POSIX extensions */
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+#include <upo/hashtable_compact.h>
+#include <upo/hashtable_cuckoo.h>
+#include <upo/hashtable_inline.h>
+#include <upo/hashtable_snapshot.h>
+#include <upo/hires_timer.h>
+#include <upo/mph.h>
+#include <upo/random.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 1000000
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define SNAPSHOT_PATH_TEMPLATE "/tmp/ht_compare.XXXXXX"
+#define ADVERSARIAL_BLOCKS 13
+
+
+/**
+ * \brief Defines a hash table under test, as a set of operations on an opaque
+ *  table.
+ */
+typedef struct {
+            const char* name;
+            void* (*create)(void);
+            void (*destroy)(void* table);
+            void* (*get)(void* table, const void* key);
+            void (*put)(void* table, void* key, void* value);
+            void (*del)(void* table, const void* key);
+            double (*load_factor)(void* table);
+        } table_driver_t;
+
+/** \brief Defines the benchmarked phases. */
+typedef enum {
+            insert_phase,
+            hit_phase,
+            miss_phase,
+            delete_phase,
+            num_phases
+        } phase_t;
+
+
+/** \brief Compares two integers. */
+static int int_compare(const void* a, const void* b);
+
+/** \brief Runs all the phases on the given table, storing the runtime (in nanoseconds) per operation of each phase. */
+static void run(const table_driver_t* driver, int** present, int** absent, size_t n, double* ns_per_op, double* load_factor);
+
+/** \brief Compares hash tables. */
+static void compare_tables(size_t n, unsigned int seed);
+
+/** \brief Compares building hash tables by repeated puts and in bulk, printing the runtime (in nanoseconds) per key. */
+static void compare_builds(int** present, size_t n);
+
+/** \brief Compares lookups in a hash table with linear probing and in a static hash table, printing the runtime (in nanoseconds) per operation. */
+static void compare_static(int** present, int** absent, size_t n);
+
+/** \brief Compares reopening a snapshot with rebuilding the table from the keys. */
+static void compare_snapshot(int** present, size_t n);
+
+/** \brief Compares tables with plain and seeded hash functions on random and on colliding string keys. */
+static void compare_adversarial(void);
+
+/** \brief Puts and then gets the given string keys into the given kind of table, measuring the runtime (in nanoseconds) per operation. */
+static void run_strings(size_t kind, char** keys, size_t n, double* put_ns, double* get_ns);
+
+/** \brief Returns the size of an integer. */
+static size_t int_size(const void* p);
+
+/** \brief Compares two strings. */
+static int str_compare(const void* a, const void* b);
+
+/** \brief Displays a help message. */
+static void usage(const char* progname);
+
+static void* sepchain_create(void);
+static void sepchain_destroy(void* table);
+static void* sepchain_get(void* table, const void* key);
+static void sepchain_put(void* table, void* key, void* value);
+static void sepchain_del(void* table, const void* key);
+static double sepchain_load_factor(void* table);
+
+static void* sepchain_bloom_create(void);
+static void* sepchain_cuckoo_create(void);
+
+static void* linprob_create(void);
+static void linprob_destroy(void* table);
+static void* linprob_get(void* table, const void* key);
+static void linprob_put(void* table, void* key, void* value);
+static void linprob_del(void* table, const void* key);
+static double linprob_load_factor(void* table);
+
+static void* cuckoo_create(void);
+static void cuckoo_destroy(void* table);
+static void* cuckoo_get(void* table, const void* key);
+static void cuckoo_put(void* table, void* key, void* value);
+static void cuckoo_del(void* table, const void* key);
+static double cuckoo_load_factor(void* table);
+
+static void* compact_create(void);
+static void compact_destroy(void* table);
+static void* compact_get(void* table, const void* key);
+static void compact_put(void* table, void* key, void* value);
+static void compact_del(void* table, const void* key);
+static double compact_load_factor(void* table);
+
+static void* int_int_create(void);
+static void int_int_destroy(void* table);
+static void* int_int_get(void* table, const void* key);
+static void int_int_put(void* table, void* key, void* value);
+static void int_int_del(void* table, const void* key);
+static double int_int_load_factor(void* table);
+
+
+/** \brief The compared hash tables. */
+static const table_driver_t drivers[] = {
+            {"sepchain", sepchain_create, sepchain_destroy, sepchain_get, sepchain_put, sepchain_del, sepchain_load_factor},
+            {"sepchain+bloom", sepchain_bloom_create, sepchain_destroy, sepchain_get, sepchain_put, sepchain_del, sepchain_load_factor},
+            {"sepchain+cuckoo", sepchain_cuckoo_create, sepchain_destroy, sepchain_get, sepchain_put, sepchain_del, sepchain_load_factor},
+            {"linprob", linprob_create, linprob_destroy, linprob_get, linprob_put, linprob_del, linprob_load_factor},
+            {"cuckoo", cuckoo_create, cuckoo_destroy, cuckoo_get, cuckoo_put, cuckoo_del, cuckoo_load_factor},
+            {"compact", compact_create, compact_destroy, compact_get, compact_put, compact_del, compact_load_factor},
+            {"int->int", int_int_create, int_int_destroy, int_int_get, int_int_put, int_int_del, int_int_load_factor}
+        };
+
+/** \brief The names of the benchmarked phases. */
+static const char* phase_names[] = {"insert", "get hit", "get miss", "delete"};
+
+
+int int_compare(const void* a, const void* b)
+{
+    const int* aa = a;
+    const int* bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+int str_compare(const void* a, const void* b)
+{
+    return strcmp(a, b);
+}
+
+void* sepchain_create(void)
+{
+    return upo_ht_sepchain_create(UPO_HT_SEPCHAIN_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+}
+
+void sepchain_destroy(void* table)
+{
+    upo_ht_sepchain_destroy(table, 0);
+}
+
+void* sepchain_get(void* table, const void* key)
+{
+    return upo_ht_sepchain_get(table, key);
+}
+
+void sepchain_put(void* table, void* key, void* value)
+{
+    upo_ht_sepchain_put(table, key, value);
+}
+
+void sepchain_del(void* table, const void* key)
+{
+    upo_ht_sepchain_delete(table, key, 0);
+}
+
+double sepchain_load_factor(void* table)
+{
+    return upo_ht_sepchain_load_factor(table);
+}
+
+void* sepchain_bloom_create(void)
+{
+    upo_ht_sepchain_t ht = sepchain_create();
+
+    upo_ht_sepchain_set_filter(ht, UPO_HT_FILTER_BLOOM);
+
+    return ht;
+}
+
+void* sepchain_cuckoo_create(void)
+{
+    upo_ht_sepchain_t ht = sepchain_create();
+
+    upo_ht_sepchain_set_filter(ht, UPO_HT_FILTER_CUCKOO);
+
+    return ht;
+}
+
+void* linprob_create(void)
+{
+    return upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+}
+
+void linprob_destroy(void* table)
+{
+    upo_ht_linprob_destroy(table, 0);
+}
+
+void* linprob_get(void* table, const void* key)
+{
+    return upo_ht_linprob_get(table, key);
+}
+
+void linprob_put(void* table, void* key, void* value)
+{
+    upo_ht_linprob_put(table, key, value);
+}
+
+void linprob_del(void* table, const void* key)
+{
+    upo_ht_linprob_delete(table, key, 0);
+}
+
+double linprob_load_factor(void* table)
+{
+    return upo_ht_linprob_load_factor(table);
+}
+
+void* cuckoo_create(void)
+{
+    return upo_ht_cuckoo_create(UPO_HT_CUCKOO_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+}
+
+void cuckoo_destroy(void* table)
+{
+    upo_ht_cuckoo_destroy(table, 0);
+}
+
+void* cuckoo_get(void* table, const void* key)
+{
+    return upo_ht_cuckoo_get(table, key);
+}
+
+void cuckoo_put(void* table, void* key, void* value)
+{
+    upo_ht_cuckoo_put(table, key, value);
+}
+
+void cuckoo_del(void* table, const void* key)
+{
+    upo_ht_cuckoo_delete(table, key, 0);
+}
+
+double cuckoo_load_factor(void* table)
+{
+    return upo_ht_cuckoo_load_factor(table);
+}
+
+void* compact_create(void)
+{
+    return upo_ht_compact_create(UPO_HT_COMPACT_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+}
+
+void compact_destroy(void* table)
+{
+    upo_ht_compact_destroy(table, 0);
+}
+
+void* compact_get(void* table, const void* key)
+{
+    return upo_ht_compact_get(table, key);
+}
+
+void compact_put(void* table, void* key, void* value)
+{
+    upo_ht_compact_put(table, key, value);
+}
+
+void compact_del(void* table, const void* key)
+{
+    upo_ht_compact_delete(table, key, 0);
+}
+
+double compact_load_factor(void* table)
+{
+    return upo_ht_compact_load_factor(table);
+}
+
+void* int_int_create(void)
+{
+    return upo_ht_int_int_create(UPO_HT_INLINE_DEFAULT_CAPACITY);
+}
+
+void int_int_destroy(void* table)
+{
+    upo_ht_int_int_destroy(table);
+}
+
+void* int_int_get(void* table, const void* key)
+{
+    /* The table stores integers: return the key itself to signal a hit */
+    return upo_ht_int_int_get(table, *((const int*) key), NULL) ? (void*) key : NULL;
+}
+
+void int_int_put(void* table, void* key, void* value)
+{
+    upo_ht_int_int_put(table, *((int*) key), *((int*) value));
+}
+
+void int_int_del(void* table, const void* key)
+{
+    upo_ht_int_int_delete(table, *((const int*) key));
+}
+
+double int_int_load_factor(void* table)
+{
+    return upo_ht_int_int_load_factor(table);
+}
+
+void run(const table_driver_t* driver, int** present, int** absent, size_t n, double* ns_per_op, double* load_factor)
+{
+    upo_hires_timer_t timer;
+    void* table = NULL;
+    size_t hits = 0;
+    size_t p = 0;
+    size_t i = 0;
+
+    table = driver->create();
+    timer = upo_hires_timer_create();
+    for (p = 0; p < num_phases; ++p)
+    {
+        upo_hires_timer_start(timer);
+        switch (p)
+        {
+            case insert_phase:
+                for (i = 0; i < n; ++i)
+                {
+                    driver->put(table, present[i], present[i]);
+                }
+                break;
+            case hit_phase:
+                /* Look the keys up in a different order than they were inserted */
+                for (i = n; i > 0; --i)
+                {
+                    hits += (driver->get(table, present[i-1]) != NULL);
+                }
+                break;
+            case miss_phase:
+                for (i = 0; i < n; ++i)
+                {
+                    hits += (driver->get(table, absent[i]) != NULL);
+                }
+                break;
+            default:
+                for (i = 0; i < n; ++i)
+                {
+                    driver->del(table, present[i]);
+                }
+                break;
+        }
+        upo_hires_timer_stop(timer);
+        ns_per_op[p] = upo_hires_timer_elapsed(timer)*1e+9/n;
+        if (p == insert_phase)
+        {
+            *load_factor = driver->load_factor(table);
+        }
+    }
+    upo_hires_timer_destroy(timer);
+    driver->destroy(table);
+
+    if (hits != n)
+    {
+        upo_throw_error("Unexpected number of successful lookups");
+    }
+}
+
+void compare_tables(size_t n, unsigned int seed)
+{
+    int* keys = NULL;
+    int** present = NULL;
+    int** absent = NULL;
+    size_t d = 0;
+    size_t p = 0;
+    size_t i = 0;
+
+    srand(seed);
+
+    keys = malloc(2*n*sizeof(int));
+    present = malloc(n*sizeof(int*));
+    absent = malloc(n*sizeof(int*));
+    if (keys == NULL || present == NULL || absent == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    for (i = 0; i < 2*n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+    upo_random_shuffle(keys, 2*n, sizeof(int));
+    for (i = 0; i < n; ++i)
+    {
+        present[i] = &keys[i];
+        absent[i] = &keys[n+i];
+    }
+
+    printf("Keys: %lu\n", (unsigned long) n);
+    printf("(runtime in nanoseconds per operation; tables start empty and grow)\n");
+    printf("%-16s", "table");
+    for (p = 0; p < num_phases; ++p)
+    {
+        printf(" %10s", phase_names[p]);
+    }
+    printf(" %12s\n", "load factor");
+    for (d = 0; d < sizeof drivers/sizeof drivers[0]; ++d)
+    {
+        double ns_per_op[num_phases];
+        double load_factor = 0;
+
+        run(&drivers[d], present, absent, n, ns_per_op, &load_factor);
+        printf("%-16s", drivers[d].name);
+        for (p = 0; p < num_phases; ++p)
+        {
+            printf(" %10.2f", ns_per_op[p]);
+        }
+        printf(" %12.3f\n", load_factor);
+        fflush(stdout);
+    }
+
+    compare_builds(present, n);
+    compare_static(present, absent, n);
+    compare_snapshot(present, n);
+    compare_adversarial();
+
+    free(absent);
+    free(present);
+    free(keys);
+}
+
+void compare_builds(int** present, size_t n)
+{
+    upo_hires_timer_t timer;
+    upo_ht_sepchain_t sepchain = NULL;
+    upo_ht_linprob_t linprob = NULL;
+    double puts_ns = 0;
+    double build_ns = 0;
+    size_t i = 0;
+
+    timer = upo_hires_timer_create();
+
+    printf("\nBulk building (runtime in nanoseconds per key)\n");
+    printf("%-12s %10s %10s %10s\n", "table", "puts", "build", "speedup");
+
+    upo_hires_timer_start(timer);
+    sepchain = upo_ht_sepchain_create(UPO_HT_SEPCHAIN_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_sepchain_put(sepchain, present[i], present[i]);
+    }
+    upo_hires_timer_stop(timer);
+    puts_ns = upo_hires_timer_elapsed(timer)*1e+9/n;
+    upo_ht_sepchain_destroy(sepchain, 0);
+
+    upo_hires_timer_start(timer);
+    sepchain = upo_ht_sepchain_build_from_arrays((void* const*) present, (void* const*) present, n, upo_ht_hash_int_mix, int_compare);
+    upo_hires_timer_stop(timer);
+    build_ns = upo_hires_timer_elapsed(timer)*1e+9/n;
+    upo_ht_sepchain_destroy(sepchain, 0);
+    printf("%-12s %10.2f %10.2f %10.2f\n", "sepchain", puts_ns, build_ns, puts_ns/build_ns);
+
+    upo_hires_timer_start(timer);
+    linprob = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_linprob_put(linprob, present[i], present[i]);
+    }
+    upo_hires_timer_stop(timer);
+    puts_ns = upo_hires_timer_elapsed(timer)*1e+9/n;
+    upo_ht_linprob_destroy(linprob, 0);
+
+    upo_hires_timer_start(timer);
+    linprob = upo_ht_linprob_build_from_arrays((void* const*) present, (void* const*) present, n, upo_ht_hash_int_mix, int_compare);
+    upo_hires_timer_stop(timer);
+    build_ns = upo_hires_timer_elapsed(timer)*1e+9/n;
+    upo_ht_linprob_destroy(linprob, 0);
+    printf("%-12s %10.2f %10.2f %10.2f\n", "linprob", puts_ns, build_ns, puts_ns/build_ns);
+
+    upo_hires_timer_destroy(timer);
+}
+
+void compare_static(int** present, int** absent, size_t n)
+{
+    upo_hires_timer_t timer;
+    upo_ht_linprob_t linprob = NULL;
+    upo_mph_table_t table = NULL;
+    upo_ht_stats_t stats;
+    double build_ns = 0;
+    double hit_ns = 0;
+    double miss_ns = 0;
+    size_t hits = 0;
+    size_t i = 0;
+
+    timer = upo_hires_timer_create();
+
+    printf("\nStatic tables (runtime in nanoseconds per operation; memory in bytes per key, keys and values excluded)\n");
+    printf("%-12s %10s %10s %10s %10s\n", "table", "build", "hit", "miss", "memory");
+
+    upo_hires_timer_start(timer);
+    linprob = upo_ht_linprob_build_from_arrays((void* const*) present, (void* const*) present, n, upo_ht_hash_int_mix, int_compare);
+    upo_hires_timer_stop(timer);
+    build_ns = upo_hires_timer_elapsed(timer)*1e+9/n;
+    upo_hires_timer_start(timer);
+    for (i = n; i > 0; --i)
+    {
+        hits += (upo_ht_linprob_get(linprob, present[i-1]) != NULL);
+    }
+    upo_hires_timer_stop(timer);
+    hit_ns = upo_hires_timer_elapsed(timer)*1e+9/n;
+    upo_hires_timer_start(timer);
+    for (i = 0; i < n; ++i)
+    {
+        hits += (upo_ht_linprob_get(linprob, absent[i]) != NULL);
+    }
+    upo_hires_timer_stop(timer);
+    miss_ns = upo_hires_timer_elapsed(timer)*1e+9/n;
+    upo_ht_linprob_stats(linprob, &stats);
+    printf("%-12s %10.2f %10.2f %10.2f %10.2f\n", "linprob", build_ns, hit_ns, miss_ns, (double) stats.total_bytes/n);
+    upo_ht_linprob_destroy(linprob, 0);
+
+    upo_hires_timer_start(timer);
+    table = upo_mph_table_build((void* const*) present, (void* const*) present, n, upo_ht_hash_int_mix, int_compare);
+    upo_hires_timer_stop(timer);
+    if (table == NULL)
+    {
+        upo_throw_error("Unable to build the static hash table");
+    }
+    build_ns = upo_hires_timer_elapsed(timer)*1e+9/n;
+    upo_hires_timer_start(timer);
+    for (i = n; i > 0; --i)
+    {
+        hits += (upo_mph_table_get(table, present[i-1]) != NULL);
+    }
+    upo_hires_timer_stop(timer);
+    hit_ns = upo_hires_timer_elapsed(timer)*1e+9/n;
+    upo_hires_timer_start(timer);
+    for (i = 0; i < n; ++i)
+    {
+        hits += (upo_mph_table_get(table, absent[i]) != NULL);
+    }
+    upo_hires_timer_stop(timer);
+    miss_ns = upo_hires_timer_elapsed(timer)*1e+9/n;
+    printf("%-12s %10.2f %10.2f %10.2f %10.2f\n", "mph", build_ns, hit_ns, miss_ns, (double) upo_mph_table_memory_usage(table)/n);
+    upo_mph_table_destroy(table, 0);
+
+    upo_hires_timer_destroy(timer);
+
+    if (hits != 2*n)
+    {
+        upo_throw_error("Unexpected number of successful lookups");
+    }
+}
+
+void compare_snapshot(int** present, size_t n)
+{
+    upo_hires_timer_t timer;
+    upo_ht_linprob_t linprob = NULL;
+    upo_ht_snapshot_t snap = NULL;
+    char path[] = SNAPSHOT_PATH_TEMPLATE;
+    int fd = -1;
+    size_t hits = 0;
+    size_t i = 0;
+
+    /* A fresh file in the temporary directory, rather than a fixed name in
+     * the working one: saving replaces it */
+    fd = mkstemp(path);
+    if (fd == -1)
+    {
+        upo_throw_sys_error("Unable to create a temporary file for the snapshot");
+    }
+    close(fd);
+
+    timer = upo_hires_timer_create();
+
+    printf("\nSnapshots (runtime in milliseconds)\n");
+
+    upo_hires_timer_start(timer);
+    linprob = upo_ht_linprob_build_from_arrays((void* const*) present, (void* const*) present, n, upo_ht_hash_int_mix, int_compare);
+    upo_hires_timer_stop(timer);
+    printf("%-24s %10.3f\n", "rebuild", upo_hires_timer_elapsed(timer)*1e+3);
+
+    upo_hires_timer_start(timer);
+    if (!upo_ht_linprob_save(linprob, path, upo_ht_hash_int_mix, int_size, int_size))
+    {
+        upo_throw_sys_error("Unable to save the snapshot");
+    }
+    upo_hires_timer_stop(timer);
+    printf("%-24s %10.3f\n", "save", upo_hires_timer_elapsed(timer)*1e+3);
+    upo_ht_linprob_destroy(linprob, 0);
+
+    upo_hires_timer_start(timer);
+    snap = upo_ht_snapshot_open(path, upo_ht_hash_int_mix, int_compare);
+    upo_hires_timer_stop(timer);
+    if (snap == NULL)
+    {
+        upo_throw_sys_error("Unable to open the snapshot");
+    }
+    printf("%-24s %10.3f\n", "open", upo_hires_timer_elapsed(timer)*1e+3);
+
+    /* The first lookups also fault the pages of the file in */
+    upo_hires_timer_start(timer);
+    for (i = n; i > 0; --i)
+    {
+        hits += upo_ht_snapshot_contains(snap, present[i-1]);
+    }
+    upo_hires_timer_stop(timer);
+    printf("%-24s %10.3f\n", "lookup all keys", upo_hires_timer_elapsed(timer)*1e+3);
+
+    upo_ht_snapshot_close(snap);
+    remove(path);
+    upo_hires_timer_destroy(timer);
+
+    if (hits != n)
+    {
+        upo_throw_error("Unexpected number of successful lookups");
+    }
+}
+
+void compare_adversarial(void)
+{
+    static const char* names[] = {"sepchain", "sepchain+sip", "linprob", "linprob+sip"};
+    size_t n = (size_t) 1 << ADVERSARIAL_BLOCKS;
+    char* buffer = NULL;
+    char** random_keys = NULL;
+    char** colliding_keys = NULL;
+    size_t i = 0;
+    size_t j = 0;
+
+    buffer = malloc(2*n*(2*ADVERSARIAL_BLOCKS + 1));
+    random_keys = malloc(n*sizeof(char*));
+    colliding_keys = malloc(n*sizeof(char*));
+    if (buffer == NULL || random_keys == NULL || colliding_keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for string keys");
+    }
+
+    /* Strings made of blocks "ab" and "bA" share their djb2 hash value, as
+     * 'a'*33 + 'b' == 'b'*33 + 'A'; random strings of the same length are the
+     * baseline (duplicates among them are harmless) */
+    for (i = 0; i < n; ++i)
+    {
+        random_keys[i] = buffer + 2*i*(2*ADVERSARIAL_BLOCKS + 1);
+        colliding_keys[i] = random_keys[i] + 2*ADVERSARIAL_BLOCKS + 1;
+        upo_random_string(random_keys[i], 2*ADVERSARIAL_BLOCKS);
+        for (j = 0; j < ADVERSARIAL_BLOCKS; ++j)
+        {
+            colliding_keys[i][2*j] = ((i >> j) & 1) ? 'b' : 'a';
+            colliding_keys[i][2*j+1] = ((i >> j) & 1) ? 'A' : 'b';
+        }
+        colliding_keys[i][2*ADVERSARIAL_BLOCKS] = '\0';
+    }
+
+    printf("\nAdversarial keys (runtime in nanoseconds per operation; %lu strings, plain tables use djb2)\n", (unsigned long) n);
+    printf("%-16s %10s %10s %10s %10s\n", "table", "rnd put", "rnd get", "adv put", "adv get");
+    for (i = 0; i < sizeof names/sizeof names[0]; ++i)
+    {
+        double ns[4];
+
+        run_strings(i, random_keys, n, &ns[0], &ns[1]);
+        run_strings(i, colliding_keys, n, &ns[2], &ns[3]);
+        printf("%-16s %10.2f %10.2f %10.2f %10.2f\n", names[i], ns[0], ns[1], ns[2], ns[3]);
+        fflush(stdout);
+    }
+
+    free(colliding_keys);
+    free(random_keys);
+    free(buffer);
+}
+
+void run_strings(size_t kind, char** keys, size_t n, double* put_ns, double* get_ns)
+{
+    upo_hires_timer_t timer;
+    upo_ht_sepchain_t sepchain = NULL;
+    upo_ht_linprob_t linprob = NULL;
+    size_t i = 0;
+
+    timer = upo_hires_timer_create();
+
+    switch (kind)
+    {
+        case 0:
+            sepchain = upo_ht_sepchain_create(UPO_HT_SEPCHAIN_DEFAULT_CAPACITY, upo_ht_hash_str_djb2, str_compare);
+            break;
+        case 1:
+            sepchain = upo_ht_sepchain_create_seeded(UPO_HT_SEPCHAIN_DEFAULT_CAPACITY, upo_ht_hash_str_sip, str_compare);
+            break;
+        case 2:
+            linprob = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_str_djb2, str_compare);
+            break;
+        default:
+            linprob = upo_ht_linprob_create_seeded(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_str_sip, str_compare);
+            break;
+    }
+
+    upo_hires_timer_start(timer);
+    for (i = 0; i < n; ++i)
+    {
+        if (sepchain != NULL)
+        {
+            upo_ht_sepchain_put(sepchain, keys[i], keys[i]);
+        }
+        else
+        {
+            upo_ht_linprob_put(linprob, keys[i], keys[i]);
+        }
+    }
+    upo_hires_timer_stop(timer);
+    *put_ns = upo_hires_timer_elapsed(timer)*1e+9/n;
+
+    upo_hires_timer_start(timer);
+    for (i = 0; i < n; ++i)
+    {
+        void* value = (sepchain != NULL) ? upo_ht_sepchain_get(sepchain, keys[i]) : upo_ht_linprob_get(linprob, keys[i]);
+
+        assert( value != NULL );
+    }
+    upo_hires_timer_stop(timer);
+    *get_ns = upo_hires_timer_elapsed(timer)*1e+9/n;
+
+    upo_ht_sepchain_destroy(sepchain, 0);
+    upo_ht_linprob_destroy(linprob, 0);
+    upo_hires_timer_destroy(timer);
+}
+
+
+size_t int_size(const void* p)
+{
+    (void) p;
+
+    return sizeof(int);
+}
+
+void usage(const char* progname)
+{
+    fprintf(stderr, "Usage: %s <options>\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-n <value>: Specifies the number of keys to insert.\n"
+                    "            [default: %lu]\n", (unsigned long) DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+}
+
+
+int main(int argc, char* argv[])
+{
+    size_t opt_n = DEFAULT_OPT_NUM_KEYS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int arg;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-h", argv[arg]))
+        {
+            usage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+        else if (!strcmp("-n", argv[arg]) || !strcmp("-s", argv[arg]))
+        {
+            const char* opt = argv[arg];
+
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected value for option '%s'.\n", opt);
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            if (opt[1] == 'n')
+            {
+                opt_n = atol(argv[arg]);
+            }
+            else
+            {
+                opt_seed = atoi(argv[arg]);
+            }
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: unknown option '%s'.\n", argv[arg]);
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (opt_n == 0)
+    {
+        fprintf(stderr, "ERROR: the number of keys must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    compare_tables(opt_n, opt_seed);
+
+    return EXIT_SUCCESS;
+}
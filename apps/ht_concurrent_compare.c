@@ -0,0 +1,490 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/ht_concurrent_compare.c
+ *
+ * \brief An application to compare the throughput of hash tables shared by
+ *  several threads.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+#include <upo/hashtable_concurrent.h>
+#include <upo/hashtable_rcu.h>
+#include <upo/hires_timer.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 100000
+#define DEFAULT_OPT_NUM_OPS (size_t) 1000000
+#define DEFAULT_OPT_NUM_THREADS (size_t) 8
+#define DEFAULT_OPT_READ_PERCENT (size_t) 90
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+
+
+/**
+ * \brief Defines a hash table under test, as a set of operations on an opaque
+ *  table.
+ */
+typedef struct {
+            const char* name;
+            void* (*create)(size_t n);
+            void (*destroy)(void* table);
+            void* (*get)(void* table, const void* key);
+            void (*put)(void* table, void* key, void* value);
+            void (*del)(void* table, const void* key);
+        } table_driver_t;
+
+/** \brief Defines a separate chaining hash table protected by a global mutex. */
+typedef struct {
+            pthread_mutex_t mutex;
+            upo_ht_sepchain_t ht;
+        } locked_sepchain_t;
+
+/** \brief Defines the work of a benchmark thread. */
+typedef struct {
+            const table_driver_t* driver;
+            void* table;
+            int* keys;
+            size_t num_keys;
+            size_t num_ops;
+            size_t read_percent;
+            int* hot_key;
+            unsigned long rng_state;
+            size_t hits;
+        } worker_t;
+
+
+static int int_compare(const void* a, const void* b);
+static unsigned long next_random(unsigned long* state);
+static void* worker_run(void* arg);
+static double run(const table_driver_t* driver, int* keys, size_t num_keys, size_t num_ops, size_t num_threads, size_t read_percent, int* hot_key, unsigned int seed);
+static void compare_tables(size_t num_keys, size_t num_ops, size_t max_threads, size_t read_percent, unsigned int seed);
+static void usage(const char* progname);
+
+static void* locked_sepchain_create(size_t n);
+static void locked_sepchain_destroy(void* table);
+static void* locked_sepchain_get(void* table, const void* key);
+static void locked_sepchain_put(void* table, void* key, void* value);
+static void locked_sepchain_del(void* table, const void* key);
+
+static void* concurrent_global_create(size_t n);
+static void* concurrent_striped_create(size_t n);
+static void concurrent_destroy(void* table);
+static void* concurrent_get(void* table, const void* key);
+static void concurrent_put(void* table, void* key, void* value);
+static void concurrent_del(void* table, const void* key);
+
+static void* rcu_create(size_t n);
+static void rcu_destroy(void* table);
+static void* rcu_get(void* table, const void* key);
+static void rcu_put(void* table, void* key, void* value);
+static void rcu_del(void* table, const void* key);
+
+
+/** \brief The compared hash tables. */
+static const table_driver_t drivers[] = {
+            {"sepchain+mutex", locked_sepchain_create, locked_sepchain_destroy, locked_sepchain_get, locked_sepchain_put, locked_sepchain_del},
+            {"concurrent/1", concurrent_global_create, concurrent_destroy, concurrent_get, concurrent_put, concurrent_del},
+            {"concurrent", concurrent_striped_create, concurrent_destroy, concurrent_get, concurrent_put, concurrent_del},
+            {"rcu", rcu_create, rcu_destroy, rcu_get, rcu_put, rcu_del}
+        };
+
+
+int int_compare(const void* a, const void* b)
+{
+    const int* aa = a;
+    const int* bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+unsigned long next_random(unsigned long* state)
+{
+    /* A xorshift generator: rand() is neither reentrant nor scalable */
+    unsigned long x = *state;
+
+    x ^= (x << 13) & 0xFFFFFFFFUL;
+    x ^= x >> 17;
+    x ^= (x << 5) & 0xFFFFFFFFUL;
+    *state = x & 0xFFFFFFFFUL;
+
+    return *state;
+}
+
+void* locked_sepchain_create(size_t n)
+{
+    locked_sepchain_t* table = malloc(sizeof(locked_sepchain_t));
+
+    if (table == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the locked hash table");
+    }
+    if (pthread_mutex_init(&table->mutex, NULL) != 0)
+    {
+        upo_throw_error("Unable to initialize the mutex of the locked hash table");
+    }
+    table->ht = upo_ht_sepchain_create(n, upo_ht_hash_int_mix, int_compare);
+
+    return table;
+}
+
+void locked_sepchain_destroy(void* table)
+{
+    locked_sepchain_t* t = table;
+
+    upo_ht_sepchain_destroy(t->ht, 0);
+    pthread_mutex_destroy(&t->mutex);
+    free(t);
+}
+
+void* locked_sepchain_get(void* table, const void* key)
+{
+    locked_sepchain_t* t = table;
+    void* value = NULL;
+
+    pthread_mutex_lock(&t->mutex);
+    value = upo_ht_sepchain_get(t->ht, key);
+    pthread_mutex_unlock(&t->mutex);
+
+    return value;
+}
+
+void locked_sepchain_put(void* table, void* key, void* value)
+{
+    locked_sepchain_t* t = table;
+
+    pthread_mutex_lock(&t->mutex);
+    upo_ht_sepchain_put(t->ht, key, value);
+    pthread_mutex_unlock(&t->mutex);
+}
+
+void locked_sepchain_del(void* table, const void* key)
+{
+    locked_sepchain_t* t = table;
+
+    pthread_mutex_lock(&t->mutex);
+    upo_ht_sepchain_delete(t->ht, key, 0);
+    pthread_mutex_unlock(&t->mutex);
+}
+
+void* concurrent_global_create(size_t n)
+{
+    return upo_ht_concurrent_create(n, 1, upo_ht_hash_int_mix, int_compare);
+}
+
+void* concurrent_striped_create(size_t n)
+{
+    return upo_ht_concurrent_create(n, UPO_HT_CONCURRENT_DEFAULT_STRIPES, upo_ht_hash_int_mix, int_compare);
+}
+
+void concurrent_destroy(void* table)
+{
+    upo_ht_concurrent_destroy(table, 0);
+}
+
+void* concurrent_get(void* table, const void* key)
+{
+    return upo_ht_concurrent_get(table, key);
+}
+
+void concurrent_put(void* table, void* key, void* value)
+{
+    upo_ht_concurrent_put(table, key, value);
+}
+
+void concurrent_del(void* table, const void* key)
+{
+    upo_ht_concurrent_delete(table, key, 0);
+}
+
+void* rcu_create(size_t n)
+{
+    return upo_ht_rcu_create(n, upo_ht_hash_int_mix, int_compare);
+}
+
+void rcu_destroy(void* table)
+{
+    upo_ht_rcu_destroy(table, 0);
+}
+
+void* rcu_get(void* table, const void* key)
+{
+    return upo_ht_rcu_get(table, key);
+}
+
+void rcu_put(void* table, void* key, void* value)
+{
+    upo_ht_rcu_put(table, key, value);
+}
+
+void rcu_del(void* table, const void* key)
+{
+    upo_ht_rcu_delete(table, key, 0);
+}
+
+void* worker_run(void* arg)
+{
+    worker_t* w = arg;
+    size_t i = 0;
+
+    /* Keys are drawn from twice the preloaded range, so that half of the
+     * lookups miss; updates are evenly split between puts and deletes, so
+     * that the size stays roughly constant */
+    if (w->hot_key != NULL)
+    {
+        /* Every thread looks up the same key, as in a configuration cache */
+        for (i = 0; i < w->num_ops; ++i)
+        {
+            w->hits += (w->driver->get(w->table, w->hot_key) != NULL);
+        }
+        return NULL;
+    }
+
+    for (i = 0; i < w->num_ops; ++i)
+    {
+        unsigned long r = next_random(&w->rng_state);
+        int* key = &w->keys[r % (2*w->num_keys)];
+
+        if ((r >> 16) % 100 < w->read_percent)
+        {
+            w->hits += (w->driver->get(w->table, key) != NULL);
+        }
+        else if ((r >> 8) & 1U)
+        {
+            w->driver->put(w->table, key, key);
+        }
+        else
+        {
+            w->driver->del(w->table, key);
+        }
+    }
+
+    return NULL;
+}
+
+double run(const table_driver_t* driver, int* keys, size_t num_keys, size_t num_ops, size_t num_threads, size_t read_percent, int* hot_key, unsigned int seed)
+{
+    pthread_t* threads = NULL;
+    worker_t* workers = NULL;
+    upo_hires_timer_t timer;
+    void* table = NULL;
+    double runtime = 0;
+    size_t i = 0;
+
+    threads = malloc(num_threads*sizeof(pthread_t));
+    workers = malloc(num_threads*sizeof(worker_t));
+    if (threads == NULL || workers == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the benchmark threads");
+    }
+
+    table = driver->create(num_keys);
+    for (i = 0; i < num_keys; ++i)
+    {
+        driver->put(table, &keys[2*i], &keys[2*i]);
+    }
+
+    for (i = 0; i < num_threads; ++i)
+    {
+        workers[i].driver = driver;
+        workers[i].table = table;
+        workers[i].keys = keys;
+        workers[i].num_keys = num_keys;
+        workers[i].num_ops = num_ops/num_threads;
+        workers[i].read_percent = read_percent;
+        workers[i].hot_key = hot_key;
+        workers[i].rng_state = (seed + 2654435761UL*(i+1)) & 0xFFFFFFFFUL;
+        workers[i].rng_state |= 1UL;
+        workers[i].hits = 0;
+    }
+
+    timer = upo_hires_timer_create();
+    upo_hires_timer_start(timer);
+    for (i = 0; i < num_threads; ++i)
+    {
+        if (pthread_create(&threads[i], NULL, worker_run, &workers[i]) != 0)
+        {
+            upo_throw_error("Unable to create a benchmark thread");
+        }
+    }
+    for (i = 0; i < num_threads; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    upo_hires_timer_stop(timer);
+    runtime = upo_hires_timer_elapsed(timer);
+    upo_hires_timer_destroy(timer);
+
+    driver->destroy(table);
+    free(workers);
+    free(threads);
+
+    /* Millions of operations per second */
+    return (num_ops/num_threads)*num_threads/runtime*1e-6;
+}
+
+void compare_tables(size_t num_keys, size_t num_ops, size_t max_threads, size_t read_percent, unsigned int seed)
+{
+    int* keys = NULL;
+    size_t t = 0;
+    size_t d = 0;
+    size_t i = 0;
+
+    keys = malloc(2*num_keys*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    for (i = 0; i < 2*num_keys; ++i)
+    {
+        keys[i] = (int) i;
+    }
+
+    printf("Keys: %lu, operations: %lu, reads: %lu%%\n", (unsigned long) num_keys, (unsigned long) num_ops, (unsigned long) read_percent);
+    printf("(throughput in millions of operations per second)\n");
+    printf("%-16s", "threads");
+    for (t = 1; t <= max_threads; t *= 2)
+    {
+        printf(" %10lu", (unsigned long) t);
+    }
+    putchar('\n');
+    for (d = 0; d < sizeof drivers/sizeof drivers[0]; ++d)
+    {
+        printf("%-16s", drivers[d].name);
+        for (t = 1; t <= max_threads; t *= 2)
+        {
+            printf(" %10.2f", run(&drivers[d], keys, num_keys, num_ops, t, read_percent, NULL, seed));
+            fflush(stdout);
+        }
+        putchar('\n');
+    }
+
+    /* Lookups of a single hot key show whether reads contend on shared lines */
+    printf("\nHot key (lookups only, all of the same key)\n");
+    for (d = 0; d < sizeof drivers/sizeof drivers[0]; ++d)
+    {
+        printf("%-16s", drivers[d].name);
+        for (t = 1; t <= max_threads; t *= 2)
+        {
+            printf(" %10.2f", run(&drivers[d], keys, num_keys, num_ops, t, 100, &keys[0], seed));
+            fflush(stdout);
+        }
+        putchar('\n');
+    }
+
+    free(keys);
+}
+
+void usage(const char* progname)
+{
+    fprintf(stderr, "Usage: %s <options>\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the number of keys initially stored in the tables.\n"
+                    "            [default: %lu]\n", (unsigned long) DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-n <value>: Specifies the total number of operations (split among threads).\n"
+                    "            [default: %lu]\n", (unsigned long) DEFAULT_OPT_NUM_OPS);
+    fprintf(stderr, "-r <value>: Specifies the percentage of lookups among operations.\n"
+                    "            [default: %lu]\n", (unsigned long) DEFAULT_OPT_READ_PERCENT);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-t <value>: Specifies the maximum number of threads (runs use 1, 2, 4, ... threads).\n"
+                    "            [default: %lu]\n", (unsigned long) DEFAULT_OPT_NUM_THREADS);
+}
+
+
+int main(int argc, char* argv[])
+{
+    size_t opt_k = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_n = DEFAULT_OPT_NUM_OPS;
+    size_t opt_r = DEFAULT_OPT_READ_PERCENT;
+    size_t opt_t = DEFAULT_OPT_NUM_THREADS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int arg;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-h", argv[arg]))
+        {
+            usage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+        else if (!strcmp("-k", argv[arg]) || !strcmp("-n", argv[arg]) || !strcmp("-r", argv[arg])
+                 || !strcmp("-s", argv[arg]) || !strcmp("-t", argv[arg]))
+        {
+            const char* opt = argv[arg];
+
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected value for option '%s'.\n", opt);
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            if (opt[1] == 'k')
+            {
+                opt_k = atol(argv[arg]);
+            }
+            else if (opt[1] == 'n')
+            {
+                opt_n = atol(argv[arg]);
+            }
+            else if (opt[1] == 'r')
+            {
+                opt_r = atol(argv[arg]);
+            }
+            else if (opt[1] == 't')
+            {
+                opt_t = atol(argv[arg]);
+            }
+            else
+            {
+                opt_seed = atoi(argv[arg]);
+            }
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: unknown option '%s'.\n", argv[arg]);
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (opt_k == 0 || opt_n == 0 || opt_t == 0 || opt_r > 100)
+    {
+        fprintf(stderr, "ERROR: keys, operations and threads must be positive, and reads at most 100%%.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    compare_tables(opt_k, opt_n, opt_t, opt_r, opt_seed);
+
+    return EXIT_SUCCESS;
+}
@@ -18,6 +18,25 @@
  *   subtree of v.
  * .
  *
+ * Trees built by upo_bst_create() take the shape given by the order of
+ * insertions: sorted insertions make them degenerate into lists, with a
+ * height linear in their size.
+ * Trees built by upo_bst_create_balanced() with #UPO_BST_AVL are AVL trees:
+ * the heights of the two subtrees of each node differ by at most one, so the
+ * height stays below \f$1.45 \log_2(n+2)\f$ and every operation that walks
+ * down a single path takes logarithmic time.
+ * Below, `h` denotes the height of the tree: `O(h)` is `O(n)` for unbalanced
+ * trees and `O(log n)` for balanced ones.
+ *
+ * Each node also records the size of its subtree, so that the size of the
+ * tree is known in constant time and keys can be found (or counted) by
+ * their position in the order of keys, with upo_bst_rank(),
+ * upo_bst_select() and upo_bst_count_range(), by walking down a single path.
+ *
+ * No operation recurses: the paths that must be walked back up (e.g., to
+ * rebalance the tree) are kept in an explicit stack, so that even degenerate
+ * trees of many keys never exhaust the call stack.
+ *
  * \author Your Name
  *
  * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
@@ -45,6 +64,13 @@
 #include <stddef.h>
 
 
+/** \brief Binary search trees that are never rebalanced. */
+#define UPO_BST_UNBALANCED 0
+
+/** \brief Binary search trees balanced as AVL trees. */
+#define UPO_BST_AVL 1
+
+
 /** \brief Declares the Binary Search Tree type. */
 typedef struct upo_bst_s* upo_bst_t;
 
@@ -91,6 +117,32 @@ typedef struct upo_bst_key_list_node_s upo_bst_key_list_node_t;
 /** \brief The type for list of keys. */
 typedef upo_bst_key_list_node_t* upo_bst_key_list_t;
 
+/** \brief The maximum depth of the nodes a cursor keeps the path to. */
+#define UPO_BST_CURSOR_MAX_DEPTH 64U
+
+/**
+ * \brief The type for cursors over the keys of a binary search tree, in
+ *  order.
+ *
+ * A cursor lies between two consecutive keys (or before the first one, or
+ * after the last one), and moves forward or backward one key at a time
+ * without allocating memory.
+ * It keeps the path from the root down to the node of the key that follows
+ * it, so each move takes amortized constant time.
+ * Past #UPO_BST_CURSOR_MAX_DEPTH nodes (never in AVL trees of less than
+ * about \f$2^{44}\f$ keys), the path is dropped and each move looks for the
+ * next key from the root, in `O(h)` time.
+ * Its fields are private.
+ */
+struct upo_bst_cursor_s {
+    struct upo_bst_node_s* path[UPO_BST_CURSOR_MAX_DEPTH]; /**< The nodes from the root down to the current one. */
+    size_t depth; /**< The number of nodes of the path. */
+    struct upo_bst_node_s* node; /**< The node of the key following the cursor (`NULL` after the last key). */
+    int overflow; /**< Tells whether the path is too long to be kept. */
+};
+/** \brief Alias for the type for cursors. */
+typedef struct upo_bst_cursor_s upo_bst_cursor_t;
+
 
 /**
  * \brief Creates a new empty binary search tree.
@@ -102,6 +154,19 @@ typedef upo_bst_key_list_node_t* upo_bst_key_list_t;
  */
 upo_bst_t upo_bst_create(upo_bst_comparator_t key_cmp);
 
+/**
+ * \brief Creates a new empty binary search tree with the given balancing
+ *  scheme.
+ *
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \param balance The balancing scheme: #UPO_BST_UNBALANCED (the same as
+ *  upo_bst_create()) or #UPO_BST_AVL.
+ * \return An empty binary search tree.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+upo_bst_t upo_bst_create_balanced(upo_bst_comparator_t key_cmp, int balance);
+
 /**
  * \brief Destroys the given binary search tree together with data stored on it.
  *
@@ -147,7 +212,7 @@ void upo_bst_clear(upo_bst_t tree, int destroy_data);
  * The old value is returned so that its memory can be deallocated
  * (if necessary).
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
  */
 void* upo_bst_put(upo_bst_t tree, void* key, void* value);
 
@@ -167,7 +232,7 @@ upo_bst_comparator_t upo_bst_get_comparator(const upo_bst_t tree);
  * \param key The key.
  * \return The value associated to \a key, or `NULL` if the key is not found.
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
  */
 void* upo_bst_get(const upo_bst_t tree, const void* key);
 
@@ -184,7 +249,7 @@ void* upo_bst_get(const upo_bst_t tree, const void* key);
  * Memory deallocation (if requested) is performed by means of the `free()`
  * standard C function.
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
  */
 void upo_bst_delete(upo_bst_t tree, const void* key, int destroy_data);
 
@@ -197,7 +262,7 @@ void upo_bst_delete(upo_bst_t tree, const void* key, int destroy_data);
  * \return `1` if the binary search tree contains an item identified by the
  *  given key, or `0` if the key is not found.
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
  */
 int upo_bst_contains(const upo_bst_t tree, const void* key);
 
@@ -211,7 +276,7 @@ int upo_bst_contains(const upo_bst_t tree, const void* key);
  *
  * If the key is already present in the tree, no insertion takes place.
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
  */
 void upo_bst_insert(upo_bst_t tree, void* key, void* value);
 
@@ -221,7 +286,7 @@ void upo_bst_insert(upo_bst_t tree, void* key, void* value);
  * \param tree The binary search tree.
  * \return The number of nodes of the given binary search tree.
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Worst-case complexity: constant, `O(1)`.
  */
 size_t upo_bst_size(const upo_bst_t tree);
 
@@ -243,7 +308,7 @@ int upo_bst_is_empty(const upo_bst_t tree);
  * \param tree The binary search tree.
  * \return The height of the given binary search tree.
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Worst-case complexity: constant, `O(1)`.
  */
 size_t upo_bst_height(const upo_bst_t tree);
 
@@ -271,7 +336,7 @@ void upo_bst_traverse_in_order(const upo_bst_t tree, upo_bst_visitor_t visit, vo
  * \param tree The binary search tree.
  * \return The smallest key, or `NULL` if the tree is empty.
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
  */
 void* upo_bst_min(const upo_bst_t tree);
 
@@ -281,7 +346,7 @@ void* upo_bst_min(const upo_bst_t tree);
  * \param tree The binary search tree.
  * \return The largest key, or `NULL` if the tree is empty.
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
  */
 void* upo_bst_max(upo_bst_t tree);
 
@@ -297,7 +362,7 @@ void* upo_bst_max(upo_bst_t tree);
  * Memory deallocation (if requested) is performed by means of the `free()`
  * standard C function.
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
  */
 void upo_bst_delete_min(upo_bst_t tree, int destroy_data);
 
@@ -313,7 +378,7 @@ void upo_bst_delete_min(upo_bst_t tree, int destroy_data);
  * Memory deallocation (if requested) is performed by means of the `free()`
  * standard C function.
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
  */
 void upo_bst_delete_max(upo_bst_t tree, int destroy_data);
 
@@ -325,7 +390,7 @@ void upo_bst_delete_max(upo_bst_t tree, int destroy_data);
  * \param key The key.
  * \return The largest key which is less than or equal to the given key.
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
  */
 void* upo_bst_floor(const upo_bst_t tree, const void* key);
 
@@ -337,7 +402,7 @@ void* upo_bst_floor(const upo_bst_t tree, const void* key);
  * \param key The key.
  * \return The smallest key which is greater than or equal to the given key.
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
  */
 void* upo_bst_ceiling(const upo_bst_t tree, const void* key);
 
@@ -348,10 +413,13 @@ void* upo_bst_ceiling(const upo_bst_t tree, const void* key);
  * \param tree The binary search tree.
  * \param low_key The lower bound of the range of keys.
  * \param high_key The upper bound of the range of keys.
- * \return A singly-linked list of keys inside the provided range, or `NULL` if
- *  no key falls inside the range.
+ * \return A singly-linked list of keys inside the provided range, from the
+ *  largest to the smallest, or `NULL` if no key falls inside the range.
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Only the subtrees that may hold keys inside the range are visited.
+ *
+ * Worst-case complexity: linear in the height `h` of the tree and in the
+ *  number `k` of keys inside the range, `O(h+k)`.
  */
 upo_bst_key_list_t upo_bst_keys_range(const upo_bst_t tree, const void* low_key, const void* high_key);
 
@@ -383,6 +451,124 @@ upo_bst_key_list_t upo_bst_keys(const upo_bst_t tree);
  */
 int upo_bst_is_bst(const upo_bst_t tree, const void* min_key, const void* max_key);
 
+/**
+ * \brief Returns the number of keys in the given binary search tree that are
+ *  less than the given key.
+ *
+ * \param tree The binary search tree.
+ * \param key The key (which needs not be in the tree).
+ * \param key_cmp The key comparison function, which must order keys as the
+ *  one of the tree.
+ * \return The rank of \a key, i.e. the number of keys less than \a key.
+ *
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
+ */
 size_t upo_bst_rank(const upo_bst_t tree, const void* key, upo_bst_comparator_t key_cmp);
 
+/**
+ * \brief Returns the key of the given rank in the given binary search tree.
+ *
+ * \param tree The binary search tree.
+ * \param k The rank, starting from `0` for the smallest key.
+ * \return The key that is greater than exactly \a k other keys, or `NULL`
+ *  if \a k is not less than the size of the tree.
+ *
+ * For each key of the tree, `upo_bst_select(tree, upo_bst_rank(tree, key,
+ * cmp))` is the key itself.
+ *
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
+ */
+void* upo_bst_select(const upo_bst_t tree, size_t k);
+
+/**
+ * \brief Returns the number of keys in the given binary search tree that are
+ *  inside the provided range of keys.
+ *
+ * \param tree The binary search tree.
+ * \param low_key The lower bound of the range of keys.
+ * \param high_key The upper bound of the range of keys.
+ * \return The number of keys `k` such that `low_key <= k <= high_key` (`0`
+ *  if \a low_key is greater than \a high_key).
+ *
+ * Unlike upo_bst_keys_range(), the keys are not enumerated.
+ *
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
+ */
+size_t upo_bst_count_range(const upo_bst_t tree, const void* low_key, const void* high_key);
+
+/**
+ * \brief Places the given cursor before the smallest key of the given binary
+ *  search tree.
+ *
+ * \param tree The binary search tree.
+ * \param cursor The cursor.
+ *
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
+ */
+void upo_bst_cursor_reset(const upo_bst_t tree, upo_bst_cursor_t* cursor);
+
+/**
+ * \brief Places the given cursor after the largest key of the given binary
+ *  search tree.
+ *
+ * \param tree The binary search tree.
+ * \param cursor The cursor.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_bst_cursor_reset_end(const upo_bst_t tree, upo_bst_cursor_t* cursor);
+
+/**
+ * \brief Places the given cursor right before the smallest key of the given
+ *  binary search tree which is greater than or equal to the given key.
+ *
+ * \param tree The binary search tree.
+ * \param cursor The cursor.
+ * \param key The key (which needs not be in the tree).
+ * \return `1` if such a key exists, or `0` if the cursor is placed after the
+ *  largest key.
+ *
+ * Moving forward then yields the keys greater than or equal to \a key, while
+ * moving backward yields the keys less than \a key.
+ *
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
+ */
+int upo_bst_cursor_seek(const upo_bst_t tree, upo_bst_cursor_t* cursor, const void* key);
+
+/**
+ * \brief Moves the given cursor past the next key.
+ *
+ * \param tree The binary search tree.
+ * \param cursor The cursor.
+ * \param key Where the key is stored (may be `NULL`).
+ * \param value Where the value is stored (may be `NULL`).
+ * \return `1` if a key was found, or `0` if the cursor is after the largest
+ *  key.
+ *
+ * The tree must not be modified while a cursor is used over it.
+ *
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`;
+ *  amortized constant time, `O(1)`, over a whole enumeration.
+ */
+int upo_bst_cursor_next(const upo_bst_t tree, upo_bst_cursor_t* cursor, void** key, void** value);
+
+/**
+ * \brief Moves the given cursor back past the previous key.
+ *
+ * \param tree The binary search tree.
+ * \param cursor The cursor.
+ * \param key Where the key is stored (may be `NULL`).
+ * \param value Where the value is stored (may be `NULL`).
+ * \return `1` if a key was found, or `0` if the cursor is before the
+ *  smallest key.
+ *
+ * Calling upo_bst_cursor_next() then upo_bst_cursor_prev() yields the same
+ * key twice.
+ * The tree must not be modified while a cursor is used over it.
+ *
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`;
+ *  amortized constant time, `O(1)`, over a whole enumeration.
+ */
+int upo_bst_cursor_prev(const upo_bst_t tree, upo_bst_cursor_t* cursor, void** key, void** value);
+
 #endif /* UPO_BST_H */
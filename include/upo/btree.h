@@ -0,0 +1,361 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/btree.h
+ *
+ * \brief The B-Tree ordered map abstract data type.
+ *
+ * A B-tree stores many keys per node, sorted in a contiguous array, so that a
+ * path from the root down to a leaf crosses few nodes: with a minimum degree
+ * of #UPO_BTREE_MIN_DEGREE, a tree of a million keys is four or five levels
+ * deep, against about twenty-five for a balanced binary search tree, and
+ * each level costs a few cache misses rather than one per key compared.
+ * Within a node, keys are looked for by binary search.
+ *
+ * All leaves are at the same depth, so every operation that walks down a
+ * single path takes \f$O(\log n)\f$ time, whatever the order of insertions.
+ * Internal nodes also record the number of keys under each child, so that
+ * keys can be found (or counted) by their position in the order of keys.
+ *
+ * The interface mirrors the one of binary search trees (see upo/bst.h),
+ * whose comparator, visitor and key list types it shares.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_BTREE_H
+#define UPO_BTREE_H
+
+
+#include <stddef.h>
+#include <upo/bst.h>
+
+
+/**
+ * \brief The minimum degree of B-trees.
+ *
+ * Every node but the root holds between `t-1` and `2t-1` keys, and every
+ * internal node has one child more than keys.
+ */
+#define UPO_BTREE_MIN_DEGREE 16U
+
+
+/** \brief Declares the B-Tree type. */
+typedef struct upo_btree_s* upo_btree_t;
+
+
+/**
+ * \brief Creates a new empty B-tree.
+ *
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty B-tree.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+upo_btree_t upo_btree_create(upo_bst_comparator_t key_cmp);
+
+/**
+ * \brief Destroys the given B-tree together with data stored on it.
+ *
+ * \param tree The B-tree to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for keys
+ *  and values stored in this B-tree must be freed (value `1`) or not (value
+ *  `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_btree_destroy(upo_btree_t tree, int destroy_data);
+
+/**
+ * \brief Removes all elements from the given B-tree.
+ *
+ * \param tree The B-tree to clear.
+ * \param destroy_data Tells whether the previously allocated memory for keys
+ *  and values stored in this B-tree must be freed (value `1`) or not (value
+ *  `0`).
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_btree_clear(upo_btree_t tree, int destroy_data);
+
+/**
+ * \brief Stores the given value identified by the provided key in the given
+ *  B-tree.
+ *
+ * \param tree The B-tree.
+ * \param key The key.
+ * \param value The value.
+ * \return The replaced value in case of a duplicate, otherwise `NULL`.
+ *
+ * If the key is already present in the tree, the associated value is replaced
+ * by the one provided as argument to this function (the stored key is kept).
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log n)`.
+ */
+void* upo_btree_put(upo_btree_t tree, void* key, void* value);
+
+/**
+ * \brief Stores the given value identified by the provided key in the given
+ *  B-tree but ignores duplicates.
+ *
+ * \param tree The B-tree.
+ * \param key The key.
+ * \param value The value.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log n)`.
+ */
+void upo_btree_insert(upo_btree_t tree, void* key, void* value);
+
+/**
+ * \brief Returns the comparison function stored in the B-tree.
+ *
+ * \param tree The B-tree.
+ * \return The comparison function.
+ */
+upo_bst_comparator_t upo_btree_get_comparator(const upo_btree_t tree);
+
+/**
+ * \brief Returns the value identified by the provided key in the given
+ *  B-tree.
+ *
+ * \param tree The B-tree.
+ * \param key The key.
+ * \return The value associated to \a key, or `NULL` if the key is not found.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log n)`.
+ */
+void* upo_btree_get(const upo_btree_t tree, const void* key);
+
+/**
+ * \brief Tells if the given B-tree contains the given key.
+ *
+ * \param tree The B-tree.
+ * \param key The key.
+ * \return `1` if the key is found, or `0` otherwise.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log n)`.
+ */
+int upo_btree_contains(const upo_btree_t tree, const void* key);
+
+/**
+ * \brief Removes the given key from the given B-tree.
+ *
+ * \param tree The B-tree.
+ * \param key The key.
+ * \param destroy_data Tells whether the previously allocated memory for the
+ *  key and its value must be freed (value `1`) or not (value `0`).
+ *
+ * Nodes are merged or refilled on the way down, so that the tree is walked
+ * once.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log n)`.
+ */
+void upo_btree_delete(upo_btree_t tree, const void* key, int destroy_data);
+
+/**
+ * \brief Returns the number of keys stored in the given B-tree.
+ *
+ * \param tree The B-tree.
+ * \return The number of keys.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_btree_size(const upo_btree_t tree);
+
+/**
+ * \brief Tells if the given B-tree is empty.
+ *
+ * \param tree The B-tree.
+ * \return `1` if the B-tree is empty or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_btree_is_empty(const upo_btree_t tree);
+
+/**
+ * \brief Returns the height of the given B-tree.
+ *
+ * \param tree The B-tree.
+ * \return The number of edges from the root down to the leaves (`0` for an
+ *  empty tree).
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_btree_height(const upo_btree_t tree);
+
+/**
+ * \brief Visits the keys of the given B-tree in order.
+ *
+ * \param tree The B-tree to traverse.
+ * \param visit The visit function.
+ * \param visit_arg An additional parameter to pass to the visit function.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_btree_traverse_in_order(const upo_btree_t tree, upo_bst_visitor_t visit, void* visit_arg);
+
+/**
+ * \brief Returns the smallest key in the given B-tree.
+ *
+ * \param tree The B-tree.
+ * \return The smallest key, or `NULL` if the tree is empty.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log n)`.
+ */
+void* upo_btree_min(const upo_btree_t tree);
+
+/**
+ * \brief Returns the largest key in the given B-tree.
+ *
+ * \param tree The B-tree.
+ * \return The largest key, or `NULL` if the tree is empty.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log n)`.
+ */
+void* upo_btree_max(const upo_btree_t tree);
+
+/**
+ * \brief Removes the smallest key from the given B-tree.
+ *
+ * \param tree The B-tree.
+ * \param destroy_data Tells whether the previously allocated memory for the
+ *  key and its value must be freed (value `1`) or not (value `0`).
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log n)`.
+ */
+void upo_btree_delete_min(upo_btree_t tree, int destroy_data);
+
+/**
+ * \brief Removes the largest key from the given B-tree.
+ *
+ * \param tree The B-tree.
+ * \param destroy_data Tells whether the previously allocated memory for the
+ *  key and its value must be freed (value `1`) or not (value `0`).
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log n)`.
+ */
+void upo_btree_delete_max(upo_btree_t tree, int destroy_data);
+
+/**
+ * \brief Returns the largest key less than or equal to the given key.
+ *
+ * \param tree The B-tree.
+ * \param key The key.
+ * \return The floor of \a key, or `NULL` if there is none.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log n)`.
+ */
+void* upo_btree_floor(const upo_btree_t tree, const void* key);
+
+/**
+ * \brief Returns the smallest key greater than or equal to the given key.
+ *
+ * \param tree The B-tree.
+ * \param key The key.
+ * \return The ceiling of \a key, or `NULL` if there is none.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log n)`.
+ */
+void* upo_btree_ceiling(const upo_btree_t tree, const void* key);
+
+/**
+ * \brief Returns the keys in the given B-tree that are inside the provided
+ *  range of keys.
+ *
+ * \param tree The B-tree.
+ * \param low_key The lower bound of the range of keys.
+ * \param high_key The upper bound of the range of keys.
+ * \return A singly-linked list of keys inside the provided range, from the
+ *  largest to the smallest (as upo_bst_keys_range() does), or `NULL` if no
+ *  key falls inside the range.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements and
+ *  linear in the number `k` of keys inside the range, `O(log n + k)`.
+ */
+upo_bst_key_list_t upo_btree_keys_range(const upo_btree_t tree, const void* low_key, const void* high_key);
+
+/**
+ * \brief Returns all the keys in the given B-tree.
+ *
+ * \param tree The B-tree.
+ * \return A singly-linked list of keys, from the largest to the smallest, or
+ *  `NULL` if the tree is empty.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+upo_bst_key_list_t upo_btree_keys(const upo_btree_t tree);
+
+/**
+ * \brief Returns the number of keys in the given B-tree that are less than
+ *  the given key.
+ *
+ * \param tree The B-tree.
+ * \param key The key (which needs not be in the tree).
+ * \return The rank of \a key.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log n)`.
+ */
+size_t upo_btree_rank(const upo_btree_t tree, const void* key);
+
+/**
+ * \brief Returns the key of the given rank in the given B-tree.
+ *
+ * \param tree The B-tree.
+ * \param k The rank, starting from `0` for the smallest key.
+ * \return The key with exactly \a k smaller keys, or `NULL` if \a k is not
+ *  less than the size of the tree.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log n)`.
+ */
+void* upo_btree_select(const upo_btree_t tree, size_t k);
+
+/**
+ * \brief Returns the number of keys in the given B-tree that are inside the
+ *  provided range of keys.
+ *
+ * \param tree The B-tree.
+ * \param low_key The lower bound of the range of keys.
+ * \param high_key The upper bound of the range of keys.
+ * \return The number of keys \f$k\f$ such that \f$low\_key \le k \le
+ *  high\_key\f$.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log n)`.
+ */
+size_t upo_btree_count_range(const upo_btree_t tree, const void* low_key, const void* high_key);
+
+
+#endif /* UPO_BTREE_H */
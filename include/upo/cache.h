@@ -0,0 +1,279 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/cache.h
+ *
+ * \brief Bounded key-value caches.
+ *
+ * A cache maps keys to values like a hash table, but the total size of its
+ * entries is bounded: when a new entry does not fit, other entries are
+ * evicted according to the replacement policy chosen at creation:
+ * - #UPO_CACHE_LRU evicts the least recently used entry;
+ * - #UPO_CACHE_CLOCK approximates LRU with a reference bit per entry, set by
+ *   lookups, so that hits do not move entries (entries are inspected in
+ *   insertion order and those with the bit set get a second chance);
+ * - #UPO_CACHE_S3FIFO admits new entries into a small FIFO queue (10% of the
+ *   capacity), promotes to the main FIFO queue only those accessed again
+ *   before leaving it, and remembers the keys recently evicted from the
+ *   small queue in a ghost queue, so that they go straight to the main one
+ *   when they come back; scans and one-hit wonders thus never flush the
+ *   frequently used entries.
+ * .
+ *
+ * The size of an entry is given when it is put, in any unit: use `1` for all
+ * entries to bound their number, or their size in bytes to bound memory.
+ *
+ * Each entry is a single node, drawn from a memory pool, which holds the key,
+ * the value, the link of its list of collisions and the links of its
+ * recency (or FIFO) queue: both the lookup and the update of the policy are
+ * constant time, and no memory is allocated per operation once the cache is
+ * full.
+ * Keys are hashed once per operation, with #UPO_HT_HASH_FULL_RANGE (see
+ * upo/hashtable.h).
+ *
+ * See:
+ * - J. Yang, Y. Zhang, Z. Qiu, Y. Yue and K. V. Rashmi, "FIFO queues are all
+ *   you need for cache eviction", SOSP 2023.
+ * .
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_CACHE_H
+#define UPO_CACHE_H
+
+
+#include <stddef.h>
+#include <upo/hashtable.h>
+
+
+/** \brief Least recently used replacement policy. */
+#define UPO_CACHE_LRU 0
+
+/** \brief CLOCK (second chance) replacement policy. */
+#define UPO_CACHE_CLOCK 1
+
+/** \brief S3-FIFO replacement policy. */
+#define UPO_CACHE_S3FIFO 2
+
+
+/** \brief Type for caches. */
+typedef struct upo_cache_s* upo_cache_t;
+
+/**
+ * \brief The type for functions notified of evicted entries.
+ *
+ * The first parameter is the key, the second one is the value and the third
+ * one is the argument given to upo_cache_set_evict_callback().
+ * The function may free the key and the value, but it must not access the
+ * cache.
+ */
+typedef void (*upo_cache_evict_callback_t)(void*, void*, void*);
+
+/** \brief The type for statistics about the accesses to a cache. */
+struct upo_cache_stats_s {
+    size_t hits; /**< The number of lookups that found their key. */
+    size_t misses; /**< The number of lookups that did not find their key. */
+    size_t evictions; /**< The number of entries evicted to make room for others. */
+};
+/** \brief Alias for the type for statistics about a cache. */
+typedef struct upo_cache_stats_s upo_cache_stats_t;
+
+
+/**
+ * \brief Creates a new empty cache.
+ *
+ * \param policy The replacement policy: #UPO_CACHE_LRU, #UPO_CACHE_CLOCK or
+ *  #UPO_CACHE_S3FIFO.
+ * \param capacity The maximum total size of the entries.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty cache.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+upo_cache_t upo_cache_create(int policy, size_t capacity, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Destroys the given cache.
+ *
+ * \param cache The cache to destroy.
+ * \param destroy_data Tells whether the keys and the values must be freed
+ *  (the eviction callback is not called).
+ *
+ * Worst-case complexity: linear in the number `n` of entries, `O(n)`.
+ */
+void upo_cache_destroy(upo_cache_t cache, int destroy_data);
+
+/**
+ * \brief Removes all the entries of the given cache.
+ *
+ * \param cache The cache to clear.
+ * \param destroy_data Tells whether the keys and the values must be freed
+ *  (the eviction callback is not called).
+ *
+ * The statistics are kept.
+ *
+ * Worst-case complexity: linear in the number `n` of entries, `O(n)`.
+ */
+void upo_cache_clear(upo_cache_t cache, int destroy_data);
+
+/**
+ * \brief Sets the function notified of the entries evicted from the given
+ *  cache.
+ *
+ * \param cache The cache.
+ * \param callback The function, or `NULL` to be notified of nothing.
+ * \param arg An additional parameter to pass to the function.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_cache_set_evict_callback(upo_cache_t cache, upo_cache_evict_callback_t callback, void* arg);
+
+/**
+ * \brief Stores the given key-value pair into the given cache.
+ *
+ * \param cache The cache.
+ * \param key The key.
+ * \param value The value.
+ * \param size The size of the entry, at most the capacity of the cache.
+ * \return The value previously associated to the key, which is replaced (the
+ *  key is kept), or `NULL` if the key was not cached.
+ *
+ * A replacement counts as an access to the entry.
+ * Then entries are evicted, and notified to the eviction callback, until the
+ * total size is within the capacity; except with LRU, the new entry itself
+ * may be among them, if the policy favours the entries already cached.
+ *
+ * Worst-case complexity: linear in the number `n` of entries, `O(n)`, when
+ *  many entries must be evicted or the index grows; amortized constant time,
+ *  `O(1)`, per entry.
+ */
+void* upo_cache_put(upo_cache_t cache, void* key, void* value, size_t size);
+
+/**
+ * \brief Looks up the given key in the given cache, as an access.
+ *
+ * \param cache The cache.
+ * \param key The key.
+ * \return The value associated to the key, or `NULL` if the key is not
+ *  cached.
+ *
+ * The access updates the replacement policy and counts as a hit or a miss.
+ *
+ * Worst-case complexity: linear in the number `n` of entries, `O(n)`, when
+ *  all keys collide; expected constant time, `O(1)`.
+ */
+void* upo_cache_get(upo_cache_t cache, const void* key);
+
+/**
+ * \brief Looks up the given key in the given cache, without accessing it.
+ *
+ * \param cache The cache.
+ * \param key The key.
+ * \return The value associated to the key, or `NULL` if the key is not
+ *  cached.
+ *
+ * Neither the replacement policy nor the statistics are affected.
+ *
+ * Worst-case complexity: linear in the number `n` of entries, `O(n)`, when
+ *  all keys collide; expected constant time, `O(1)`.
+ */
+void* upo_cache_peek(const upo_cache_t cache, const void* key);
+
+/**
+ * \brief Tells if the given cache contains the given key, without accessing
+ *  it.
+ *
+ * \param cache The cache.
+ * \param key The key.
+ * \return `1` if the key is cached, or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the number `n` of entries, `O(n)`, when
+ *  all keys collide; expected constant time, `O(1)`.
+ */
+int upo_cache_contains(const upo_cache_t cache, const void* key);
+
+/**
+ * \brief Removes the given key and its value from the given cache.
+ *
+ * \param cache The cache.
+ * \param key The key.
+ * \param destroy_data Tells whether the key and the value must be freed
+ *  (the eviction callback is not called).
+ * \return `1` if the key was cached, or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the number `n` of entries, `O(n)`, when
+ *  all keys collide; expected constant time, `O(1)`.
+ */
+int upo_cache_delete(upo_cache_t cache, const void* key, int destroy_data);
+
+/**
+ * \brief Returns the number of entries of the given cache.
+ *
+ * \param cache The cache.
+ * \return The number of cached keys.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_cache_size(const upo_cache_t cache);
+
+/**
+ * \brief Returns the total size of the entries of the given cache.
+ *
+ * \param cache The cache.
+ * \return The sum of the sizes given to upo_cache_put() for the cached keys.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_cache_used(const upo_cache_t cache);
+
+/**
+ * \brief Returns the capacity of the given cache.
+ *
+ * \param cache The cache.
+ * \return The maximum total size of the entries.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_cache_capacity(const upo_cache_t cache);
+
+/**
+ * \brief Returns statistics about the accesses to the given cache.
+ *
+ * \param cache The cache.
+ * \param stats Where the statistics are stored (all zero if \a cache is
+ *  `NULL`).
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_cache_stats(const upo_cache_t cache, upo_cache_stats_t* stats);
+
+/**
+ * \brief Resets the statistics about the accesses to the given cache.
+ *
+ * \param cache The cache.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_cache_reset_stats(upo_cache_t cache);
+
+
+#endif /* UPO_CACHE_H */
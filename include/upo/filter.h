@@ -0,0 +1,246 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/filter.h
+ *
+ * \brief Approximate membership filters.
+ *
+ * A filter represents a set in a few bits per element and answers membership
+ * queries with no false negatives, but with a small probability of false
+ * positives: if it tells that an element is absent, the element is surely
+ * absent.
+ * Thus a filter placed in front of a larger (or slower) data structure lets
+ * most lookups of absent elements return without searching it.
+ *
+ * Filters store hash values rather than elements, so they work with any type
+ * of element: each function takes the hash value of an element, which should
+ * be computed over the whole word (e.g., by a hash function of
+ * upo/hashtable.h called with #UPO_HT_HASH_FULL_RANGE); hash values are mixed
+ * again internally, so weak hash functions do no harm beyond their own
+ * collisions.
+ *
+ * Two filters are provided:
+ * - \c upo_bloom_filter_t, a blocked Bloom filter, whose bits for an element
+ *   all lie in the same cache line, so that an operation touches one cache
+ *   line; elements cannot be removed;
+ * - \c upo_cuckoo_filter_t, a cuckoo filter, which stores a 16-bit fingerprint
+ *   of each element in one of two buckets of four fingerprints each, and
+ *   supports removals.
+ * .
+ *
+ * See:
+ * - F. Putze, P. Sanders and J. Singler, "Cache-, Hash- and Space-Efficient
+ *   Bloom Filters", WEA 2007.
+ * - B. Fan, D.G. Andersen, M. Kaminsky and M.D. Mitzenmacher, "Cuckoo Filter:
+ *   Practically Better Than Bloom", CoNEXT 2014.
+ * .
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_FILTER_H
+#define UPO_FILTER_H
+
+
+#include <stddef.h>
+
+
+/** \brief Default number of bits per element of Bloom filters (about 1% of false positives). */
+#define UPO_BLOOM_FILTER_DEFAULT_BITS_PER_ELEMENT 10U
+
+
+/*** BEGIN of BLOCKED BLOOM FILTER ***/
+
+
+/** \brief Type for blocked Bloom filters. */
+typedef struct upo_bloom_filter_s* upo_bloom_filter_t;
+
+
+/**
+ * \brief Creates a new empty Bloom filter.
+ *
+ * \param n The expected number of elements.
+ * \param bits_per_element The number of bits per element (e.g.,
+ *  #UPO_BLOOM_FILTER_DEFAULT_BITS_PER_ELEMENT); the more bits, the fewer false
+ *  positives.
+ * \return An empty Bloom filter.
+ *
+ * More than \a n elements may be added, at the cost of more false positives.
+ *
+ * Worst-case complexity: linear in the number of bits, `O(n)`.
+ */
+upo_bloom_filter_t upo_bloom_filter_create(size_t n, size_t bits_per_element);
+
+/**
+ * \brief Destroys the given Bloom filter.
+ *
+ * \param filter The Bloom filter to destroy.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_bloom_filter_destroy(upo_bloom_filter_t filter);
+
+/**
+ * \brief Removes all elements from the given Bloom filter.
+ *
+ * \param filter The Bloom filter to clear.
+ *
+ * Worst-case complexity: linear in the number of bits, `O(n)`.
+ */
+void upo_bloom_filter_clear(upo_bloom_filter_t filter);
+
+/**
+ * \brief Adds an element to the given Bloom filter.
+ *
+ * \param filter The Bloom filter.
+ * \param hash The hash value of the element.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_bloom_filter_add(upo_bloom_filter_t filter, size_t hash);
+
+/**
+ * \brief Tells if the given Bloom filter may contain an element.
+ *
+ * \param filter The Bloom filter.
+ * \param hash The hash value of the element.
+ * \return `0` if the element has surely not been added, or `1` if it may have
+ *  been added.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_bloom_filter_may_contain(const upo_bloom_filter_t filter, size_t hash);
+
+/**
+ * \brief Returns the memory used by the given Bloom filter.
+ *
+ * \param filter The Bloom filter.
+ * \return The number of bytes allocated for the filter.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_bloom_filter_memory_usage(const upo_bloom_filter_t filter);
+
+
+/*** END of BLOCKED BLOOM FILTER ***/
+
+
+/*** BEGIN of CUCKOO FILTER ***/
+
+
+/** \brief Type for cuckoo filters. */
+typedef struct upo_cuckoo_filter_s* upo_cuckoo_filter_t;
+
+
+/**
+ * \brief Creates a new empty cuckoo filter.
+ *
+ * \param n The number of elements the filter must be able to hold.
+ * \return An empty cuckoo filter.
+ *
+ * Worst-case complexity: linear in the number of elements, `O(n)`.
+ */
+upo_cuckoo_filter_t upo_cuckoo_filter_create(size_t n);
+
+/**
+ * \brief Destroys the given cuckoo filter.
+ *
+ * \param filter The cuckoo filter to destroy.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_cuckoo_filter_destroy(upo_cuckoo_filter_t filter);
+
+/**
+ * \brief Removes all elements from the given cuckoo filter.
+ *
+ * \param filter The cuckoo filter to clear.
+ *
+ * Worst-case complexity: linear in the capacity of the filter, `O(n)`.
+ */
+void upo_cuckoo_filter_clear(upo_cuckoo_filter_t filter);
+
+/**
+ * \brief Adds an element to the given cuckoo filter.
+ *
+ * \param filter The cuckoo filter.
+ * \param hash The hash value of the element.
+ * \return `1` if the element has been added, or `0` if the filter is full (the
+ *  filter is not modified).
+ *
+ * An element may be added more than once (and then must be removed as many
+ * times), up to eight times.
+ *
+ * Worst-case complexity: constant, `O(1)` (a bounded number of fingerprints
+ *  is moved to make room).
+ */
+int upo_cuckoo_filter_add(upo_cuckoo_filter_t filter, size_t hash);
+
+/**
+ * \brief Removes an element from the given cuckoo filter.
+ *
+ * \param filter The cuckoo filter.
+ * \param hash The hash value of the element, which must have been added.
+ * \return `1` if a fingerprint of the element has been removed, or `0`
+ *  otherwise.
+ *
+ * Removing an element that has not been added may remove another element
+ * with the same fingerprint, which would then be falsely reported as absent.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_cuckoo_filter_remove(upo_cuckoo_filter_t filter, size_t hash);
+
+/**
+ * \brief Tells if the given cuckoo filter may contain an element.
+ *
+ * \param filter The cuckoo filter.
+ * \param hash The hash value of the element.
+ * \return `0` if the element is surely absent, or `1` if it may be present.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_cuckoo_filter_may_contain(const upo_cuckoo_filter_t filter, size_t hash);
+
+/**
+ * \brief Returns the number of elements in the given cuckoo filter.
+ *
+ * \param filter The cuckoo filter.
+ * \return The number of elements.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_cuckoo_filter_size(const upo_cuckoo_filter_t filter);
+
+/**
+ * \brief Returns the memory used by the given cuckoo filter.
+ *
+ * \param filter The cuckoo filter.
+ * \return The number of bytes allocated for the filter.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_cuckoo_filter_memory_usage(const upo_cuckoo_filter_t filter);
+
+
+/*** END of CUCKOO FILTER ***/
+
+
+#endif /* UPO_FILTER_H */
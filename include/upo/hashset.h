@@ -0,0 +1,569 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/hashset.h
+ *
+ * \brief Hash sets and hash multimaps.
+ *
+ * These containers are specializations of the hash table with linear
+ * probing (see upo/hashtable.h) for two common uses:
+ * - \c upo_hset_t stores keys only, so sets need no dummy value per key;
+ * - \c upo_hmultimap_t associates each key to a vector of values, rather
+ *   than replacing the value of a key put twice.
+ * .
+ *
+ * Both share the same probing core: an array of slots, with a power-of-two
+ * capacity and a load factor of at most 1/2, holds indexes into a dense array
+ * of entries.
+ * Each entry records its key and the (mixed) hash value of the key, so that
+ * probes compare hash values before calling the key comparison function,
+ * resizes never call the key hash function, and deletions move the following
+ * slots of the cluster back rather than leaving tombstones.
+ * Keys are hashed once per operation, with #UPO_HT_HASH_FULL_RANGE, by a
+ * plain or a seeded hash function, as for the hash tables of upo/hashtable.h.
+ *
+ * The core is also the one of \c upo_ht_linprob_t, whose entries add a value
+ * to the key and its hash value: each container only chooses what its entries
+ * hold.
+ *
+ * An entry of a set takes two words, against the three of an entry of
+ * \c upo_ht_linprob_t; an entry of a multimap takes five words plus its
+ * vector of values, which is contiguous and can be read as a C array.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHSET_H
+#define UPO_HASHSET_H
+
+
+#include <stddef.h>
+#include <upo/hashtable.h>
+
+
+/*** BEGIN of HASH SET ***/
+
+
+/** \brief Default capacity of hash sets. */
+#define UPO_HSET_DEFAULT_CAPACITY 16U
+
+
+/** \brief Declares the Hash Set type. */
+typedef struct upo_hset_s* upo_hset_t;
+
+
+/**
+ * \brief Creates a new empty hash set.
+ *
+ * \param m The initial capacity of the hash set, rounded up to a power of
+ *  two.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash set.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash set, `O(m)`.
+ */
+upo_hset_t upo_hset_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Creates a new empty hash set whose keys are hashed with a random
+ *  seed.
+ *
+ * \param m The initial capacity of the hash set, rounded up to a power of
+ *  two.
+ * \param key_hash A pointer to the seeded function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash set.
+ *
+ * The seed is drawn by means of upo_ht_random_seed() and never changes (see
+ * upo_ht_linprob_create_seeded()).
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash set, `O(m)`.
+ */
+upo_hset_t upo_hset_create_seeded(size_t m, upo_ht_seeded_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Returns the seed of the given hash set.
+ *
+ * \param set The hash set.
+ * \return The seed passed to the seeded hash function, or `0` if the hash
+ *  set was not created by upo_hset_create_seeded().
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_hset_seed(const upo_hset_t set);
+
+/**
+ * \brief Destroys the given hash set.
+ *
+ * \param set The hash set to destroy.
+ * \param destroy_data Tells whether the keys must be freed.
+ *
+ * Worst-case complexity: linear in the number `n` of keys, `O(n)`.
+ */
+void upo_hset_destroy(upo_hset_t set, int destroy_data);
+
+/**
+ * \brief Removes all keys from the given hash set.
+ *
+ * \param set The hash set to clear.
+ * \param destroy_data Tells whether the keys must be freed.
+ *
+ * Worst-case complexity: linear in the number `n` of keys and in the
+ *  capacity `m` of the hash set, `O(n+m)`.
+ */
+void upo_hset_clear(upo_hset_t set, int destroy_data);
+
+/**
+ * \brief Adds the given key to the given hash set.
+ *
+ * \param set The hash set.
+ * \param key The key.
+ * \return `1` if the key is added, or `0` if an equal key was already
+ *  present (the stored key is kept, and \a key still belongs to the caller).
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash set, `O(m)`.
+ */
+int upo_hset_insert(upo_hset_t set, void* key);
+
+/**
+ * \brief Returns the stored key equal to the given key.
+ *
+ * \param set The hash set.
+ * \param key The key.
+ * \return The stored key, or `NULL` if no equal key is present.
+ *
+ * Useful to share a single copy of equal keys (e.g., to intern strings).
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash set, `O(m)`.
+ */
+void* upo_hset_get(const upo_hset_t set, const void* key);
+
+/**
+ * \brief Looks up a batch of keys in the given hash set.
+ *
+ * \param set The hash set.
+ * \param keys The array of keys to look up.
+ * \param n The number of keys in \a keys.
+ * \param keys_out The array of (at least) \a n elements where the stored key
+ *  equal to each key (or `NULL` if none is present) is stored.
+ * \return The number of keys found.
+ *
+ * The outcome is the same as calling upo_hset_get() for each key, but the
+ * cache misses of groups of keys overlap (see upo_ht_linprob_get_batch()).
+ *
+ * Worst-case complexity: linear in the number `n` of keys and in the
+ *  capacity `m` of the hash set, `O(n*m)`.
+ */
+size_t upo_hset_get_batch(const upo_hset_t set, void* const* keys, size_t n, void** keys_out);
+
+/**
+ * \brief Tells if the given hash set contains the given key.
+ *
+ * \param set The hash set.
+ * \param key The key.
+ * \return `1` if the key is present, or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash set, `O(m)`.
+ */
+int upo_hset_contains(const upo_hset_t set, const void* key);
+
+/**
+ * \brief Removes the given key from the given hash set.
+ *
+ * \param set The hash set.
+ * \param key The key.
+ * \param destroy_data Tells whether the stored key must be freed.
+ * \return `1` if the key was present, or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash set, `O(m)`.
+ */
+int upo_hset_delete(upo_hset_t set, const void* key, int destroy_data);
+
+/**
+ * \brief Returns the number of keys of the given hash set.
+ *
+ * \param set The hash set.
+ * \return The number of keys.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_hset_size(const upo_hset_t set);
+
+/**
+ * \brief Tells if the given hash set is empty.
+ *
+ * \param set The hash set.
+ * \return `1` if the hash set is empty, or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_hset_is_empty(const upo_hset_t set);
+
+/**
+ * \brief Returns the capacity of the given hash set.
+ *
+ * \param set The hash set.
+ * \return The number of slots.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_hset_capacity(const upo_hset_t set);
+
+/**
+ * \brief Returns the load factor of the given hash set.
+ *
+ * \param set The hash set.
+ * \return The ratio between the size and the capacity of the hash set.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+double upo_hset_load_factor(const upo_hset_t set);
+
+/**
+ * \brief Performs a traversal of the given hash set.
+ *
+ * \param set The hash set to traverse.
+ * \param visit The visit function, which is passed each key and `NULL` as
+ *  its value.
+ * \param visit_arg An additional parameter to pass to the visit function.
+ *
+ * The hash set must not be modified during the traversal.
+ *
+ * Worst-case complexity: linear in the number `n` of keys, `O(n)`.
+ */
+void upo_hset_traverse(const upo_hset_t set, upo_ht_visitor_t visit, void* visit_arg);
+
+/**
+ * \brief Moves the given cursor to the next key.
+ *
+ * \param set The hash set.
+ * \param cursor The cursor.
+ * \param key Where the key is stored (may be `NULL`).
+ * \return `1` if a key was found, or `0` if the enumeration is over.
+ *
+ * The hash set must not be modified while it is being enumerated.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_hset_cursor_next(const upo_hset_t set, upo_ht_cursor_t* cursor, void** key);
+
+/**
+ * \brief Collects statistics about the internals of the given hash set.
+ *
+ * \param set The hash set.
+ * \param stats Where the statistics are stored.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash set, `O(m)`.
+ */
+void upo_hset_stats(const upo_hset_t set, upo_ht_stats_t* stats);
+
+
+/*** END of HASH SET ***/
+
+
+/*** BEGIN of HASH MULTIMAP ***/
+
+
+/** \brief Default capacity of hash multimaps. */
+#define UPO_HMULTIMAP_DEFAULT_CAPACITY 16U
+
+
+/** \brief Declares the Hash Multimap type. */
+typedef struct upo_hmultimap_s* upo_hmultimap_t;
+
+
+/**
+ * \brief Creates a new empty hash multimap.
+ *
+ * \param m The initial capacity of the hash multimap, rounded up to a power
+ *  of two.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash multimap.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash multimap,
+ *  `O(m)`.
+ */
+upo_hmultimap_t upo_hmultimap_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Creates a new empty hash multimap whose keys are hashed with a
+ *  random seed.
+ *
+ * \param m The initial capacity of the hash multimap, rounded up to a power
+ *  of two.
+ * \param key_hash A pointer to the seeded function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash multimap.
+ *
+ * The seed is drawn by means of upo_ht_random_seed() and never changes (see
+ * upo_ht_linprob_create_seeded()).
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash multimap,
+ *  `O(m)`.
+ */
+upo_hmultimap_t upo_hmultimap_create_seeded(size_t m, upo_ht_seeded_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Returns the seed of the given hash multimap.
+ *
+ * \param mm The hash multimap.
+ * \return The seed passed to the seeded hash function, or `0` if the hash
+ *  multimap was not created by upo_hmultimap_create_seeded().
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_hmultimap_seed(const upo_hmultimap_t mm);
+
+/**
+ * \brief Destroys the given hash multimap.
+ *
+ * \param mm The hash multimap to destroy.
+ * \param destroy_data Tells whether the keys and the values must be freed.
+ *
+ * Worst-case complexity: linear in the number `n` of values, `O(n)`.
+ */
+void upo_hmultimap_destroy(upo_hmultimap_t mm, int destroy_data);
+
+/**
+ * \brief Removes all keys and values from the given hash multimap.
+ *
+ * \param mm The hash multimap to clear.
+ * \param destroy_data Tells whether the keys and the values must be freed.
+ *
+ * Worst-case complexity: linear in the number `n` of values and in the
+ *  capacity `m` of the hash multimap, `O(n+m)`.
+ */
+void upo_hmultimap_clear(upo_hmultimap_t mm, int destroy_data);
+
+/**
+ * \brief Appends the given value to the values of the given key.
+ *
+ * \param mm The hash multimap.
+ * \param key The key.
+ * \param value The value.
+ * \return `1` if an equal key was already present (the stored key is kept,
+ *  and \a key still belongs to the caller), or `0` if the key is added.
+ *
+ * Values are kept in insertion order; the same value may be put twice.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash multimap and
+ *  in the number `k` of values of the key, `O(m+k)`; amortized constant time
+ *  per value.
+ */
+int upo_hmultimap_put(upo_hmultimap_t mm, void* key, void* value);
+
+/**
+ * \brief Returns the values of the given key.
+ *
+ * \param mm The hash multimap.
+ * \param key The key.
+ * \param count Where the number of values is stored (may be `NULL`; `0` is
+ *  stored if the key is not present).
+ * \return The contiguous array of the values, or `NULL` if the key is not
+ *  present.
+ *
+ * The array is owned by the hash multimap and is valid until the next
+ * modification.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash multimap,
+ *  `O(m)`.
+ */
+void* const* upo_hmultimap_get(const upo_hmultimap_t mm, const void* key, size_t* count);
+
+/**
+ * \brief Looks up the values of a batch of keys in the given hash multimap.
+ *
+ * \param mm The hash multimap.
+ * \param keys The array of keys to look up.
+ * \param n The number of keys in \a keys.
+ * \param values_out The array of (at least) \a n elements where the array of
+ *  the values of each key (or `NULL` if the key is not present) is stored.
+ * \param counts_out The array of (at least) \a n elements where the number
+ *  of values of each key is stored (may be `NULL`).
+ * \return The number of keys found.
+ *
+ * The outcome is the same as calling upo_hmultimap_get() for each key, but
+ * the cache misses of groups of keys overlap (see
+ * upo_ht_linprob_get_batch()).
+ *
+ * Worst-case complexity: linear in the number `n` of keys and in the
+ *  capacity `m` of the hash multimap, `O(n*m)`.
+ */
+size_t upo_hmultimap_get_batch(const upo_hmultimap_t mm, void* const* keys, size_t n, void* const** values_out, size_t* counts_out);
+
+/**
+ * \brief Returns the number of values of the given key.
+ *
+ * \param mm The hash multimap.
+ * \param key The key.
+ * \return The number of values, or `0` if the key is not present.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash multimap,
+ *  `O(m)`.
+ */
+size_t upo_hmultimap_count(const upo_hmultimap_t mm, const void* key);
+
+/**
+ * \brief Tells if the given hash multimap contains the given key.
+ *
+ * \param mm The hash multimap.
+ * \param key The key.
+ * \return `1` if the key is present, or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash multimap,
+ *  `O(m)`.
+ */
+int upo_hmultimap_contains(const upo_hmultimap_t mm, const void* key);
+
+/**
+ * \brief Removes the given key and all its values.
+ *
+ * \param mm The hash multimap.
+ * \param key The key.
+ * \param destroy_data Tells whether the stored key and the values must be
+ *  freed.
+ * \return `1` if the key was present, or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash multimap and
+ *  in the number `k` of values of the key, `O(m+k)`.
+ */
+int upo_hmultimap_delete(upo_hmultimap_t mm, const void* key, int destroy_data);
+
+/**
+ * \brief Removes the first occurrence of the given value among the values of
+ *  the given key.
+ *
+ * \param mm The hash multimap.
+ * \param key The key.
+ * \param value The value, compared by address.
+ * \param destroy_data Tells whether the value must be freed, along with the
+ *  stored key if it is left without values.
+ * \return `1` if the value was found, or `0` otherwise.
+ *
+ * The order of the other values is preserved.
+ * A key left without values is removed.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash multimap and
+ *  in the number `k` of values of the key, `O(m+k)`.
+ */
+int upo_hmultimap_delete_value(upo_hmultimap_t mm, const void* key, const void* value, int destroy_data);
+
+/**
+ * \brief Returns the number of keys of the given hash multimap.
+ *
+ * \param mm The hash multimap.
+ * \return The number of distinct keys.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_hmultimap_size(const upo_hmultimap_t mm);
+
+/**
+ * \brief Returns the number of values of the given hash multimap.
+ *
+ * \param mm The hash multimap.
+ * \return The number of values, over all keys.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_hmultimap_num_values(const upo_hmultimap_t mm);
+
+/**
+ * \brief Tells if the given hash multimap is empty.
+ *
+ * \param mm The hash multimap.
+ * \return `1` if the hash multimap is empty, or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_hmultimap_is_empty(const upo_hmultimap_t mm);
+
+/**
+ * \brief Returns the capacity of the given hash multimap.
+ *
+ * \param mm The hash multimap.
+ * \return The number of slots.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_hmultimap_capacity(const upo_hmultimap_t mm);
+
+/**
+ * \brief Returns the load factor of the given hash multimap.
+ *
+ * \param mm The hash multimap.
+ * \return The ratio between the number of keys and the capacity of the hash
+ *  multimap.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+double upo_hmultimap_load_factor(const upo_hmultimap_t mm);
+
+/**
+ * \brief Performs a traversal of the given hash multimap.
+ *
+ * \param mm The hash multimap to traverse.
+ * \param visit The visit function, which is passed each key-value pair (a
+ *  key with `k` values is visited `k` times).
+ * \param visit_arg An additional parameter to pass to the visit function.
+ *
+ * The hash multimap must not be modified during the traversal.
+ *
+ * Worst-case complexity: linear in the number `n` of values, `O(n)`.
+ */
+void upo_hmultimap_traverse(const upo_hmultimap_t mm, upo_ht_visitor_t visit, void* visit_arg);
+
+/**
+ * \brief Moves the given cursor to the next key, along with its values.
+ *
+ * \param mm The hash multimap.
+ * \param cursor The cursor.
+ * \param key Where the key is stored (may be `NULL`).
+ * \param values Where the contiguous array of the values is stored (may be
+ *  `NULL`).
+ * \param count Where the number of values is stored (may be `NULL`).
+ * \return `1` if a key was found, or `0` if the enumeration is over.
+ *
+ * The hash multimap must not be modified while it is being enumerated.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_hmultimap_cursor_next(const upo_hmultimap_t mm, upo_ht_cursor_t* cursor, void** key, void* const** values, size_t* count);
+
+/**
+ * \brief Collects statistics about the internals of the given hash multimap.
+ *
+ * \param mm The hash multimap.
+ * \param stats Where the statistics are stored.
+ *
+ * The vectors of values count as entry bytes.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash multimap,
+ *  `O(m)`.
+ */
+void upo_hmultimap_stats(const upo_hmultimap_t mm, upo_ht_stats_t* stats);
+
+
+/*** END of HASH MULTIMAP ***/
+
+
+#endif /* UPO_HASHSET_H */
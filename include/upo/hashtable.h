@@ -50,6 +50,20 @@
  */
 typedef size_t (*upo_ht_hasher_t)(const void*, size_t);
 
+/** \brief The type for seeded hash functions.
+ *
+ * Declares the type for key hash functions that also depend on a secret
+ * seed, chosen at random for each hash table, so that the keys colliding
+ * in a table cannot be predicted from the source code of the hash function.
+ * A seeded hash function takes three parameters:
+ * - The first parameter is a pointer to the key to hash.
+ * - The second parameter is the seed.
+ * - The third parameter is the capacity of the hash table.
+ * A seeded hash function returns a nonnegative number which represents a
+ * position (index) in the hash table.
+ */
+typedef size_t (*upo_ht_seeded_hasher_t)(const void*, size_t, size_t);
+
 /**
  * \brief The type for key comparison functions.
  *
@@ -93,6 +107,57 @@ typedef struct upo_ht_key_list_node_s upo_ht_key_list_node_t;
 /** \brief The type for list of keys. */
 typedef upo_ht_key_list_node_t* upo_ht_key_list_t;
 
+/**
+ * \brief The type for cursors over the key-value pairs of a hash table.
+ *
+ * A cursor records a position in a hash table, so that pairs can be
+ * enumerated one at a time without allocating memory.
+ * Its fields are private: a cursor must be initialized by means of
+ * upo_ht_cursor_reset() and then only passed to the `cursor_next` function of
+ * a single hash table.
+ */
+struct upo_ht_cursor_s {
+    size_t index; /**< The current slot or entry. */
+    void* node; /**< The next node of the current list of collisions, if any. */
+};
+/** \brief Alias for the type for cursors. */
+typedef struct upo_ht_cursor_s upo_ht_cursor_t;
+
+/**
+ * \brief Positions the given cursor before the first key-value pair.
+ *
+ * \param cursor The cursor.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_ht_cursor_reset(upo_ht_cursor_t* cursor);
+
+
+/** \brief Number of entries of the histograms of hash table statistics. */
+#define UPO_HT_STATS_HISTOGRAM_SIZE 16U
+
+/**
+ * \brief The type for statistics about the internals of a hash table.
+ *
+ * The probe length of a key is the number of keys (or slots) a successful
+ * search for it inspects, the key itself included.
+ */
+struct upo_ht_stats_s {
+    size_t size; /**< The number of stored keys. */
+    size_t capacity; /**< The number of slots. */
+    size_t slot_bytes; /**< The bytes taken by the array of slots. */
+    size_t entry_bytes; /**< The bytes taken by the nodes of the lists of collisions, or by the entries. */
+    size_t overhead_bytes; /**< The bytes taken by the table structure itself (and its filter, if any). */
+    size_t total_bytes; /**< The sum of all the above bytes (keys and values excluded). */
+    size_t tombstones; /**< The number of slots marked as deleted (always `0`, since no table of this module leaves tombstones). */
+    size_t histogram[UPO_HT_STATS_HISTOGRAM_SIZE]; /**< With separate chaining, the number of slots whose list holds `i` keys; with open addressing, the number of keys whose probe length is `i+1`; the last entry also counts longer lists or probes. */
+    size_t max_probe; /**< The maximum probe length. */
+    double avg_probe; /**< The average probe length (`0` if the table is empty). */
+    size_t resizes; /**< The number of times the table has been resized (or rehashed in place) since its creation. */
+    double resize_time; /**< The total time (in seconds) spent resizing (or rehashing in place). */
+};
+/** \brief Alias for the type for statistics about a hash table. */
+typedef struct upo_ht_stats_s upo_ht_stats_t;
 
 /*** END of COMMON TYPES ***/
 
@@ -103,6 +168,21 @@ typedef upo_ht_key_list_node_t* upo_ht_key_list_t;
 /** \brief Default capacity of hash tables with separate chaining. */
 #define UPO_HT_SEPCHAIN_DEFAULT_CAPACITY 997U
 
+/** \brief Default load factor above which a hash table with separate chaining grows. */
+#define UPO_HT_SEPCHAIN_DEFAULT_MAX_LOAD_FACTOR 1.0
+
+/** \brief Default load factor below which a hash table with separate chaining shrinks. */
+#define UPO_HT_SEPCHAIN_DEFAULT_MIN_LOAD_FACTOR 0.125
+
+/** \brief No filter is consulted before the lists of collisions. */
+#define UPO_HT_FILTER_NONE 0
+
+/** \brief A blocked Bloom filter is consulted before the lists of collisions. */
+#define UPO_HT_FILTER_BLOOM 1
+
+/** \brief A cuckoo filter is consulted before the lists of collisions. */
+#define UPO_HT_FILTER_CUCKOO 2
+
 
 /** \brief Type for hash tables with separate chaining. */
 typedef struct upo_ht_sepchain_s* upo_ht_sepchain_t;
@@ -116,10 +196,71 @@ typedef struct upo_ht_sepchain_s* upo_ht_sepchain_t;
  * \param key_cmp A pointer to the function used to compare keys.
  * \return An empty hash table.
  *
+ * The hash table is created with the default load factors
+ * #UPO_HT_SEPCHAIN_DEFAULT_MIN_LOAD_FACTOR and
+ * #UPO_HT_SEPCHAIN_DEFAULT_MAX_LOAD_FACTOR; its capacity never drops below
+ * \a m.
+ *
  * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
  */
 upo_ht_sepchain_t upo_ht_sepchain_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
 
+/**
+ * \brief Creates a new empty hash table whose keys are hashed with a random
+ *  seed.
+ *
+ * \param m The initial capacity of the hash table.
+ * \param key_hash A pointer to the seeded function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash table.
+ *
+ * The seed is drawn by means of upo_ht_random_seed() and never changes.
+ * As long as it stays secret, keys crafted to collide in one table are
+ * spread in any other; with a keyed hash function such as
+ * upo_ht_hash_str_sip(), no input can make the lists of collisions grow
+ * longer than logarithmic, with high probability.
+ * Apart from the hash function, the hash table is the same as the one
+ * returned by upo_ht_sepchain_create().
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+upo_ht_sepchain_t upo_ht_sepchain_create_seeded(size_t m, upo_ht_seeded_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Returns the seed of the given hash table.
+ *
+ * \param ht The hash table.
+ * \return The seed passed to the seeded hash function, or `0` if the hash
+ *  table was not created by upo_ht_sepchain_create_seeded().
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_sepchain_seed(const upo_ht_sepchain_t ht);
+
+/**
+ * \brief Creates a new hash table holding the given key-value pairs.
+ *
+ * \param keys The array of keys.
+ * \param values The array of values (\a values[i] is associated to \a keys[i]).
+ * \param n The number of key-value pairs.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return A hash table with the same content as one obtained by putting the
+ *  given pairs, in order, into an empty hash table.
+ *
+ * The capacity is chosen once, as by upo_ht_sepchain_reserve(), starting from
+ * #UPO_HT_SEPCHAIN_DEFAULT_CAPACITY, which is also the capacity the table may
+ * shrink back to.
+ * Then all keys are hashed in a single pass, and the pairs are placed in order
+ * of (ranges of) hash values, so that the slots being filled stay in cache;
+ * no resize takes place.
+ * If a key appears more than once, its last value is kept.
+ *
+ * Worst-case complexity: quadratic in the number `n` of elements, `O(n^2)`,
+ *  when all keys collide; expected linear time, `O(n)`.
+ */
+upo_ht_sepchain_t upo_ht_sepchain_build_from_arrays(void* const* keys, void* const* values, size_t n, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
 /**
  * \brief Destroys the given hash table.
  *
@@ -161,6 +302,8 @@ void upo_ht_sepchain_clear(upo_ht_sepchain_t ht, int destroy_data);
  * replaced by the one provided as argument to this function.
  * The old value is returned so that its memory can be deallocated
  * (if necessary).
+ * If the insertion makes the load factor exceed the maximum one, the capacity
+ * of the hash table is doubled.
  *
  * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
  */
@@ -175,6 +318,8 @@ void* upo_ht_sepchain_put(upo_ht_sepchain_t ht, void* key, void* value);
  * \param value The value.
  *
  * If the key is already present in the hash table, no insertion takes place.
+ * If the insertion makes the load factor exceed the maximum one, the capacity
+ * of the hash table is doubled.
  *
  * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
  */
@@ -192,6 +337,26 @@ void upo_ht_sepchain_insert(upo_ht_sepchain_t ht, void* key, void* value);
  */
 void* upo_ht_sepchain_get(const upo_ht_sepchain_t ht, const void* key);
 
+/**
+ * \brief Looks up a batch of keys in the given hash table.
+ *
+ * \param ht The hash table.
+ * \param keys The array of keys to look up.
+ * \param n The number of keys in \a keys.
+ * \param values_out The array of (at least) \a n elements where the value
+ *  associated to each key (or `NULL` if the key is not found) is stored.
+ * \return The number of keys found.
+ *
+ * The outcome is the same as calling upo_ht_sepchain_get() for each key.
+ * The lookups are split into groups: all the keys of a group are hashed
+ * first and their slots and chain heads are prefetched, so that the cache misses
+ * of the group overlap instead of being paid one after the other.
+ *
+ * Worst-case complexity: linear in the number `n` of keys and in the number
+ *  `s` of elements, `O(n*s)`.
+ */
+size_t upo_ht_sepchain_get_batch(const upo_ht_sepchain_t ht, void* const* keys, size_t n, void** values_out);
+
 /**
  * \brief Tells if the given hash table contains an item identified by
  *  the given key.
@@ -216,6 +381,9 @@ int upo_ht_sepchain_contains(const upo_ht_sepchain_t ht, const void* key);
  *
  * Memory deallocation (if requested) is performed by means of the `free()`
  * standard C function.
+ * If the removal makes the load factor fall below the minimum one, the
+ * capacity of the hash table is halved, without going below the capacity
+ * given at creation time.
  *
  * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
  */
@@ -264,6 +432,17 @@ size_t upo_ht_sepchain_size(const upo_ht_sepchain_t ht);
  */
 double upo_ht_sepchain_load_factor(const upo_ht_sepchain_t ht);
 
+/**
+ * \brief Collects statistics about the internals of the given hash table.
+ *
+ * \param ht The hash table.
+ * \param stats Where the statistics are stored (all zero if \a ht is `NULL`).
+ *
+ * Worst-case complexity: linear in the number `n` of elements and in the
+ *  capacity `m` of the hash table, `O(n+m)`.
+ */
+void upo_ht_sepchain_stats(const upo_ht_sepchain_t ht, upo_ht_stats_t* stats);
+
 /**
  * \brief Returns the keys in the given hash table.
  *
@@ -285,6 +464,93 @@ upo_ht_key_list_t upo_ht_sepchain_keys(const upo_ht_sepchain_t ht);
  */
 void upo_ht_sepchain_traverse(const upo_ht_sepchain_t ht, upo_ht_visitor_t visit, void* visit_arg);
 
+/**
+ * \brief Moves the given cursor to the next key-value pair.
+ *
+ * \param ht The hash table.
+ * \param cursor The cursor.
+ * \param key Where the key is stored (may be `NULL`).
+ * \param value Where the value is stored (may be `NULL`).
+ * \return `1` if a pair was found, or `0` if the enumeration is over.
+ *
+ * The hash table must not be modified while it is being enumerated.
+ *
+ * Worst-case complexity: linear in the number `m` of slots, `O(m)`; a whole
+ *  enumeration takes `O(n+m)` time, where `n` is the number of elements.
+ */
+int upo_ht_sepchain_cursor_next(const upo_ht_sepchain_t ht, upo_ht_cursor_t* cursor, void** key, void** value);
+
+/**
+ * \brief Copies the keys in the given hash table to the given array.
+ *
+ * \param ht The hash table.
+ * \param keys The array of keys.
+ * \param n The length of the array.
+ * \return The number of copied keys, that is the minimum between \a n and the
+ *  size of the hash table.
+ *
+ * Worst-case complexity: linear in the number `n` of elements and in the
+ *  number `m` of slots, `O(n+m)`.
+ */
+size_t upo_ht_sepchain_keys_into(const upo_ht_sepchain_t ht, void** keys, size_t n);
+
+/**
+ * \brief Sets the load factors that drive the automatic resizing of the
+ *  given hash table.
+ *
+ * \param ht The hash table.
+ * \param min_load_factor The load factor below which the hash table shrinks
+ *  after a removal, or `0` to never shrink.
+ * \param max_load_factor The load factor above which the hash table grows
+ *  after an insertion, or `0` to never grow.
+ *
+ * Unless growth is disabled, \a min_load_factor must be less than half of
+ * \a max_load_factor, so that a resize never triggers the opposite one.
+ * The hash table is resized immediately if its current load factor lies
+ * outside the new bounds.
+ *
+ * Worst-case complexity: linear in the number `n` of elements and in the
+ *  capacity `m` of the hash table, `O(n+m)`.
+ */
+void upo_ht_sepchain_set_load_factors(upo_ht_sepchain_t ht, double min_load_factor, double max_load_factor);
+
+/**
+ * \brief Makes room in the given hash table for the given number of keys.
+ *
+ * \param ht The hash table.
+ * \param n The number of keys the hash table must hold without growing.
+ *
+ * The capacity is increased (never decreased) so that \a n keys can be
+ * stored without exceeding the maximum load factor; reserving before a bulk
+ * insertion avoids the intermediate resizes.
+ *
+ * Worst-case complexity: linear in the number `n` of elements and in the
+ *  capacity `m` of the hash table, `O(n+m)`.
+ */
+void upo_ht_sepchain_reserve(upo_ht_sepchain_t ht, size_t n);
+
+/**
+ * \brief Sets the approximate membership filter that lookups of the given
+ *  hash table consult before walking a list of collisions.
+ *
+ * \param ht The hash table.
+ * \param type The kind of filter: #UPO_HT_FILTER_NONE (the default),
+ *  #UPO_HT_FILTER_BLOOM or #UPO_HT_FILTER_CUCKOO.
+ *
+ * A filter answers most lookups of absent keys from a single cache line,
+ * without touching the slots nor the nodes, which pays off when misses are
+ * frequent and the table does not fit in cache.
+ * Filters are fed with the hash value returned by the key hash function
+ * for #UPO_HT_HASH_FULL_RANGE, so lookups of present keys hash twice.
+ * Removed keys leave their bits in a Bloom filter (making it less effective,
+ * never wrong) until the next resize; a cuckoo filter forgets them at once.
+ * The filter is rebuilt from the stored keys whenever the table is resized.
+ *
+ * Worst-case complexity: linear in the number `n` of elements and in the
+ *  capacity `m` of the hash table, `O(n+m)`.
+ */
+void upo_ht_sepchain_set_filter(upo_ht_sepchain_t ht, int type);
+
 
 /*** END of HASH TABLE with SEPARATE CHAINING ***/
 
@@ -292,7 +558,7 @@ void upo_ht_sepchain_traverse(const upo_ht_sepchain_t ht, upo_ht_visitor_t visit
 /*** BEGIN of HASH TABLE with OPEN ADDRESSING ***/
 
 
-/** \brief Initial capacity of hash tables with linear probing. */
+/** \brief Initial capacity of hash tables with linear probing (a power of two). */
 #define UPO_HT_LINPROB_DEFAULT_CAPACITY 16U
 
 /** \brief Type for hash tables with linear probing. */
@@ -307,10 +573,75 @@ typedef struct upo_ht_linprob_s* upo_ht_linprob_t;
  * \param key_cmp A pointer to the function used to compare keys.
  * \return An empty hash table.
  *
+ * The capacity is rounded up to the next power of two, so that the probe
+ * sequence wraps around the table by means of a bit mask rather than an
+ * integer division.
+ * The hash function is invoked with #UPO_HT_HASH_FULL_RANGE, once per
+ * operation, and the result is mixed by means of upo_ht_hash_mix(); entries
+ * keep it, so that probes compare hash values before keys, resizes never
+ * call the hash function, and deletions move the following keys of the
+ * cluster back rather than leaving tombstones.
+ * The table shares this probing core with the containers of upo/hashset.h.
+ *
  * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
  */
 upo_ht_linprob_t upo_ht_linprob_create(size_t m, upo_ht_hasher_t hasher, upo_ht_comparator_t key_cmp);
 
+/**
+ * \brief Creates a new empty hash table whose keys are hashed with a random
+ *  seed.
+ *
+ * \param m The initial capacity of the hash table.
+ * \param key_hash A pointer to the seeded function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash table.
+ *
+ * The seed is drawn by means of upo_ht_random_seed() and never changes.
+ * As long as it stays secret, keys crafted to collide in one table are
+ * spread in any other; with a keyed hash function such as
+ * upo_ht_hash_str_sip(), no input can make the clusters grow
+ * longer than logarithmic, with high probability.
+ * Apart from the hash function, the hash table is the same as the one
+ * returned by upo_ht_linprob_create().
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+upo_ht_linprob_t upo_ht_linprob_create_seeded(size_t m, upo_ht_seeded_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Returns the seed of the given hash table.
+ *
+ * \param ht The hash table.
+ * \return The seed passed to the seeded hash function, or `0` if the hash
+ *  table was not created by upo_ht_linprob_create_seeded().
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_linprob_seed(const upo_ht_linprob_t ht);
+
+/**
+ * \brief Creates a new hash table holding the given key-value pairs.
+ *
+ * \param keys The array of keys.
+ * \param values The array of values (\a values[i] is associated to \a keys[i]).
+ * \param n The number of key-value pairs.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return A hash table with the same content as one obtained by putting the
+ *  given pairs, in order, into an empty hash table.
+ *
+ * The capacity is chosen once, as the smallest power of two (not less than
+ * #UPO_HT_LINPROB_DEFAULT_CAPACITY) keeping the load factor within `1/2`.
+ * Then all keys are hashed in a single pass, and the pairs are placed in order
+ * of (ranges of) hash values, so that the slots being filled stay in cache;
+ * no resize takes place.
+ * If a key appears more than once, its last value is kept.
+ *
+ * Worst-case complexity: quadratic in the number `n` of elements, `O(n^2)`,
+ *  when all keys collide; expected linear time, `O(n)`.
+ */
+upo_ht_linprob_t upo_ht_linprob_build_from_arrays(void* const* keys, void* const* values, size_t n, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
 /**
  * \brief Destroys the given hash table.
  *
@@ -383,6 +714,26 @@ void upo_ht_linprob_insert(upo_ht_linprob_t ht, void* key, void* value);
  */
 void* upo_ht_linprob_get(const upo_ht_linprob_t ht, const void* key);
 
+/**
+ * \brief Looks up a batch of keys in the given hash table.
+ *
+ * \param ht The hash table.
+ * \param keys The array of keys to look up.
+ * \param n The number of keys in \a keys.
+ * \param values_out The array of (at least) \a n elements where the value
+ *  associated to each key (or `NULL` if the key is not found) is stored.
+ * \return The number of keys found.
+ *
+ * The outcome is the same as calling upo_ht_linprob_get() for each key.
+ * The lookups are split into groups: all the keys of a group are hashed
+ * first and their slots are prefetched, so that the cache misses of the group
+ * overlap instead of being paid one after the other.
+ *
+ * Worst-case complexity: linear in the number `n` of keys and in the number
+ *  `s` of elements, `O(n*s)`.
+ */
+size_t upo_ht_linprob_get_batch(const upo_ht_linprob_t ht, void* const* keys, size_t n, void** values_out);
+
 /**
  * \brief Tells if the given hash table contains an item identified by
  *  the given key.
@@ -455,13 +806,40 @@ size_t upo_ht_linprob_size(const upo_ht_linprob_t ht);
  */
 double upo_ht_linprob_load_factor(const upo_ht_linprob_t ht);
 
+/**
+ * \brief Collects statistics about the internals of the given hash table.
+ *
+ * \param ht The hash table.
+ * \param stats Where the statistics are stored (all zero if \a ht is `NULL`).
+ *
+ * Worst-case complexity: linear in the number `n` of elements and in the
+ *  capacity `m` of the hash table, `O(n+m)`.
+ */
+void upo_ht_linprob_stats(const upo_ht_linprob_t ht, upo_ht_stats_t* stats);
+
+/**
+ * \brief Rebuilds the slots of the given hash table, without changing its
+ *  capacity.
+ *
+ * \param ht The hash table.
+ *
+ * The slots are rebuilt from the hash values kept by the entries, and the
+ * rebuild counts as a resize in the statistics.
+ * Since deletions leave no tombstones, probes are already as short as after
+ * reinserting every key, so this is never needed to speed up lookups.
+ *
+ * Worst-case complexity: linear in the number `n` of elements and in the
+ *  capacity `m` of the hash table, `O(n+m)`.
+ */
+void upo_ht_linprob_compact(upo_ht_linprob_t ht);
+
 /**
  * \brief Returns the keys in the given hash table.
  *
  * \param ht The hash table.
  * \return A singly-linked list of keys, or `NULL` if the hash table is empty.
  *
- * Worst-case complexity: linear in the number `m` of slots, `O(m)`.
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
  */
 upo_ht_key_list_t upo_ht_linprob_keys(const upo_ht_linprob_t ht);
 
@@ -472,10 +850,40 @@ upo_ht_key_list_t upo_ht_linprob_keys(const upo_ht_linprob_t ht);
  * \param visit The visit function.
  * \param visit_arg An additional parameter to pass to the visit function
  *
- * Worst-case complexity: linear in the number `m` of slots, `O(m)`.
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
  */
 void upo_ht_linprob_traverse(const upo_ht_linprob_t ht, upo_ht_visitor_t visit, void* visit_arg);
 
+/**
+ * \brief Moves the given cursor to the next key-value pair.
+ *
+ * \param ht The hash table.
+ * \param cursor The cursor.
+ * \param key Where the key is stored (may be `NULL`).
+ * \param value Where the value is stored (may be `NULL`).
+ * \return `1` if a pair was found, or `0` if the enumeration is over.
+ *
+ * Key-value pairs are stored contiguously, so a whole enumeration is a linear
+ * scan of `n` entries, whatever the capacity.
+ * The hash table must not be modified while it is being enumerated.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_ht_linprob_cursor_next(const upo_ht_linprob_t ht, upo_ht_cursor_t* cursor, void** key, void** value);
+
+/**
+ * \brief Copies the keys in the given hash table to the given array.
+ *
+ * \param ht The hash table.
+ * \param keys The array of keys.
+ * \param n The length of the array.
+ * \return The number of copied keys, that is the minimum between \a n and the
+ *  size of the hash table.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+size_t upo_ht_linprob_keys_into(const upo_ht_linprob_t ht, void** keys, size_t n);
+
 
 /*** END of HASH TABLE with OPEN ADDRESSING ***/
 
@@ -483,6 +891,51 @@ void upo_ht_linprob_traverse(const upo_ht_linprob_t ht, upo_ht_visitor_t visit,
 /*** BEGIN of HASH FUNCTIONS ***/
 
 
+/**
+ * \brief The number of possible hash values to pass to a hash function to get
+ *  a (virtually) unreduced hash value.
+ *
+ * Useful to compare hash functions independently from the capacity of a table
+ * and for data structures that reduce hash values by themselves.
+ */
+#define UPO_HT_HASH_FULL_RANGE ((size_t) -1)
+
+/**
+ * \brief Reduces the given hash value to the range \f$\{0,\ldots,m-1\}\f$.
+ *
+ * \param h The (unreduced) hash value.
+ * \param m The number of possible hash values.
+ * \return The reduced hash value.
+ *
+ * If \a m is a power of two the reduction is a bit mask, that is
+ * \f$h \bmod m\f$ computed without any division; otherwise, the remainder of
+ * the division \f$h / m\f$ is returned.
+ * Hash functions are meant to mix the whole key into a full-width value and
+ * to call this function only once, at the end.
+ */
+size_t upo_ht_reduce(size_t h, size_t m);
+
+/**
+ * \brief Reduces the given hash value to the range \f$\{0,\ldots,m-1\}\f$
+ *  by means of the Lemire's multiply-shift method (a.k.a. *fastrange*).
+ *
+ * \param h The (unreduced) hash value.
+ * \param m The number of possible hash values.
+ * \return The reduced hash value, that is \f$\lfloor h m / 2^w \rfloor\f$,
+ *  where \f$w\f$ is the number of bits of `size_t`.
+ *
+ * Unlike upo_ht_reduce(), this reduction never divides, whatever \a m is, but
+ * it only depends on the most significant bits of \a h.
+ * Thus it must only be used with hash values that are well mixed over the
+ * whole word.
+ *
+ * See:
+ * - D. Lemire, "A fast alternative to the modulo reduction", 2016.
+ * .
+ */
+size_t upo_ht_reduce_fastrange(size_t h, size_t m);
+
+
 /**
  * \brief Hash function for integers that uses the division method.
  *
@@ -529,9 +982,76 @@ size_t upo_ht_hash_int_mult(const void* x, double a, size_t m);
  * \param x The integer to be hashed.
  * \param m The number of possible hash values.
  * \return The hash value which is an integer number in \f$\{0,\ldots,m-1\}\f$.
+ *
+ * The multiplicative constant is \f$a = (\sqrt{5}-1)/2\f$.
+ * Unlike upo_ht_hash_int_mult(), this function uses fixed-point arithmetic:
+ * the fractional part of \f$a x\f$ is the low word of the product between
+ * \f$x\f$ and \f$\lfloor 2^{64} a \rfloor\f$, and it is scaled to \a m by
+ * means of upo_ht_reduce_fastrange().
+ * Thus, no floating-point operation is involved.
  */
 size_t upo_ht_hash_int_mult_knuth(const void* x, size_t m);
 
+/**
+ * \brief Hash function for integers based on a multiply-xorshift finalizer.
+ *
+ * \param x The integer to be hashed.
+ * \param m The number of possible hash values.
+ * \return The hash value which is an integer number in \f$\{0,\ldots,m-1\}\f$.
+ *
+ * The integer is mixed by means of upo_ht_hash_mix() and the result is reduced
+ * by means of upo_ht_reduce_fastrange().
+ * Unlike the division and multiplication methods, every bit of the key
+ * affects every bit of the hash value, so that also keys sharing their low
+ * (or high) bits are spread evenly over any number of hash values.
+ */
+size_t upo_ht_hash_int_mix(const void* x, size_t m);
+
+/**
+ * \brief Mixes the bits of the given word.
+ *
+ * \param x The word to mix.
+ * \return The mixed word (not reduced to any range).
+ *
+ * This is the 64-bit finalizer of MurmurHash3, made of alternated xor-shift
+ * and multiply steps.
+ * It is a bijection, and flipping a single input bit flips each output bit
+ * with probability close to 1/2.
+ */
+size_t upo_ht_hash_mix(size_t x);
+
+/**
+ * \brief Seeded hash function for integers based on a multiply-xorshift
+ *  finalizer.
+ *
+ * \param x The integer to be hashed.
+ * \param seed The seed.
+ * \param m The number of possible hash values.
+ * \return The hash value which is an integer number in \f$\{0,\ldots,m-1\}\f$.
+ *
+ * The integer is xored with the seed before being hashed as by
+ * upo_ht_hash_int_mix().
+ * This is as fast as the unseeded function and defeats keys precomputed
+ * offline, but it is not a keyed pseudorandom function: an attacker who can
+ * observe the timing of many operations may still learn enough of the seed.
+ * Prefer upo_ht_hash_int_sip() when keys come from untrusted sources.
+ */
+size_t upo_ht_hash_int_mix_seeded(const void* x, size_t seed, size_t m);
+
+/**
+ * \brief Seeded hash function for integers based on SipHash.
+ *
+ * \param x The integer to be hashed.
+ * \param seed The seed.
+ * \param m The number of possible hash values.
+ * \return The hash value which is an integer number in \f$\{0,\ldots,m-1\}\f$.
+ *
+ * The bytes of the integer are hashed by means of upo_ht_hash_bytes_sip(),
+ * keyed by the seed, and the result is reduced by means of
+ * upo_ht_reduce_fastrange().
+ */
+size_t upo_ht_hash_int_sip(const void* x, size_t seed, size_t m);
+
 /**
  * \brief Hash function for strings.
  *
@@ -550,6 +1070,12 @@ size_t upo_ht_hash_int_mult_knuth(const void* x, size_t m);
  * \f]
  * where:
  * - \f$k=(k_0,\ldots,k_{\ell-1})\f$ is an array of characters of size \$\ell\$
+ * .
+ * The polynomial is accumulated modulo \f$2^w\f$ (being \f$w\f$ the number
+ * of bits of `size_t`) and it is reduced modulo \a m only once, at the end,
+ * by means of upo_ht_reduce().
+ * When \a m is a power of two the result is the same as reducing at every
+ * step.
  */
 size_t upo_ht_hash_str(const void* s, size_t h0, size_t a, size_t m);
 
@@ -591,6 +1117,10 @@ size_t upo_ht_hash_str_java(const void* s, size_t m);
 /**
  * \brief The Kernighan and Ritchie's hash function proposed in the second
  *  edition of their C book.
+ *
+ * This is the same polynomial hash (with multiplier `31` and no initial
+ * value) as the Java's one, see upo_ht_hash_str_java(); it is kept as a
+ * separate function only for the sake of reference.
  */
 size_t upo_ht_hash_str_kr2e(const void* s, size_t m);
 
@@ -600,6 +1130,93 @@ size_t upo_ht_hash_str_kr2e(const void* s, size_t m);
  */
 size_t upo_ht_hash_str_sgistl(const void* s, size_t m);
 
+/**
+ * \brief The xxHash64 hash function applied to a string.
+ *
+ * \param s The string to be hashed.
+ * \param m The number of possible hash values.
+ * \return The hash value which is an integer number in \f$\{0,\ldots,m-1\}\f$.
+ *
+ * The characters of the string (without the end-of-string character) are
+ * hashed by means of upo_ht_hash_bytes_xx64() with a zero seed, and the result
+ * is reduced by means of upo_ht_reduce_fastrange().
+ */
+size_t upo_ht_hash_str_xx64(const void* s, size_t m);
+
+/**
+ * \brief The xxHash64 hash function applied to a buffer of bytes.
+ *
+ * \param data A pointer to the bytes to hash.
+ * \param len The number of bytes to hash.
+ * \param seed The seed of the hash function.
+ * \return The hash value (not reduced to any range).
+ *
+ * The buffer is consumed one 64-bit word at a time (in four independent lanes
+ * for buffers of at least 32 bytes), so that the cost per byte is a fraction
+ * of the one of the character-at-a-time hash functions.
+ * Words are read as little-endian, thus the result does not depend on the
+ * platform (apart from being truncated when `size_t` is narrower than 64
+ * bits).
+ *
+ * See:
+ * - https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+ * .
+ */
+size_t upo_ht_hash_bytes_xx64(const void* data, size_t len, size_t seed);
+
+/**
+ * \brief Seeded hash function for strings based on SipHash.
+ *
+ * \param s The string to be hashed.
+ * \param seed The seed.
+ * \param m The number of possible hash values.
+ * \return The hash value which is an integer number in \f$\{0,\ldots,m-1\}\f$.
+ *
+ * The characters of the string (without the end-of-string character) are
+ * hashed by means of upo_ht_hash_bytes_sip(), keyed by the seed, and the
+ * result is reduced by means of upo_ht_reduce_fastrange().
+ * Unlike the polynomial hash functions (e.g., upo_ht_hash_str_djb2()), for
+ * which any number of colliding strings is easily built, finding collisions
+ * requires the seed.
+ */
+size_t upo_ht_hash_str_sip(const void* s, size_t seed, size_t m);
+
+/**
+ * \brief The SipHash-2-4 keyed hash function applied to a buffer of bytes.
+ *
+ * \param data A pointer to the bytes to hash.
+ * \param len The number of bytes to hash.
+ * \param k0 The first half of the 128-bit key.
+ * \param k1 The second half of the 128-bit key.
+ * \return The hash value (not reduced to any range).
+ *
+ * SipHash is a pseudorandom function: without the key, its outputs cannot be
+ * told apart from random ones, thus neither colliding inputs can be found.
+ * It is several times slower than upo_ht_hash_bytes_xx64() on long buffers,
+ * but on short keys the difference is a few nanoseconds.
+ * Words are read as little-endian, and the result does not depend on the
+ * platform (apart from being truncated, like the key halves, when `size_t` is
+ * narrower than 64 bits).
+ *
+ * See:
+ * - J.-P. Aumasson and D. J. Bernstein, "SipHash: a fast short-input PRF",
+ *   INDOCRYPT 2012.
+ * .
+ */
+size_t upo_ht_hash_bytes_sip(const void* data, size_t len, size_t k0, size_t k1);
+
+/**
+ * \brief Returns a random seed for seeded hash functions.
+ *
+ * \return A seed read from the entropy source of the system
+ *  (`/dev/urandom`).
+ *
+ * Where no such source exists, the seed is derived from the clock and from
+ * addresses, which are hard to predict but not secret: seeded hash tables
+ * are then only protected against keys crafted in advance.
+ */
+size_t upo_ht_random_seed(void);
+
 
 /*** END of HASH FUNCTIONS ***/
 
@@ -0,0 +1,298 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/hashtable_compact.h
+ *
+ * \brief The Compact Hash Table abstract data type.
+ *
+ * A compact hash table keeps its key-value pairs, together with their hash
+ * values, in a dense array of entries, in insertion order; the slots of the
+ * table only hold the positions of the entries, probed linearly.
+ * Each slot is as narrow as the capacity allows (8, 16, 32 or 64 bits), so
+ * the sparse part of the table costs a few bytes per slot, while the entries
+ * (three words each) are allocated only for stored pairs.
+ * Narrow slots and a higher load factor make it about 20% smaller than
+ * \c upo_ht_linprob_t for the same keys (e.g., 34 versus 42 bytes per key
+ * with one million keys, on a 64-bit platform), and about 35% smaller than a
+ * table storing 24-byte pairs directly in its slots at a load factor of at
+ * most 1/2.
+ * Traversals, key lists and cursors enumerate the pairs in the order they were
+ * first inserted.
+ *
+ * A removal leaves a hole in the array of entries, which is reclaimed when
+ * the array fills up, by compacting the entries (their order is preserved).
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHTABLE_COMPACT_H
+#define UPO_HASHTABLE_COMPACT_H
+
+
+#include <stddef.h>
+#include <upo/hashtable.h>
+
+
+/** \brief Default capacity of compact hash tables. */
+#define UPO_HT_COMPACT_DEFAULT_CAPACITY 8U
+
+/**
+ * \brief Load factor up to which entries may be appended to a compact hash
+ *  table before it is compacted or grown.
+ *
+ * Removed entries count towards the load until they are reclaimed.
+ */
+#define UPO_HT_COMPACT_MAX_LOAD_FACTOR (2.0/3.0)
+
+
+/** \brief Type for compact hash tables. */
+typedef struct upo_ht_compact_s* upo_ht_compact_t;
+
+
+/**
+ * \brief Creates a new empty compact hash table.
+ *
+ * \param m The initial capacity of the hash table, rounded up to a power of
+ *  two (and to at least #UPO_HT_COMPACT_DEFAULT_CAPACITY).
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash table.
+ *
+ * The hash function is called once per key with #UPO_HT_HASH_FULL_RANGE as
+ * number of possible hash values; its result is mixed and stored along with
+ * the key, so keys are never hashed again when the table is resized.
+ * The capacity never falls below \a m as keys are removed.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+upo_ht_compact_t upo_ht_compact_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Destroys the given hash table.
+ *
+ * \param ht The hash table to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_ht_compact_destroy(upo_ht_compact_t ht, int destroy_data);
+
+/**
+ * \brief Removes all key-value pairs from the given hash table.
+ *
+ * \param ht The hash table to clear.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_compact_clear(upo_ht_compact_t ht, int destroy_data);
+
+/**
+ * \brief Insert the given value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ * \return The replaced value in case of a duplicate, otherwise `NULL`.
+ *
+ * If the key is already present in the hash table, the associated value is
+ * replaced by the one provided as argument to this function, and the key
+ * keeps its position in the insertion order.
+ * The key must not be `NULL`, which marks removed entries.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void* upo_ht_compact_put(upo_ht_compact_t ht, void* key, void* value);
+
+/**
+ * \brief Inserts the given value identified by the provided key in the given
+ *  hash table but ignores duplicates.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ *
+ * If the key is already present in the hash table, no insertion takes place.
+ * The key must not be `NULL`, which marks removed entries.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_compact_insert(upo_ht_compact_t ht, void* key, void* value);
+
+/**
+ * \brief Returns the value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return The value associated to \a key, or `NULL` if the key is not found.
+ *
+ * The key comparison function is only called on entries whose stored hash
+ * value matches the one of \a key.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void* upo_ht_compact_get(const upo_ht_compact_t ht, const void* key);
+
+/**
+ * \brief Tells if the given hash table contains an item identified by
+ *  the given key.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return `1` if the hash table contains an item identified by the
+ *  given key, or `0` if the key is not found.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+int upo_ht_compact_contains(const upo_ht_compact_t ht, const void* key);
+
+/**
+ * \brief Removes the value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param destroy_data Tells whether the previously allocated memory for data,
+ *  that is to be removed, must be freed (value `1`) or not (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ * The relative order of the remaining keys is unchanged.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_compact_delete(upo_ht_compact_t ht, const void* key, int destroy_data);
+
+/**
+ * \brief Tells if the given hash table is empty.
+ *
+ * \param ht The hash table.
+ * \return `1` if the hash table is empty or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_ht_compact_is_empty(const upo_ht_compact_t ht);
+
+/**
+ * \brief Returns the capacity of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The number of slots.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_compact_capacity(const upo_ht_compact_t ht);
+
+/**
+ * \brief Returns the size of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The number of keys stored in the hash table.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_compact_size(const upo_ht_compact_t ht);
+
+/**
+ * \brief Returns the load factor of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The ratio between the size and the capacity of the hash table.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+double upo_ht_compact_load_factor(const upo_ht_compact_t ht);
+
+/**
+ * \brief Returns the number of bytes of memory used by the given hash table.
+ *
+ * \param ht The hash table.
+ * \return The size of the table structure, of its slots and of its (allocated)
+ *  entries; the memory of keys and values is not included.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_compact_memory_usage(const upo_ht_compact_t ht);
+
+/**
+ * \brief Returns the keys in the given hash table.
+ *
+ * \param ht The hash table.
+ * \return A singly-linked list of keys, in insertion order, or `NULL` if the
+ *  hash table is empty.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+upo_ht_key_list_t upo_ht_compact_keys(const upo_ht_compact_t ht);
+
+/**
+ * \brief Performs a traversal of the hash table, in insertion order.
+ *
+ * \param ht The hash table to traverse.
+ * \param visit The visit function.
+ * \param visit_arg An additional parameter to pass to the visit function
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_ht_compact_traverse(const upo_ht_compact_t ht, upo_ht_visitor_t visit, void* visit_arg);
+
+/**
+ * \brief Moves the given cursor to the next key-value pair, in insertion
+ *  order.
+ *
+ * \param ht The hash table.
+ * \param cursor The cursor.
+ * \param key Where the key is stored (may be `NULL`).
+ * \param value Where the value is stored (may be `NULL`).
+ * \return `1` if a pair was found, or `0` if the enumeration is over.
+ *
+ * The hash table must not be modified while it is being enumerated.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`;
+ *  amortized constant time, `O(1)`, over a whole enumeration.
+ */
+int upo_ht_compact_cursor_next(const upo_ht_compact_t ht, upo_ht_cursor_t* cursor, void** key, void** value);
+
+/**
+ * \brief Copies the keys in the given hash table to the given array, in
+ *  insertion order.
+ *
+ * \param ht The hash table.
+ * \param keys The array of keys.
+ * \param n The length of the array.
+ * \return The number of copied keys, that is the minimum between \a n and the
+ *  size of the hash table.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+size_t upo_ht_compact_keys_into(const upo_ht_compact_t ht, void** keys, size_t n);
+
+
+#endif /* UPO_HASHTABLE_COMPACT_H */
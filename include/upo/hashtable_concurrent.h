@@ -0,0 +1,270 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/hashtable_concurrent.h
+ *
+ * \brief The Concurrent Hash Table abstract data type.
+ *
+ * A concurrent hash table is a hash table with separate chaining that can be
+ * shared by several threads.
+ * Its slots are partitioned into stripes, each protected by its own
+ * reader-writer lock: lookups on a stripe proceed in parallel, while updates
+ * only exclude the operations on the same stripe.
+ * Each stripe grows and shrinks on its own, so that a resize never blocks the
+ * operations on the other stripes.
+ *
+ * The hash table stores pointers to keys and values but never accesses the
+ * values; it is up to the caller to make sure that keys and values are not
+ * freed while other threads may still use them.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHTABLE_CONCURRENT_H
+#define UPO_HASHTABLE_CONCURRENT_H
+
+
+#include <stddef.h>
+#include <upo/hashtable.h>
+
+
+/** \brief Default capacity of concurrent hash tables. */
+#define UPO_HT_CONCURRENT_DEFAULT_CAPACITY 1024U
+
+/** \brief Default number of stripes of concurrent hash tables. */
+#define UPO_HT_CONCURRENT_DEFAULT_STRIPES 64U
+
+
+/** \brief Type for concurrent hash tables. */
+typedef struct upo_ht_concurrent_s* upo_ht_concurrent_t;
+
+
+/**
+ * \brief Creates a new empty concurrent hash table.
+ *
+ * \param m The initial capacity of the hash table.
+ * \param stripes The number of stripes (i.e., of locks), rounded up to a power
+ *  of two.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash table.
+ *
+ * The hash function is called with #UPO_HT_HASH_FULL_RANGE as number of
+ * possible hash values; the resulting value is mixed and then split between
+ * the choice of the stripe and the choice of the slot within the stripe.
+ * The capacity is evenly split among the stripes; each stripe doubles its
+ * capacity when its load factor exceeds `1` and halves it when its load factor
+ * falls below `1/8`, but never below its initial capacity.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table and in
+ *  the number `s` of stripes, `O(m+s)`.
+ */
+upo_ht_concurrent_t upo_ht_concurrent_create(size_t m, size_t stripes, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Destroys the given hash table.
+ *
+ * \param ht The hash table to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * No other thread may access the hash table during and after its destruction.
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_concurrent_destroy(upo_ht_concurrent_t ht, int destroy_data);
+
+/**
+ * \brief Removes all key-value pairs from the given hash table.
+ *
+ * \param ht The hash table to clear.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * Stripes are cleared one at a time, so concurrent insertions into stripes
+ * already cleared are preserved.
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_concurrent_clear(upo_ht_concurrent_t ht, int destroy_data);
+
+/**
+ * \brief Insert the given value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ * \return The replaced value in case of a duplicate, otherwise `NULL`.
+ *
+ * If the key is already present in the hash table, the associated value is
+ * replaced by the one provided as argument to this function.
+ * Only the stripe of the key is locked (for writing).
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void* upo_ht_concurrent_put(upo_ht_concurrent_t ht, void* key, void* value);
+
+/**
+ * \brief Inserts the given value identified by the provided key in the given
+ *  hash table but ignores duplicates.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ * \return `1` if the key has been inserted, or `0` if it was already present.
+ *
+ * The check and the insertion are performed atomically, so this function can
+ * be used to elect the single thread that inserts a key.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+int upo_ht_concurrent_insert(upo_ht_concurrent_t ht, void* key, void* value);
+
+/**
+ * \brief Returns the value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return The value associated to \a key, or `NULL` if the key is not found.
+ *
+ * Only the stripe of the key is locked (for reading).
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void* upo_ht_concurrent_get(const upo_ht_concurrent_t ht, const void* key);
+
+/**
+ * \brief Tells if the given hash table contains an item identified by
+ *  the given key.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return `1` if the hash table contains an item identified by the
+ *  given key, or `0` if the key is not found.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+int upo_ht_concurrent_contains(const upo_ht_concurrent_t ht, const void* key);
+
+/**
+ * \brief Removes the value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param destroy_data Tells whether the previously allocated memory for data,
+ *  that is to be removed, must be freed (value `1`) or not (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function, while the stripe is still locked; this is safe only if
+ * no other thread still uses the removed key and value.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_ht_concurrent_delete(upo_ht_concurrent_t ht, const void* key, int destroy_data);
+
+/**
+ * \brief Tells if the given hash table is empty.
+ *
+ * \param ht The hash table.
+ * \return `1` if the hash table is empty or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the number `s` of stripes, `O(s)`.
+ */
+int upo_ht_concurrent_is_empty(const upo_ht_concurrent_t ht);
+
+/**
+ * \brief Returns the capacity of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The total number of slots of all the stripes.
+ *
+ * Worst-case complexity: linear in the number `s` of stripes, `O(s)`.
+ */
+size_t upo_ht_concurrent_capacity(const upo_ht_concurrent_t ht);
+
+/**
+ * \brief Returns the size of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The number of keys stored in the hash table.
+ *
+ * Stripes are read one at a time, so under concurrent updates the result is
+ * only a snapshot of each single stripe.
+ *
+ * Worst-case complexity: linear in the number `s` of stripes, `O(s)`.
+ */
+size_t upo_ht_concurrent_size(const upo_ht_concurrent_t ht);
+
+/**
+ * \brief Returns the number of stripes of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The number of stripes (i.e., of locks).
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_concurrent_stripes(const upo_ht_concurrent_t ht);
+
+/**
+ * \brief Returns the load factor of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The ratio between the size and the capacity of the hash table.
+ *
+ * Worst-case complexity: linear in the number `s` of stripes, `O(s)`.
+ */
+double upo_ht_concurrent_load_factor(const upo_ht_concurrent_t ht);
+
+/**
+ * \brief Returns the keys in the given hash table.
+ *
+ * \param ht The hash table.
+ * \return A singly-linked list of keys, or `NULL` if the hash table is empty.
+ *
+ * The list is built by visiting one stripe at a time.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+upo_ht_key_list_t upo_ht_concurrent_keys(const upo_ht_concurrent_t ht);
+
+/**
+ * \brief Performs a traversal of the hash table.
+ *
+ * \param ht The hash table to traverse.
+ * \param visit The visit function.
+ * \param visit_arg An additional parameter to pass to the visit function
+ *
+ * Stripes are visited one at a time while holding their lock for reading: the
+ * visit function must not modify the hash table, and it sees every stripe as
+ * it was at the time of its visit.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_concurrent_traverse(const upo_ht_concurrent_t ht, upo_ht_visitor_t visit, void* visit_arg);
+
+
+#endif /* UPO_HASHTABLE_CONCURRENT_H */
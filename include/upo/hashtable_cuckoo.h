@@ -0,0 +1,258 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/hashtable_cuckoo.h
+ *
+ * \brief The Cuckoo Hash Table abstract data type.
+ *
+ * A cuckoo hash table stores each key in one of two buckets, chosen by two
+ * independent hash values; each bucket has #UPO_HT_CUCKOO_BUCKET_SLOTS slots
+ * and fills exactly one cache line, together with a one-byte tag per slot.
+ * A lookup inspects at most the two buckets of the key (and a small stash,
+ * which is almost always empty), thus it takes constant time in the worst
+ * case and touches at most two cache lines of the table; the tags, derived
+ * from the hash values, let most lookups skip the key comparisons (and so the
+ * memory of the stored keys) altogether.
+ * An insertion into two full buckets evicts one of the keys, which is moved to
+ * its other bucket, possibly evicting another key, and so on; when the chain
+ * of evictions gets too long, the homeless key is put in the stash, and when
+ * the stash is full the table is rebuilt with new hash functions.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHTABLE_CUCKOO_H
+#define UPO_HASHTABLE_CUCKOO_H
+
+
+#include <stddef.h>
+#include <upo/hashtable.h>
+
+
+/**
+ * \brief Number of slots per bucket of cuckoo hash tables.
+ *
+ * Three key-value pairs and their tags fit in a 64-byte cache line.
+ */
+#define UPO_HT_CUCKOO_BUCKET_SLOTS 3U
+
+/** \brief Default capacity of cuckoo hash tables (16 buckets). */
+#define UPO_HT_CUCKOO_DEFAULT_CAPACITY (16U*UPO_HT_CUCKOO_BUCKET_SLOTS)
+
+/** \brief Number of slots of the stash of cuckoo hash tables. */
+#define UPO_HT_CUCKOO_STASH_SLOTS 4U
+
+/** \brief Load factor above which a cuckoo hash table doubles its capacity. */
+#define UPO_HT_CUCKOO_MAX_LOAD_FACTOR 0.9
+
+
+/** \brief Type for cuckoo hash tables. */
+typedef struct upo_ht_cuckoo_s* upo_ht_cuckoo_t;
+
+
+/**
+ * \brief Creates a new empty cuckoo hash table.
+ *
+ * \param m The initial capacity of the hash table, rounded up so that the
+ *  number of buckets is a power of two.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash table.
+ *
+ * The hash function is called once per key with #UPO_HT_HASH_FULL_RANGE as
+ * number of possible hash values; the two bucket indexes are derived from its
+ * result by mixing it with two seeds, which change when the table is rebuilt.
+ * Since keys with the same hash value always share their buckets, no more than
+ * `2*UPO_HT_CUCKOO_BUCKET_SLOTS+UPO_HT_CUCKOO_STASH_SLOTS` keys may have the
+ * same hash value.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+upo_ht_cuckoo_t upo_ht_cuckoo_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Destroys the given hash table.
+ *
+ * \param ht The hash table to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_cuckoo_destroy(upo_ht_cuckoo_t ht, int destroy_data);
+
+/**
+ * \brief Removes all key-value pairs from the given hash table.
+ *
+ * \param ht The hash table to clear.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_cuckoo_clear(upo_ht_cuckoo_t ht, int destroy_data);
+
+/**
+ * \brief Insert the given value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ * \return The replaced value in case of a duplicate, otherwise `NULL`.
+ *
+ * If the key is already present in the hash table, the associated value is
+ * replaced by the one provided as argument to this function.
+ * The key must not be `NULL`, which marks free slots.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`, when
+ *  the table is rebuilt; expected amortized constant time, `O(1)`.
+ */
+void* upo_ht_cuckoo_put(upo_ht_cuckoo_t ht, void* key, void* value);
+
+/**
+ * \brief Inserts the given value identified by the provided key in the given
+ *  hash table but ignores duplicates.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ *
+ * If the key is already present in the hash table, no insertion takes place.
+ * The key must not be `NULL`, which marks free slots.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`, when
+ *  the table is rebuilt; expected amortized constant time, `O(1)`.
+ */
+void upo_ht_cuckoo_insert(upo_ht_cuckoo_t ht, void* key, void* value);
+
+/**
+ * \brief Returns the value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return The value associated to \a key, or `NULL` if the key is not found.
+ *
+ * At most two buckets and the stash are inspected.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void* upo_ht_cuckoo_get(const upo_ht_cuckoo_t ht, const void* key);
+
+/**
+ * \brief Tells if the given hash table contains an item identified by
+ *  the given key.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return `1` if the hash table contains an item identified by the
+ *  given key, or `0` if the key is not found.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_ht_cuckoo_contains(const upo_ht_cuckoo_t ht, const void* key);
+
+/**
+ * \brief Removes the value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param destroy_data Tells whether the previously allocated memory for data,
+ *  that is to be removed, must be freed (value `1`) or not (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ * The freed slot is used to move back a stashed key, if any.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_ht_cuckoo_delete(upo_ht_cuckoo_t ht, const void* key, int destroy_data);
+
+/**
+ * \brief Tells if the given hash table is empty.
+ *
+ * \param ht The hash table.
+ * \return `1` if the hash table is empty or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_ht_cuckoo_is_empty(const upo_ht_cuckoo_t ht);
+
+/**
+ * \brief Returns the capacity of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The total number of slots of the buckets (the stash excluded).
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_cuckoo_capacity(const upo_ht_cuckoo_t ht);
+
+/**
+ * \brief Returns the size of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The number of keys stored in the hash table.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_cuckoo_size(const upo_ht_cuckoo_t ht);
+
+/**
+ * \brief Returns the load factor of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The ratio between the size and the capacity of the hash table.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+double upo_ht_cuckoo_load_factor(const upo_ht_cuckoo_t ht);
+
+/**
+ * \brief Returns the keys in the given hash table.
+ *
+ * \param ht The hash table.
+ * \return A singly-linked list of keys, or `NULL` if the hash table is empty.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+upo_ht_key_list_t upo_ht_cuckoo_keys(const upo_ht_cuckoo_t ht);
+
+/**
+ * \brief Performs a traversal of the hash table.
+ *
+ * \param ht The hash table to traverse.
+ * \param visit The visit function.
+ * \param visit_arg An additional parameter to pass to the visit function
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_cuckoo_traverse(const upo_ht_cuckoo_t ht, upo_ht_visitor_t visit, void* visit_arg);
+
+
+#endif /* UPO_HASHTABLE_CUCKOO_H */
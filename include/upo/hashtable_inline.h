@@ -0,0 +1,123 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/hashtable_inline.h
+ *
+ * \brief Hash tables with keys and values stored inline.
+ *
+ * These hash tables resolve collisions by linear probing, like
+ * \c upo_ht_linprob_t, but each of them is specialized for a key type and a
+ * value type: keys and values are stored by value in the array of slots,
+ * rather than as pointers to user memory.
+ * Thus no memory needs to be allocated per key, and a lookup compares keys
+ * without dereferencing any pointer.
+ *
+ * The following tables are provided:
+ * - \c upo_ht_int_int_t, from `int` keys to `int` values;
+ * - \c upo_ht_u64_ptr_t, from `uint64_t` keys to `void*` values.
+ * .
+ *
+ * Key `0` marks free slots and is kept aside, so any key may be stored.
+ * Deletions shift the following keys back rather than leaving tombstones.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHTABLE_INLINE_H
+#define UPO_HASHTABLE_INLINE_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/** \brief Default capacity of hash tables with inline keys and values. */
+#define UPO_HT_INLINE_DEFAULT_CAPACITY 16U
+
+/** \brief Load factor above which hash tables with inline keys and values double their capacity. */
+#define UPO_HT_INLINE_MAX_LOAD_FACTOR 0.75
+
+
+/**
+ * \brief Declares the types and the functions of a hash table with inline
+ *  keys and values.
+ *
+ * \param prefix The prefix of all the names (e.g., `upo_ht_int_int_`).
+ * \param K The type of keys.
+ * \param V The type of values.
+ *
+ * The invocation must be followed by a semicolon.
+ * It declares the type `prefix##t` of hash tables, the type
+ * `prefix##visitor_t` of functions visiting their pairs, i.e.,
+ * `void (*)(K key, V value, void* visit_arg)`, and the following functions:
+ * - `prefix##t prefix##create(size_t m)` creates an empty table with an
+ *   initial capacity of \a m slots, rounded up to a power of two (the
+ *   capacity never falls below \a m as keys are removed), in `O(m)` time;
+ * - `void prefix##destroy(prefix##t ht)` destroys the table, in `O(1)` time;
+ * - `void prefix##clear(prefix##t ht)` removes all key-value pairs, in
+ *   `O(m)` time;
+ * - `int prefix##put(prefix##t ht, K key, V value)` associates \a value to
+ *   \a key, returning `1` if the key was already present (its value is
+ *   replaced), or `0` otherwise;
+ * - `int prefix##get(const prefix##t ht, K key, V* value)` stores the value
+ *   associated to \a key where \a value points (unless it is `NULL`),
+ *   returning `1` if the key is found, or `0` otherwise;
+ * - `int prefix##contains(const prefix##t ht, K key)` returns `1` if \a key
+ *   is found, or `0` otherwise;
+ * - `int prefix##delete(prefix##t ht, K key)` removes \a key and its value,
+ *   returning `1` if the key was found, or `0` otherwise;
+ * - `int prefix##is_empty(const prefix##t ht)`,
+ *   `size_t prefix##capacity(const prefix##t ht)`,
+ *   `size_t prefix##size(const prefix##t ht)` and
+ *   `double prefix##load_factor(const prefix##t ht)` return the emptiness,
+ *   the number of slots, the number of keys and their ratio, in `O(1)`
+ *   time;
+ * - `void prefix##traverse(const prefix##t ht, prefix##visitor_t visit,
+ *   void* visit_arg)` calls \a visit on each pair, in `O(m)` time (the table
+ *   must not be modified meanwhile).
+ * .
+ * Lookups, insertions and deletions take `O(m)` time in the worst case.
+ * Values are never freed.
+ */
+#define UPO_HT_INLINE_DECLARE(prefix, K, V) \
+    typedef struct prefix##s* prefix##t; \
+    typedef void (*prefix##visitor_t)(K key, V value, void* visit_arg); \
+    prefix##t prefix##create(size_t m); \
+    void prefix##destroy(prefix##t ht); \
+    void prefix##clear(prefix##t ht); \
+    int prefix##put(prefix##t ht, K key, V value); \
+    int prefix##get(const prefix##t ht, K key, V* value); \
+    int prefix##contains(const prefix##t ht, K key); \
+    int prefix##delete(prefix##t ht, K key); \
+    int prefix##is_empty(const prefix##t ht); \
+    size_t prefix##capacity(const prefix##t ht); \
+    size_t prefix##size(const prefix##t ht); \
+    double prefix##load_factor(const prefix##t ht); \
+    void prefix##traverse(const prefix##t ht, prefix##visitor_t visit, void* visit_arg)
+
+
+/** \brief Hash tables from `int` keys to `int` values. */
+UPO_HT_INLINE_DECLARE(upo_ht_int_int_, int, int);
+
+/** \brief Hash tables from `uint64_t` keys to `void*` values. */
+UPO_HT_INLINE_DECLARE(upo_ht_u64_ptr_, uint64_t, void*);
+
+
+#endif /* UPO_HASHTABLE_INLINE_H */
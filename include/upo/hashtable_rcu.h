@@ -0,0 +1,279 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/hashtable_rcu.h
+ *
+ * \brief The Read-Copy-Update (RCU) Hash Table abstract data type.
+ *
+ * An RCU hash table is a hash table with separate chaining, designed for
+ * read-mostly workloads shared by several threads.
+ * Lookups never take locks and never wait: they complete in a bounded number
+ * of steps regardless of what other threads do.
+ * Updates are serialized by a mutex and publish their changes with atomic
+ * pointer stores, so that a concurrent lookup always sees either the old or
+ * the new state of a list of collisions.
+ * Unlinked nodes (and the slot arrays replaced by a resize) are not freed
+ * right away: they are retired, and freed after a grace period, i.e., once
+ * every lookup that may still be reading them has completed.
+ *
+ * Lookups announce themselves by incrementing a per-epoch counter, picked by
+ * thread so that threads reading the same keys do not share cache lines;
+ * a grace period advances the epoch twice and each time waits for the
+ * counters of the previous epoch to drain (epoch-based reclamation).
+ *
+ * The hash table stores pointers to keys and values but never accesses the
+ * values: a value returned by a lookup stays valid only as long as the caller
+ * makes sure that no other thread frees it.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHTABLE_RCU_H
+#define UPO_HASHTABLE_RCU_H
+
+
+#include <stddef.h>
+#include <upo/hashtable.h>
+
+
+/** \brief Default capacity of RCU hash tables. */
+#define UPO_HT_RCU_DEFAULT_CAPACITY 1024U
+
+/**
+ * \brief Number of retired nodes that triggers a grace period and the
+ *  reclamation of the retired nodes.
+ */
+#define UPO_HT_RCU_RETIRE_BATCH 64U
+
+
+/** \brief Type for RCU hash tables. */
+typedef struct upo_ht_rcu_s* upo_ht_rcu_t;
+
+
+/**
+ * \brief Creates a new empty RCU hash table.
+ *
+ * \param m The initial capacity of the hash table (rounded up to a power of
+ *  two).
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash table.
+ *
+ * The hash function is called with #UPO_HT_HASH_FULL_RANGE as number of
+ * possible hash values and the result is mixed, so that the hash value of a
+ * key does not depend on the capacity of the hash table.
+ * The capacity doubles when the load factor exceeds `1`.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+upo_ht_rcu_t upo_ht_rcu_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Destroys the given hash table.
+ *
+ * \param ht The hash table to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * No other thread may access the hash table during and after its destruction.
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_rcu_destroy(upo_ht_rcu_t ht, int destroy_data);
+
+/**
+ * \brief Removes all key-value pairs from the given hash table.
+ *
+ * \param ht The hash table to clear.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * The slots are replaced at once by empty ones, so a concurrent lookup sees
+ * either all or none of the old keys.
+ * The function waits for a grace period before freeing memory.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table and in
+ *  the number `n` of elements, `O(m+n)`, plus a grace period.
+ */
+void upo_ht_rcu_clear(upo_ht_rcu_t ht, int destroy_data);
+
+/**
+ * \brief Insert the given value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ * \return The replaced value in case of a duplicate, otherwise `NULL`.
+ *
+ * If the key is already present in the hash table, the associated value is
+ * replaced atomically by the one provided as argument to this function.
+ * Concurrent lookups may still return the old value until they complete: call
+ * upo_ht_rcu_synchronize() before freeing it.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void* upo_ht_rcu_put(upo_ht_rcu_t ht, void* key, void* value);
+
+/**
+ * \brief Inserts the given value identified by the provided key in the given
+ *  hash table but ignores duplicates.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ * \return `1` if the key has been inserted, or `0` if it was already present.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+int upo_ht_rcu_insert(upo_ht_rcu_t ht, void* key, void* value);
+
+/**
+ * \brief Returns the value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return The value associated to \a key, or `NULL` if the key is not found.
+ *
+ * This function takes no lock and is wait-free: it can run concurrently with
+ * any other operation but upo_ht_rcu_destroy().
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void* upo_ht_rcu_get(const upo_ht_rcu_t ht, const void* key);
+
+/**
+ * \brief Tells if the given hash table contains an item identified by
+ *  the given key.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return `1` if the hash table contains an item identified by the
+ *  given key, or `0` if the key is not found.
+ *
+ * This function takes no lock and is wait-free.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+int upo_ht_rcu_contains(const upo_ht_rcu_t ht, const void* key);
+
+/**
+ * \brief Removes the value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param destroy_data Tells whether the previously allocated memory for data,
+ *  that is to be removed, must be freed (value `1`) or not (value `0`).
+ *
+ * The node of the key is retired: it is freed (together with the key and the
+ * value, if requested) after a grace period, which is run once
+ * #UPO_HT_RCU_RETIRE_BATCH nodes have been retired.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`, plus a
+ *  grace period once every #UPO_HT_RCU_RETIRE_BATCH removals.
+ */
+void upo_ht_rcu_delete(upo_ht_rcu_t ht, const void* key, int destroy_data);
+
+/**
+ * \brief Waits for a grace period and frees the retired memory.
+ *
+ * \param ht The hash table.
+ *
+ * When this function returns, every lookup started before the call has
+ * completed: values replaced by upo_ht_rcu_put() or keys and values removed
+ * by upo_ht_rcu_delete() can then be freed by the caller.
+ *
+ * Worst-case complexity: linear in the number `r` of retired nodes, `O(r)`,
+ *  plus the time taken by the lookups in progress to complete.
+ */
+void upo_ht_rcu_synchronize(upo_ht_rcu_t ht);
+
+/**
+ * \brief Tells if the given hash table is empty.
+ *
+ * \param ht The hash table.
+ * \return `1` if the hash table is empty or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_ht_rcu_is_empty(const upo_ht_rcu_t ht);
+
+/**
+ * \brief Returns the capacity of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The total number of slots of the hash table.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_rcu_capacity(const upo_ht_rcu_t ht);
+
+/**
+ * \brief Returns the size of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The number of keys stored in the hash table.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_rcu_size(const upo_ht_rcu_t ht);
+
+/**
+ * \brief Returns the load factor of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The ratio between the size and the capacity of the hash table.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+double upo_ht_rcu_load_factor(const upo_ht_rcu_t ht);
+
+/**
+ * \brief Returns the keys in the given hash table.
+ *
+ * \param ht The hash table.
+ * \return A singly-linked list of keys, or `NULL` if the hash table is empty.
+ *
+ * Like lookups, this function takes no lock.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+upo_ht_key_list_t upo_ht_rcu_keys(const upo_ht_rcu_t ht);
+
+/**
+ * \brief Performs a traversal of the hash table.
+ *
+ * \param ht The hash table to traverse.
+ * \param visit The visit function.
+ * \param visit_arg An additional parameter to pass to the visit function
+ *
+ * Like lookups, the traversal takes no lock; the visit function must not
+ * modify the hash table, since grace periods wait for the traversal to end.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_rcu_traverse(const upo_ht_rcu_t ht, upo_ht_visitor_t visit, void* visit_arg);
+
+
+#endif /* UPO_HASHTABLE_RCU_H */
@@ -0,0 +1,181 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/hashtable_snapshot.h
+ *
+ * \brief Read-only hash table snapshots, mapped in memory from a file.
+ *
+ * A snapshot is a file holding a hash table with linear probing whose slots
+ * store the offsets (from the beginning of the file) of the key-value pairs,
+ * rather than pointers; the bytes of keys and values are stored in the file
+ * too.
+ * Thus the file is position-independent: opening it maps it in memory and
+ * checks its header, without reading, deserializing or allocating anything
+ * per key, and lookups return pointers into the mapped file.
+ * Pages are loaded by the operating system on first access and shared among
+ * all the processes mapping the same file.
+ *
+ * Keys and values must be flat objects (e.g., numbers, strings or structures
+ * without pointers), since only their bytes are saved.
+ * The hash function must not depend on the addresses of keys nor on the
+ * process, since the slots are computed when the snapshot is saved and used
+ * when it is looked up.
+ * Numbers are stored in the native byte order, and a snapshot saved on a
+ * platform with a different byte order is rejected.
+ *
+ * The file layout is:
+ * - a header of eight 64-bit words: the magic number, the byte-order mark, the
+ *   number of keys, the number of slots, the offsets of the slots and of the
+ *   records, the size of the file, and a reserved word;
+ * - the slots, one 64-bit word each, holding the offset of a record or `0` if
+ *   free;
+ * - the records, each made of the 64-bit sizes of the key and of the value,
+ *   followed by the bytes of the key and of the value, each padded to a
+ *   multiple of eight bytes (so that keys and values are suitably aligned).
+ * .
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHTABLE_SNAPSHOT_H
+#define UPO_HASHTABLE_SNAPSHOT_H
+
+
+#include <stddef.h>
+#include <upo/hashtable.h>
+
+
+/**
+ * \brief The type for functions returning the size of objects.
+ *
+ * A size function takes a pointer to a key (or to a value) and returns the
+ * number of bytes to save, e.g. `sizeof(int)` for integers or `strlen()+1` for
+ * strings.
+ */
+typedef size_t (*upo_ht_sizer_t)(const void*);
+
+/** \brief Type for hash table snapshots. */
+typedef struct upo_ht_snapshot_s* upo_ht_snapshot_t;
+
+
+/**
+ * \brief Saves a snapshot of the given hash table with linear probing.
+ *
+ * \param ht The hash table.
+ * \param path The path of the file to write (replaced if it exists).
+ * \param key_hash A pointer to the function used to hash keys; it must be the
+ *  one later passed to upo_ht_snapshot_open().
+ * \param key_size A pointer to the function returning the size of keys.
+ * \param value_size A pointer to the function returning the size of values;
+ *  `NULL` values are saved as empty values.
+ * \return `1` on success, or `0` if the file could not be written (`errno`
+ *  tells why).
+ *
+ * Worst-case complexity: linear in the number `n` of elements and in the
+ *  total size of keys and values, plus the time of probing.
+ */
+int upo_ht_linprob_save(const upo_ht_linprob_t ht, const char* path, upo_ht_hasher_t key_hash, upo_ht_sizer_t key_size, upo_ht_sizer_t value_size);
+
+/**
+ * \brief Opens a snapshot for read-only lookups.
+ *
+ * \param path The path of the snapshot file.
+ * \param key_hash A pointer to the function used to hash keys (the same used
+ *  when saving the snapshot).
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return The snapshot, or `NULL` if the file could not be mapped or is not a
+ *  valid snapshot (`errno` tells why, if a system call failed).
+ *
+ * Only the header is read: the rest of the file is loaded lazily, as it is
+ * accessed.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+upo_ht_snapshot_t upo_ht_snapshot_open(const char* path, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Closes the given snapshot, unmapping its file.
+ *
+ * \param snap The snapshot to close.
+ *
+ * Pointers returned by lookups are no longer valid afterwards.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_ht_snapshot_close(upo_ht_snapshot_t snap);
+
+/**
+ * \brief Returns the value identified by the provided key in the given
+ *  snapshot.
+ *
+ * \param snap The snapshot.
+ * \param key The key.
+ * \return A pointer to the bytes of the value in the mapped file (which must
+ *  not be modified), or `NULL` if the key is not found.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the snapshot, `O(m)`.
+ */
+const void* upo_ht_snapshot_get(const upo_ht_snapshot_t snap, const void* key);
+
+/**
+ * \brief Tells if the given snapshot contains the given key.
+ *
+ * \param snap The snapshot.
+ * \param key The key.
+ * \return `1` if the key is found, or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the snapshot, `O(m)`.
+ */
+int upo_ht_snapshot_contains(const upo_ht_snapshot_t snap, const void* key);
+
+/**
+ * \brief Returns the size of the given snapshot.
+ *
+ * \param snap The snapshot.
+ * \return The number of keys.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_snapshot_size(const upo_ht_snapshot_t snap);
+
+/**
+ * \brief Returns the capacity of the given snapshot.
+ *
+ * \param snap The snapshot.
+ * \return The number of slots.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_snapshot_capacity(const upo_ht_snapshot_t snap);
+
+/**
+ * \brief Performs a traversal of the given snapshot.
+ *
+ * \param snap The snapshot to traverse.
+ * \param visit The visit function, which must not modify keys and values.
+ * \param visit_arg An additional parameter to pass to the visit function
+ *
+ * Worst-case complexity: linear in the number `n` of elements and in the
+ *  capacity `m` of the snapshot, `O(n+m)`.
+ */
+void upo_ht_snapshot_traverse(const upo_ht_snapshot_t snap, upo_ht_visitor_t visit, void* visit_arg);
+
+
+#endif /* UPO_HASHTABLE_SNAPSHOT_H */
@@ -35,5 +35,18 @@
  */
 #define UPO_SUPPRESS_UNUSED_VARIABLE_WARNING(x) (void) (x)
 
+/**
+ * \brief Macro to hint the processor that the memory pointed by \a p is going
+ *  to be read soon, so that it can be fetched into the cache in advance.
+ *
+ * The hint is only a performance hint: it never faults, even on invalid
+ * addresses, and expands to a no-op on compilers without prefetch support.
+ */
+#if defined(__GNUC__)
+# define UPO_PREFETCH(p) __builtin_prefetch(p)
+#else
+# define UPO_PREFETCH(p) (void) (p)
+#endif
+
 
 #endif /* UPO_MACRO_H */
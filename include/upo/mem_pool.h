@@ -0,0 +1,148 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/mem_pool.h
+ *
+ * \brief The Memory Pool abstract data type.
+ *
+ * A memory pool hands out fixed-size objects carved from large blocks of
+ * memory (slabs).
+ * Released objects are kept in a free list and reused by later allocations,
+ * while all the objects of a pool can be released at once by releasing its
+ * slabs.
+ * This makes memory pools suitable for the nodes of linked data structures
+ * (e.g., lists of collisions, trees, stacks and queues), which would otherwise
+ * pay a call to `malloc()` and `free()` per node.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_MEM_POOL_H
+#define UPO_MEM_POOL_H
+
+
+#include <stddef.h>
+
+
+/** \brief Default number of objects in the first slab of a memory pool. */
+#define UPO_MEM_POOL_DEFAULT_OBJS_PER_SLAB 64U
+
+/** \brief Maximum number of objects in a slab of a memory pool. */
+#define UPO_MEM_POOL_MAX_OBJS_PER_SLAB 65536U
+
+
+/** \brief Declares the Memory Pool type. */
+typedef struct upo_mem_pool_s* upo_mem_pool_t;
+
+
+/**
+ * \brief Creates a new memory pool.
+ *
+ * \param obj_size The size (in bytes) of the objects handed out by the pool.
+ * \param objs_per_slab The number of objects in the first slab, or `0` to use
+ *  the default value #UPO_MEM_POOL_DEFAULT_OBJS_PER_SLAB.
+ * \return An empty memory pool.
+ *
+ * No slab is allocated until the first object is requested.
+ * Each new slab holds twice the objects of the previous one, up to
+ * #UPO_MEM_POOL_MAX_OBJS_PER_SLAB objects.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+upo_mem_pool_t upo_mem_pool_create(size_t obj_size, size_t objs_per_slab);
+
+/**
+ * \brief Destroys the given memory pool together with all its slabs.
+ *
+ * \param pool The memory pool to destroy.
+ *
+ * All the objects handed out by the pool become invalid.
+ *
+ * Worst-case complexity: linear in the number `s` of slabs, `O(s)`.
+ */
+void upo_mem_pool_destroy(upo_mem_pool_t pool);
+
+/**
+ * \brief Releases all the objects handed out by the given memory pool.
+ *
+ * \param pool The memory pool to clear.
+ *
+ * All the slabs are released at once, without visiting the objects; thus all
+ * the objects handed out by the pool become invalid.
+ *
+ * Worst-case complexity: linear in the number `s` of slabs, `O(s)`.
+ */
+void upo_mem_pool_clear(upo_mem_pool_t pool);
+
+/**
+ * \brief Allocates an object from the given memory pool.
+ *
+ * \param pool The memory pool.
+ * \return A pointer to an uninitialized object of the size given at creation
+ *  time, suitably aligned for integers up to `long`, `double` and pointers
+ *  (but not necessarily for `long double`, which may need a stricter
+ *  alignment).
+ *
+ * The most recently released object is reused first; otherwise, the object is
+ * carved from the current slab, and a new slab is allocated when the current
+ * one is exhausted.
+ *
+ * Worst-case complexity: constant, `O(1)` (plus the cost of a `malloc()` call
+ * once per slab).
+ */
+void* upo_mem_pool_alloc(upo_mem_pool_t pool);
+
+/**
+ * \brief Gives back an object to the given memory pool.
+ *
+ * \param pool The memory pool the object was allocated from.
+ * \param obj The object to release (may be `NULL`).
+ *
+ * The object is pushed on the free list of the pool; the memory is returned
+ * to the system only when the pool is cleared or destroyed.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_mem_pool_free(upo_mem_pool_t pool, void* obj);
+
+/**
+ * \brief Returns the number of objects currently handed out by the given
+ *  memory pool.
+ *
+ * \param pool The memory pool.
+ * \return The number of allocated and not yet released objects.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_mem_pool_size(const upo_mem_pool_t pool);
+
+/**
+ * \brief Returns the number of bytes allocated from the system by the given
+ *  memory pool.
+ *
+ * \param pool The memory pool.
+ * \return The total size (in bytes) of the slabs and of the pool itself.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_mem_pool_footprint(const upo_mem_pool_t pool);
+
+
+#endif /* UPO_MEM_POOL_H */
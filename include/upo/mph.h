@@ -0,0 +1,243 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/mph.h
+ *
+ * \brief Minimal perfect hash functions and static hash tables.
+ *
+ * A minimal perfect hash function maps each key of a set of \f$n\f$ keys,
+ * known in advance, to a distinct integer in \f$\{0,\ldots,n-1\}\f$.
+ * Keys outside the set are mapped to arbitrary integers in the same range.
+ *
+ * Functions are built as in PTHash: keys are hashed into buckets of about
+ * #UPO_MPH_BUCKET_SIZE keys each, and, for each bucket in decreasing order of
+ * size, a *pilot* is searched such that the positions of its keys, computed
+ * from their hash values and the pilot, are all free.
+ * Pilots are stored in a byte each: when none of the 256 pilots of a bucket
+ * finds free positions, the bucket takes the pilot that collides with the
+ * fewest (and smallest) buckets, which are evicted and placed again, as in
+ * PtrHash.
+ * Positions range over 1% more than \f$n\f$ slots, so that the last buckets
+ * find free slots quickly, and the positions \f$\ge n\f$ are then remapped to
+ * the free positions \f$< n\f$.
+ * Only the pilots and the (small) remapping array are stored: about 3.3 bits
+ * per key, whatever the keys are.
+ * An evaluation hashes the key, reads a pilot and, rarely, a remapped
+ * position.
+ *
+ * A static hash table stores the key-value pairs at the positions given by a
+ * minimal perfect hash function, so that a lookup probes exactly one slot.
+ *
+ * Hash functions and comparison functions follow the conventions of
+ * upo/hashtable.h; hash functions are called with #UPO_HT_HASH_FULL_RANGE, so
+ * they should mix keys over a whole word (e.g., upo_ht_hash_int_mix() or
+ * upo_ht_hash_str_xx64()).
+ *
+ * See:
+ * - G.E. Pibiri and R. Trani, "PTHash: Revisiting FCH Minimal Perfect
+ *   Hashing", SIGIR 2021.
+ * - R. Groot Koerkamp, "PtrHash: Minimal Perfect Hashing at RAM Throughput",
+ *   SEA 2025.
+ * .
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_MPH_H
+#define UPO_MPH_H
+
+
+#include <stddef.h>
+#include <upo/hashtable.h>
+
+
+/** \brief Average number of keys per bucket of minimal perfect hash functions. */
+#define UPO_MPH_BUCKET_SIZE 3U
+
+
+/*** BEGIN of MINIMAL PERFECT HASH FUNCTIONS ***/
+
+
+/** \brief Type for minimal perfect hash functions. */
+typedef struct upo_mph_s* upo_mph_t;
+
+
+/**
+ * \brief Builds a minimal perfect hash function for the given keys.
+ *
+ * \param keys The array of keys, which must be distinct.
+ * \param n The number of keys.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \return A minimal perfect hash function, or `NULL` if the keys are not
+ *  distinct or (very unlikely, with a good hash function) their hash values
+ *  collide.
+ *
+ * The keys are not referenced by the function, thus they may be freed
+ * afterwards.
+ *
+ * Worst-case complexity: expected linear in the number `n` of keys, `O(n)`.
+ */
+upo_mph_t upo_mph_build(void* const* keys, size_t n, upo_ht_hasher_t key_hash);
+
+/**
+ * \brief Destroys the given minimal perfect hash function.
+ *
+ * \param mph The minimal perfect hash function to destroy.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_mph_destroy(upo_mph_t mph);
+
+/**
+ * \brief Evaluates the given minimal perfect hash function on the given key.
+ *
+ * \param mph The minimal perfect hash function.
+ * \param key The key.
+ * \return A distinct integer in \f$\{0,\ldots,n-1\}\f$ for each key of the
+ *  set the function was built for, or an arbitrary integer in the same range
+ *  for other keys (`0` if \f$n = 0\f$).
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_mph_lookup(const upo_mph_t mph, const void* key);
+
+/**
+ * \brief Returns the number of keys of the given minimal perfect hash
+ *  function.
+ *
+ * \param mph The minimal perfect hash function.
+ * \return The number of keys.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_mph_size(const upo_mph_t mph);
+
+/**
+ * \brief Returns the memory used by the given minimal perfect hash function.
+ *
+ * \param mph The minimal perfect hash function.
+ * \return The number of bytes allocated for the function.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_mph_memory_usage(const upo_mph_t mph);
+
+
+/*** END of MINIMAL PERFECT HASH FUNCTIONS ***/
+
+
+/*** BEGIN of STATIC HASH TABLES ***/
+
+
+/** \brief Type for static hash tables. */
+typedef struct upo_mph_table_s* upo_mph_table_t;
+
+
+/**
+ * \brief Creates a static hash table holding the given key-value pairs.
+ *
+ * \param keys The array of keys, which must be distinct.
+ * \param values The array of values (\a values[i] is associated to \a keys[i]).
+ * \param n The number of key-value pairs.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return A static hash table, or `NULL` if upo_mph_build() fails.
+ *
+ * Keys and values are referenced, not copied, by the table.
+ *
+ * Worst-case complexity: expected linear in the number `n` of keys, `O(n)`.
+ */
+upo_mph_table_t upo_mph_table_build(void* const* keys, void* const* values, size_t n, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Destroys the given static hash table.
+ *
+ * \param table The static hash table to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for data,
+ *  that is stored in the hash table, must be freed (value `1`) or not (value
+ *  `0`).
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`, if
+ *  data are freed; constant, `O(1)`, otherwise.
+ */
+void upo_mph_table_destroy(upo_mph_table_t table, int destroy_data);
+
+/**
+ * \brief Returns the value identified by the provided key in the given
+ *  static hash table.
+ *
+ * \param table The static hash table.
+ * \param key The key.
+ * \return The value associated to the key, or `NULL` if the key is not found.
+ *
+ * Exactly one slot is probed, and one key compared.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void* upo_mph_table_get(const upo_mph_table_t table, const void* key);
+
+/**
+ * \brief Tells if the given static hash table contains the given key.
+ *
+ * \param table The static hash table.
+ * \param key The key.
+ * \return `1` if the key is found, or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_mph_table_contains(const upo_mph_table_t table, const void* key);
+
+/**
+ * \brief Returns the size of the given static hash table.
+ *
+ * \param table The static hash table.
+ * \return The number of keys.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_mph_table_size(const upo_mph_table_t table);
+
+/**
+ * \brief Returns the memory used by the given static hash table.
+ *
+ * \param table The static hash table.
+ * \return The number of bytes allocated for the table and its minimal perfect
+ *  hash function (keys and values excluded).
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_mph_table_memory_usage(const upo_mph_table_t table);
+
+/**
+ * \brief Performs a traversal of the given static hash table.
+ *
+ * \param table The static hash table to traverse.
+ * \param visit The visit function.
+ * \param visit_arg An additional parameter to pass to the visit function
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_mph_table_traverse(const upo_mph_table_t table, upo_ht_visitor_t visit, void* visit_arg);
+
+
+/*** END of STATIC HASH TABLES ***/
+
+
+#endif /* UPO_MPH_H */
@@ -19,9 +19,11 @@
  * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <assert.h>
 #include "bst_private.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 /**** EXERCISE #1 - BEGIN of FUNDAMENTAL OPERATIONS ****/
@@ -29,7 +31,17 @@
 
 upo_bst_t upo_bst_create(upo_bst_comparator_t key_cmp)
 {
-    upo_bst_t tree = malloc(sizeof(struct upo_bst_s));
+    return upo_bst_create_balanced(key_cmp, UPO_BST_UNBALANCED);
+}
+
+upo_bst_t upo_bst_create_balanced(upo_bst_comparator_t key_cmp, int balance)
+{
+    upo_bst_t tree = NULL;
+
+    /* preconditions */
+    assert( balance == UPO_BST_UNBALANCED || balance == UPO_BST_AVL );
+
+    tree = malloc(sizeof(struct upo_bst_s));
     if (tree == NULL)
     {
         perror("Unable to create a binary search tree");
@@ -38,6 +50,8 @@ upo_bst_t upo_bst_create(upo_bst_comparator_t key_cmp)
 
     tree->root = NULL;
     tree->key_cmp = key_cmp;
+    tree->nodes = upo_mem_pool_create(sizeof(struct upo_bst_node_s), 0);
+    tree->balance = balance;
 
     return tree;
 }
@@ -47,24 +61,29 @@ void upo_bst_destroy(upo_bst_t tree, int destroy_data)
     if (tree != NULL)
     {
         upo_bst_clear(tree, destroy_data);
+        upo_mem_pool_destroy(tree->nodes);
         free(tree);
     }
 }
 
-void upo_bst_clear_impl(upo_bst_node_t* node, int destroy_data)
+void upo_bst_clear_impl(upo_bst_node_t* node)
 {
-    if (node != NULL)
+    while (node != NULL)
     {
-        upo_bst_clear_impl(node->left, destroy_data);
-        upo_bst_clear_impl(node->right, destroy_data);
-
-        if (destroy_data)
+        if (node->left != NULL)
+        {
+            /* Move the left subtree up, until the smallest key is at the top */
+            upo_bst_node_t* left = node->left;
+            node->left = left->right;
+            left->right = node;
+            node = left;
+        }
+        else
         {
             free(node->key);
             free(node->value);
+            node = node->right;
         }
-
-        free(node);
     }
 }
 
@@ -72,21 +91,21 @@ void upo_bst_clear(upo_bst_t tree, int destroy_data)
 {
     if (tree != NULL)
     {
-        upo_bst_clear_impl(tree->root, destroy_data);
+        if (destroy_data)
+            upo_bst_clear_impl(tree->root);
+        upo_mem_pool_clear(tree->nodes);
         tree->root = NULL;
     }
 }
 
 void* upo_bst_put(upo_bst_t tree, void* key, void* value)
 {
-    void* valueOld = NULL;
-    tree->root = upo_bst_put_impl(tree->root, key, value, valueOld, tree->key_cmp);
-    return valueOld;
+    return upo_bst_put_impl(tree, key, value, 1);
 }
 
 void upo_bst_insert(upo_bst_t tree, void* key, void* value)
 {
-    tree->root = upo_bst_insert_impl(tree->root, key, value, NULL, tree->key_cmp);
+    upo_bst_put_impl(tree, key, value, 0);
 }
 
 void* upo_bst_get(const upo_bst_t tree, const void* key)
@@ -106,19 +125,22 @@ int upo_bst_contains(const upo_bst_t tree, const void* key)
 
 void upo_bst_delete(upo_bst_t tree, const void* key, int destroy_data)
 {
-    tree->root = upo_bst_delete_impl(tree->root, key, destroy_data, tree->key_cmp);
+    upo_bst_delete_impl(tree, key, destroy_data);
 }
 
 size_t upo_bst_size(const upo_bst_t tree)
 {
     if (tree == NULL)
         return 0;
-    return upo_bst_size_impl(tree->root);
+    return upo_bst_node_size(tree->root);
 }
 
 size_t upo_bst_height(const upo_bst_t tree)
 {
-    return upo_bst_height_impl(tree->root);
+    /* Heights are kept in the nodes, counting nodes rather than edges */
+    if (tree == NULL || tree->root == NULL)
+        return 0;
+    return tree->root->height - 1;
 }
 
 void upo_bst_traverse_in_order(const upo_bst_t tree, upo_bst_visitor_t visit, void* visit_arg)
@@ -133,189 +155,240 @@ int upo_bst_is_empty(const upo_bst_t tree)
     return 0;
 }
 
-static upo_bst_node_t* upo_bst_put_impl(upo_bst_node_t* root, void* key, void* value, void* valueOld, upo_bst_comparator_t key_cmp)
+static upo_bst_node_t* upo_bst_new_node(upo_mem_pool_t nodes, void* key, void* value)
 {
-    valueOld = NULL;
-    if (root == NULL)
-    {
-        root = malloc(sizeof(struct upo_bst_node_s));
-        if (root == NULL)
-        {
-            perror("Unable to create a bst node");
-            abort();
-        }
-        root->key = key;
-        root->value = value;
-        root->left = NULL;
-        root->right = NULL;
-    }
-    else if (key_cmp(key, root->key) < 0)
-    {
-        root->left = upo_bst_put_impl(root->left, key, value, valueOld, key_cmp);
-    }
-    else if (key_cmp(key, root->key) > 0)
-    {
-        root->right = upo_bst_put_impl(root->right, key, value, valueOld, key_cmp);
-    }
-    else
-    {
-        valueOld = root->value;
-        root->value = value;
-    }
-    return root;
+    upo_bst_node_t* node = upo_mem_pool_alloc(nodes);
+    node->key = key;
+    node->value = value;
+    node->left = NULL;
+    node->right = NULL;
+    node->height = 1;
+    node->size = 1;
+    return node;
 }
 
-static upo_bst_node_t* upo_bst_insert_impl(upo_bst_node_t* root, void* key, void* value, void* valueOld, upo_bst_comparator_t key_cmp)
+static void* upo_bst_put_impl(upo_bst_t tree, void* key, void* value, int replace)
 {
-    valueOld = NULL;
-    if (root == NULL)
+    upo_bst_path_t path;
+    upo_bst_node_t** link = &tree->root;
+    void* old_value = NULL;
+    upo_bst_path_init(&path);
+    while (*link != NULL)
     {
-        root = malloc(sizeof(struct upo_bst_node_s));
-        if (root == NULL)
+        int cmp = tree->key_cmp(key, (*link)->key);
+        if (cmp == 0)
         {
-            perror("Unable to create a bst node");
-            abort();
+            if (replace)
+            {
+                old_value = (*link)->value;
+                (*link)->value = value;
+            }
+            upo_bst_path_free(&path);
+            return old_value;
         }
-        root->key = key;
-        root->value = value;
-        root->left = NULL;
-        root->right = NULL;
-    }
-    else if (key_cmp(key, root->key) < 0)
-    {
-        root->left = upo_bst_insert_impl(root->left, key, value, valueOld, key_cmp);
+        upo_bst_path_push(&path, link);
+        link = (cmp < 0) ? &(*link)->left : &(*link)->right;
     }
-    else if (key_cmp(key, root->key) > 0)
-    {
-        root->right = upo_bst_insert_impl(root->right, key, value, valueOld, key_cmp);
-    }
-    return root;
+    *link = upo_bst_new_node(tree->nodes, key, value);
+    upo_bst_rebalance_path(tree, &path);
+    upo_bst_path_free(&path);
+    return NULL;
 }
 
 static upo_bst_node_t* upo_bst_get_impl(upo_bst_node_t* root, const void* key, upo_bst_comparator_t key_cmp)
 {
-    if (root == NULL)
-    {
-        return NULL;
-    }
-    else if (key_cmp(key, root->key) < 0)
-    {
-        return upo_bst_get_impl(root->left, key, key_cmp);
-    }
-    else if (key_cmp(key, root->key) > 0)
-    {
-        return upo_bst_get_impl(root->right, key, key_cmp);
-    }
-    else
+    while (root != NULL)
     {
-        return root;
+        int cmp = key_cmp(key, root->key);
+        if (cmp == 0)
+            return root;
+        root = (cmp < 0) ? root->left : root->right;
     }
+    return NULL;
 }
 
-static upo_bst_node_t* upo_bst_delete_impl(upo_bst_node_t* root, const void* key, int destroy_data, upo_bst_comparator_t key_cmp)
+static void upo_bst_delete_impl(upo_bst_t tree, const void* key, int destroy_data)
 {
-    if (root == NULL)
-        return NULL;
-    if (key_cmp(key, root->key) < 0) 
+    upo_bst_path_t path;
+    upo_bst_node_t** link = &tree->root;
+    upo_bst_node_t* node = NULL;
+    upo_bst_path_init(&path);
+    while (*link != NULL)
     {
-        root->left = upo_bst_delete_impl(root->left, key, destroy_data, key_cmp);
+        int cmp = tree->key_cmp(key, (*link)->key);
+        if (cmp == 0)
+            break;
+        upo_bst_path_push(&path, link);
+        link = (cmp < 0) ? &(*link)->left : &(*link)->right;
     }
-    else if (key_cmp(key, root->key) > 0)
-    {
-        root->right = upo_bst_delete_impl(root->right, key, destroy_data, key_cmp);
-    }
-    else if (root->left != NULL && root->right != NULL)
-    {
-        root = upo_bst_delete_2c_impl(root, key, destroy_data, key_cmp);
-    }
-    else
+    node = *link;
+    if (node != NULL)
     {
-        root = upo_bst_delete_1c_impl(root, destroy_data);
+        if (destroy_data)
+        {
+            free(node->key);
+            free(node->value);
+        }
+        if (node->left == NULL || node->right == NULL)
+        {
+            *link = (node->left != NULL) ? node->left : node->right;
+        }
+        else
+        {
+            /* Two children: the successor moves into the node, and its own
+             * node is unlinked instead */
+            upo_bst_node_t* succ = NULL;
+            upo_bst_path_push(&path, link);
+            link = &node->right;
+            while ((*link)->left != NULL)
+            {
+                upo_bst_path_push(&path, link);
+                link = &(*link)->left;
+            }
+            succ = *link;
+            node->key = succ->key;
+            node->value = succ->value;
+            *link = succ->right;
+            node = succ;
+        }
+        upo_mem_pool_free(tree->nodes, node);
+        upo_bst_rebalance_path(tree, &path);
     }
-    return root;
+    upo_bst_path_free(&path);
 }
 
-static upo_bst_node_t* upo_bst_delete_2c_impl(upo_bst_node_t* root, const void* key, int destroy_data, upo_bst_comparator_t key_cmp)
+static size_t upo_bst_node_height(const upo_bst_node_t* node)
 {
-    upo_bst_node_t* m = upo_bst_max_node_impl(root);
-    root->key = m->key;
-    root->value = m->value;
-    root->left =  upo_bst_delete_impl(root->left, key, destroy_data, key_cmp);
-    return root;
+    if (node == NULL)
+        return 0;
+    return node->height;
 }
 
-static upo_bst_node_t* upo_bst_max_node_impl(upo_bst_node_t* root)
+static size_t upo_bst_node_size(const upo_bst_node_t* node)
 {
-    if (root == NULL)
-    {
-        return NULL;
-    }
-    else if (root->right != NULL)
-    {
-        return upo_bst_max_node_impl(root->right);
-    }
-    else
-    {
-        return root;
-    }
+    if (node == NULL)
+        return 0;
+    return node->size;
 }
 
-static upo_bst_node_t* upo_bst_delete_1c_impl(upo_bst_node_t* root, int destroy_data)
+static void upo_bst_update(upo_bst_node_t* node)
 {
-    upo_bst_node_t* n = root;
-    if (root->left != NULL)
-    {
-        root = root->left;
-    } 
-    else
+    size_t left = upo_bst_node_height(node->left);
+    size_t right = upo_bst_node_height(node->right);
+    node->height = 1 + ((left > right) ? left : right);
+    node->size = 1 + upo_bst_node_size(node->left) + upo_bst_node_size(node->right);
+}
+
+static upo_bst_node_t* upo_bst_rotate_left(upo_bst_node_t* node)
+{
+    upo_bst_node_t* right = node->right;
+    node->right = right->left;
+    right->left = node;
+    upo_bst_update(node);
+    upo_bst_update(right);
+    return right;
+}
+
+static upo_bst_node_t* upo_bst_rotate_right(upo_bst_node_t* node)
+{
+    upo_bst_node_t* left = node->left;
+    node->left = left->right;
+    left->right = node;
+    upo_bst_update(node);
+    upo_bst_update(left);
+    return left;
+}
+
+static upo_bst_node_t* upo_bst_rebalance(upo_bst_t tree, upo_bst_node_t* node)
+{
+    size_t left = upo_bst_node_height(node->left);
+    size_t right = upo_bst_node_height(node->right);
+    if (tree->balance == UPO_BST_AVL)
     {
-        root = root->right;
+        if (left > right + 1)
+        {
+            /* Left-right case: turn it into a left-left one first */
+            if (upo_bst_node_height(node->left->left) < upo_bst_node_height(node->left->right))
+                node->left = upo_bst_rotate_left(node->left);
+            return upo_bst_rotate_right(node);
+        }
+        if (right > left + 1)
+        {
+            if (upo_bst_node_height(node->right->right) < upo_bst_node_height(node->right->left))
+                node->right = upo_bst_rotate_right(node->right);
+            return upo_bst_rotate_left(node);
+        }
     }
-    if (destroy_data)
+    upo_bst_update(node);
+    return node;
+}
+
+static void upo_bst_rebalance_path(upo_bst_t tree, upo_bst_path_t* path)
+{
+    while (path->size > 0)
     {
-        free(n->key);
-        free(n->value);
+        upo_bst_node_t** link = upo_bst_path_pop(path);
+        *link = upo_bst_rebalance(tree, *link);
     }
-    free(n);
-    return root;
 }
 
-static size_t upo_bst_size_impl(upo_bst_node_t* root)
+static void upo_bst_path_init(upo_bst_path_t* path)
 {
-    if (root == NULL)
-        return 0;
-    return 1 + upo_bst_size_impl(root->left) + upo_bst_size_impl(root->right);
+    path->links = path->inline_links;
+    path->size = 0;
+    path->capacity = UPO_BST_PATH_INLINE_SIZE;
 }
 
-static size_t upo_bst_height_impl(upo_bst_node_t* root)
+static void upo_bst_path_push(upo_bst_path_t* path, upo_bst_node_t** link)
 {
-    if (root == NULL || upo_bst_is_leaf_impl(root) == 1)
-        return 0;
-    return 1 + upo_bst_max_size(upo_bst_height_impl(root->left), upo_bst_height_impl(root->right));
+    if (path->size == path->capacity)
+    {
+        upo_bst_node_t*** links = malloc(2*path->capacity*sizeof(upo_bst_node_t**));
+        if (links == NULL)
+        {
+            perror("Unable to grow the path of a binary search tree");
+            abort();
+        }
+        memcpy(links, path->links, path->size*sizeof(upo_bst_node_t**));
+        upo_bst_path_free(path);
+        path->links = links;
+        path->capacity *= 2;
+    }
+    path->links[path->size++] = link;
 }
 
-static int upo_bst_is_leaf_impl(upo_bst_node_t* root)
+static upo_bst_node_t** upo_bst_path_pop(upo_bst_path_t* path)
 {
-    if (root->left == NULL && root->right == NULL)
-        return 1;
-    return 0;
+    assert( path->size > 0 );
+    return path->links[--path->size];
 }
 
-static size_t upo_bst_max_size(size_t v1, size_t v2)
+static void upo_bst_path_free(upo_bst_path_t* path)
 {
-    if (v1 > v2)
-        return v1;
-    return v2;
+    if (path->links != path->inline_links)
+        free(path->links);
 }
 
 static void upo_bst_traverse_in_order_impl(upo_bst_node_t* root, upo_bst_visitor_t visit, void* visit_arg)
 {
-    if (root != NULL)
+    upo_bst_path_t path;
+    upo_bst_node_t** link = &root;
+    upo_bst_path_init(&path);
+    for (;;)
     {
-        upo_bst_traverse_in_order_impl(root->left, visit, visit_arg);
-        visit(root->key, root->value, visit_arg);
-        upo_bst_traverse_in_order_impl(root->right, visit, visit_arg);
+        upo_bst_node_t* node = NULL;
+        while (*link != NULL)
+        {
+            upo_bst_path_push(&path, link);
+            link = &(*link)->left;
+        }
+        if (path.size == 0)
+            break;
+        node = *upo_bst_path_pop(&path);
+        visit(node->key, node->value, visit_arg);
+        link = &node->right;
     }
+    upo_bst_path_free(&path);
 }
 
 /**** EXERCISE #1 - END of FUNDAMENTAL OPERATIONS ****/
@@ -366,13 +439,15 @@ void* upo_bst_ceiling(const upo_bst_t tree, const void* key)
 
 upo_bst_key_list_t upo_bst_keys_range(const upo_bst_t tree, const void* low_key, const void* high_key)
 {
-    upo_bst_keys_range_t data;
-    data.low_key = low_key;
-    data.high_key = high_key;
-    data.key_cmp = tree->key_cmp;
-    data.key_list = NULL;
-    upo_bst_traverse_in_order(tree, upo_bst_keys_range_impl, &data);
-    return data.key_list;    
+    upo_bst_key_list_t key_list = NULL;
+    upo_bst_cursor_t cursor;
+    void* key = NULL;
+    /* Seeking skips the subtrees left of the range, and the enumeration
+     * stops at its end */
+    upo_bst_cursor_seek(tree, &cursor, low_key);
+    while (upo_bst_cursor_next(tree, &cursor, &key, NULL) && tree->key_cmp(key, high_key) <= 0)
+        upo_bst_keys_impl(key, NULL, &key_list);
+    return key_list;
 }
 
 upo_bst_key_list_t upo_bst_keys(const upo_bst_t tree)
@@ -384,79 +459,67 @@ upo_bst_key_list_t upo_bst_keys(const upo_bst_t tree)
 
 int upo_bst_is_bst(const upo_bst_t tree, const void* min_key, const void* max_key)
 {
-    int is_bst = 1;
-    upo_bst_is_bst_impl(tree->root, min_key, max_key, tree->key_cmp, &is_bst);
-    return is_bst;
+    return upo_bst_is_bst_impl(tree->root, min_key, max_key, tree->key_cmp);
 }
 
 static void* upo_bst_min_impl(upo_bst_node_t* root)
 {
     if (root == NULL)
-    {
         return NULL;
-    }
-    else if (root->left != NULL)
-    {
-        return upo_bst_min_impl(root->left);
-    }
-    else
-    {
-        return root->key;
-    }
+    while (root->left != NULL)
+        root = root->left;
+    return root->key;
 }
 
 static void* upo_bst_max_impl(upo_bst_node_t* root)
 {
     if (root == NULL)
-    {
         return NULL;
-    }
-    else if (root->right != NULL)
-    {
-        return upo_bst_max_impl(root->right);
-    }
-    else
-    {
-        return root->key;
-    }
+    while (root->right != NULL)
+        root = root->right;
+    return root->key;
 }
 
 static upo_bst_node_t* upo_bst_floor_impl(upo_bst_node_t* root, const void* key, upo_bst_comparator_t key_cmp)
 {
-    upo_bst_node_t* floor;
-    if (root == NULL)
-        return NULL;
-    if (key_cmp(key, root->key) == 0)
-        return root;
-    if (key_cmp(key, root->key) < 0)
-        return upo_bst_floor_impl(root->left, key, key_cmp);
-    floor = upo_bst_floor_impl(root->right, key, key_cmp);
-    if (floor != NULL && key_cmp(key, floor->key) >= 0)
-        return floor;
-    return root;
+    upo_bst_node_t* floor = NULL;
+    while (root != NULL)
+    {
+        int cmp = key_cmp(key, root->key);
+        if (cmp == 0)
+            return root;
+        if (cmp < 0)
+        {
+            root = root->left;
+        }
+        else
+        {
+            floor = root;
+            root = root->right;
+        }
+    }
+    return floor;
 }
 
 static upo_bst_node_t* upo_bst_ceiling_impl(upo_bst_node_t* root, const void* key, upo_bst_comparator_t key_cmp)
 {
-    upo_bst_node_t* ceil;
-    if (root == NULL)
-        return NULL;
-    if (key_cmp(key, root->key) == 0)
-        return root;
-    if (key_cmp(key, root->key) > 0)
-        return upo_bst_ceiling_impl(root->right, key, key_cmp);
-    ceil = upo_bst_ceiling_impl(root->left, key, key_cmp);
-    if (ceil != NULL && key_cmp(key, ceil->key) <= 0)
-        return ceil;
-    return root;
-}
-
-void upo_bst_keys_range_impl(void* key, void* value, void* data_args)
-{
-    upo_bst_keys_range_t* data = data_args;
-    upo_bst_comparator_t key_cmp = data->key_cmp;
-    if (key_cmp(key, data->low_key) >= 0 && key_cmp(key, data->high_key) <= 0)
-        upo_bst_keys_impl(key, value, &(data->key_list));
+    upo_bst_node_t* ceil = NULL;
+    while (root != NULL)
+    {
+        int cmp = key_cmp(key, root->key);
+        if (cmp == 0)
+            return root;
+        if (cmp > 0)
+        {
+            root = root->right;
+        }
+        else
+        {
+            ceil = root;
+            root = root->left;
+        }
+    }
+    return ceil;
 }
 
 void upo_bst_keys_impl(void* key, void* value, void* key_list)
@@ -468,19 +531,34 @@ void upo_bst_keys_impl(void* key, void* value, void* key_list)
     *list = node;
 }
 
-static void upo_bst_is_bst_impl(upo_bst_node_t* root, const void* min_key, const void* max_key, upo_bst_comparator_t key_cmp, int* is_bst)
+static int upo_bst_is_bst_impl(upo_bst_node_t* root, const void* min_key, const void* max_key, upo_bst_comparator_t key_cmp)
 {
-    if (root != NULL && *is_bst)
+    upo_bst_path_t path;
+    upo_bst_node_t** link = &root;
+    int is_bst = 1;
+    upo_bst_path_init(&path);
+    if (root != NULL)
+        upo_bst_path_push(&path, link);
+    while (is_bst && path.size > 0)
     {
-        if (key_cmp(min_key, root->key) > 0 || key_cmp(root->key, max_key) > 0)
-            *is_bst = 0;
-        if (root->left != NULL && key_cmp(root->key, root->left->key) < 0)
-            *is_bst = 0;
-        if (root->right != NULL && key_cmp(root->key, root->right->key) > 0)
-            *is_bst = 0;
-        upo_bst_is_bst_impl(root->left, min_key, max_key, key_cmp, is_bst);
-        upo_bst_is_bst_impl(root->right, min_key, max_key, key_cmp, is_bst);
+        upo_bst_node_t* node = *upo_bst_path_pop(&path);
+        if (key_cmp(min_key, node->key) > 0 || key_cmp(node->key, max_key) > 0)
+            is_bst = 0;
+        if (node->left != NULL)
+        {
+            if (key_cmp(node->key, node->left->key) < 0)
+                is_bst = 0;
+            upo_bst_path_push(&path, &node->left);
+        }
+        if (node->right != NULL)
+        {
+            if (key_cmp(node->key, node->right->key) > 0)
+                is_bst = 0;
+            upo_bst_path_push(&path, &node->right);
+        }
     }
+    upo_bst_path_free(&path);
+    return is_bst;
 }
 
 /**** EXERCISE #2 - END of EXTRA OPERATIONS ****/
@@ -498,23 +576,259 @@ upo_bst_comparator_t upo_bst_get_comparator(const upo_bst_t tree)
 
 size_t upo_bst_rank(const upo_bst_t tree, const void* key, upo_bst_comparator_t key_cmp)
 {
-    int result;
-    upo_bst_rank_t* data = NULL;
+    int found = 0;
+    if (tree == NULL)
+        return 0;
+    return upo_bst_rank_impl(tree->root, key, key_cmp, &found);
+}
+
+void* upo_bst_select(const upo_bst_t tree, size_t k)
+{
+    upo_bst_node_t* node = NULL;
+    if (tree == NULL)
+        return NULL;
+    node = tree->root;
+    while (node != NULL)
+    {
+        size_t left = upo_bst_node_size(node->left);
+        if (k < left)
+        {
+            node = node->left;
+        }
+        else if (k == left)
+        {
+            return node->key;
+        }
+        else
+        {
+            k -= left + 1;
+            node = node->right;
+        }
+    }
+    return NULL;
+}
+
+size_t upo_bst_count_range(const upo_bst_t tree, const void* low_key, const void* high_key)
+{
+    int found = 0;
+    size_t high_rank = 0;
+    if (tree == NULL || tree->key_cmp(low_key, high_key) > 0)
+        return 0;
+    high_rank = upo_bst_rank_impl(tree->root, high_key, tree->key_cmp, &found);
+    return high_rank + found - upo_bst_rank_impl(tree->root, low_key, tree->key_cmp, &found);
+}
+
+static size_t upo_bst_rank_impl(const upo_bst_node_t* root, const void* key, upo_bst_comparator_t key_cmp, int* found)
+{
+    size_t rank = 0;
+    *found = 0;
+    while (root != NULL)
+    {
+        int cmp = key_cmp(key, root->key);
+        if (cmp < 0)
+        {
+            root = root->left;
+        }
+        else if (cmp > 0)
+        {
+            /* The whole left subtree and the node precede the key */
+            rank += upo_bst_node_size(root->left) + 1;
+            root = root->right;
+        }
+        else
+        {
+            *found = 1;
+            return rank + upo_bst_node_size(root->left);
+        }
+    }
+    return rank;
+}
+
+void upo_bst_cursor_reset(const upo_bst_t tree, upo_bst_cursor_t* cursor)
+{
+    upo_bst_node_t* node = NULL;
+    assert( cursor != NULL );
+    upo_bst_cursor_reset_end(tree, cursor);
+    if (tree == NULL)
+        return;
+    for (node = tree->root; node != NULL; node = node->left)
+        upo_bst_cursor_push(cursor, node);
+    cursor->node = (cursor->depth > 0) ? cursor->path[cursor->depth-1] : NULL;
+    if (cursor->overflow)
+        cursor->node = upo_bst_next_node(tree, NULL);
+}
+
+void upo_bst_cursor_reset_end(const upo_bst_t tree, upo_bst_cursor_t* cursor)
+{
+    assert( cursor != NULL );
+    (void) tree;
+    cursor->depth = 0;
+    cursor->node = NULL;
+    cursor->overflow = 0;
+}
+
+int upo_bst_cursor_seek(const upo_bst_t tree, upo_bst_cursor_t* cursor, const void* key)
+{
+    upo_bst_node_t* node = NULL;
+    upo_bst_node_t* ceiling = NULL;
+    assert( cursor != NULL );
+    upo_bst_cursor_reset_end(tree, cursor);
     if (tree == NULL)
         return 0;
-    data = malloc(sizeof(upo_bst_rank_t));
-    data->key_cmp = key_cmp;
-    data->compare_key = key;
-    data->rank_count = 0;
-    upo_bst_traverse_in_order(tree, upo_bst_rank_impl, data);
-    result = data->rank_count;
-    free(data); 
-    return result;
+    node = tree->root;
+    while (node != NULL)
+    {
+        int cmp = tree->key_cmp(key, node->key);
+        upo_bst_cursor_push(cursor, node);
+        if (cmp == 0)
+        {
+            ceiling = node;
+            break;
+        }
+        if (cmp < 0)
+        {
+            ceiling = node;
+            node = node->left;
+        }
+        else
+        {
+            node = node->right;
+        }
+    }
+    /* The ceiling is on the path: drop the nodes below it */
+    if (!cursor->overflow)
+    {
+        while (cursor->depth > 0 && cursor->path[cursor->depth-1] != ceiling)
+            cursor->depth -= 1;
+    }
+    cursor->node = ceiling;
+    return (ceiling != NULL) ? 1 : 0;
+}
+
+int upo_bst_cursor_next(const upo_bst_t tree, upo_bst_cursor_t* cursor, void** key, void** value)
+{
+    upo_bst_node_t* node = NULL;
+    assert( cursor != NULL );
+    node = cursor->node;
+    if (tree == NULL || node == NULL)
+        return 0;
+    if (key != NULL)
+        *key = node->key;
+    if (value != NULL)
+        *value = node->value;
+    if (cursor->overflow)
+    {
+        cursor->node = upo_bst_next_node(tree, node);
+    }
+    else if (node->right != NULL)
+    {
+        /* The next key is the smallest one of the right subtree */
+        for (node = node->right; node != NULL; node = node->left)
+            upo_bst_cursor_push(cursor, node);
+        cursor->node = (cursor->overflow) ? upo_bst_next_node(tree, cursor->node) : cursor->path[cursor->depth-1];
+    }
+    else
+    {
+        /* The next key is the first ancestor reached from its left subtree */
+        cursor->depth -= 1;
+        while (cursor->depth > 0 && cursor->path[cursor->depth-1]->right == node)
+        {
+            node = cursor->path[cursor->depth-1];
+            cursor->depth -= 1;
+        }
+        cursor->node = (cursor->depth > 0) ? cursor->path[cursor->depth-1] : NULL;
+    }
+    return 1;
+}
+
+int upo_bst_cursor_prev(const upo_bst_t tree, upo_bst_cursor_t* cursor, void** key, void** value)
+{
+    upo_bst_node_t* node = NULL;
+    assert( cursor != NULL );
+    if (tree == NULL || tree->root == NULL)
+        return 0;
+    if (cursor->overflow)
+    {
+        node = upo_bst_prev_node(tree, cursor->node);
+        if (node == NULL)
+            return 0;
+    }
+    else if (cursor->node == NULL)
+    {
+        /* After the largest key: walk down to it */
+        for (node = tree->root; node != NULL; node = node->right)
+            upo_bst_cursor_push(cursor, node);
+        node = (cursor->overflow) ? upo_bst_prev_node(tree, NULL) : cursor->path[cursor->depth-1];
+    }
+    else if (cursor->node->left != NULL)
+    {
+        /* The previous key is the largest one of the left subtree */
+        for (node = cursor->node->left; node != NULL; node = node->right)
+            upo_bst_cursor_push(cursor, node);
+        node = (cursor->overflow) ? upo_bst_prev_node(tree, cursor->node) : cursor->path[cursor->depth-1];
+    }
+    else
+    {
+        /* The previous key is the first ancestor reached from its right
+         * subtree: if there is none, the cursor stays before the smallest key */
+        size_t depth = cursor->depth - 1;
+        while (depth > 0 && cursor->path[depth-1]->left == cursor->path[depth])
+            depth -= 1;
+        if (depth == 0)
+            return 0;
+        cursor->depth = depth;
+        node = cursor->path[depth-1];
+    }
+    cursor->node = node;
+    if (key != NULL)
+        *key = node->key;
+    if (value != NULL)
+        *value = node->value;
+    return 1;
+}
+
+static void upo_bst_cursor_push(upo_bst_cursor_t* cursor, upo_bst_node_t* node)
+{
+    if (cursor->depth < UPO_BST_CURSOR_MAX_DEPTH)
+        cursor->path[cursor->depth++] = node;
+    else
+        cursor->overflow = 1;
 }
 
-void upo_bst_rank_impl(void* key, void* value, void* data_args)
+static upo_bst_node_t* upo_bst_next_node(const upo_bst_t tree, const upo_bst_node_t* node)
 {
-    upo_bst_rank_t* data = data_args;
-    if (data->key_cmp(key, data->compare_key) < 0)
-        data->rank_count++;
+    upo_bst_node_t* next = NULL;
+    upo_bst_node_t* root = tree->root;
+    while (root != NULL)
+    {
+        if (node == NULL || tree->key_cmp(node->key, root->key) < 0)
+        {
+            next = root;
+            root = root->left;
+        }
+        else
+        {
+            root = root->right;
+        }
+    }
+    return next;
+}
+
+static upo_bst_node_t* upo_bst_prev_node(const upo_bst_t tree, const upo_bst_node_t* node)
+{
+    upo_bst_node_t* prev = NULL;
+    upo_bst_node_t* root = tree->root;
+    while (root != NULL)
+    {
+        if (node == NULL || tree->key_cmp(node->key, root->key) > 0)
+        {
+            prev = root;
+            root = root->right;
+        }
+        else
+        {
+            root = root->left;
+        }
+    }
+    return prev;
 }
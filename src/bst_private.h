@@ -30,6 +30,7 @@
 
 
 #include <upo/bst.h>
+#include <upo/mem_pool.h>
 
 
 /** \brief Alias for binary search tree node type. */
@@ -42,6 +43,8 @@ struct upo_bst_node_s
     void* value; /**< Pointer to user-provided value. */
     upo_bst_node_t* left; /**< Pointer to the left child node. */
     upo_bst_node_t* right; /**< Pointer to the right child node. */
+    size_t height; /**< The number of nodes of the longest path from this node down to a leaf. */
+    size_t size; /**< The number of nodes of the subtree rooted at this node. */
 };
 
 /** \brief Defines a binary tree. */
@@ -49,42 +52,173 @@ struct upo_bst_s
 {
     upo_bst_node_t* root; /**< The root of the binary tree. */
     upo_bst_comparator_t key_cmp; /**< Pointer to the key comparison function. */
+    upo_mem_pool_t nodes; /**< The pool the nodes of the tree are drawn from. */
+    int balance; /**< The balancing scheme (see #UPO_BST_AVL). */
 };
 
+/**
+ * \brief The number of links a path holds without allocating memory.
+ *
+ * AVL trees are never deeper than that (under about \f$2^{44}\f$ keys), and
+ * neither are unbalanced trees built from random keys, in practice.
+ */
+#define UPO_BST_PATH_INLINE_SIZE 64U
+
+/** \brief Alias for the type for paths. */
+typedef struct upo_bst_path_s upo_bst_path_t;
 
 /**
- * \brief Clears the subtree rooted at the given node.
+ * \brief Type for explicit stacks of links from the root of a tree down to
+ *  some node, which replace recursion.
  *
- * \param node The root of the subtree where to clear nodes.
- * \param destroy_data Tells whether the memory previously allocated for the key
- *  and the associated value must be freed (value `1`) or not (value `0`).
+ * Each link is the address of the pointer to a node (either the root of the
+ * tree or a child pointer of its parent), so that the node can be replaced
+ * in place, e.g., after a rotation.
+ */
+struct upo_bst_path_s
+{
+    upo_bst_node_t** inline_links[UPO_BST_PATH_INLINE_SIZE]; /**< The links, while they fit. */
+    upo_bst_node_t*** links; /**< The links (either `inline_links` or a heap-allocated array). */
+    size_t size; /**< The number of links. */
+    size_t capacity; /**< The number of links that fit in `links`. */
+};
+
+
+/**
+ * \brief Destroys the user data stored in the subtree rooted at the given node.
  *
- * Memory deallocation (if requested) is performed by means of the `free()`
- * standard C function.
+ * \param node The root of the subtree where to destroy data.
+ *
+ * Memory deallocation is performed by means of the `free()` standard C
+ * function.
+ * Nodes are not freed: they are given back all at once by clearing the pool
+ * they were drawn from.
+ * The subtree is flattened by right rotations on the way, which takes
+ * constant extra space.
  */
-static void upo_bst_clear_impl(upo_bst_node_t*, int destroy_data);
+static void upo_bst_clear_impl(upo_bst_node_t*);
 
-static upo_bst_node_t* upo_bst_put_impl(upo_bst_node_t* root, void* key, void* value, void* valueOld, upo_bst_comparator_t key_cmp);
+static upo_bst_node_t* upo_bst_new_node(upo_mem_pool_t nodes, void* key, void* value);
 
-static upo_bst_node_t* upo_bst_insert_impl(upo_bst_node_t* root, void* key, void* value, void* valueOld, upo_bst_comparator_t key_cmp);
+/**
+ * \brief Stores the given key-value pair in the given tree.
+ *
+ * \param tree The binary search tree.
+ * \param key The key.
+ * \param value The value.
+ * \param replace Tells whether the value of a duplicate key is replaced.
+ * \return The value of the duplicate key, if any, or `NULL` otherwise.
+ */
+static void* upo_bst_put_impl(upo_bst_t tree, void* key, void* value, int replace);
 
 static upo_bst_node_t* upo_bst_get_impl(upo_bst_node_t* root, const void* key, upo_bst_comparator_t key_cmp);
 
-static upo_bst_node_t* upo_bst_delete_impl(upo_bst_node_t* root, const void* key, int destroy_data, upo_bst_comparator_t key_cmp);
+/**
+ * \brief Removes the given key from the given tree.
+ *
+ * \param tree The binary search tree.
+ * \param key The key.
+ * \param destroy_data Tells whether the key and its value must be freed.
+ */
+static void upo_bst_delete_impl(upo_bst_t tree, const void* key, int destroy_data);
 
-static upo_bst_node_t* upo_bst_delete_2c_impl(upo_bst_node_t* root, const void* key, int destroy_data, upo_bst_comparator_t key_cmp);
+/**
+ * \brief Returns the height of the subtree rooted at the given node, in
+ *  nodes.
+ *
+ * \param node The root of the subtree (may be `NULL`).
+ * \return The number of nodes of the longest path from \a node down to a
+ *  leaf, or `0` if \a node is `NULL`.
+ */
+static size_t upo_bst_node_height(const upo_bst_node_t* node);
 
-static upo_bst_node_t* upo_bst_max_node_impl(upo_bst_node_t* root);
+/**
+ * \brief Returns the size of the subtree rooted at the given node.
+ *
+ * \param node The root of the subtree (may be `NULL`).
+ * \return The number of nodes of the subtree, or `0` if \a node is `NULL`.
+ */
+static size_t upo_bst_node_size(const upo_bst_node_t* node);
 
-static upo_bst_node_t* upo_bst_delete_1c_impl(upo_bst_node_t* root, int destroy_data);
+/**
+ * \brief Recomputes the height and the size of the given node from those of
+ *  its children.
+ *
+ * \param node The node.
+ */
+static void upo_bst_update(upo_bst_node_t* node);
 
-static size_t upo_bst_size_impl(upo_bst_node_t* root);
+/**
+ * \brief Rotates the subtree rooted at the given node to the left.
+ *
+ * \param node The root of the subtree, which must have a right child.
+ * \return The new root of the subtree (the former right child).
+ */
+static upo_bst_node_t* upo_bst_rotate_left(upo_bst_node_t* node);
 
-static size_t upo_bst_height_impl(upo_bst_node_t* root);
+/**
+ * \brief Rotates the subtree rooted at the given node to the right.
+ *
+ * \param node The root of the subtree, which must have a left child.
+ * \return The new root of the subtree (the former left child).
+ */
+static upo_bst_node_t* upo_bst_rotate_right(upo_bst_node_t* node);
 
-static int upo_bst_is_leaf_impl(upo_bst_node_t* root);
+/**
+ * \brief Updates the given node after one of its subtrees has changed, and
+ *  restores the balance of the given tree at that node.
+ *
+ * \param tree The binary search tree.
+ * \param node The node, whose subtrees must be balanced.
+ * \return The new root of the subtree rooted at \a node.
+ *
+ * With #UPO_BST_AVL, the heights of the two subtrees of each node differ by
+ * at most one; since an update changes them by at most one, one single or
+ * double rotation is enough.
+ */
+static upo_bst_node_t* upo_bst_rebalance(upo_bst_t tree, upo_bst_node_t* node);
 
-static size_t upo_bst_max_size(size_t v1, size_t v2);
+/**
+ * \brief Restores the balance of the given tree along the given path, from
+ *  the bottom up, and empties the path.
+ *
+ * \param tree The binary search tree.
+ * \param path The path to the node where the tree changed.
+ */
+static void upo_bst_rebalance_path(upo_bst_t tree, upo_bst_path_t* path);
+
+/**
+ * \brief Initializes the given empty path.
+ *
+ * \param path The path.
+ */
+static void upo_bst_path_init(upo_bst_path_t* path);
+
+/**
+ * \brief Appends the given link to the given path.
+ *
+ * \param path The path.
+ * \param link The link.
+ *
+ * Links beyond #UPO_BST_PATH_INLINE_SIZE go in an array which doubles as
+ * needed.
+ */
+static void upo_bst_path_push(upo_bst_path_t* path, upo_bst_node_t** link);
+
+/**
+ * \brief Removes the last link from the given (nonempty) path.
+ *
+ * \param path The path.
+ * \return The removed link.
+ */
+static upo_bst_node_t** upo_bst_path_pop(upo_bst_path_t* path);
+
+/**
+ * \brief Frees the memory the given path may have allocated.
+ *
+ * \param path The path.
+ */
+static void upo_bst_path_free(upo_bst_path_t* path);
 
 static void upo_bst_traverse_in_order_impl(upo_bst_node_t* root, upo_bst_visitor_t visit, void* visit_arg);
 
@@ -96,29 +230,53 @@ static upo_bst_node_t* upo_bst_floor_impl(upo_bst_node_t* root, const void* key,
 
 static upo_bst_node_t* upo_bst_ceiling_impl(upo_bst_node_t* root, const void* key, upo_bst_comparator_t key_cmp);
 
-void upo_bst_keys_range_impl(void* key, void* value, void* data_args);
-
 void upo_bst_keys_impl(void* key, void* value, void* key_list);
 
-typedef struct upo_bst_keys_range_s upo_bst_keys_range_t;
+static int upo_bst_is_bst_impl(upo_bst_node_t* root, const void* min_key, const void* max_key, upo_bst_comparator_t key_cmp);
 
-struct upo_bst_keys_range_s {
-    const void* low_key;
-    const void* high_key;
-    upo_bst_comparator_t key_cmp;
-    upo_bst_key_list_t key_list;
-};
-
-static void upo_bst_is_bst_impl(upo_bst_node_t* root, const void* min_key, const void* max_key, upo_bst_comparator_t key_cmp, int* is_bst);
+/**
+ * \brief Counts the keys less than the given key in the subtree rooted at the
+ *  given node.
+ *
+ * \param root The root of the subtree.
+ * \param key The key.
+ * \param key_cmp The key comparison function.
+ * \param found Where `1` is stored if the key is present, or `0` otherwise.
+ * \return The number of keys less than \a key.
+ */
+static size_t upo_bst_rank_impl(const upo_bst_node_t* root, const void* key, upo_bst_comparator_t key_cmp, int* found);
 
-struct upo_bst_rank_s {
-    upo_bst_comparator_t key_cmp;
-    const void* compare_key;
-    int rank_count;
-};
+/**
+ * \brief Appends the given node to the path of the given cursor.
+ *
+ * \param cursor The cursor.
+ * \param node The node.
+ *
+ * If the path is full, the cursor switches to looking for keys from the
+ * root.
+ */
+static void upo_bst_cursor_push(upo_bst_cursor_t* cursor, upo_bst_node_t* node);
 
-typedef struct upo_bst_rank_s upo_bst_rank_t;
+/**
+ * \brief Returns the node of the smallest key greater than the key of the
+ *  given node, looking for it from the root.
+ *
+ * \param tree The binary search tree.
+ * \param node The node.
+ * \return The node of the next key, or `NULL` if \a node holds the largest
+ *  key.
+ */
+static upo_bst_node_t* upo_bst_next_node(const upo_bst_t tree, const upo_bst_node_t* node);
 
-void upo_bst_rank_impl(void* key, void* value, void* data_args);
+/**
+ * \brief Returns the node of the largest key less than the key of the given
+ *  node (or the largest key, if \a node is `NULL`), looking for it from the
+ *  root.
+ *
+ * \param tree The binary search tree.
+ * \param node The node (may be `NULL`).
+ * \return The node of the previous key, or `NULL` if there is none.
+ */
+static upo_bst_node_t* upo_bst_prev_node(const upo_bst_t tree, const upo_bst_node_t* node);
 
 #endif /* UPO_BST_PRIVATE_H */
@@ -0,0 +1,928 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include "btree_private.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/bst.h>
+#include <upo/btree.h>
+#include <upo/error.h>
+#include <upo/mem_pool.h>
+
+
+/*** BEGIN of NODES ***/
+
+
+upo_btree_node_t* upo_btree_new_node(upo_btree_t tree, int leaf)
+{
+    upo_btree_node_t* node = upo_mem_pool_alloc(leaf ? tree->leaves : tree->internals);
+
+    node->n = 0;
+    node->leaf = leaf;
+
+    return node;
+}
+
+void upo_btree_free_node(upo_btree_t tree, upo_btree_node_t* node)
+{
+    upo_mem_pool_free(node->leaf ? tree->leaves : tree->internals, node);
+}
+
+size_t upo_btree_node_search(const upo_btree_t tree, const upo_btree_node_t* node, const void* key, int* found)
+{
+    size_t lo = 0;
+    size_t hi = node->n;
+
+    *found = 0;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo)/2;
+        int cmp = tree->key_cmp(key, node->keys[mid]);
+
+        if (cmp == 0)
+        {
+            *found = 1;
+            return mid;
+        }
+        if (cmp < 0)
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+
+    return lo;
+}
+
+size_t upo_btree_node_size(const upo_btree_node_t* node)
+{
+    size_t size = node->n;
+
+    if (!node->leaf)
+    {
+        size_t i;
+
+        for (i = 0; i <= node->n; ++i)
+        {
+            size += node->counts[i];
+        }
+    }
+
+    return size;
+}
+
+void upo_btree_node_insert_at(upo_btree_node_t* node, size_t i, void* key, void* value, upo_btree_node_t* right)
+{
+    /* preconditions */
+    assert( node->n < UPO_BTREE_MAX_KEYS );
+    assert( i <= node->n );
+
+    memmove(&node->keys[i+1], &node->keys[i], (node->n - i)*sizeof(void*));
+    memmove(&node->values[i+1], &node->values[i], (node->n - i)*sizeof(void*));
+    node->keys[i] = key;
+    node->values[i] = value;
+    if (!node->leaf)
+    {
+        memmove(&node->children[i+2], &node->children[i+1], (node->n - i)*sizeof(upo_btree_node_t*));
+        memmove(&node->counts[i+2], &node->counts[i+1], (node->n - i)*sizeof(size_t));
+        node->children[i+1] = right;
+        node->counts[i+1] = upo_btree_node_size(right);
+    }
+    node->n += 1;
+}
+
+void upo_btree_node_remove_at(upo_btree_node_t* node, size_t i)
+{
+    /* preconditions */
+    assert( i < node->n );
+
+    memmove(&node->keys[i], &node->keys[i+1], (node->n - i - 1)*sizeof(void*));
+    memmove(&node->values[i], &node->values[i+1], (node->n - i - 1)*sizeof(void*));
+    if (!node->leaf)
+    {
+        memmove(&node->children[i+1], &node->children[i+2], (node->n - i - 1)*sizeof(upo_btree_node_t*));
+        memmove(&node->counts[i+1], &node->counts[i+2], (node->n - i - 1)*sizeof(size_t));
+    }
+    node->n -= 1;
+}
+
+void upo_btree_split_child(upo_btree_t tree, upo_btree_node_t* parent, size_t i)
+{
+    upo_btree_node_t* left = parent->children[i];
+    upo_btree_node_t* right = upo_btree_new_node(tree, left->leaf);
+    size_t t = UPO_BTREE_MIN_DEGREE;
+
+    /* preconditions */
+    assert( left->n == UPO_BTREE_MAX_KEYS );
+
+    memcpy(right->keys, &left->keys[t], (t-1)*sizeof(void*));
+    memcpy(right->values, &left->values[t], (t-1)*sizeof(void*));
+    if (!left->leaf)
+    {
+        memcpy(right->children, &left->children[t], t*sizeof(upo_btree_node_t*));
+        memcpy(right->counts, &left->counts[t], t*sizeof(size_t));
+    }
+    right->n = t-1;
+    left->n = t-1;
+
+    upo_btree_node_insert_at(parent, i, left->keys[t-1], left->values[t-1], right);
+    parent->counts[i] -= parent->counts[i+1] + 1;
+}
+
+void upo_btree_merge_children(upo_btree_t tree, upo_btree_node_t* parent, size_t i)
+{
+    upo_btree_node_t* left = parent->children[i];
+    upo_btree_node_t* right = parent->children[i+1];
+
+    /* preconditions */
+    assert( left->n + right->n < UPO_BTREE_MAX_KEYS );
+
+    left->keys[left->n] = parent->keys[i];
+    left->values[left->n] = parent->values[i];
+    memcpy(&left->keys[left->n+1], right->keys, right->n*sizeof(void*));
+    memcpy(&left->values[left->n+1], right->values, right->n*sizeof(void*));
+    if (!left->leaf)
+    {
+        memcpy(&left->children[left->n+1], right->children, (right->n+1)*sizeof(upo_btree_node_t*));
+        memcpy(&left->counts[left->n+1], right->counts, (right->n+1)*sizeof(size_t));
+    }
+    left->n += 1 + right->n;
+
+    parent->counts[i] += 1 + parent->counts[i+1];
+    upo_btree_node_remove_at(parent, i);
+    upo_btree_free_node(tree, right);
+}
+
+size_t upo_btree_fill_child(upo_btree_t tree, upo_btree_node_t* parent, size_t i)
+{
+    upo_btree_node_t* child = parent->children[i];
+    size_t moved = 0;
+
+    if (i > 0 && parent->children[i-1]->n > UPO_BTREE_MIN_KEYS)
+    {
+        /* Rotate the largest key of the left sibling through the parent */
+        upo_btree_node_t* left = parent->children[i-1];
+
+        memmove(&child->keys[1], child->keys, child->n*sizeof(void*));
+        memmove(&child->values[1], child->values, child->n*sizeof(void*));
+        child->keys[0] = parent->keys[i-1];
+        child->values[0] = parent->values[i-1];
+        if (!child->leaf)
+        {
+            memmove(&child->children[1], child->children, (child->n+1)*sizeof(upo_btree_node_t*));
+            memmove(&child->counts[1], child->counts, (child->n+1)*sizeof(size_t));
+            child->children[0] = left->children[left->n];
+            child->counts[0] = left->counts[left->n];
+            moved = child->counts[0];
+        }
+        child->n += 1;
+        parent->keys[i-1] = left->keys[left->n-1];
+        parent->values[i-1] = left->values[left->n-1];
+        left->n -= 1;
+
+        parent->counts[i-1] -= 1 + moved;
+        parent->counts[i] += 1 + moved;
+        return i;
+    }
+    if (i < parent->n && parent->children[i+1]->n > UPO_BTREE_MIN_KEYS)
+    {
+        /* Rotate the smallest key of the right sibling through the parent */
+        upo_btree_node_t* right = parent->children[i+1];
+
+        child->keys[child->n] = parent->keys[i];
+        child->values[child->n] = parent->values[i];
+        if (!child->leaf)
+        {
+            child->children[child->n+1] = right->children[0];
+            child->counts[child->n+1] = right->counts[0];
+            moved = right->counts[0];
+            memmove(right->children, &right->children[1], right->n*sizeof(upo_btree_node_t*));
+            memmove(right->counts, &right->counts[1], right->n*sizeof(size_t));
+        }
+        child->n += 1;
+        parent->keys[i] = right->keys[0];
+        parent->values[i] = right->values[0];
+        memmove(right->keys, &right->keys[1], (right->n-1)*sizeof(void*));
+        memmove(right->values, &right->values[1], (right->n-1)*sizeof(void*));
+        right->n -= 1;
+
+        parent->counts[i+1] -= 1 + moved;
+        parent->counts[i] += 1 + moved;
+        return i;
+    }
+
+    /* Both siblings hold the minimum number of keys: merge with one */
+    if (i < parent->n)
+    {
+        upo_btree_merge_children(tree, parent, i);
+        return i;
+    }
+    upo_btree_merge_children(tree, parent, i-1);
+    return i-1;
+}
+
+
+/*** END of NODES ***/
+
+
+/*** BEGIN of B-TREE ***/
+
+
+upo_btree_t upo_btree_create(upo_bst_comparator_t key_cmp)
+{
+    upo_btree_t tree = NULL;
+
+    /* preconditions */
+    assert( key_cmp != NULL );
+
+    tree = malloc(sizeof(struct upo_btree_s));
+    if (tree == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the B-Tree");
+    }
+
+    tree->root = NULL;
+    tree->size = 0;
+    tree->height = 0;
+    tree->key_cmp = key_cmp;
+    /* Leaves, which are most of the nodes, have no children */
+    tree->leaves = upo_mem_pool_create(offsetof(upo_btree_node_t, counts), 0);
+    tree->internals = upo_mem_pool_create(sizeof(upo_btree_node_t), 0);
+
+    return tree;
+}
+
+void upo_btree_destroy(upo_btree_t tree, int destroy_data)
+{
+    if (tree != NULL)
+    {
+        upo_btree_clear(tree, destroy_data);
+        upo_mem_pool_destroy(tree->leaves);
+        upo_mem_pool_destroy(tree->internals);
+        free(tree);
+    }
+}
+
+void upo_btree_clear(upo_btree_t tree, int destroy_data)
+{
+    if (tree != NULL)
+    {
+        if (destroy_data)
+        {
+            upo_btree_iter_t iter;
+            void* key = NULL;
+            void* value = NULL;
+
+            upo_btree_iter_seek(tree, &iter, NULL);
+            while (upo_btree_iter_next(&iter, &key, &value))
+            {
+                free(key);
+                free(value);
+            }
+        }
+        upo_mem_pool_clear(tree->leaves);
+        upo_mem_pool_clear(tree->internals);
+        tree->root = NULL;
+        tree->size = 0;
+        tree->height = 0;
+    }
+}
+
+void* upo_btree_put(upo_btree_t tree, void* key, void* value)
+{
+    return upo_btree_put_impl(tree, key, value, 1);
+}
+
+void upo_btree_insert(upo_btree_t tree, void* key, void* value)
+{
+    upo_btree_put_impl(tree, key, value, 0);
+}
+
+void* upo_btree_put_impl(upo_btree_t tree, void* key, void* value, int replace)
+{
+    upo_btree_node_t* path[UPO_BTREE_MAX_DEPTH];
+    size_t index[UPO_BTREE_MAX_DEPTH];
+    size_t depth = 0;
+    upo_btree_node_t* node = NULL;
+    size_t d;
+
+    /* preconditions */
+    assert( tree != NULL );
+
+    if (tree->root == NULL)
+    {
+        tree->root = upo_btree_new_node(tree, 1);
+    }
+    else if (tree->root->n == UPO_BTREE_MAX_KEYS)
+    {
+        /* Splitting the root is the only way the tree grows taller */
+        node = upo_btree_new_node(tree, 0);
+        node->children[0] = tree->root;
+        node->counts[0] = tree->size;
+        upo_btree_split_child(tree, node, 0);
+        tree->root = node;
+        tree->height += 1;
+    }
+
+    /* Full nodes are split on the way down, so that there is always room for
+     * the key moved up by a split */
+    node = tree->root;
+    for (;;)
+    {
+        int found = 0;
+        size_t i = upo_btree_node_search(tree, node, key, &found);
+
+        if (!found && !node->leaf && node->children[i]->n == UPO_BTREE_MAX_KEYS)
+        {
+            int cmp = 0;
+
+            upo_btree_split_child(tree, node, i);
+            cmp = tree->key_cmp(key, node->keys[i]);
+            found = (cmp == 0);
+            if (cmp > 0)
+            {
+                ++i;
+            }
+        }
+        if (found)
+        {
+            void* old_value = NULL;
+
+            if (replace)
+            {
+                old_value = node->values[i];
+                node->values[i] = value;
+            }
+            return old_value;
+        }
+        if (node->leaf)
+        {
+            upo_btree_node_insert_at(node, i, key, value, NULL);
+            break;
+        }
+        assert( depth < UPO_BTREE_MAX_DEPTH );
+        path[depth] = node;
+        index[depth] = i;
+        ++depth;
+        node = node->children[i];
+    }
+
+    for (d = 0; d < depth; ++d)
+    {
+        path[d]->counts[index[d]] += 1;
+    }
+    tree->size += 1;
+
+    return NULL;
+}
+
+upo_bst_comparator_t upo_btree_get_comparator(const upo_btree_t tree)
+{
+    if (tree == NULL)
+    {
+        return NULL;
+    }
+
+    return tree->key_cmp;
+}
+
+void* upo_btree_get(const upo_btree_t tree, const void* key)
+{
+    upo_btree_node_t* node = NULL;
+
+    if (tree == NULL)
+    {
+        return NULL;
+    }
+
+    node = tree->root;
+    while (node != NULL)
+    {
+        int found = 0;
+        size_t i = upo_btree_node_search(tree, node, key, &found);
+
+        if (found)
+        {
+            return node->values[i];
+        }
+        node = node->leaf ? NULL : node->children[i];
+    }
+
+    return NULL;
+}
+
+int upo_btree_contains(const upo_btree_t tree, const void* key)
+{
+    upo_btree_node_t* node = NULL;
+
+    if (tree == NULL)
+    {
+        return 0;
+    }
+
+    node = tree->root;
+    while (node != NULL)
+    {
+        int found = 0;
+        size_t i = upo_btree_node_search(tree, node, key, &found);
+
+        if (found)
+        {
+            return 1;
+        }
+        node = node->leaf ? NULL : node->children[i];
+    }
+
+    return 0;
+}
+
+void upo_btree_delete(upo_btree_t tree, const void* key, int destroy_data)
+{
+    if (tree != NULL && tree->root != NULL)
+    {
+        upo_btree_delete_impl(tree, key, destroy_data);
+    }
+}
+
+void upo_btree_delete_impl(upo_btree_t tree, const void* key, int destroy_data)
+{
+    upo_btree_node_t* path[UPO_BTREE_MAX_DEPTH];
+    size_t index[UPO_BTREE_MAX_DEPTH];
+    size_t depth = 0;
+    upo_btree_node_t* node = tree->root;
+    /* Set once the key is replaced by its predecessor or successor, which is
+     * then unlinked from below without being freed */
+    int moved = 0;
+    int removed = 0;
+    size_t d;
+
+    /* Every child is given more than the minimum number of keys before going
+     * down to it, so that removing a key from it never needs going back up */
+    for (;;)
+    {
+        int found = 0;
+        size_t i = upo_btree_node_search(tree, node, key, &found);
+
+        if (node->leaf)
+        {
+            if (found)
+            {
+                if (destroy_data && !moved)
+                {
+                    free(node->keys[i]);
+                    free(node->values[i]);
+                }
+                upo_btree_node_remove_at(node, i);
+                removed = 1;
+            }
+            break;
+        }
+
+        if (found && node->children[i]->n > UPO_BTREE_MIN_KEYS)
+        {
+            /* Replace the key with its predecessor, then unlink that */
+            upo_btree_node_t* pred = node->children[i];
+
+            while (!pred->leaf)
+            {
+                pred = pred->children[pred->n];
+            }
+            if (destroy_data && !moved)
+            {
+                free(node->keys[i]);
+                free(node->values[i]);
+            }
+            node->keys[i] = pred->keys[pred->n-1];
+            node->values[i] = pred->values[pred->n-1];
+            key = node->keys[i];
+            moved = 1;
+        }
+        else if (found && node->children[i+1]->n > UPO_BTREE_MIN_KEYS)
+        {
+            /* Replace the key with its successor, then unlink that */
+            upo_btree_node_t* succ = node->children[i+1];
+
+            while (!succ->leaf)
+            {
+                succ = succ->children[0];
+            }
+            if (destroy_data && !moved)
+            {
+                free(node->keys[i]);
+                free(node->values[i]);
+            }
+            node->keys[i] = succ->keys[0];
+            node->values[i] = succ->values[0];
+            key = node->keys[i];
+            moved = 1;
+            ++i;
+        }
+        else if (found)
+        {
+            /* Push the key down into the merge of its two children */
+            upo_btree_merge_children(tree, node, i);
+        }
+        else if (node->children[i]->n == UPO_BTREE_MIN_KEYS)
+        {
+            i = upo_btree_fill_child(tree, node, i);
+        }
+
+        if (node == tree->root && node->n == 0)
+        {
+            /* A merge took the last key of the root */
+            tree->root = node->children[0];
+            upo_btree_free_node(tree, node);
+            tree->height -= 1;
+            node = tree->root;
+            continue;
+        }
+        assert( depth < UPO_BTREE_MAX_DEPTH );
+        path[depth] = node;
+        index[depth] = i;
+        ++depth;
+        node = node->children[i];
+    }
+
+    if (removed)
+    {
+        for (d = 0; d < depth; ++d)
+        {
+            path[d]->counts[index[d]] -= 1;
+        }
+        tree->size -= 1;
+    }
+    if (tree->root->n == 0)
+    {
+        upo_btree_free_node(tree, tree->root);
+        tree->root = NULL;
+    }
+}
+
+size_t upo_btree_size(const upo_btree_t tree)
+{
+    return (tree != NULL) ? tree->size : 0;
+}
+
+int upo_btree_is_empty(const upo_btree_t tree)
+{
+    return upo_btree_size(tree) == 0 ? 1 : 0;
+}
+
+size_t upo_btree_height(const upo_btree_t tree)
+{
+    return (tree != NULL) ? tree->height : 0;
+}
+
+void upo_btree_traverse_in_order(const upo_btree_t tree, upo_bst_visitor_t visit, void* visit_arg)
+{
+    upo_btree_iter_t iter;
+    void* key = NULL;
+    void* value = NULL;
+
+    upo_btree_iter_seek(tree, &iter, NULL);
+    while (upo_btree_iter_next(&iter, &key, &value))
+    {
+        visit(key, value, visit_arg);
+    }
+}
+
+void* upo_btree_min(const upo_btree_t tree)
+{
+    upo_btree_node_t* node = NULL;
+
+    if (tree == NULL || tree->root == NULL)
+    {
+        return NULL;
+    }
+
+    node = tree->root;
+    while (!node->leaf)
+    {
+        node = node->children[0];
+    }
+
+    return node->keys[0];
+}
+
+void* upo_btree_max(const upo_btree_t tree)
+{
+    upo_btree_node_t* node = NULL;
+
+    if (tree == NULL || tree->root == NULL)
+    {
+        return NULL;
+    }
+
+    node = tree->root;
+    while (!node->leaf)
+    {
+        node = node->children[node->n];
+    }
+
+    return node->keys[node->n-1];
+}
+
+void upo_btree_delete_min(upo_btree_t tree, int destroy_data)
+{
+    upo_btree_delete(tree, upo_btree_min(tree), destroy_data);
+}
+
+void upo_btree_delete_max(upo_btree_t tree, int destroy_data)
+{
+    upo_btree_delete(tree, upo_btree_max(tree), destroy_data);
+}
+
+void* upo_btree_floor(const upo_btree_t tree, const void* key)
+{
+    upo_btree_node_t* node = NULL;
+    void* floor = NULL;
+
+    if (tree == NULL)
+    {
+        return NULL;
+    }
+
+    node = tree->root;
+    while (node != NULL)
+    {
+        int found = 0;
+        size_t i = upo_btree_node_search(tree, node, key, &found);
+
+        if (found)
+        {
+            return node->keys[i];
+        }
+        if (i > 0)
+        {
+            floor = node->keys[i-1];
+        }
+        node = node->leaf ? NULL : node->children[i];
+    }
+
+    return floor;
+}
+
+void* upo_btree_ceiling(const upo_btree_t tree, const void* key)
+{
+    upo_btree_node_t* node = NULL;
+    void* ceiling = NULL;
+
+    if (tree == NULL)
+    {
+        return NULL;
+    }
+
+    node = tree->root;
+    while (node != NULL)
+    {
+        int found = 0;
+        size_t i = upo_btree_node_search(tree, node, key, &found);
+
+        if (found)
+        {
+            return node->keys[i];
+        }
+        if (i < node->n)
+        {
+            ceiling = node->keys[i];
+        }
+        node = node->leaf ? NULL : node->children[i];
+    }
+
+    return ceiling;
+}
+
+upo_bst_key_list_t upo_btree_keys_range(const upo_btree_t tree, const void* low_key, const void* high_key)
+{
+    upo_bst_key_list_t key_list = NULL;
+    upo_btree_iter_t iter;
+    void* key = NULL;
+    void* value = NULL;
+
+    if (tree == NULL)
+    {
+        return NULL;
+    }
+
+    upo_btree_iter_seek(tree, &iter, low_key);
+    while (upo_btree_iter_next(&iter, &key, &value) && tree->key_cmp(key, high_key) <= 0)
+    {
+        upo_btree_key_list_push(&key_list, key);
+    }
+
+    return key_list;
+}
+
+upo_bst_key_list_t upo_btree_keys(const upo_btree_t tree)
+{
+    upo_bst_key_list_t key_list = NULL;
+    upo_btree_iter_t iter;
+    void* key = NULL;
+    void* value = NULL;
+
+    upo_btree_iter_seek(tree, &iter, NULL);
+    while (upo_btree_iter_next(&iter, &key, &value))
+    {
+        upo_btree_key_list_push(&key_list, key);
+    }
+
+    return key_list;
+}
+
+size_t upo_btree_rank(const upo_btree_t tree, const void* key)
+{
+    int found = 0;
+
+    if (tree == NULL)
+    {
+        return 0;
+    }
+
+    return upo_btree_rank_impl(tree, key, &found);
+}
+
+void* upo_btree_select(const upo_btree_t tree, size_t k)
+{
+    upo_btree_node_t* node = NULL;
+
+    if (tree == NULL || k >= tree->size)
+    {
+        return NULL;
+    }
+
+    node = tree->root;
+    while (!node->leaf)
+    {
+        size_t i = 0;
+
+        /* Skip the children (and the keys after them) which come before */
+        while (k >= node->counts[i])
+        {
+            k -= node->counts[i];
+            if (k == 0)
+            {
+                return node->keys[i];
+            }
+            k -= 1;
+            ++i;
+        }
+        node = node->children[i];
+    }
+
+    return node->keys[k];
+}
+
+size_t upo_btree_count_range(const upo_btree_t tree, const void* low_key, const void* high_key)
+{
+    int found = 0;
+    size_t high_rank = 0;
+
+    if (tree == NULL || tree->key_cmp(low_key, high_key) > 0)
+    {
+        return 0;
+    }
+
+    high_rank = upo_btree_rank_impl(tree, high_key, &found);
+
+    return high_rank + found - upo_btree_rank_impl(tree, low_key, &found);
+}
+
+size_t upo_btree_rank_impl(const upo_btree_t tree, const void* key, int* found)
+{
+    upo_btree_node_t* node = tree->root;
+    size_t rank = 0;
+
+    *found = 0;
+    while (node != NULL)
+    {
+        size_t i = upo_btree_node_search(tree, node, key, found);
+        size_t j;
+
+        /* The keys before position i, and the children before and at it if
+         * the key is there (or before it otherwise) */
+        rank += i;
+        if (!node->leaf)
+        {
+            for (j = 0; j < i; ++j)
+            {
+                rank += node->counts[j];
+            }
+            if (*found)
+            {
+                rank += node->counts[i];
+            }
+        }
+        if (*found || node->leaf)
+        {
+            break;
+        }
+        node = node->children[i];
+    }
+
+    return rank;
+}
+
+void upo_btree_iter_seek(const upo_btree_t tree, upo_btree_iter_t* iter, const void* key)
+{
+    upo_btree_node_t* node = NULL;
+
+    iter->depth = 0;
+    node = (tree != NULL) ? tree->root : NULL;
+    while (node != NULL)
+    {
+        int found = 0;
+        size_t i = (key != NULL) ? upo_btree_node_search(tree, node, key, &found) : 0;
+
+        assert( iter->depth < UPO_BTREE_MAX_DEPTH );
+        iter->nodes[iter->depth] = node;
+        iter->index[iter->depth] = i;
+        iter->depth += 1;
+        node = (found || node->leaf) ? NULL : node->children[i];
+    }
+    /* Nodes whose keys all come before the given one are done with */
+    while (iter->depth > 0 && iter->index[iter->depth-1] == iter->nodes[iter->depth-1]->n)
+    {
+        iter->depth -= 1;
+    }
+}
+
+int upo_btree_iter_next(upo_btree_iter_t* iter, void** key, void** value)
+{
+    upo_btree_node_t* node = NULL;
+    size_t i = 0;
+
+    if (iter->depth == 0)
+    {
+        return 0;
+    }
+
+    node = iter->nodes[iter->depth-1];
+    i = iter->index[iter->depth-1];
+    *key = node->keys[i];
+    *value = node->values[i];
+
+    /* The next key is the smallest one of the following child, if any */
+    iter->index[iter->depth-1] = i+1;
+    if (!node->leaf)
+    {
+        node = node->children[i+1];
+        for (;;)
+        {
+            assert( iter->depth < UPO_BTREE_MAX_DEPTH );
+            iter->nodes[iter->depth] = node;
+            iter->index[iter->depth] = 0;
+            iter->depth += 1;
+            if (node->leaf)
+            {
+                break;
+            }
+            node = node->children[0];
+        }
+    }
+    while (iter->depth > 0 && iter->index[iter->depth-1] == iter->nodes[iter->depth-1]->n)
+    {
+        iter->depth -= 1;
+    }
+
+    return 1;
+}
+
+void upo_btree_key_list_push(upo_bst_key_list_t* key_list, void* key)
+{
+    upo_bst_key_list_node_t* node = malloc(sizeof(upo_bst_key_list_node_t));
+
+    if (node == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for a list of keys");
+    }
+
+    node->key = key;
+    node->next = *key_list;
+    *key_list = node;
+}
+
+
+/*** END of B-TREE ***/
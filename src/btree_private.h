@@ -0,0 +1,253 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/btree_private.h
+ *
+ * \brief Private header for the B-Tree ordered map abstract data type.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_BTREE_PRIVATE_H
+#define UPO_BTREE_PRIVATE_H
+
+
+#include <stddef.h>
+#include <upo/bst.h>
+#include <upo/btree.h>
+#include <upo/mem_pool.h>
+
+
+/** \brief The maximum number of keys of a node. */
+#define UPO_BTREE_MAX_KEYS (2*UPO_BTREE_MIN_DEGREE-1)
+
+/** \brief The minimum number of keys of a node other than the root. */
+#define UPO_BTREE_MIN_KEYS (UPO_BTREE_MIN_DEGREE-1)
+
+/**
+ * \brief The maximum number of nodes of a path from the root down to a leaf.
+ *
+ * Since every internal node but the root has at least two children, this is
+ * more than enough for any number of keys that fits in memory.
+ */
+#define UPO_BTREE_MAX_DEPTH 64U
+
+
+/** \brief Alias for the type for nodes of B-trees. */
+typedef struct upo_btree_node_s upo_btree_node_t;
+
+/**
+ * \brief Type for nodes of B-trees.
+ *
+ * Leaves are allocated without the trailing arrays of children and counts,
+ * which only internal nodes use.
+ */
+struct upo_btree_node_s
+{
+    size_t n; /**< The number of keys. */
+    int leaf; /**< Tells whether the node is a leaf. */
+    void* keys[UPO_BTREE_MAX_KEYS]; /**< The keys, in increasing order. */
+    void* values[UPO_BTREE_MAX_KEYS]; /**< The values associated to the keys. */
+    size_t counts[UPO_BTREE_MAX_KEYS+1]; /**< The number of keys under each child. */
+    upo_btree_node_t* children[UPO_BTREE_MAX_KEYS+1]; /**< The children: `children[i]` holds the keys between `keys[i-1]` and `keys[i]`. */
+};
+
+/** \brief Type for B-trees. */
+struct upo_btree_s
+{
+    upo_btree_node_t* root; /**< The root (`NULL` if the tree is empty). */
+    size_t size; /**< The number of keys. */
+    size_t height; /**< The number of edges from the root down to the leaves. */
+    upo_bst_comparator_t key_cmp; /**< The key comparison function. */
+    upo_mem_pool_t leaves; /**< The pool the leaves are drawn from. */
+    upo_mem_pool_t internals; /**< The pool the internal nodes are drawn from. */
+};
+
+/**
+ * \brief Type for in-order iterators over B-trees.
+ *
+ * The iterator keeps the path from the root down to the node of the next key:
+ * `index[d]` is the position in `nodes[d]` of the next key to yield from it.
+ */
+struct upo_btree_iter_s
+{
+    upo_btree_node_t* nodes[UPO_BTREE_MAX_DEPTH]; /**< The nodes of the path. */
+    size_t index[UPO_BTREE_MAX_DEPTH]; /**< The positions of the next keys in the nodes. */
+    size_t depth; /**< The number of nodes of the path (`0` after the last key). */
+};
+/** \brief Alias for the type for iterators over B-trees. */
+typedef struct upo_btree_iter_s upo_btree_iter_t;
+
+
+/**
+ * \brief Creates a new node with no keys.
+ *
+ * \param tree The B-tree.
+ * \param leaf Tells whether the node is a leaf.
+ * \return The new node.
+ */
+static upo_btree_node_t* upo_btree_new_node(upo_btree_t tree, int leaf);
+
+/**
+ * \brief Gives the given node back to the pool it was drawn from.
+ *
+ * \param tree The B-tree.
+ * \param node The node.
+ */
+static void upo_btree_free_node(upo_btree_t tree, upo_btree_node_t* node);
+
+/**
+ * \brief Looks for the given key among the keys of the given node, by binary
+ *  search.
+ *
+ * \param tree The B-tree.
+ * \param node The node.
+ * \param key The key.
+ * \param found Where `1` is stored if the key is in the node, or `0`
+ *  otherwise.
+ * \return The position of the key, if found, or of the first greater key
+ *  (which is also the child where to look for the key) otherwise.
+ */
+static size_t upo_btree_node_search(const upo_btree_t tree, const upo_btree_node_t* node, const void* key, int* found);
+
+/**
+ * \brief Returns the number of keys of the subtree rooted at the given node.
+ *
+ * \param node The node.
+ * \return The number of keys of the subtree.
+ */
+static size_t upo_btree_node_size(const upo_btree_node_t* node);
+
+/**
+ * \brief Inserts a key, its value and the child on its right into the given
+ *  node, at the given position.
+ *
+ * \param node The node, which must not be full.
+ * \param i The position.
+ * \param key The key.
+ * \param value The value.
+ * \param right The child following the key (ignored for leaves).
+ */
+static void upo_btree_node_insert_at(upo_btree_node_t* node, size_t i, void* key, void* value, upo_btree_node_t* right);
+
+/**
+ * \brief Removes a key, its value and the child on its right from the given
+ *  node, at the given position.
+ *
+ * \param node The node.
+ * \param i The position.
+ */
+static void upo_btree_node_remove_at(upo_btree_node_t* node, size_t i);
+
+/**
+ * \brief Splits the given full child of the given node in two halves, moving
+ *  its middle key up.
+ *
+ * \param tree The B-tree.
+ * \param parent The parent, which must not be full.
+ * \param i The position of the child.
+ */
+static void upo_btree_split_child(upo_btree_t tree, upo_btree_node_t* parent, size_t i);
+
+/**
+ * \brief Merges two adjacent children of the given node, together with the
+ *  key between them.
+ *
+ * \param tree The B-tree.
+ * \param parent The parent.
+ * \param i The position of the left child; the right one is freed.
+ */
+static void upo_btree_merge_children(upo_btree_t tree, upo_btree_node_t* parent, size_t i);
+
+/**
+ * \brief Makes the given child of the given node hold more than the minimum
+ *  number of keys, by moving a key from a sibling or by merging it with one.
+ *
+ * \param tree The B-tree.
+ * \param parent The parent.
+ * \param i The position of the child.
+ * \return The position of the child holding its former keys (it changes if
+ *  the child is merged into its left sibling).
+ */
+static size_t upo_btree_fill_child(upo_btree_t tree, upo_btree_node_t* parent, size_t i);
+
+/**
+ * \brief Stores the given key-value pair, splitting the full nodes met on the
+ *  way down.
+ *
+ * \param tree The B-tree.
+ * \param key The key.
+ * \param value The value.
+ * \param replace Tells whether the value of a duplicate key is replaced.
+ * \return The value of the duplicate key, if replaced, or `NULL` otherwise.
+ */
+static void* upo_btree_put_impl(upo_btree_t tree, void* key, void* value, int replace);
+
+/**
+ * \brief Removes the given key, if present, and the root if it is left
+ *  without keys.
+ *
+ * \param tree The B-tree.
+ * \param key The key.
+ * \param destroy_data Tells whether the key and its value must be freed.
+ */
+static void upo_btree_delete_impl(upo_btree_t tree, const void* key, int destroy_data);
+
+/**
+ * \brief Counts the keys less than the given key.
+ *
+ * \param tree The B-tree.
+ * \param key The key.
+ * \param found Where `1` is stored if the key is present, or `0` otherwise.
+ * \return The number of keys less than \a key.
+ */
+static size_t upo_btree_rank_impl(const upo_btree_t tree, const void* key, int* found);
+
+/**
+ * \brief Places the given iterator before the smallest key greater than or
+ *  equal to the given key.
+ *
+ * \param tree The B-tree.
+ * \param iter The iterator.
+ * \param key The key, or `NULL` to place the iterator before the smallest key.
+ */
+static void upo_btree_iter_seek(const upo_btree_t tree, upo_btree_iter_t* iter, const void* key);
+
+/**
+ * \brief Moves the given iterator past the next key.
+ *
+ * \param iter The iterator.
+ * \param key Where the key is stored.
+ * \param value Where the value is stored.
+ * \return `1` if a key was found, or `0` if the iterator is after the
+ *  largest key.
+ */
+static int upo_btree_iter_next(upo_btree_iter_t* iter, void** key, void** value);
+
+/**
+ * \brief Prepends the given key to the given list of keys.
+ *
+ * \param key_list The list.
+ * \param key The key.
+ */
+static void upo_btree_key_list_push(upo_bst_key_list_t* key_list, void* key);
+
+
+#endif /* UPO_BTREE_PRIVATE_H */
@@ -0,0 +1,510 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include "cache_private.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+#include <upo/mem_pool.h>
+
+
+upo_cache_t upo_cache_create(int policy, size_t capacity, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_cache_t cache = NULL;
+
+    /* preconditions */
+    assert( policy == UPO_CACHE_LRU || policy == UPO_CACHE_CLOCK || policy == UPO_CACHE_S3FIFO );
+    assert( capacity > 0 );
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
+
+    cache = malloc(sizeof(struct upo_cache_s));
+    if (cache == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the Cache");
+    }
+    cache->buckets = calloc(UPO_CACHE_INITIAL_BUCKETS, sizeof(upo_cache_entry_t*));
+    if (cache->buckets == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the index of the Cache");
+    }
+
+    cache->policy = policy;
+    cache->capacity = capacity;
+    cache->small_capacity = capacity/100*UPO_CACHE_S3FIFO_SMALL_PERCENT + capacity%100*UPO_CACHE_S3FIFO_SMALL_PERCENT/100;
+    if (cache->small_capacity == 0)
+    {
+        cache->small_capacity = 1;
+    }
+    memset(cache->queues, 0, sizeof(cache->queues));
+    cache->num_buckets = UPO_CACHE_INITIAL_BUCKETS;
+    cache->num_indexed = 0;
+    cache->key_hash = key_hash;
+    cache->key_cmp = key_cmp;
+    cache->entries = upo_mem_pool_create(sizeof(upo_cache_entry_t), 0);
+    cache->evict = NULL;
+    cache->evict_arg = NULL;
+    upo_cache_reset_stats(cache);
+
+    return cache;
+}
+
+void upo_cache_destroy(upo_cache_t cache, int destroy_data)
+{
+    if (cache != NULL)
+    {
+        upo_cache_clear(cache, destroy_data);
+        upo_mem_pool_destroy(cache->entries);
+        free(cache->buckets);
+        free(cache);
+    }
+}
+
+void upo_cache_clear(upo_cache_t cache, int destroy_data)
+{
+    if (cache != NULL)
+    {
+        if (destroy_data)
+        {
+            upo_cache_entry_t* entry = NULL;
+
+            for (entry = cache->queues[UPO_CACHE_MAIN].head; entry != NULL; entry = entry->next)
+            {
+                free(entry->key);
+                free(entry->value);
+            }
+            for (entry = cache->queues[UPO_CACHE_SMALL].head; entry != NULL; entry = entry->next)
+            {
+                free(entry->key);
+                free(entry->value);
+            }
+        }
+        /* Entries are all given back at once by clearing their pool */
+        memset(cache->buckets, 0, cache->num_buckets*sizeof(upo_cache_entry_t*));
+        memset(cache->queues, 0, sizeof(cache->queues));
+        cache->num_indexed = 0;
+        upo_mem_pool_clear(cache->entries);
+    }
+}
+
+void upo_cache_set_evict_callback(upo_cache_t cache, upo_cache_evict_callback_t callback, void* arg)
+{
+    /* preconditions */
+    assert( cache != NULL );
+
+    cache->evict = callback;
+    cache->evict_arg = arg;
+}
+
+void* upo_cache_put(upo_cache_t cache, void* key, void* value, size_t size)
+{
+    upo_cache_entry_t* entry = NULL;
+    upo_cache_entry_t* ghost = NULL;
+    void* old_value = NULL;
+    size_t hash = 0;
+
+    /* preconditions */
+    assert( cache != NULL );
+    assert( size <= cache->capacity );
+
+    hash = upo_cache_hash(cache, key);
+    entry = upo_cache_find(cache, key, hash, &ghost);
+    if (entry != NULL)
+    {
+        old_value = entry->value;
+        entry->value = value;
+        cache->queues[entry->queue].size += size - entry->size;
+        entry->size = size;
+        upo_cache_touch(cache, entry);
+    }
+    else
+    {
+        int queue = UPO_CACHE_MAIN;
+
+        if (ghost != NULL)
+        {
+            /* The key left the small queue too early: admit it into the main one */
+            upo_cache_remove(cache, ghost, 0);
+        }
+        else if (cache->policy == UPO_CACHE_S3FIFO)
+        {
+            queue = UPO_CACHE_SMALL;
+        }
+        entry = upo_mem_pool_alloc(cache->entries);
+        entry->key = key;
+        entry->value = value;
+        entry->size = size;
+        entry->hash = hash;
+        entry->freq = 0;
+        upo_cache_index_add(cache, entry);
+        upo_cache_push(cache, entry, queue);
+    }
+
+    while (upo_cache_used(cache) > cache->capacity)
+    {
+        upo_cache_evict_one(cache);
+    }
+
+    return old_value;
+}
+
+void* upo_cache_get(upo_cache_t cache, const void* key)
+{
+    upo_cache_entry_t* entry = NULL;
+
+    /* preconditions */
+    assert( cache != NULL );
+
+    entry = upo_cache_find(cache, key, upo_cache_hash(cache, key), NULL);
+    if (entry == NULL)
+    {
+        cache->stats.misses += 1;
+        return NULL;
+    }
+    cache->stats.hits += 1;
+    upo_cache_touch(cache, entry);
+
+    return entry->value;
+}
+
+void* upo_cache_peek(const upo_cache_t cache, const void* key)
+{
+    upo_cache_entry_t* entry = NULL;
+
+    if (cache == NULL)
+    {
+        return NULL;
+    }
+
+    entry = upo_cache_find(cache, key, upo_cache_hash(cache, key), NULL);
+
+    return (entry != NULL) ? entry->value : NULL;
+}
+
+int upo_cache_contains(const upo_cache_t cache, const void* key)
+{
+    if (cache == NULL)
+    {
+        return 0;
+    }
+
+    return (upo_cache_find(cache, key, upo_cache_hash(cache, key), NULL) != NULL) ? 1 : 0;
+}
+
+int upo_cache_delete(upo_cache_t cache, const void* key, int destroy_data)
+{
+    upo_cache_entry_t* entry = NULL;
+
+    if (cache == NULL)
+    {
+        return 0;
+    }
+
+    entry = upo_cache_find(cache, key, upo_cache_hash(cache, key), NULL);
+    if (entry == NULL)
+    {
+        return 0;
+    }
+    upo_cache_remove(cache, entry, destroy_data);
+
+    return 1;
+}
+
+size_t upo_cache_size(const upo_cache_t cache)
+{
+    return (cache != NULL) ? cache->queues[UPO_CACHE_MAIN].count + cache->queues[UPO_CACHE_SMALL].count : 0;
+}
+
+size_t upo_cache_used(const upo_cache_t cache)
+{
+    return (cache != NULL) ? cache->queues[UPO_CACHE_MAIN].size + cache->queues[UPO_CACHE_SMALL].size : 0;
+}
+
+size_t upo_cache_capacity(const upo_cache_t cache)
+{
+    return (cache != NULL) ? cache->capacity : 0;
+}
+
+void upo_cache_stats(const upo_cache_t cache, upo_cache_stats_t* stats)
+{
+    /* preconditions */
+    assert( stats != NULL );
+
+    if (cache != NULL)
+    {
+        *stats = cache->stats;
+    }
+    else
+    {
+        memset(stats, 0, sizeof(upo_cache_stats_t));
+    }
+}
+
+void upo_cache_reset_stats(upo_cache_t cache)
+{
+    if (cache != NULL)
+    {
+        memset(&cache->stats, 0, sizeof(upo_cache_stats_t));
+    }
+}
+
+upo_cache_entry_t* upo_cache_find(const upo_cache_t cache, const void* key, size_t hash, upo_cache_entry_t** ghost)
+{
+    upo_cache_entry_t* entry = cache->buckets[hash & (cache->num_buckets - 1)];
+
+    if (ghost != NULL)
+    {
+        *ghost = NULL;
+    }
+    for (; entry != NULL; entry = entry->hash_next)
+    {
+        if (entry->hash != hash)
+        {
+            continue;
+        }
+        if (entry->queue != UPO_CACHE_GHOST)
+        {
+            if (cache->key_cmp(key, entry->key) == 0)
+            {
+                return entry;
+            }
+        }
+        else if (ghost != NULL)
+        {
+            /* Ghosts are matched by hash value only, as their key is gone */
+            *ghost = entry;
+        }
+    }
+
+    return NULL;
+}
+
+size_t upo_cache_hash(const upo_cache_t cache, const void* key)
+{
+    return upo_ht_hash_mix(cache->key_hash(key, UPO_HT_HASH_FULL_RANGE));
+}
+
+void upo_cache_index_add(upo_cache_t cache, upo_cache_entry_t* entry)
+{
+    size_t i = 0;
+
+    if (cache->num_indexed >= cache->num_buckets)
+    {
+        size_t n = 2*cache->num_buckets;
+        upo_cache_entry_t** buckets = calloc(n, sizeof(upo_cache_entry_t*));
+
+        if (buckets == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for the index of the Cache");
+        }
+        for (i = 0; i < cache->num_buckets; ++i)
+        {
+            upo_cache_entry_t* e = cache->buckets[i];
+
+            while (e != NULL)
+            {
+                upo_cache_entry_t* next = e->hash_next;
+
+                e->hash_next = buckets[e->hash & (n - 1)];
+                buckets[e->hash & (n - 1)] = e;
+                e = next;
+            }
+        }
+        free(cache->buckets);
+        cache->buckets = buckets;
+        cache->num_buckets = n;
+    }
+
+    i = entry->hash & (cache->num_buckets - 1);
+    entry->hash_next = cache->buckets[i];
+    cache->buckets[i] = entry;
+    cache->num_indexed += 1;
+}
+
+void upo_cache_index_remove(upo_cache_t cache, upo_cache_entry_t* entry)
+{
+    upo_cache_entry_t** link = &cache->buckets[entry->hash & (cache->num_buckets - 1)];
+
+    while (*link != entry)
+    {
+        link = &(*link)->hash_next;
+    }
+    *link = entry->hash_next;
+    cache->num_indexed -= 1;
+}
+
+void upo_cache_push(upo_cache_t cache, upo_cache_entry_t* entry, int queue)
+{
+    upo_cache_queue_t* q = &cache->queues[queue];
+
+    entry->queue = (unsigned char) queue;
+    entry->prev = NULL;
+    entry->next = q->head;
+    if (q->head != NULL)
+    {
+        q->head->prev = entry;
+    }
+    else
+    {
+        q->tail = entry;
+    }
+    q->head = entry;
+    q->count += 1;
+    q->size += entry->size;
+}
+
+void upo_cache_unlink(upo_cache_t cache, upo_cache_entry_t* entry)
+{
+    upo_cache_queue_t* q = &cache->queues[entry->queue];
+
+    if (entry->prev != NULL)
+    {
+        entry->prev->next = entry->next;
+    }
+    else
+    {
+        q->head = entry->next;
+    }
+    if (entry->next != NULL)
+    {
+        entry->next->prev = entry->prev;
+    }
+    else
+    {
+        q->tail = entry->prev;
+    }
+    q->count -= 1;
+    q->size -= entry->size;
+}
+
+void upo_cache_touch(upo_cache_t cache, upo_cache_entry_t* entry)
+{
+    switch (cache->policy)
+    {
+        case UPO_CACHE_LRU:
+            if (entry != cache->queues[UPO_CACHE_MAIN].head)
+            {
+                upo_cache_unlink(cache, entry);
+                upo_cache_push(cache, entry, UPO_CACHE_MAIN);
+            }
+            break;
+        case UPO_CACHE_CLOCK:
+            entry->freq = 1;
+            break;
+        default:
+            if (entry->freq < UPO_CACHE_S3FIFO_MAX_FREQ)
+            {
+                entry->freq += 1;
+            }
+            break;
+    }
+}
+
+void upo_cache_evict_one(upo_cache_t cache)
+{
+    upo_cache_queue_t* main_queue = &cache->queues[UPO_CACHE_MAIN];
+    upo_cache_queue_t* small_queue = &cache->queues[UPO_CACHE_SMALL];
+    upo_cache_entry_t* entry = NULL;
+
+    if (cache->policy == UPO_CACHE_LRU)
+    {
+        upo_cache_evict_entry(cache, main_queue->tail, 0);
+        return;
+    }
+
+    if (cache->policy == UPO_CACHE_S3FIFO)
+    {
+        /* Entries accessed while in the small queue move to the main one,
+         * the others are evicted (and remembered as ghosts) */
+        while (small_queue->count > 0 && (small_queue->size >= cache->small_capacity || main_queue->count == 0))
+        {
+            entry = small_queue->tail;
+            if (entry->freq == 0)
+            {
+                upo_cache_evict_entry(cache, entry, 1);
+                return;
+            }
+            upo_cache_unlink(cache, entry);
+            entry->freq = 0;
+            upo_cache_push(cache, entry, UPO_CACHE_MAIN);
+        }
+    }
+
+    /* CLOCK, and the main queue of S3-FIFO: entries accessed since their
+     * last inspection are reinserted at the head, with one access less */
+    for (;;)
+    {
+        entry = main_queue->tail;
+        if (entry->freq == 0)
+        {
+            upo_cache_evict_entry(cache, entry, 0);
+            return;
+        }
+        upo_cache_unlink(cache, entry);
+        entry->freq -= 1;
+        upo_cache_push(cache, entry, UPO_CACHE_MAIN);
+    }
+}
+
+void upo_cache_evict_entry(upo_cache_t cache, upo_cache_entry_t* entry, int to_ghost)
+{
+    void* key = entry->key;
+    void* value = entry->value;
+
+    cache->stats.evictions += 1;
+    if (to_ghost)
+    {
+        upo_cache_unlink(cache, entry);
+        entry->key = NULL;
+        entry->value = NULL;
+        entry->size = 0;
+        entry->freq = 0;
+        upo_cache_push(cache, entry, UPO_CACHE_GHOST);
+        while (cache->queues[UPO_CACHE_GHOST].count > upo_cache_size(cache))
+        {
+            upo_cache_remove(cache, cache->queues[UPO_CACHE_GHOST].tail, 0);
+        }
+    }
+    else
+    {
+        upo_cache_remove(cache, entry, 0);
+    }
+
+    if (cache->evict != NULL)
+    {
+        cache->evict(key, value, cache->evict_arg);
+    }
+}
+
+void upo_cache_remove(upo_cache_t cache, upo_cache_entry_t* entry, int destroy_data)
+{
+    upo_cache_index_remove(cache, entry);
+    upo_cache_unlink(cache, entry);
+    if (destroy_data && entry->queue != UPO_CACHE_GHOST)
+    {
+        free(entry->key);
+        free(entry->value);
+    }
+    upo_mem_pool_free(cache->entries, entry);
+}
@@ -0,0 +1,204 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/cache_private.h
+ *
+ * \brief Private header for bounded key-value caches.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_CACHE_PRIVATE_H
+#define UPO_CACHE_PRIVATE_H
+
+
+#include <stddef.h>
+#include <upo/cache.h>
+#include <upo/hashtable.h>
+#include <upo/mem_pool.h>
+
+
+/** \brief The initial number of lists of collisions of the index of caches (a power of two). */
+#define UPO_CACHE_INITIAL_BUCKETS 16U
+
+/** \brief The percentage of the capacity given to the small queue of S3-FIFO. */
+#define UPO_CACHE_S3FIFO_SMALL_PERCENT 10U
+
+/** \brief The maximum access frequency recorded by S3-FIFO. */
+#define UPO_CACHE_S3FIFO_MAX_FREQ 3U
+
+/** \brief The queue of LRU and CLOCK entries, and of S3-FIFO entries promoted from the small queue. */
+#define UPO_CACHE_MAIN 0
+
+/** \brief The queue of S3-FIFO entries admitted recently. */
+#define UPO_CACHE_SMALL 1
+
+/** \brief The queue of S3-FIFO ghost entries, that is of the keys recently evicted from the small queue. */
+#define UPO_CACHE_GHOST 2
+
+/** \brief The number of queues. */
+#define UPO_CACHE_NUM_QUEUES 3
+
+
+/**
+ * \brief Type for entries of caches.
+ *
+ * Ghost entries only keep the hash value of their key: the key itself may
+ * have been freed after the eviction.
+ */
+struct upo_cache_entry_s
+{
+    void* key; /**< Pointer to the user-provided key (`NULL` for ghosts). */
+    void* value; /**< Pointer to the value associated to the key. */
+    size_t size; /**< The size of the entry. */
+    size_t hash; /**< The (mixed) hash value of the key. */
+    struct upo_cache_entry_s* hash_next; /**< The next entry of the list of collisions. */
+    struct upo_cache_entry_s* prev; /**< The previous (more recent) entry of the queue. */
+    struct upo_cache_entry_s* next; /**< The next (older) entry of the queue. */
+    unsigned char queue; /**< The queue holding the entry (see #UPO_CACHE_MAIN). */
+    unsigned char freq; /**< The reference bit (CLOCK) or the access frequency (S3-FIFO). */
+};
+/** \brief Alias for the type for entries of caches. */
+typedef struct upo_cache_entry_s upo_cache_entry_t;
+
+/** \brief Type for queues of entries, from the most recent (head) to the oldest (tail). */
+struct upo_cache_queue_s
+{
+    upo_cache_entry_t* head; /**< The most recent entry. */
+    upo_cache_entry_t* tail; /**< The oldest entry. */
+    size_t count; /**< The number of entries. */
+    size_t size; /**< The total size of the entries. */
+};
+/** \brief Alias for the type for queues of entries. */
+typedef struct upo_cache_queue_s upo_cache_queue_t;
+
+/** \brief Type for caches. */
+struct upo_cache_s
+{
+    int policy; /**< The replacement policy. */
+    size_t capacity; /**< The maximum total size of the entries. */
+    size_t small_capacity; /**< The size of the small queue above which S3-FIFO evicts from it. */
+    upo_cache_queue_t queues[UPO_CACHE_NUM_QUEUES]; /**< The queues of entries. */
+    upo_cache_entry_t** buckets; /**< The heads of the lists of collisions of the index. */
+    size_t num_buckets; /**< The number of lists of collisions (a power of two). */
+    size_t num_indexed; /**< The number of entries in the index, ghosts included. */
+    upo_ht_hasher_t key_hash; /**< The key hash function. */
+    upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+    upo_mem_pool_t entries; /**< The pool the entries are drawn from. */
+    upo_cache_evict_callback_t evict; /**< The function notified of evictions (may be `NULL`). */
+    void* evict_arg; /**< The additional parameter of the eviction function. */
+    upo_cache_stats_t stats; /**< The statistics about the accesses. */
+};
+
+
+/**
+ * \brief Looks for the entry of the given key.
+ *
+ * \param cache The cache.
+ * \param key The key.
+ * \param hash The hash value of the key.
+ * \param ghost Where the ghost entry of the key is stored, if any and if no
+ *  entry is found (may be `NULL`).
+ * \return The (non-ghost) entry, or `NULL` if the key is not cached.
+ */
+static upo_cache_entry_t* upo_cache_find(const upo_cache_t cache, const void* key, size_t hash, upo_cache_entry_t** ghost);
+
+/**
+ * \brief Returns the hash value of the given key.
+ *
+ * \param cache The cache.
+ * \param key The key.
+ * \return The hash value, mixed over the whole word.
+ */
+static size_t upo_cache_hash(const upo_cache_t cache, const void* key);
+
+/**
+ * \brief Adds the given entry to the index, doubling the number of lists of
+ *  collisions if needed.
+ *
+ * \param cache The cache.
+ * \param entry The entry.
+ */
+static void upo_cache_index_add(upo_cache_t cache, upo_cache_entry_t* entry);
+
+/**
+ * \brief Removes the given entry from the index.
+ *
+ * \param cache The cache.
+ * \param entry The entry.
+ */
+static void upo_cache_index_remove(upo_cache_t cache, upo_cache_entry_t* entry);
+
+/**
+ * \brief Inserts the given entry at the head of the given queue.
+ *
+ * \param cache The cache.
+ * \param entry The entry (not in any queue).
+ * \param queue The queue.
+ */
+static void upo_cache_push(upo_cache_t cache, upo_cache_entry_t* entry, int queue);
+
+/**
+ * \brief Removes the given entry from its queue.
+ *
+ * \param cache The cache.
+ * \param entry The entry.
+ */
+static void upo_cache_unlink(upo_cache_t cache, upo_cache_entry_t* entry);
+
+/**
+ * \brief Records an access to the given entry, according to the policy of
+ *  the given cache.
+ *
+ * \param cache The cache.
+ * \param entry The entry.
+ */
+static void upo_cache_touch(upo_cache_t cache, upo_cache_entry_t* entry);
+
+/**
+ * \brief Evicts one entry from the given cache, according to its policy.
+ *
+ * \param cache The (nonempty) cache.
+ */
+static void upo_cache_evict_one(upo_cache_t cache);
+
+/**
+ * \brief Evicts the given entry, notifying the eviction callback.
+ *
+ * \param cache The cache.
+ * \param entry The entry.
+ * \param to_ghost Tells whether the key must be remembered by a ghost entry.
+ *
+ * Ghost entries are never more than the cached ones: the oldest are dropped.
+ */
+static void upo_cache_evict_entry(upo_cache_t cache, upo_cache_entry_t* entry, int to_ghost);
+
+/**
+ * \brief Removes the given entry from the index and from its queue and frees
+ *  it.
+ *
+ * \param cache The cache.
+ * \param entry The entry.
+ * \param destroy_data Tells whether the key and the value must be freed.
+ */
+static void upo_cache_remove(upo_cache_t cache, upo_cache_entry_t* entry, int destroy_data);
+
+
+#endif /* UPO_CACHE_PRIVATE_H */
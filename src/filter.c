@@ -0,0 +1,372 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <limits.h>
+#include "filter_private.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+
+
+/*** BEGIN of BLOCKED BLOOM FILTER ***/
+
+
+upo_bloom_filter_t upo_bloom_filter_create(size_t n, size_t bits_per_element)
+{
+    upo_bloom_filter_t filter = NULL;
+    size_t k = 0;
+
+    /* preconditions */
+    assert( bits_per_element > 0 );
+
+    filter = malloc(sizeof(struct upo_bloom_filter_s));
+    if (filter == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the Bloom Filter");
+    }
+
+    filter->num_blocks = (n*bits_per_element + UPO_BLOOM_FILTER_BLOCK_BITS - 1)/UPO_BLOOM_FILTER_BLOCK_BITS;
+    if (filter->num_blocks == 0)
+    {
+        filter->num_blocks = 1;
+    }
+    /* The optimal number of bits per element is about bits_per_element*ln(2) */
+    k = (bits_per_element*69 + 50)/100;
+    filter->num_hashes = (k < 1) ? 1 : (k > UPO_BLOOM_FILTER_MAX_HASHES) ? UPO_BLOOM_FILTER_MAX_HASHES : k;
+
+    /* Over-allocate, so that blocks can be aligned to cache lines */
+    filter->memory = malloc(filter->num_blocks*UPO_BLOOM_FILTER_BLOCK_SIZE + UPO_BLOOM_FILTER_BLOCK_SIZE - 1);
+    if (filter->memory == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the bits of the Bloom Filter");
+    }
+    filter->blocks = (uint64_t*) (((uintptr_t) filter->memory + UPO_BLOOM_FILTER_BLOCK_SIZE - 1) & ~((uintptr_t) UPO_BLOOM_FILTER_BLOCK_SIZE - 1));
+    upo_bloom_filter_clear(filter);
+
+    return filter;
+}
+
+void upo_bloom_filter_destroy(upo_bloom_filter_t filter)
+{
+    if (filter != NULL)
+    {
+        free(filter->memory);
+        free(filter);
+    }
+}
+
+void upo_bloom_filter_clear(upo_bloom_filter_t filter)
+{
+    if (filter != NULL)
+    {
+        memset(filter->blocks, 0, filter->num_blocks*UPO_BLOOM_FILTER_BLOCK_SIZE);
+    }
+}
+
+void upo_bloom_filter_add(upo_bloom_filter_t filter, size_t hash)
+{
+    size_t x = upo_ht_hash_mix(hash);
+    uint64_t* block = NULL;
+    size_t a = 0;
+    size_t b = 0;
+    size_t i = 0;
+
+    /* preconditions */
+    assert( filter != NULL );
+
+    /* The highest bits of x choose the block, other bits (by double hashing)
+     * the bits within the block */
+    block = filter->blocks + upo_ht_reduce_fastrange(x, filter->num_blocks)*(UPO_BLOOM_FILTER_BLOCK_SIZE/8);
+    a = upo_ht_hash_mix(x);
+    b = (a >> (sizeof(size_t)*CHAR_BIT/2)) | 1U;
+    for (i = 0; i < filter->num_hashes; ++i)
+    {
+        size_t bit = (a + i*b) % UPO_BLOOM_FILTER_BLOCK_BITS;
+
+        block[bit/64] |= (uint64_t) 1 << (bit % 64);
+    }
+}
+
+int upo_bloom_filter_may_contain(const upo_bloom_filter_t filter, size_t hash)
+{
+    size_t x = upo_ht_hash_mix(hash);
+    const uint64_t* block = NULL;
+    size_t a = 0;
+    size_t b = 0;
+    size_t i = 0;
+
+    /* preconditions */
+    assert( filter != NULL );
+
+    block = filter->blocks + upo_ht_reduce_fastrange(x, filter->num_blocks)*(UPO_BLOOM_FILTER_BLOCK_SIZE/8);
+    a = upo_ht_hash_mix(x);
+    b = (a >> (sizeof(size_t)*CHAR_BIT/2)) | 1U;
+    for (i = 0; i < filter->num_hashes; ++i)
+    {
+        size_t bit = (a + i*b) % UPO_BLOOM_FILTER_BLOCK_BITS;
+
+        if (!((block[bit/64] >> (bit % 64)) & 1U))
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+size_t upo_bloom_filter_memory_usage(const upo_bloom_filter_t filter)
+{
+    if (filter == NULL)
+    {
+        return 0;
+    }
+
+    return sizeof(struct upo_bloom_filter_s)
+           + filter->num_blocks*UPO_BLOOM_FILTER_BLOCK_SIZE + UPO_BLOOM_FILTER_BLOCK_SIZE - 1;
+}
+
+
+/*** END of BLOCKED BLOOM FILTER ***/
+
+
+/*** BEGIN of CUCKOO FILTER ***/
+
+
+upo_cuckoo_filter_t upo_cuckoo_filter_create(size_t n)
+{
+    upo_cuckoo_filter_t filter = NULL;
+    size_t needed = (size_t) (n/(UPO_CUCKOO_FILTER_BUCKET_SIZE*UPO_CUCKOO_FILTER_MAX_LOAD_FACTOR)) + 1;
+
+    filter = malloc(sizeof(struct upo_cuckoo_filter_s));
+    if (filter == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the Cuckoo Filter");
+    }
+
+    /* Alternate buckets are computed by xor, which needs a power of two */
+    filter->num_buckets = 1;
+    while (filter->num_buckets < needed)
+    {
+        filter->num_buckets *= 2;
+    }
+    filter->fingerprints = malloc(filter->num_buckets*UPO_CUCKOO_FILTER_BUCKET_SIZE*sizeof(uint16_t));
+    if (filter->fingerprints == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the buckets of the Cuckoo Filter");
+    }
+    filter->kicks = 0;
+    upo_cuckoo_filter_clear(filter);
+
+    return filter;
+}
+
+void upo_cuckoo_filter_destroy(upo_cuckoo_filter_t filter)
+{
+    if (filter != NULL)
+    {
+        free(filter->fingerprints);
+        free(filter);
+    }
+}
+
+void upo_cuckoo_filter_clear(upo_cuckoo_filter_t filter)
+{
+    if (filter != NULL)
+    {
+        memset(filter->fingerprints, 0, filter->num_buckets*UPO_CUCKOO_FILTER_BUCKET_SIZE*sizeof(uint16_t));
+        filter->size = 0;
+        filter->has_victim = 0;
+    }
+}
+
+int upo_cuckoo_filter_add(upo_cuckoo_filter_t filter, size_t hash)
+{
+    size_t bucket = 0;
+    uint16_t fp = 0;
+    size_t i = 0;
+
+    /* preconditions */
+    assert( filter != NULL );
+
+    /* The victim of the last failed insertion has no room: the filter is full */
+    if (filter->has_victim)
+    {
+        return 0;
+    }
+
+    fp = upo_cuckoo_filter_fingerprint(filter, hash, &bucket);
+    if (!upo_cuckoo_filter_put(filter, bucket, fp))
+    {
+        bucket = upo_cuckoo_filter_alt_bucket(filter, bucket, fp);
+        if (!upo_cuckoo_filter_put(filter, bucket, fp))
+        {
+            /* Move a random fingerprint to its alternate bucket, and so on */
+            for (i = 0; i < UPO_CUCKOO_FILTER_MAX_KICKS; ++i)
+            {
+                size_t r = upo_ht_hash_mix(++filter->kicks);
+                uint16_t* slot = &filter->fingerprints[bucket*UPO_CUCKOO_FILTER_BUCKET_SIZE + r % UPO_CUCKOO_FILTER_BUCKET_SIZE];
+                uint16_t evicted = *slot;
+
+                *slot = fp;
+                fp = evicted;
+                bucket = upo_cuckoo_filter_alt_bucket(filter, bucket, fp);
+                if (upo_cuckoo_filter_put(filter, bucket, fp))
+                {
+                    break;
+                }
+            }
+            if (i == UPO_CUCKOO_FILTER_MAX_KICKS)
+            {
+                /* Keep the homeless fingerprint aside, so no element is lost */
+                filter->has_victim = 1;
+                filter->victim_bucket = bucket;
+                filter->victim = fp;
+            }
+        }
+    }
+    filter->size += 1;
+
+    return 1;
+}
+
+int upo_cuckoo_filter_remove(upo_cuckoo_filter_t filter, size_t hash)
+{
+    size_t buckets[2];
+    uint16_t fp = 0;
+    size_t b = 0;
+
+    /* preconditions */
+    assert( filter != NULL );
+
+    fp = upo_cuckoo_filter_fingerprint(filter, hash, &buckets[0]);
+    buckets[1] = upo_cuckoo_filter_alt_bucket(filter, buckets[0], fp);
+
+    if (filter->has_victim && filter->victim == fp
+        && (filter->victim_bucket == buckets[0] || filter->victim_bucket == buckets[1]))
+    {
+        filter->has_victim = 0;
+        filter->size -= 1;
+        return 1;
+    }
+    for (b = 0; b < 2; ++b)
+    {
+        size_t i = upo_cuckoo_filter_find(filter, buckets[b], fp);
+
+        if (i < UPO_CUCKOO_FILTER_BUCKET_SIZE)
+        {
+            filter->fingerprints[buckets[b]*UPO_CUCKOO_FILTER_BUCKET_SIZE + i] = 0;
+            filter->size -= 1;
+            /* Give the victim, if any, the freed place (or one in its other bucket) */
+            if (filter->has_victim
+                && (upo_cuckoo_filter_put(filter, filter->victim_bucket, filter->victim)
+                    || upo_cuckoo_filter_put(filter, upo_cuckoo_filter_alt_bucket(filter, filter->victim_bucket, filter->victim), filter->victim)))
+            {
+                filter->has_victim = 0;
+            }
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int upo_cuckoo_filter_may_contain(const upo_cuckoo_filter_t filter, size_t hash)
+{
+    size_t bucket = 0;
+    size_t alt = 0;
+    uint16_t fp = 0;
+
+    /* preconditions */
+    assert( filter != NULL );
+
+    fp = upo_cuckoo_filter_fingerprint(filter, hash, &bucket);
+    alt = upo_cuckoo_filter_alt_bucket(filter, bucket, fp);
+
+    return (upo_cuckoo_filter_find(filter, bucket, fp) < UPO_CUCKOO_FILTER_BUCKET_SIZE
+            || upo_cuckoo_filter_find(filter, alt, fp) < UPO_CUCKOO_FILTER_BUCKET_SIZE
+            || (filter->has_victim && filter->victim == fp
+                && (filter->victim_bucket == bucket || filter->victim_bucket == alt))) ? 1 : 0;
+}
+
+size_t upo_cuckoo_filter_size(const upo_cuckoo_filter_t filter)
+{
+    return (filter != NULL) ? filter->size : 0;
+}
+
+size_t upo_cuckoo_filter_memory_usage(const upo_cuckoo_filter_t filter)
+{
+    if (filter == NULL)
+    {
+        return 0;
+    }
+
+    return sizeof(struct upo_cuckoo_filter_s)
+           + filter->num_buckets*UPO_CUCKOO_FILTER_BUCKET_SIZE*sizeof(uint16_t);
+}
+
+uint16_t upo_cuckoo_filter_fingerprint(const upo_cuckoo_filter_t filter, size_t hash, size_t* bucket)
+{
+    size_t x = upo_ht_hash_mix(hash);
+    uint16_t fp = (uint16_t) (x >> (sizeof(size_t)*CHAR_BIT - 16));
+
+    /* The lowest bits choose the bucket, the highest ones the fingerprint */
+    *bucket = x & (filter->num_buckets - 1);
+
+    return (fp != 0) ? fp : 1;
+}
+
+size_t upo_cuckoo_filter_alt_bucket(const upo_cuckoo_filter_t filter, size_t bucket, uint16_t fp)
+{
+    return (bucket ^ upo_ht_hash_mix(fp)) & (filter->num_buckets - 1);
+}
+
+int upo_cuckoo_filter_put(upo_cuckoo_filter_t filter, size_t bucket, uint16_t fp)
+{
+    size_t i = upo_cuckoo_filter_find(filter, bucket, 0);
+
+    if (i == UPO_CUCKOO_FILTER_BUCKET_SIZE)
+    {
+        return 0;
+    }
+    filter->fingerprints[bucket*UPO_CUCKOO_FILTER_BUCKET_SIZE + i] = fp;
+
+    return 1;
+}
+
+size_t upo_cuckoo_filter_find(const upo_cuckoo_filter_t filter, size_t bucket, uint16_t fp)
+{
+    const uint16_t* fps = filter->fingerprints + bucket*UPO_CUCKOO_FILTER_BUCKET_SIZE;
+    size_t i = 0;
+
+    while (i < UPO_CUCKOO_FILTER_BUCKET_SIZE && fps[i] != fp)
+    {
+        ++i;
+    }
+
+    return i;
+}
+
+
+/*** END of CUCKOO FILTER ***/
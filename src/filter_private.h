@@ -0,0 +1,120 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/filter_private.h
+ *
+ * \brief Private header for approximate membership filters.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_FILTER_PRIVATE_H
+#define UPO_FILTER_PRIVATE_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <upo/filter.h>
+
+
+/** \brief The size (in bytes) of the blocks of Bloom filters, i.e. of a cache line. */
+#define UPO_BLOOM_FILTER_BLOCK_SIZE 64U
+
+/** \brief The number of bits of the blocks of Bloom filters. */
+#define UPO_BLOOM_FILTER_BLOCK_BITS (UPO_BLOOM_FILTER_BLOCK_SIZE*8U)
+
+/** \brief The largest number of bits set per element in Bloom filters. */
+#define UPO_BLOOM_FILTER_MAX_HASHES 16U
+
+/** \brief The number of fingerprints per bucket of cuckoo filters. */
+#define UPO_CUCKOO_FILTER_BUCKET_SIZE 4U
+
+/** \brief The maximum load factor cuckoo filters are sized for. */
+#define UPO_CUCKOO_FILTER_MAX_LOAD_FACTOR 0.9
+
+/** \brief The number of fingerprints moved by an insertion before the filter is deemed full. */
+#define UPO_CUCKOO_FILTER_MAX_KICKS 500U
+
+
+/** \brief Type for blocked Bloom filters. */
+struct upo_bloom_filter_s
+{
+    void* memory; /**< The allocated memory, which the blocks are aligned within. */
+    uint64_t* blocks; /**< The bits, as blocks of #UPO_BLOOM_FILTER_BLOCK_SIZE bytes aligned to a cache line. */
+    size_t num_blocks; /**< The number of blocks. */
+    size_t num_hashes; /**< The number of bits set per element. */
+};
+
+/** \brief Type for cuckoo filters. */
+struct upo_cuckoo_filter_s
+{
+    uint16_t* fingerprints; /**< The buckets, of #UPO_CUCKOO_FILTER_BUCKET_SIZE fingerprints each (`0` if free). */
+    size_t num_buckets; /**< The number of buckets (a power of two). */
+    size_t size; /**< The number of elements. */
+    int has_victim; /**< Tells whether a fingerprint could not be placed by the last insertion. */
+    size_t victim_bucket; /**< The bucket of the fingerprint that could not be placed. */
+    uint16_t victim; /**< The fingerprint that could not be placed. */
+    size_t kicks; /**< The number of fingerprints moved so far, from which moves are chosen. */
+};
+
+
+/**
+ * \brief Returns the fingerprint and the first bucket of an element.
+ *
+ * \param filter The cuckoo filter.
+ * \param hash The hash value of the element.
+ * \param bucket Where the first bucket is stored.
+ * \return The fingerprint (never `0`).
+ */
+static uint16_t upo_cuckoo_filter_fingerprint(const upo_cuckoo_filter_t filter, size_t hash, size_t* bucket);
+
+/**
+ * \brief Returns the alternate bucket of a fingerprint.
+ *
+ * \param filter The cuckoo filter.
+ * \param bucket One of the two buckets of the fingerprint.
+ * \param fp The fingerprint.
+ * \return The other bucket (the function is an involution).
+ */
+static size_t upo_cuckoo_filter_alt_bucket(const upo_cuckoo_filter_t filter, size_t bucket, uint16_t fp);
+
+/**
+ * \brief Stores a fingerprint into a free place of a bucket.
+ *
+ * \param filter The cuckoo filter.
+ * \param bucket The bucket.
+ * \param fp The fingerprint.
+ * \return `1` on success, or `0` if the bucket is full.
+ */
+static int upo_cuckoo_filter_put(upo_cuckoo_filter_t filter, size_t bucket, uint16_t fp);
+
+/**
+ * \brief Looks for a fingerprint in a bucket.
+ *
+ * \param filter The cuckoo filter.
+ * \param bucket The bucket.
+ * \param fp The fingerprint.
+ * \return The index of the fingerprint within the bucket, or
+ *  #UPO_CUCKOO_FILTER_BUCKET_SIZE if it is not found.
+ */
+static size_t upo_cuckoo_filter_find(const upo_cuckoo_filter_t filter, size_t bucket, uint16_t fp);
+
+
+#endif /* UPO_FILTER_PRIVATE_H */
@@ -0,0 +1,598 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include "hashset_private.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/error.h>
+#include <upo/hashset.h>
+#include <upo/hashtable.h>
+
+
+/*** BEGIN of HASH SET ***/
+
+
+upo_hset_t upo_hset_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_hset_t set = NULL;
+
+    /* preconditions */
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
+
+    set = malloc(sizeof(struct upo_hset_s));
+    if (set == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the Hash Set");
+    }
+    upo_hprobe_init(&set->core, m, sizeof(upo_hprobe_entry_t), key_hash, NULL, key_cmp);
+
+    return set;
+}
+
+upo_hset_t upo_hset_create_seeded(size_t m, upo_ht_seeded_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_hset_t set = NULL;
+
+    /* preconditions */
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
+
+    set = malloc(sizeof(struct upo_hset_s));
+    if (set == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the Hash Set");
+    }
+    upo_hprobe_init(&set->core, m, sizeof(upo_hprobe_entry_t), NULL, key_hash, key_cmp);
+
+    return set;
+}
+
+size_t upo_hset_seed(const upo_hset_t set)
+{
+    return (set != NULL) ? set->core.seed : 0;
+}
+
+void upo_hset_destroy(upo_hset_t set, int destroy_data)
+{
+    if (set != NULL)
+    {
+        upo_hset_clear(set, destroy_data);
+        upo_hprobe_free(&set->core);
+        free(set);
+    }
+}
+
+void upo_hset_clear(upo_hset_t set, int destroy_data)
+{
+    if (set != NULL)
+    {
+        if (destroy_data)
+        {
+            size_t i = 0;
+
+            for (i = 0; i < set->core.size; ++i)
+            {
+                free(UPO_HPROBE_ENTRY(&set->core, i)->key);
+            }
+        }
+        upo_hprobe_clear(&set->core);
+    }
+}
+
+int upo_hset_insert(upo_hset_t set, void* key)
+{
+    int found = 0;
+
+    /* preconditions */
+    assert( set != NULL );
+
+    upo_hprobe_insert(&set->core, key, upo_hprobe_hash(&set->core, key), &found);
+
+    return !found;
+}
+
+void* upo_hset_get(const upo_hset_t set, const void* key)
+{
+    upo_hprobe_entry_t* entry = NULL;
+
+    if (set == NULL)
+    {
+        return NULL;
+    }
+
+    entry = upo_hprobe_lookup(&set->core, key);
+
+    return (entry != NULL) ? entry->key : NULL;
+}
+
+size_t upo_hset_get_batch(const upo_hset_t set, void* const* keys, size_t n, void** keys_out)
+{
+    upo_hprobe_entry_t* entries[UPO_HPROBE_BATCH_GROUP_SIZE];
+    size_t found = 0;
+    size_t first = 0;
+
+    /* preconditions */
+    assert( set != NULL );
+    assert( keys != NULL || n == 0 );
+    assert( keys_out != NULL || n == 0 );
+
+    for (first = 0; first < n; first += UPO_HPROBE_BATCH_GROUP_SIZE)
+    {
+        size_t group = (n - first < UPO_HPROBE_BATCH_GROUP_SIZE) ? n - first : UPO_HPROBE_BATCH_GROUP_SIZE;
+        size_t i = 0;
+
+        found += upo_hprobe_lookup_batch(&set->core, keys + first, group, entries);
+        for (i = 0; i < group; ++i)
+        {
+            keys_out[first+i] = (entries[i] != NULL) ? entries[i]->key : NULL;
+        }
+    }
+
+    return found;
+}
+
+int upo_hset_contains(const upo_hset_t set, const void* key)
+{
+    if (set == NULL)
+    {
+        return 0;
+    }
+
+    return (upo_hprobe_lookup(&set->core, key) != NULL) ? 1 : 0;
+}
+
+int upo_hset_delete(upo_hset_t set, const void* key, int destroy_data)
+{
+    upo_hprobe_entry_t* entry = NULL;
+
+    if (set == NULL)
+    {
+        return 0;
+    }
+
+    entry = upo_hprobe_lookup(&set->core, key);
+    if (entry == NULL)
+    {
+        return 0;
+    }
+    if (destroy_data)
+    {
+        free(entry->key);
+    }
+    upo_hprobe_remove(&set->core, entry);
+
+    return 1;
+}
+
+size_t upo_hset_size(const upo_hset_t set)
+{
+    return (set != NULL) ? set->core.size : 0;
+}
+
+int upo_hset_is_empty(const upo_hset_t set)
+{
+    return upo_hset_size(set) == 0 ? 1 : 0;
+}
+
+size_t upo_hset_capacity(const upo_hset_t set)
+{
+    return (set != NULL) ? set->core.capacity : 0;
+}
+
+double upo_hset_load_factor(const upo_hset_t set)
+{
+    return upo_hset_size(set) / (double) upo_hset_capacity(set);
+}
+
+void upo_hset_traverse(const upo_hset_t set, upo_ht_visitor_t visit, void* visit_arg)
+{
+    if (set != NULL)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < set->core.size; ++i)
+        {
+            visit(UPO_HPROBE_ENTRY(&set->core, i)->key, NULL, visit_arg);
+        }
+    }
+}
+
+int upo_hset_cursor_next(const upo_hset_t set, upo_ht_cursor_t* cursor, void** key)
+{
+    /* preconditions */
+    assert( cursor != NULL );
+
+    if (set == NULL || cursor->index >= set->core.size)
+    {
+        return 0;
+    }
+    if (key != NULL)
+    {
+        *key = UPO_HPROBE_ENTRY(&set->core, cursor->index)->key;
+    }
+    cursor->index += 1;
+
+    return 1;
+}
+
+void upo_hset_stats(const upo_hset_t set, upo_ht_stats_t* stats)
+{
+    /* preconditions */
+    assert( stats != NULL );
+
+    if (set == NULL)
+    {
+        memset(stats, 0, sizeof(upo_ht_stats_t));
+        return;
+    }
+
+    upo_hprobe_stats(&set->core, stats);
+    stats->overhead_bytes = sizeof(struct upo_hset_s);
+    stats->total_bytes = stats->slot_bytes + stats->entry_bytes + stats->overhead_bytes;
+}
+
+
+/*** END of HASH SET ***/
+
+
+/*** BEGIN of HASH MULTIMAP ***/
+
+
+upo_hmultimap_t upo_hmultimap_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_hmultimap_t mm = NULL;
+
+    /* preconditions */
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
+
+    mm = malloc(sizeof(struct upo_hmultimap_s));
+    if (mm == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the Hash Multimap");
+    }
+    upo_hprobe_init(&mm->core, m, sizeof(upo_hmultimap_entry_t), key_hash, NULL, key_cmp);
+    mm->num_values = 0;
+
+    return mm;
+}
+
+upo_hmultimap_t upo_hmultimap_create_seeded(size_t m, upo_ht_seeded_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_hmultimap_t mm = NULL;
+
+    /* preconditions */
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
+
+    mm = malloc(sizeof(struct upo_hmultimap_s));
+    if (mm == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the Hash Multimap");
+    }
+    upo_hprobe_init(&mm->core, m, sizeof(upo_hmultimap_entry_t), NULL, key_hash, key_cmp);
+    mm->num_values = 0;
+
+    return mm;
+}
+
+size_t upo_hmultimap_seed(const upo_hmultimap_t mm)
+{
+    return (mm != NULL) ? mm->core.seed : 0;
+}
+
+void upo_hmultimap_destroy(upo_hmultimap_t mm, int destroy_data)
+{
+    if (mm != NULL)
+    {
+        upo_hmultimap_clear(mm, destroy_data);
+        upo_hprobe_free(&mm->core);
+        free(mm);
+    }
+}
+
+void upo_hmultimap_clear(upo_hmultimap_t mm, int destroy_data)
+{
+    if (mm != NULL)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < mm->core.size; ++i)
+        {
+            upo_hmultimap_release((upo_hmultimap_entry_t*) UPO_HPROBE_ENTRY(&mm->core, i), destroy_data);
+        }
+        upo_hprobe_clear(&mm->core);
+        mm->num_values = 0;
+    }
+}
+
+int upo_hmultimap_put(upo_hmultimap_t mm, void* key, void* value)
+{
+    upo_hmultimap_entry_t* entry = NULL;
+    int found = 0;
+
+    /* preconditions */
+    assert( mm != NULL );
+
+    entry = (upo_hmultimap_entry_t*) upo_hprobe_insert(&mm->core, key, upo_hprobe_hash(&mm->core, key), &found);
+    if (!found)
+    {
+        entry->values = NULL;
+        entry->count = 0;
+        entry->capacity = 0;
+    }
+    if (entry->count == entry->capacity)
+    {
+        size_t n = (entry->capacity > 0) ? 2*entry->capacity : UPO_HMULTIMAP_INITIAL_VALUES;
+        void** values = realloc(entry->values, n*sizeof(void*));
+
+        if (values == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for values of the Hash Multimap");
+        }
+        entry->values = values;
+        entry->capacity = n;
+    }
+    entry->values[entry->count] = value;
+    entry->count += 1;
+    mm->num_values += 1;
+
+    return found;
+}
+
+void* const* upo_hmultimap_get(const upo_hmultimap_t mm, const void* key, size_t* count)
+{
+    upo_hmultimap_entry_t* entry = NULL;
+
+    if (mm != NULL)
+    {
+        entry = (upo_hmultimap_entry_t*) upo_hprobe_lookup(&mm->core, key);
+    }
+    if (count != NULL)
+    {
+        *count = (entry != NULL) ? entry->count : 0;
+    }
+
+    return (entry != NULL) ? entry->values : NULL;
+}
+
+size_t upo_hmultimap_get_batch(const upo_hmultimap_t mm, void* const* keys, size_t n, void* const** values_out, size_t* counts_out)
+{
+    upo_hprobe_entry_t* entries[UPO_HPROBE_BATCH_GROUP_SIZE];
+    size_t found = 0;
+    size_t first = 0;
+
+    /* preconditions */
+    assert( mm != NULL );
+    assert( keys != NULL || n == 0 );
+    assert( values_out != NULL || n == 0 );
+
+    for (first = 0; first < n; first += UPO_HPROBE_BATCH_GROUP_SIZE)
+    {
+        size_t group = (n - first < UPO_HPROBE_BATCH_GROUP_SIZE) ? n - first : UPO_HPROBE_BATCH_GROUP_SIZE;
+        size_t i = 0;
+
+        found += upo_hprobe_lookup_batch(&mm->core, keys + first, group, entries);
+        for (i = 0; i < group; ++i)
+        {
+            upo_hmultimap_entry_t* entry = (upo_hmultimap_entry_t*) entries[i];
+
+            values_out[first+i] = (entry != NULL) ? entry->values : NULL;
+            if (counts_out != NULL)
+            {
+                counts_out[first+i] = (entry != NULL) ? entry->count : 0;
+            }
+        }
+    }
+
+    return found;
+}
+
+size_t upo_hmultimap_count(const upo_hmultimap_t mm, const void* key)
+{
+    size_t count = 0;
+
+    upo_hmultimap_get(mm, key, &count);
+
+    return count;
+}
+
+int upo_hmultimap_contains(const upo_hmultimap_t mm, const void* key)
+{
+    return (upo_hmultimap_get(mm, key, NULL) != NULL) ? 1 : 0;
+}
+
+int upo_hmultimap_delete(upo_hmultimap_t mm, const void* key, int destroy_data)
+{
+    upo_hmultimap_entry_t* entry = NULL;
+
+    if (mm == NULL)
+    {
+        return 0;
+    }
+
+    entry = (upo_hmultimap_entry_t*) upo_hprobe_lookup(&mm->core, key);
+    if (entry == NULL)
+    {
+        return 0;
+    }
+    mm->num_values -= entry->count;
+    upo_hmultimap_release(entry, destroy_data);
+    upo_hprobe_remove(&mm->core, &entry->header);
+
+    return 1;
+}
+
+int upo_hmultimap_delete_value(upo_hmultimap_t mm, const void* key, const void* value, int destroy_data)
+{
+    upo_hmultimap_entry_t* entry = NULL;
+    size_t i = 0;
+
+    if (mm == NULL)
+    {
+        return 0;
+    }
+
+    entry = (upo_hmultimap_entry_t*) upo_hprobe_lookup(&mm->core, key);
+    if (entry == NULL)
+    {
+        return 0;
+    }
+    while (i < entry->count && entry->values[i] != value)
+    {
+        ++i;
+    }
+    if (i == entry->count)
+    {
+        return 0;
+    }
+
+    if (destroy_data)
+    {
+        free(entry->values[i]);
+    }
+    memmove(&entry->values[i], &entry->values[i+1], (entry->count - i - 1)*sizeof(void*));
+    entry->count -= 1;
+    mm->num_values -= 1;
+    if (entry->count == 0)
+    {
+        upo_hmultimap_release(entry, destroy_data);
+        upo_hprobe_remove(&mm->core, &entry->header);
+    }
+
+    return 1;
+}
+
+size_t upo_hmultimap_size(const upo_hmultimap_t mm)
+{
+    return (mm != NULL) ? mm->core.size : 0;
+}
+
+size_t upo_hmultimap_num_values(const upo_hmultimap_t mm)
+{
+    return (mm != NULL) ? mm->num_values : 0;
+}
+
+int upo_hmultimap_is_empty(const upo_hmultimap_t mm)
+{
+    return upo_hmultimap_size(mm) == 0 ? 1 : 0;
+}
+
+size_t upo_hmultimap_capacity(const upo_hmultimap_t mm)
+{
+    return (mm != NULL) ? mm->core.capacity : 0;
+}
+
+double upo_hmultimap_load_factor(const upo_hmultimap_t mm)
+{
+    return upo_hmultimap_size(mm) / (double) upo_hmultimap_capacity(mm);
+}
+
+void upo_hmultimap_traverse(const upo_hmultimap_t mm, upo_ht_visitor_t visit, void* visit_arg)
+{
+    if (mm != NULL)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < mm->core.size; ++i)
+        {
+            upo_hmultimap_entry_t* entry = (upo_hmultimap_entry_t*) UPO_HPROBE_ENTRY(&mm->core, i);
+            size_t j = 0;
+
+            for (j = 0; j < entry->count; ++j)
+            {
+                visit(entry->header.key, entry->values[j], visit_arg);
+            }
+        }
+    }
+}
+
+int upo_hmultimap_cursor_next(const upo_hmultimap_t mm, upo_ht_cursor_t* cursor, void** key, void* const** values, size_t* count)
+{
+    upo_hmultimap_entry_t* entry = NULL;
+
+    /* preconditions */
+    assert( cursor != NULL );
+
+    if (mm == NULL || cursor->index >= mm->core.size)
+    {
+        return 0;
+    }
+    entry = (upo_hmultimap_entry_t*) UPO_HPROBE_ENTRY(&mm->core, cursor->index);
+    if (key != NULL)
+    {
+        *key = entry->header.key;
+    }
+    if (values != NULL)
+    {
+        *values = entry->values;
+    }
+    if (count != NULL)
+    {
+        *count = entry->count;
+    }
+    cursor->index += 1;
+
+    return 1;
+}
+
+void upo_hmultimap_stats(const upo_hmultimap_t mm, upo_ht_stats_t* stats)
+{
+    size_t i = 0;
+
+    /* preconditions */
+    assert( stats != NULL );
+
+    if (mm == NULL)
+    {
+        memset(stats, 0, sizeof(upo_ht_stats_t));
+        return;
+    }
+
+    upo_hprobe_stats(&mm->core, stats);
+    for (i = 0; i < mm->core.size; ++i)
+    {
+        stats->entry_bytes += ((upo_hmultimap_entry_t*) UPO_HPROBE_ENTRY(&mm->core, i))->capacity*sizeof(void*);
+    }
+    stats->overhead_bytes = sizeof(struct upo_hmultimap_s);
+    stats->total_bytes = stats->slot_bytes + stats->entry_bytes + stats->overhead_bytes;
+}
+
+void upo_hmultimap_release(upo_hmultimap_entry_t* entry, int destroy_data)
+{
+    if (destroy_data)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < entry->count; ++i)
+        {
+            free(entry->values[i]);
+        }
+        free(entry->header.key);
+    }
+    free(entry->values);
+}
+
+
+/*** END of HASH MULTIMAP ***/
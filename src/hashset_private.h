@@ -0,0 +1,89 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/hashset_private.h
+ *
+ * \brief Private header for hash sets and hash multimaps.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHSET_PRIVATE_H
+#define UPO_HASHSET_PRIVATE_H
+
+
+#include "hashtable_probe_private.h"
+#include <stddef.h>
+#include <upo/hashset.h>
+#include <upo/hashtable.h>
+
+
+/*** BEGIN of HASH SET ***/
+
+
+/** \brief Type for hash sets. */
+struct upo_hset_s
+{
+    upo_hprobe_t core; /**< The probing core, whose entries are bare headers. */
+};
+
+
+/*** END of HASH SET ***/
+
+
+/*** BEGIN of HASH MULTIMAP ***/
+
+
+/** \brief The capacity of the vector of values of a new key. */
+#define UPO_HMULTIMAP_INITIAL_VALUES 2U
+
+
+/** \brief Type for entries of hash multimaps. */
+struct upo_hmultimap_entry_s
+{
+    upo_hprobe_entry_t header; /**< The header of the entry, with the key. */
+    void** values; /**< The vector of values, in insertion order. */
+    size_t count; /**< The number of values. */
+    size_t capacity; /**< The capacity of the vector of values. */
+};
+/** \brief Alias for the type for entries of hash multimaps. */
+typedef struct upo_hmultimap_entry_s upo_hmultimap_entry_t;
+
+/** \brief Type for hash multimaps. */
+struct upo_hmultimap_s
+{
+    upo_hprobe_t core; /**< The probing core, whose entries are \c upo_hmultimap_entry_t. */
+    size_t num_values; /**< The number of values, over all keys. */
+};
+
+
+/**
+ * \brief Releases the vector of values of the given entry.
+ *
+ * \param entry The entry.
+ * \param destroy_data Tells whether the key and the values must be freed.
+ */
+static void upo_hmultimap_release(upo_hmultimap_entry_t* entry, int destroy_data);
+
+
+/*** END of HASH MULTIMAP ***/
+
+
+#endif /* UPO_HASHSET_PRIVATE_H */
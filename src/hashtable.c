@@ -22,11 +22,15 @@
 
 #include <assert.h>
 #include "hashtable_private.h"
+#include <limits.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <upo/error.h>
-#include <upo/utility.h>
+#include <upo/macro.h>
 
 
 /*** EXERCISE #1 - BEGIN of HASH TABLE with SEPARATE CHAINING ***/
@@ -35,12 +39,42 @@
 upo_ht_sepchain_t upo_ht_sepchain_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
 {
     upo_ht_sepchain_t ht = NULL;
-    size_t i = 0;
 
     /* preconditions */
     assert( key_hash != NULL );
     assert( key_cmp != NULL );
 
+    ht = upo_ht_sepchain_alloc(m, key_cmp);
+    ht->key_hash = key_hash;
+
+    return ht;
+}
+
+upo_ht_sepchain_t upo_ht_sepchain_create_seeded(size_t m, upo_ht_seeded_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_sepchain_t ht = NULL;
+
+    /* preconditions */
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
+
+    ht = upo_ht_sepchain_alloc(m, key_cmp);
+    ht->seeded_key_hash = key_hash;
+    ht->seed = upo_ht_random_seed();
+
+    return ht;
+}
+
+size_t upo_ht_sepchain_seed(const upo_ht_sepchain_t ht)
+{
+    return (ht != NULL) ? ht->seed : 0;
+}
+
+upo_ht_sepchain_t upo_ht_sepchain_alloc(size_t m, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_sepchain_t ht = NULL;
+    size_t i = 0;
+
     /* Allocate memory for the hash table type */
     ht = malloc(sizeof(struct upo_ht_sepchain_s));
     if (ht == NULL)
@@ -64,8 +98,21 @@ upo_ht_sepchain_t upo_ht_sepchain_create(size_t m, upo_ht_hasher_t key_hash, upo
     }
     ht->capacity = m;
     ht->size = 0;
-    ht->key_hash = key_hash;
+    ht->key_hash = NULL;
+    ht->seeded_key_hash = NULL;
+    ht->seed = 0;
     ht->key_cmp = key_cmp;
+    ht->nodes = upo_mem_pool_create(sizeof(upo_ht_sepchain_list_node_t), 0);
+    ht->min_capacity = m;
+    ht->min_load_factor = UPO_HT_SEPCHAIN_DEFAULT_MIN_LOAD_FACTOR;
+    ht->max_load_factor = UPO_HT_SEPCHAIN_DEFAULT_MAX_LOAD_FACTOR;
+    upo_ht_sepchain_update_thresholds(ht);
+    ht->resizes = 0;
+    ht->resize_time = 0;
+    ht->filter_type = UPO_HT_FILTER_NONE;
+    ht->bloom = NULL;
+    ht->cuckoo = NULL;
+    ht->filter_capacity = 0;
 
     return ht;
 }
@@ -75,6 +122,9 @@ void upo_ht_sepchain_destroy(upo_ht_sepchain_t ht, int destroy_data)
     if (ht != NULL)
     {
         upo_ht_sepchain_clear(ht, destroy_data);
+        upo_mem_pool_destroy(ht->nodes);
+        upo_bloom_filter_destroy(ht->bloom);
+        upo_cuckoo_filter_destroy(ht->cuckoo);
         free(ht->slots);
         free(ht);
     }
@@ -86,28 +136,26 @@ void upo_ht_sepchain_clear(upo_ht_sepchain_t ht, int destroy_data)
     {
         size_t i = 0;
 
-        /* For each slot, clear the associated list of collisions */
+        /* For each slot, clear the associated list of collisions.
+         * Nodes are not freed one by one: they are all given back at once
+         * by clearing the pool they were drawn from. */
         for (i = 0; i < ht->capacity; ++i)
         {
-            upo_ht_sepchain_list_node_t* list = NULL;
-
-            list = ht->slots[i].head;
-            while (list != NULL)
+            if (destroy_data)
             {
-                upo_ht_sepchain_list_node_t* node = list;
-
-                list = list->next;
+                upo_ht_sepchain_list_node_t* list = NULL;
 
-                if (destroy_data)
+                for (list = ht->slots[i].head; list != NULL; list = list->next)
                 {
-                    free(node->key);
-                    free(node->value);
+                    free(list->key);
+                    free(list->value);
                 }
-
-                free(node);
             }
             ht->slots[i].head = NULL;
         }
+        upo_mem_pool_clear(ht->nodes);
+        upo_bloom_filter_clear(ht->bloom);
+        upo_cuckoo_filter_clear(ht->cuckoo);
         ht->size = 0;
     }
 }
@@ -115,20 +163,27 @@ void upo_ht_sepchain_clear(upo_ht_sepchain_t ht, int destroy_data)
 void* upo_ht_sepchain_put(upo_ht_sepchain_t ht, void* key, void* value)
 {
     void* old_value = NULL;
-    upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, upo_ht_sepchain_capacity(ht));
+    size_t hash = upo_ht_sepchain_hash(ht, key, upo_ht_sepchain_capacity(ht));
     upo_ht_sepchain_list_node_t* n = ht->slots[hash].head;
     upo_ht_comparator_t key_cmp = ht->key_cmp;
     while (n != NULL && key_cmp(key, n->key) != 0)
         n = n->next;
     if (n == NULL)
     {
-        n = malloc(sizeof(upo_ht_sepchain_list_node_t));
+        n = upo_mem_pool_alloc(ht->nodes);
         n->key = key;
         n->value = value;
         n->next = ht->slots[hash].head;
         ht->slots[hash].head = n;
         ht->size += 1;
+        if (ht->size > ht->grow_size)
+        {
+            upo_ht_sepchain_resize(ht, 2*ht->capacity);
+        }
+        else if (ht->filter_type != UPO_HT_FILTER_NONE)
+        {
+            upo_ht_sepchain_filter_add(ht, key);
+        }
     }
     else
     {
@@ -140,29 +195,39 @@ void* upo_ht_sepchain_put(upo_ht_sepchain_t ht, void* key, void* value)
 
 void upo_ht_sepchain_insert(upo_ht_sepchain_t ht, void* key, void* value)
 {
-    upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, upo_ht_sepchain_capacity(ht));
+    size_t hash = upo_ht_sepchain_hash(ht, key, upo_ht_sepchain_capacity(ht));
     upo_ht_sepchain_list_node_t* n = ht->slots[hash].head;
     upo_ht_comparator_t key_cmp = ht->key_cmp;
     while (n != NULL && key_cmp(key, n->key) != 0)
         n = n->next;
     if (n == NULL)
     {
-        n = malloc(sizeof(upo_ht_sepchain_list_node_t));
+        n = upo_mem_pool_alloc(ht->nodes);
         n->key = key;
         n->value = value;
         n->next = ht->slots[hash].head;
         ht->slots[hash].head = n;
         ht->size += 1;
+        if (ht->size > ht->grow_size)
+        {
+            upo_ht_sepchain_resize(ht, 2*ht->capacity);
+        }
+        else if (ht->filter_type != UPO_HT_FILTER_NONE)
+        {
+            upo_ht_sepchain_filter_add(ht, key);
+        }
     }
 }
 
 void* upo_ht_sepchain_get(const upo_ht_sepchain_t ht, const void* key)
 {
-    upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, upo_ht_sepchain_capacity(ht));
-    upo_ht_sepchain_list_node_t* n = ht->slots[hash].head;
+    size_t hash = 0;
+    upo_ht_sepchain_list_node_t* n = NULL;
     upo_ht_comparator_t key_cmp = ht->key_cmp;
+    if (!upo_ht_sepchain_filter_may_contain(ht, key))
+        return NULL;
+    hash = upo_ht_sepchain_hash(ht, key, upo_ht_sepchain_capacity(ht));
+    n = ht->slots[hash].head;
     while (n != NULL && key_cmp(key, n->key) != 0)
         n = n->next;
     if (n != NULL)
@@ -170,6 +235,72 @@ void* upo_ht_sepchain_get(const upo_ht_sepchain_t ht, const void* key)
     return NULL;
 }
 
+size_t upo_ht_sepchain_get_batch(const upo_ht_sepchain_t ht, void* const* keys, size_t n, void** values_out)
+{
+    size_t hashes[UPO_HT_BATCH_GROUP_SIZE];
+    upo_ht_comparator_t key_cmp = NULL;
+    size_t found = 0;
+    size_t first = 0;
+
+    /* preconditions */
+    assert( ht != NULL );
+    assert( keys != NULL || n == 0 );
+    assert( values_out != NULL || n == 0 );
+
+    key_cmp = ht->key_cmp;
+    for (first = 0; first < n; first += UPO_HT_BATCH_GROUP_SIZE)
+    {
+        size_t group = (n - first < UPO_HT_BATCH_GROUP_SIZE) ? n - first : UPO_HT_BATCH_GROUP_SIZE;
+        size_t i = 0;
+
+        /* Stage 1: hash the keys and prefetch their slots (keys rejected
+         * by the filter are marked by a hash equal to the capacity) */
+        for (i = 0; i < group; ++i)
+        {
+            if (upo_ht_sepchain_filter_may_contain(ht, keys[first+i]))
+            {
+                hashes[i] = upo_ht_sepchain_hash(ht, keys[first+i], ht->capacity);
+                UPO_PREFETCH(&ht->slots[hashes[i]]);
+            }
+            else
+            {
+                hashes[i] = ht->capacity;
+            }
+        }
+
+        /* Stage 2: prefetch the heads of the lists of collisions */
+        for (i = 0; i < group; ++i)
+        {
+            if (hashes[i] < ht->capacity)
+            {
+                UPO_PREFETCH(ht->slots[hashes[i]].head);
+            }
+        }
+
+        /* Stage 3: walk the lists, whose first nodes should now be cached */
+        for (i = 0; i < group; ++i)
+        {
+            upo_ht_sepchain_list_node_t* node = (hashes[i] < ht->capacity) ? ht->slots[hashes[i]].head : NULL;
+
+            while (node != NULL && key_cmp(keys[first+i], node->key) != 0)
+            {
+                node = node->next;
+            }
+            if (node != NULL)
+            {
+                values_out[first+i] = node->value;
+                ++found;
+            }
+            else
+            {
+                values_out[first+i] = NULL;
+            }
+        }
+    }
+
+    return found;
+}
+
 int upo_ht_sepchain_contains(const upo_ht_sepchain_t ht, const void* key)
 {
     return (upo_ht_sepchain_get(ht, key) != NULL) ? 1 : 0;
@@ -177,8 +308,7 @@ int upo_ht_sepchain_contains(const upo_ht_sepchain_t ht, const void* key)
 
 void upo_ht_sepchain_delete(upo_ht_sepchain_t ht, const void* key, int destroy_data)
 {
-    upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, upo_ht_sepchain_capacity(ht));
+    size_t hash = upo_ht_sepchain_hash(ht, key, upo_ht_sepchain_capacity(ht));
     upo_ht_sepchain_list_node_t* n = ht->slots[hash].head;
     upo_ht_sepchain_list_node_t* p = NULL;
     upo_ht_comparator_t key_cmp = ht->key_cmp;
@@ -198,8 +328,16 @@ void upo_ht_sepchain_delete(upo_ht_sepchain_t ht, const void* key, int destroy_d
             free(n->key);
             free(n->value);
         }
-        free(n);
+        upo_mem_pool_free(ht->nodes, n);
         ht->size -= 1;
+        if (ht->cuckoo != NULL)
+        {
+            upo_cuckoo_filter_remove(ht->cuckoo, upo_ht_sepchain_hash(ht, key, UPO_HT_HASH_FULL_RANGE));
+        }
+        if (ht->size < ht->shrink_size && ht->capacity/2 >= ht->min_capacity)
+        {
+            upo_ht_sepchain_resize(ht, ht->capacity/2);
+        }
     }
 }
 
@@ -223,69 +361,275 @@ double upo_ht_sepchain_load_factor(const upo_ht_sepchain_t ht)
     return upo_ht_sepchain_size(ht) / (double) upo_ht_sepchain_capacity(ht);
 }
 
+void upo_ht_sepchain_set_load_factors(upo_ht_sepchain_t ht, double min_load_factor, double max_load_factor)
+{
+    /* preconditions */
+    assert( ht != NULL );
+    assert( min_load_factor >= 0 );
+    assert( max_load_factor >= 0 );
+    assert( max_load_factor == 0 || min_load_factor < max_load_factor/2 );
+
+    ht->min_load_factor = min_load_factor;
+    ht->max_load_factor = max_load_factor;
+    upo_ht_sepchain_update_thresholds(ht);
 
-/*** EXERCISE #1 - END of HASH TABLE with SEPARATE CHAINING ***/
+    if (ht->size > ht->grow_size)
+    {
+        upo_ht_sepchain_reserve(ht, ht->size);
+    }
+    else if (ht->size < ht->shrink_size && ht->capacity/2 >= ht->min_capacity)
+    {
+        size_t m = ht->capacity;
+
+        /* Halve as many times as needed, then rehash only once */
+        do
+        {
+            m /= 2;
+        }
+        while (ht->size < ht->min_load_factor*m && m/2 >= ht->min_capacity);
+        upo_ht_sepchain_resize(ht, m);
+    }
+}
 
+void upo_ht_sepchain_reserve(upo_ht_sepchain_t ht, size_t n)
+{
+    size_t m = 0;
 
-/*** EXERCISE #2 - BEGIN of HASH TABLE with LINEAR PROBING ***/
+    /* preconditions */
+    assert( ht != NULL );
 
+    m = ht->capacity > 0 ? ht->capacity : 1;
+    if (ht->max_load_factor > 0)
+    {
+        /* Double the capacity until n keys stay within the maximum load factor */
+        while (n > (size_t) (ht->max_load_factor*m))
+        {
+            m *= 2;
+        }
+    }
+    else
+    {
+        while (n > m)
+        {
+            m *= 2;
+        }
+    }
+    if (m != ht->capacity)
+    {
+        upo_ht_sepchain_resize(ht, m);
+    }
+}
 
-void upo_ht_linprob_resize(upo_ht_linprob_t ht, size_t n)
+void upo_ht_sepchain_resize(upo_ht_sepchain_t ht, size_t n)
 {
+    upo_ht_sepchain_slot_t* slots = NULL;
+    upo_hires_timer_t timer = NULL;
+    size_t i = 0;
+
     /* preconditions */
     assert( n > 0 );
 
-    if (ht != NULL)
+    timer = upo_hires_timer_create();
+    upo_hires_timer_start(timer);
+
+    slots = malloc(n*sizeof(upo_ht_sepchain_slot_t));
+    if (slots == NULL)
+    {
+        perror("Unable to allocate memory for slots of the Hash Table with Separate Chaining");
+        abort();
+    }
+    for (i = 0; i < n; ++i)
     {
-        /* The hash table must be rebuilt from scratch since the hash value of
-         * keys will be in general different (due to the change in the
-         * capacity). */
+        slots[i].head = NULL;
+    }
 
-        size_t i = 0;
-        upo_ht_linprob_t new_ht = NULL;
+    /* Unlike linear probing, nodes can simply be relinked into the new
+     * slots: the keys are rehashed but no node is allocated or freed. */
+    for (i = 0; i < ht->capacity; ++i)
+    {
+        upo_ht_sepchain_list_node_t* node = ht->slots[i].head;
 
-        /* Create a new temporary hash table */
-        new_ht = upo_ht_linprob_create(n, ht->key_hash, ht->key_cmp);
-        if (new_ht == NULL)
+        while (node != NULL)
         {
-            perror("Unable to allocate memory for slots of the Hash Table with Separate Chaining");
-            abort();
+            upo_ht_sepchain_list_node_t* next = node->next;
+            size_t hash = upo_ht_sepchain_hash(ht, node->key, n);
+
+            node->next = slots[hash].head;
+            slots[hash].head = node;
+            node = next;
         }
+    }
 
-        /* Put in the temporary hash table the key-value pairs stored in the
-         * hash table to resize.
-         * Note: by calling function 'put' we are also rehashing the keys
-         * according to the new capacity. */
-        for (i = 0; i < ht->capacity; ++i)
+    free(ht->slots);
+    ht->slots = slots;
+    ht->capacity = n;
+    upo_ht_sepchain_update_thresholds(ht);
+    if (ht->filter_type != UPO_HT_FILTER_NONE)
+    {
+        upo_ht_sepchain_filter_rebuild(ht, 0);
+    }
+
+    upo_hires_timer_stop(timer);
+    ht->resizes += 1;
+    ht->resize_time += upo_hires_timer_elapsed(timer);
+    upo_hires_timer_destroy(timer);
+}
+
+void upo_ht_sepchain_update_thresholds(upo_ht_sepchain_t ht)
+{
+    /* Thresholds are kept as sizes so that insertions and removals do not
+     * need to compute the load factor */
+    ht->grow_size = (ht->max_load_factor > 0) ? (size_t) (ht->max_load_factor*ht->capacity) : (size_t) -1;
+    ht->shrink_size = (size_t) (ht->min_load_factor*ht->capacity);
+}
+
+size_t upo_ht_sepchain_hash(const upo_ht_sepchain_t ht, const void* key, size_t m)
+{
+    return (ht->seeded_key_hash != NULL) ? ht->seeded_key_hash(key, ht->seed, m) : ht->key_hash(key, m);
+}
+
+void upo_ht_sepchain_set_filter(upo_ht_sepchain_t ht, int type)
+{
+    /* preconditions */
+    assert( ht != NULL );
+    assert( type == UPO_HT_FILTER_NONE || type == UPO_HT_FILTER_BLOOM || type == UPO_HT_FILTER_CUCKOO );
+
+    ht->filter_type = type;
+    upo_ht_sepchain_filter_rebuild(ht, 0);
+}
+
+void upo_ht_sepchain_filter_rebuild(upo_ht_sepchain_t ht, size_t n)
+{
+    size_t i = 0;
+
+    upo_bloom_filter_destroy(ht->bloom);
+    ht->bloom = NULL;
+    upo_cuckoo_filter_destroy(ht->cuckoo);
+    ht->cuckoo = NULL;
+    ht->filter_capacity = 0;
+    if (ht->filter_type == UPO_HT_FILTER_NONE)
+    {
+        return;
+    }
+
+    /* Size the filter for the keys the table can hold before its next resize
+     * (which rebuilds the filter), or for twice the current keys if it never
+     * grows */
+    if (n < 2*ht->size)
+    {
+        n = 2*ht->size;
+    }
+    if (ht->grow_size != (size_t) -1 && n < ht->grow_size)
+    {
+        n = ht->grow_size;
+    }
+    if (n < UPO_HT_SEPCHAIN_DEFAULT_CAPACITY)
+    {
+        n = UPO_HT_SEPCHAIN_DEFAULT_CAPACITY;
+    }
+
+    if (ht->filter_type == UPO_HT_FILTER_BLOOM)
+    {
+        ht->bloom = upo_bloom_filter_create(n, UPO_BLOOM_FILTER_DEFAULT_BITS_PER_ELEMENT);
+    }
+    else
+    {
+        ht->cuckoo = upo_cuckoo_filter_create(n);
+    }
+    ht->filter_capacity = n;
+
+    for (i = 0; i < ht->capacity; ++i)
+    {
+        upo_ht_sepchain_list_node_t* node = NULL;
+
+        for (node = ht->slots[i].head; node != NULL; node = node->next)
         {
-            if (ht->slots[i].key != NULL)
+            size_t hash = upo_ht_sepchain_hash(ht, node->key, UPO_HT_HASH_FULL_RANGE);
+
+            if (ht->bloom != NULL)
+            {
+                upo_bloom_filter_add(ht->bloom, hash);
+            }
+            else if (!upo_cuckoo_filter_add(ht->cuckoo, hash))
             {
-                upo_ht_linprob_put(new_ht, ht->slots[i].key, ht->slots[i].value);
+                /* Unlucky placement: start over with a larger filter */
+                upo_ht_sepchain_filter_rebuild(ht, 2*n);
+                return;
             }
         }
+    }
+}
+
+void upo_ht_sepchain_filter_add(upo_ht_sepchain_t ht, const void* key)
+{
+    size_t hash = 0;
+
+    if (ht->size > ht->filter_capacity)
+    {
+        /* The table no longer grows with its keys: neither does the filter */
+        upo_ht_sepchain_filter_rebuild(ht, 0);
+        return;
+    }
 
-        /* Copy the new slots in the old hash table.
-         * To do so we use a trick that avoids to loop for each key-value pair:
-         * swap the array of slots, the size and the capacity between new and
-         * old hash tables. */
-        upo_swap(&ht->slots, &new_ht->slots, sizeof ht->slots);
-        upo_swap(&ht->capacity, &new_ht->capacity, sizeof ht->capacity);
-        upo_swap(&ht->size, &new_ht->size, sizeof ht->size);
+    hash = upo_ht_sepchain_hash(ht, key, UPO_HT_HASH_FULL_RANGE);
+    if (ht->bloom != NULL)
+    {
+        upo_bloom_filter_add(ht->bloom, hash);
+    }
+    else if (!upo_cuckoo_filter_add(ht->cuckoo, hash))
+    {
+        upo_ht_sepchain_filter_rebuild(ht, 2*ht->filter_capacity);
+    }
+}
 
-        /* Destroy temporary hash table */
-        upo_ht_linprob_destroy(new_ht, 0);
+int upo_ht_sepchain_filter_may_contain(const upo_ht_sepchain_t ht, const void* key)
+{
+    if (ht->bloom != NULL)
+    {
+        return upo_bloom_filter_may_contain(ht->bloom, upo_ht_sepchain_hash(ht, key, UPO_HT_HASH_FULL_RANGE));
+    }
+    if (ht->cuckoo != NULL)
+    {
+        return upo_cuckoo_filter_may_contain(ht->cuckoo, upo_ht_sepchain_hash(ht, key, UPO_HT_HASH_FULL_RANGE));
     }
+
+    return 1;
 }
 
+
+/*** EXERCISE #1 - END of HASH TABLE with SEPARATE CHAINING ***/
+
+
+/*** EXERCISE #2 - BEGIN of HASH TABLE with LINEAR PROBING ***/
+
+
 upo_ht_linprob_t upo_ht_linprob_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
 {
-    upo_ht_linprob_t ht = NULL;
-    size_t i = 0;
+    /* preconditions */
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
 
+    return upo_ht_linprob_alloc(m, key_hash, NULL, key_cmp);
+}
+
+upo_ht_linprob_t upo_ht_linprob_create_seeded(size_t m, upo_ht_seeded_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
     /* preconditions */
     assert( key_hash != NULL );
     assert( key_cmp != NULL );
 
+    return upo_ht_linprob_alloc(m, NULL, key_hash, key_cmp);
+}
+
+size_t upo_ht_linprob_seed(const upo_ht_linprob_t ht)
+{
+    return (ht != NULL) ? ht->core.seed : 0;
+}
+
+upo_ht_linprob_t upo_ht_linprob_alloc(size_t m, upo_ht_hasher_t key_hash, upo_ht_seeded_hasher_t seeded_key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_linprob_t ht = NULL;
+
     /* Allocate memory for the hash table type */
     ht = malloc(sizeof(struct upo_ht_linprob_s));
     if (ht == NULL)
@@ -294,29 +638,9 @@ upo_ht_linprob_t upo_ht_linprob_create(size_t m, upo_ht_hasher_t key_hash, upo_h
         abort();
     }
 
-    /* Allocate memory for the array of slots */
-    if (m > 0)
-    {
-        ht->slots = malloc(m*sizeof(upo_ht_linprob_slot_t));
-        if (ht->slots == NULL)
-        {
-            perror("Unable to allocate memory for slots of the Hash Table with Separate Chaining");
-            abort();
-        }
-
-        /* Initialize the slots */
-        for (i = 0; i < m; ++i)
-        {
-            ht->slots[i].key = NULL;
-            ht->slots[i].value = NULL;
-            ht->slots[i].tombstone = 0;
-        }
-    }
-
-    ht->capacity = m;
-    ht->size = 0;
-    ht->key_hash = key_hash;
-    ht->key_cmp = key_cmp;
+    /* The core rounds the capacity up to a power of two, so that probe
+     * sequences can wrap around with a mask instead of a modulo. */
+    upo_hprobe_init(&ht->core, m, sizeof(upo_ht_linprob_entry_t), key_hash, seeded_key_hash, key_cmp);
 
     return ht;
 }
@@ -326,122 +650,90 @@ void upo_ht_linprob_destroy(upo_ht_linprob_t ht, int destroy_data)
     if (ht != NULL)
     {
         upo_ht_linprob_clear(ht, destroy_data);
-        free(ht->slots);
+        upo_hprobe_free(&ht->core);
         free(ht);
     }
 }
 
 void upo_ht_linprob_clear(upo_ht_linprob_t ht, int destroy_data)
 {
-    if (ht != NULL && ht->slots != NULL)
+    if (ht != NULL)
     {
-        size_t i = 0;
-
-        /* For each slot, clear the associated list of collisions */
-        for (i = 0; i < ht->capacity; ++i)
+        if (destroy_data)
         {
-            if (ht->slots[i].key != NULL)
+            size_t i = 0;
+
+            for (i = 0; i < ht->core.size; ++i)
             {
-                if (destroy_data)
-                {
-                    free(ht->slots[i].key);
-                    free(ht->slots[i].value);
-                }
-                ht->slots[i].key = NULL;
-                ht->slots[i].value = NULL;
-                ht->slots[i].tombstone = 0;
+                upo_ht_linprob_entry_t* entry = (upo_ht_linprob_entry_t*) UPO_HPROBE_ENTRY(&ht->core, i);
+
+                free(entry->header.key);
+                free(entry->value);
             }
         }
-        ht->size = 0;
+        upo_hprobe_clear(&ht->core);
     }
 }
 
 void* upo_ht_linprob_put(upo_ht_linprob_t ht, void* key, void* value)
 {
-    upo_ht_hasher_t hasher;
-    size_t hash;
-    size_t hash_tombstone;
-    upo_ht_comparator_t key_cmp;
-    int found_tombstone;
+    upo_ht_linprob_entry_t* entry = NULL;
     void* old_value = NULL;
-    if (upo_ht_linprob_load_factor(ht) >= 0.5)
-        upo_ht_linprob_resize(ht, upo_ht_linprob_capacity(ht) * 2);
-    hasher = ht->key_hash;
-    hash = hasher(key, upo_ht_linprob_capacity(ht));
-    key_cmp = ht->key_cmp;
-    found_tombstone = 0;
-    while ((ht->slots[hash].key != NULL && key_cmp(key, ht->slots[hash].key) != 0) ||
-            ht->slots[hash].tombstone)
-    {
-        if (ht->slots[hash].tombstone && !found_tombstone)
-        {
-            found_tombstone = 1;
-            hash_tombstone = hash;
-        }
-        hash = (hash + 1) % upo_ht_linprob_capacity(ht);
-    }
-    if (ht->slots[hash].key == NULL)
-    {
-        if (found_tombstone)
-            hash = hash_tombstone;
-        ht->slots[hash].key = key;
-        ht->slots[hash].value = value;
-        ht->slots[hash].tombstone = 0;
-        ht->size += 1;
-    }
-    else
+    int found = 0;
+
+    entry = (upo_ht_linprob_entry_t*) upo_hprobe_insert(&ht->core, key, upo_hprobe_hash(&ht->core, key), &found);
+    if (found)
     {
-        old_value = ht->slots[hash].value;
-        ht->slots[hash].value = value;
+        old_value = entry->value;
     }
+    entry->value = value;
+
     return old_value;
 }
 
 void upo_ht_linprob_insert(upo_ht_linprob_t ht, void* key, void* value)
 {
-    upo_ht_hasher_t hasher;
-    size_t hash;
-    size_t hash_tombstone;
-    upo_ht_comparator_t key_cmp;
-    int found_tombstone;
-    if (upo_ht_linprob_load_factor(ht) >= 0.5)
-        upo_ht_linprob_resize(ht, upo_ht_linprob_capacity(ht) * 2);
-    hasher = ht->key_hash;
-    hash = hasher(key, upo_ht_linprob_capacity(ht));
-    key_cmp = ht->key_cmp;
-    found_tombstone = 0;
-    while ((ht->slots[hash].key != NULL && key_cmp(key, ht->slots[hash].key) != 0) ||
-            ht->slots[hash].tombstone)
-    {
-        if (ht->slots[hash].tombstone && !found_tombstone)
-        {
-            found_tombstone = 1;
-            hash_tombstone = hash;
-        }
-        hash = (hash + 1) % upo_ht_linprob_capacity(ht);
-    }
-    if (ht->slots[hash].key == NULL)
+    upo_ht_linprob_entry_t* entry = NULL;
+    int found = 0;
+
+    entry = (upo_ht_linprob_entry_t*) upo_hprobe_insert(&ht->core, key, upo_hprobe_hash(&ht->core, key), &found);
+    if (!found)
     {
-        if (found_tombstone)
-            hash = hash_tombstone;
-        ht->slots[hash].key = key;
-        ht->slots[hash].value = value;
-        ht->slots[hash].tombstone = 0;
-        ht->size += 1;
+        entry->value = value;
     }
 }
 
 void* upo_ht_linprob_get(const upo_ht_linprob_t ht, const void* key)
 {
-    upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, upo_ht_linprob_capacity(ht));
-    upo_ht_comparator_t key_cmp = ht->key_cmp;
-    while ((ht->slots[hash].key != NULL && key_cmp(key, ht->slots[hash].key) != 0) ||
-            ht->slots[hash].tombstone)
+    upo_ht_linprob_entry_t* entry = (upo_ht_linprob_entry_t*) upo_hprobe_lookup(&ht->core, key);
+
+    return (entry != NULL) ? entry->value : NULL;
+}
+
+size_t upo_ht_linprob_get_batch(const upo_ht_linprob_t ht, void* const* keys, size_t n, void** values_out)
+{
+    upo_hprobe_entry_t* entries[UPO_HPROBE_BATCH_GROUP_SIZE];
+    size_t found = 0;
+    size_t first = 0;
+
+    /* preconditions */
+    assert( ht != NULL );
+    assert( keys != NULL || n == 0 );
+    assert( values_out != NULL || n == 0 );
+
+    for (first = 0; first < n; first += UPO_HPROBE_BATCH_GROUP_SIZE)
     {
-        hash = (hash + 1) % upo_ht_linprob_capacity(ht);
+        size_t group = (n - first < UPO_HPROBE_BATCH_GROUP_SIZE) ? n - first : UPO_HPROBE_BATCH_GROUP_SIZE;
+        size_t i = 0;
+
+        found += upo_hprobe_lookup_batch(&ht->core, keys + first, group, entries);
+        for (i = 0; i < group; ++i)
+        {
+            values_out[first+i] = (entries[i] != NULL) ? ((upo_ht_linprob_entry_t*) entries[i])->value : NULL;
+        }
     }
-    return (ht->slots[hash].key != NULL) ? ht->slots[hash].value : NULL;
+
+    return found;
 }
 
 int upo_ht_linprob_contains(const upo_ht_linprob_t ht, const void* key)
@@ -451,30 +743,23 @@ int upo_ht_linprob_contains(const upo_ht_linprob_t ht, const void* key)
 
 void upo_ht_linprob_delete(upo_ht_linprob_t ht, const void* key, int destroy_data)
 {
-    upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, upo_ht_linprob_capacity(ht));
-    upo_ht_comparator_t key_cmp = ht->key_cmp;
-    while ((ht->slots[hash].key != NULL && key_cmp(key, ht->slots[hash].key) != 0) ||
-            ht->slots[hash].tombstone)
-    {
-        hash = (hash + 1) % upo_ht_linprob_capacity(ht);
-    }
-    if (ht->slots[hash].key != NULL)
+    upo_ht_linprob_entry_t* entry = (upo_ht_linprob_entry_t*) upo_hprobe_lookup(&ht->core, key);
+
+    if (entry != NULL)
     {
-        ht->slots[hash].key = NULL;
-        ht->slots[hash].value = NULL;
-        ht->slots[hash].tombstone = 1;
-        ht->size -= 1;
         if (destroy_data)
-        {}
-        if (upo_ht_linprob_load_factor(ht) <= 0.125)
-            upo_ht_linprob_resize(ht, upo_ht_linprob_capacity(ht) / 2);
+        {
+            free(entry->header.key);
+            free(entry->value);
+        }
+        /* The following keys of the cluster are moved back: no tombstone is left */
+        upo_hprobe_remove(&ht->core, &entry->header);
     }
 }
 
 size_t upo_ht_linprob_size(const upo_ht_linprob_t ht)
 {
-    return (ht != NULL) ? ht->size : 0;
+    return (ht != NULL) ? ht->core.size : 0;
 }
 
 int upo_ht_linprob_is_empty(const upo_ht_linprob_t ht)
@@ -484,7 +769,7 @@ int upo_ht_linprob_is_empty(const upo_ht_linprob_t ht)
 
 size_t upo_ht_linprob_capacity(const upo_ht_linprob_t ht)
 {
-    return (ht != NULL) ? ht->capacity : 0;
+    return (ht != NULL) ? ht->core.capacity : 0;
 }
 
 double upo_ht_linprob_load_factor(const upo_ht_linprob_t ht)
@@ -492,6 +777,14 @@ double upo_ht_linprob_load_factor(const upo_ht_linprob_t ht)
     return upo_ht_linprob_size(ht) / (double) upo_ht_linprob_capacity(ht);
 }
 
+void upo_ht_linprob_compact(upo_ht_linprob_t ht)
+{
+    /* preconditions */
+    assert( ht != NULL );
+
+    upo_hprobe_resize(&ht->core, ht->core.capacity);
+}
+
 
 /*** EXERCISE #2 - END of HASH TABLE with LINEAR PROBING ***/
 
@@ -543,20 +836,20 @@ void upo_ht_sepchain_traverse(const upo_ht_sepchain_t ht, upo_ht_visitor_t visit
 upo_ht_key_list_t upo_ht_linprob_keys(const upo_ht_linprob_t ht)
 {
     upo_ht_key_list_t key_list = NULL;
-    if (ht != NULL && ht->slots != NULL)
+    if (ht != NULL)
     {
         size_t i = 0;
-        for (i = 0; i < ht->capacity; ++i)
+        for (i = 0; i < ht->core.size; ++i)
         {
-            upo_ht_linprob_slot_t slot;
-            slot = ht->slots[i];
-            if (slot.key != NULL)
+            upo_ht_key_list_node_t* key_node = malloc(sizeof(upo_ht_key_list_node_t));
+            if (key_node == NULL)
             {
-                upo_ht_key_list_node_t* key_node = malloc(sizeof(upo_ht_key_list_node_t));
-                key_node->key = slot.key;
-                key_node->next = key_list;
-                key_list = key_node;
+                perror("Unable to allocate memory for the list of keys");
+                abort();
             }
+            key_node->key = UPO_HPROBE_ENTRY(&ht->core, i)->key;
+            key_node->next = key_list;
+            key_list = key_node;
         }
     }
     return key_list;
@@ -564,35 +857,387 @@ upo_ht_key_list_t upo_ht_linprob_keys(const upo_ht_linprob_t ht)
 
 void upo_ht_linprob_traverse(const upo_ht_linprob_t ht, upo_ht_visitor_t visit, void* visit_arg)
 {
+    if (ht != NULL)
+    {
+        size_t i = 0;
+        for (i = 0; i < ht->core.size; ++i)
+        {
+            const upo_ht_linprob_entry_t* entry = (const upo_ht_linprob_entry_t*) UPO_HPROBE_ENTRY(&ht->core, i);
+
+            visit(entry->header.key, entry->value, visit_arg);
+        }
+    }
+}
+
+void upo_ht_cursor_reset(upo_ht_cursor_t* cursor)
+{
+    /* preconditions */
+    assert( cursor != NULL );
+
+    cursor->index = 0;
+    cursor->node = NULL;
+}
+
+int upo_ht_sepchain_cursor_next(const upo_ht_sepchain_t ht, upo_ht_cursor_t* cursor, void** key, void** value)
+{
+    upo_ht_sepchain_list_node_t* node = NULL;
+
+    /* preconditions */
+    assert( cursor != NULL );
+
+    if (ht == NULL || ht->slots == NULL)
+    {
+        return 0;
+    }
+
+    /* Continue the current list of collisions, or move to the next one */
+    node = cursor->node;
+    while (node == NULL && cursor->index < ht->capacity)
+    {
+        node = ht->slots[cursor->index].head;
+        cursor->index += 1;
+    }
+    if (node == NULL)
+    {
+        return 0;
+    }
+    if (key != NULL)
+    {
+        *key = node->key;
+    }
+    if (value != NULL)
+    {
+        *value = node->value;
+    }
+    cursor->node = node->next;
+
+    return 1;
+}
+
+size_t upo_ht_sepchain_keys_into(const upo_ht_sepchain_t ht, void** keys, size_t n)
+{
+    size_t count = 0;
+
+    /* preconditions */
+    assert( keys != NULL || n == 0 );
+
     if (ht != NULL && ht->slots != NULL)
     {
         size_t i = 0;
-        for (i = 0; i < ht->capacity; ++i)
+        for (i = 0; i < ht->capacity && count < n; ++i)
         {
-            upo_ht_linprob_slot_t slot;
-            slot = ht->slots[i];
-            if (slot.key != NULL)
+            upo_ht_sepchain_list_node_t* node = NULL;
+            for (node = ht->slots[i].head; node != NULL && count < n; node = node->next)
             {
-                visit(slot.key, slot.value, visit_arg);
+                keys[count++] = node->key;
             }
         }
     }
+
+    return count;
+}
+
+int upo_ht_linprob_cursor_next(const upo_ht_linprob_t ht, upo_ht_cursor_t* cursor, void** key, void** value)
+{
+    const upo_ht_linprob_entry_t* entry = NULL;
+
+    /* preconditions */
+    assert( cursor != NULL );
+
+    if (ht == NULL || cursor->index >= ht->core.size)
+    {
+        return 0;
+    }
+    entry = (const upo_ht_linprob_entry_t*) UPO_HPROBE_ENTRY(&ht->core, cursor->index);
+    if (key != NULL)
+    {
+        *key = entry->header.key;
+    }
+    if (value != NULL)
+    {
+        *value = entry->value;
+    }
+    cursor->index += 1;
+
+    return 1;
+}
+
+size_t upo_ht_linprob_keys_into(const upo_ht_linprob_t ht, void** keys, size_t n)
+{
+    size_t count = 0;
+    size_t i = 0;
+
+    /* preconditions */
+    assert( keys != NULL || n == 0 );
+
+    count = upo_ht_linprob_size(ht) < n ? upo_ht_linprob_size(ht) : n;
+    for (i = 0; i < count; ++i)
+    {
+        keys[i] = UPO_HPROBE_ENTRY(&ht->core, i)->key;
+    }
+
+    return count;
+}
+
+void upo_ht_sepchain_stats(const upo_ht_sepchain_t ht, upo_ht_stats_t* stats)
+{
+    size_t probes = 0;
+    size_t i = 0;
+
+    /* preconditions */
+    assert( stats != NULL );
+
+    memset(stats, 0, sizeof(upo_ht_stats_t));
+    if (ht == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < ht->capacity; ++i)
+    {
+        upo_ht_sepchain_list_node_t* node = NULL;
+        size_t len = 0;
+
+        for (node = ht->slots[i].head; node != NULL; node = node->next)
+        {
+            ++len;
+        }
+        stats->histogram[(len < UPO_HT_STATS_HISTOGRAM_SIZE) ? len : UPO_HT_STATS_HISTOGRAM_SIZE-1] += 1;
+        if (len > stats->max_probe)
+        {
+            stats->max_probe = len;
+        }
+        /* Finding each key of a list in turn inspects 1+2+...+len nodes */
+        probes += len*(len + 1)/2;
+    }
+
+    stats->size = ht->size;
+    stats->capacity = ht->capacity;
+    stats->slot_bytes = ht->capacity*sizeof(upo_ht_sepchain_slot_t);
+    stats->entry_bytes = upo_mem_pool_footprint(ht->nodes);
+    stats->overhead_bytes = sizeof(struct upo_ht_sepchain_s)
+                            + upo_bloom_filter_memory_usage(ht->bloom)
+                            + upo_cuckoo_filter_memory_usage(ht->cuckoo);
+    stats->total_bytes = stats->slot_bytes + stats->entry_bytes + stats->overhead_bytes;
+    stats->avg_probe = (ht->size > 0) ? probes / (double) ht->size : 0;
+    stats->resizes = ht->resizes;
+    stats->resize_time = ht->resize_time;
+}
+
+void upo_ht_linprob_stats(const upo_ht_linprob_t ht, upo_ht_stats_t* stats)
+{
+    /* preconditions */
+    assert( stats != NULL );
+
+    if (ht == NULL)
+    {
+        memset(stats, 0, sizeof(upo_ht_stats_t));
+        return;
+    }
+
+    upo_hprobe_stats(&ht->core, stats);
+    stats->overhead_bytes = sizeof(struct upo_ht_linprob_s);
+    stats->total_bytes = stats->slot_bytes + stats->entry_bytes + stats->overhead_bytes;
 }
 
 
 /*** EXERCISE #3 - END of HASH TABLE - EXTRA OPERATIONS ***/
 
 
+/*** BEGIN of HASH TABLE - BULK BUILDING ***/
+
+
+upo_ht_sepchain_t upo_ht_sepchain_build_from_arrays(void* const* keys, void* const* values, size_t n, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_sepchain_t ht = NULL;
+    upo_ht_build_pair_t* pairs = NULL;
+    size_t* hashes = NULL;
+    size_t m = UPO_HT_SEPCHAIN_DEFAULT_CAPACITY;
+    size_t k = 0;
+
+    /* preconditions */
+    assert( keys != NULL || n == 0 );
+    assert( values != NULL || n == 0 );
+
+    /* Size the table once, as upo_ht_sepchain_reserve() would */
+    while (n > (size_t) (UPO_HT_SEPCHAIN_DEFAULT_MAX_LOAD_FACTOR*m))
+    {
+        m *= 2;
+    }
+    ht = upo_ht_sepchain_create(m, key_hash, key_cmp);
+    ht->min_capacity = UPO_HT_SEPCHAIN_DEFAULT_CAPACITY;
+
+    /* Hash all the keys in one pass: the hash values are the home slots */
+    hashes = malloc((n > 0 ? n : 1)*sizeof(size_t));
+    if (hashes == NULL)
+    {
+        perror("Unable to allocate memory for building the Hash Table with Separate Chaining");
+        abort();
+    }
+    for (k = 0; k < n; ++k)
+    {
+        hashes[k] = key_hash(keys[k], m);
+    }
+    pairs = upo_ht_partition_pairs(keys, values, hashes, n, m);
+    free(hashes);
+
+    for (k = 0; k < n; ++k)
+    {
+        upo_ht_sepchain_slot_t* slot = &ht->slots[pairs[k].hash];
+        upo_ht_sepchain_list_node_t* node = slot->head;
+
+        while (node != NULL && key_cmp(pairs[k].key, node->key) != 0)
+        {
+            node = node->next;
+        }
+        if (node == NULL)
+        {
+            /* Nodes are drawn from the pool in slot order, so neighboring chains end up close in memory */
+            node = upo_mem_pool_alloc(ht->nodes);
+            node->key = pairs[k].key;
+            node->next = slot->head;
+            slot->head = node;
+            ht->size += 1;
+        }
+        node->value = pairs[k].value;
+    }
+
+    free(pairs);
+
+    return ht;
+}
+
+upo_ht_linprob_t upo_ht_linprob_build_from_arrays(void* const* keys, void* const* values, size_t n, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_linprob_t ht = NULL;
+    upo_ht_build_pair_t* pairs = NULL;
+    size_t* hashes = NULL;
+    size_t k = 0;
+
+    /* preconditions */
+    assert( keys != NULL || n == 0 );
+    assert( values != NULL || n == 0 );
+
+    /* Size the table once, for the load factor (at most 1/2) repeated puts would end up with */
+    ht = upo_ht_linprob_create((2*n > UPO_HT_LINPROB_DEFAULT_CAPACITY) ? 2*n : UPO_HT_LINPROB_DEFAULT_CAPACITY, key_hash, key_cmp);
+
+    /* Hash all the keys in one pass; entries keep the hash values, so that
+     * most keys met while probing are told apart without comparing them */
+    hashes = malloc((n > 0 ? n : 1)*sizeof(size_t));
+    if (hashes == NULL)
+    {
+        perror("Unable to allocate memory for building the Hash Table with Linear Probing");
+        abort();
+    }
+    for (k = 0; k < n; ++k)
+    {
+        hashes[k] = upo_hprobe_hash(&ht->core, keys[k]);
+    }
+    pairs = upo_ht_partition_pairs(keys, values, hashes, n, ht->core.capacity);
+    free(hashes);
+
+    for (k = 0; k < n; ++k)
+    {
+        upo_ht_linprob_entry_t* entry = NULL;
+        int found = 0;
+
+        /* The table is large enough for all the keys, so it never grows meanwhile */
+        entry = (upo_ht_linprob_entry_t*) upo_hprobe_insert(&ht->core, pairs[k].key, pairs[k].hash, &found);
+        entry->value = pairs[k].value;
+    }
+
+    free(pairs);
+
+    return ht;
+}
+
+upo_ht_build_pair_t* upo_ht_partition_pairs(void* const* keys, void* const* values, const size_t* hashes, size_t n, size_t m)
+{
+    upo_ht_build_pair_t* pairs = NULL;
+    size_t* counts = NULL;
+    size_t num_parts = 0;
+    size_t width = 0;
+    size_t i = 0;
+
+    num_parts = (m + UPO_HT_BUILD_PARTITION_SLOTS - 1)/UPO_HT_BUILD_PARTITION_SLOTS;
+    if (num_parts > UPO_HT_BUILD_MAX_PARTITIONS)
+    {
+        num_parts = UPO_HT_BUILD_MAX_PARTITIONS;
+    }
+    width = (m + num_parts - 1)/num_parts;
+
+    pairs = malloc((n > 0 ? n : 1)*sizeof(upo_ht_build_pair_t));
+    counts = calloc(num_parts + 1, sizeof(size_t));
+    if (pairs == NULL || counts == NULL)
+    {
+        perror("Unable to allocate memory for partitioning keys");
+        abort();
+    }
+
+    /* Count the keys of each partition */
+    for (i = 0; i < n; ++i)
+    {
+        counts[(hashes[i] % m)/width + 1] += 1;
+    }
+    for (i = 1; i <= num_parts; ++i)
+    {
+        counts[i] += counts[i-1];
+    }
+    /* Scatter the pairs (a stable counting sort, so duplicate keys keep their relative order) */
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_build_pair_t* pair = &pairs[counts[(hashes[i] % m)/width]++];
+
+        pair->hash = hashes[i];
+        pair->key = keys[i];
+        pair->value = values[i];
+    }
+
+    free(counts);
+
+    return pairs;
+}
+
+
+/*** END of HASH TABLE - BULK BUILDING ***/
+
+
 /*** BEGIN of HASH FUNCTIONS ***/
 
 
+size_t upo_ht_reduce(size_t h, size_t m)
+{
+    /* preconditions */
+    assert( m > 0 );
+
+    return UPO_HT_IS_POW2(m) ? (h & (m-1)) : (h % m);
+}
+
+size_t upo_ht_reduce_fastrange(size_t h, size_t m)
+{
+    /* Computes the high word of the double-width product h*m by means of
+     * half-word multiplications, so that no wider integer type is needed. */
+    const unsigned int half = sizeof(size_t)*CHAR_BIT/2;
+    const size_t lo_mask = ((size_t) 1 << half) - 1;
+    size_t h_lo = h & lo_mask;
+    size_t h_hi = h >> half;
+    size_t m_lo = m & lo_mask;
+    size_t m_hi = m >> half;
+    size_t lo_lo = h_lo*m_lo;
+    size_t hi_lo = h_hi*m_lo;
+    size_t lo_hi = h_lo*m_hi;
+    size_t cross = (lo_lo >> half) + (hi_lo & lo_mask) + lo_hi;
+
+    return h_hi*m_hi + (hi_lo >> half) + (cross >> half);
+}
+
 size_t upo_ht_hash_int_div(const void* x, size_t m)
 {
     /* preconditions */
     assert( x != NULL );
     assert( m > 0 );
 
-    return *((int*) x) % m;
+    return upo_ht_reduce(*((int*) x), m);
 }
 
 size_t upo_ht_hash_int_mult(const void* x, double a, size_t m)
@@ -602,12 +1247,66 @@ size_t upo_ht_hash_int_mult(const void* x, double a, size_t m)
     assert( a > 0 && a < 1 );
     assert( m > 0 );
 
-    return floor( m * fmod(a * *((int*) x), 1.0) );
+    {
+        double ax = a * *((int*) x);
+
+        /* The fractional part is computed as ax - floor(ax) rather than by
+         * means of fmod(), which is slower and negative for negative keys. */
+        return floor( m * (ax - floor(ax)) );
+    }
 }
 
 size_t upo_ht_hash_int_mult_knuth(const void* x, size_t m)
 {
-    return upo_ht_hash_int_mult(x, 0.5*(sqrt(5)-1), m);
+    /* preconditions */
+    assert( x != NULL );
+    assert( m > 0 );
+
+    /* Fixed-point version of the multiplication method: the low 64 bits of
+     * x*floor(2^64*a) are the fractional part of x*a scaled by 2^64, and
+     * multiplying them by m keeps the integer part (i.e., the high word). */
+    return upo_ht_reduce_fastrange(upo_ht_fold64((uint64_t) (unsigned int) *((int*) x) * UPO_HT_GOLDEN_RATIO64), m);
+}
+
+size_t upo_ht_hash_int_mix(const void* x, size_t m)
+{
+    /* preconditions */
+    assert( x != NULL );
+    assert( m > 0 );
+
+    return upo_ht_reduce_fastrange(upo_ht_hash_mix((unsigned int) *((int*) x)), m);
+}
+
+size_t upo_ht_hash_mix(size_t x)
+{
+    uint64_t h = x;
+
+    /* The 64-bit finalizer of MurmurHash3 */
+    h ^= h >> 33;
+    h *= UINT64_C(0xFF51AFD7ED558CCD);
+    h ^= h >> 33;
+    h *= UINT64_C(0xC4CEB9FE1A85EC53);
+    h ^= h >> 33;
+
+    return upo_ht_fold64(h);
+}
+
+size_t upo_ht_hash_int_mix_seeded(const void* x, size_t seed, size_t m)
+{
+    /* preconditions */
+    assert( x != NULL );
+    assert( m > 0 );
+
+    return upo_ht_reduce_fastrange(upo_ht_hash_mix((unsigned int) *((int*) x) ^ seed), m);
+}
+
+size_t upo_ht_hash_int_sip(const void* x, size_t seed, size_t m)
+{
+    /* preconditions */
+    assert( x != NULL );
+    assert( m > 0 );
+
+    return upo_ht_reduce_fastrange(upo_ht_hash_bytes_sip(x, sizeof(int), seed, upo_ht_sip_key1(seed)), m);
 }
 
 size_t upo_ht_hash_str(const void* x, size_t h0, size_t a, size_t m)
@@ -618,17 +1317,15 @@ size_t upo_ht_hash_str(const void* x, size_t h0, size_t a, size_t m)
     /* preconditions */
     assert( x != NULL );
     assert( m > 0 );
-/*
-    assert( a < m );
-*/
-    assert( h0 < m );
 
+    /* Accumulate over the full width of size_t (i.e., modulo 2^w) and reduce
+     * only once at the end: this avoids one division per character. */
     for (; *s; ++s)
     {
-        h = (a*h + *s) % m;
+        h = a*h + *s;
     }
 
-    return h;
+    return upo_ht_reduce(h, m);
 }
 
 size_t upo_ht_hash_str_djb2(const void* x, size_t m)
@@ -647,10 +1344,10 @@ size_t upo_ht_hash_str_djb2a(const void* x, size_t m)
 
     for (; *s; ++s)
     {
-        h = (33U*h ^ *s) % m;
+        h = 33U*h ^ *s;
     }
 
-    return h;
+    return upo_ht_reduce(h, m);
 }
 
 size_t upo_ht_hash_str_java(const void* x, size_t m)
@@ -673,4 +1370,215 @@ size_t upo_ht_hash_str_stlport(const void* x, size_t m)
     return upo_ht_hash_str(x, 0U, 33U, m);
 }
 
+size_t upo_ht_hash_bytes_xx64(const void* data, size_t len, size_t seed)
+{
+    const unsigned char* p = data;
+    const unsigned char* end = p + len;
+    uint64_t h = 0;
+
+    /* preconditions */
+    assert( data != NULL || len == 0 );
+
+    if (len >= 32)
+    {
+        const unsigned char* limit = end - 32;
+        uint64_t v1 = (uint64_t) seed + UPO_HT_XX64_PRIME1 + UPO_HT_XX64_PRIME2;
+        uint64_t v2 = (uint64_t) seed + UPO_HT_XX64_PRIME2;
+        uint64_t v3 = (uint64_t) seed;
+        uint64_t v4 = (uint64_t) seed - UPO_HT_XX64_PRIME1;
+
+        /* Four independent lanes, 32 bytes per iteration */
+        do
+        {
+            v1 = upo_ht_xx64_round(v1, upo_ht_read64(p)); p += 8;
+            v2 = upo_ht_xx64_round(v2, upo_ht_read64(p)); p += 8;
+            v3 = upo_ht_xx64_round(v3, upo_ht_read64(p)); p += 8;
+            v4 = upo_ht_xx64_round(v4, upo_ht_read64(p)); p += 8;
+        }
+        while (p <= limit);
+
+        h = UPO_HT_ROTL64(v1, 1) + UPO_HT_ROTL64(v2, 7) + UPO_HT_ROTL64(v3, 12) + UPO_HT_ROTL64(v4, 18);
+        h = upo_ht_xx64_merge_round(h, v1);
+        h = upo_ht_xx64_merge_round(h, v2);
+        h = upo_ht_xx64_merge_round(h, v3);
+        h = upo_ht_xx64_merge_round(h, v4);
+    }
+    else
+    {
+        h = (uint64_t) seed + UPO_HT_XX64_PRIME5;
+    }
+
+    h += (uint64_t) len;
+
+    /* Tail: one word, then one half word, then single bytes */
+    for (; p + 8 <= end; p += 8)
+    {
+        h ^= upo_ht_xx64_round(0, upo_ht_read64(p));
+        h = UPO_HT_ROTL64(h, 27)*UPO_HT_XX64_PRIME1 + UPO_HT_XX64_PRIME4;
+    }
+    if (p + 4 <= end)
+    {
+        h ^= upo_ht_read32(p)*UPO_HT_XX64_PRIME1;
+        h = UPO_HT_ROTL64(h, 23)*UPO_HT_XX64_PRIME2 + UPO_HT_XX64_PRIME3;
+        p += 4;
+    }
+    for (; p < end; ++p)
+    {
+        h ^= (*p)*UPO_HT_XX64_PRIME5;
+        h = UPO_HT_ROTL64(h, 11)*UPO_HT_XX64_PRIME1;
+    }
+
+    /* Final avalanche */
+    h ^= h >> 33;
+    h *= UPO_HT_XX64_PRIME2;
+    h ^= h >> 29;
+    h *= UPO_HT_XX64_PRIME3;
+    h ^= h >> 32;
+
+    return upo_ht_fold64(h);
+}
+
+size_t upo_ht_hash_str_xx64(const void* x, size_t m)
+{
+    /* preconditions */
+    assert( x != NULL );
+    assert( m > 0 );
+
+    return upo_ht_reduce_fastrange(upo_ht_hash_bytes_xx64(x, strlen(x), 0), m);
+}
+
+size_t upo_ht_hash_str_sip(const void* x, size_t seed, size_t m)
+{
+    /* preconditions */
+    assert( x != NULL );
+    assert( m > 0 );
+
+    return upo_ht_reduce_fastrange(upo_ht_hash_bytes_sip(x, strlen(x), seed, upo_ht_sip_key1(seed)), m);
+}
+
+size_t upo_ht_hash_bytes_sip(const void* data, size_t len, size_t k0, size_t k1)
+{
+    const unsigned char* p = data;
+    const unsigned char* end = p + (len & ~(size_t) 7);
+    uint64_t v[4];
+    uint64_t word = 0;
+    size_t i = 0;
+
+    /* preconditions */
+    assert( data != NULL || len == 0 );
+
+    /* "somepseudorandomlygeneratedbytes" */
+    v[0] = (uint64_t) k0 ^ UINT64_C(0x736F6D6570736575);
+    v[1] = (uint64_t) k1 ^ UINT64_C(0x646F72616E646F6D);
+    v[2] = (uint64_t) k0 ^ UINT64_C(0x6C7967656E657261);
+    v[3] = (uint64_t) k1 ^ UINT64_C(0x7465646279746573);
+
+    for (; p < end; p += 8)
+    {
+        word = upo_ht_read64(p);
+        v[3] ^= word;
+        upo_ht_sip_rounds(v, UPO_HT_SIPHASH_C_ROUNDS);
+        v[0] ^= word;
+    }
+
+    /* The last word holds the remaining bytes and the length (mod 256) */
+    word = (uint64_t) len << 56;
+    for (i = 0; i < (len & 7); ++i)
+    {
+        word |= (uint64_t) p[i] << (8*i);
+    }
+    v[3] ^= word;
+    upo_ht_sip_rounds(v, UPO_HT_SIPHASH_C_ROUNDS);
+    v[0] ^= word;
+
+    v[2] ^= 0xFF;
+    upo_ht_sip_rounds(v, UPO_HT_SIPHASH_D_ROUNDS);
+
+    return upo_ht_fold64(v[0] ^ v[1] ^ v[2] ^ v[3]);
+}
+
+size_t upo_ht_random_seed(void)
+{
+    static size_t calls = 0;
+    size_t seed = 0;
+    FILE* fp = NULL;
+
+    fp = fopen("/dev/urandom", "rb");
+    if (fp != NULL)
+    {
+        size_t nread = fread(&seed, sizeof(seed), 1, fp);
+
+        fclose(fp);
+        if (nread == 1)
+        {
+            return seed;
+        }
+    }
+
+    /* No entropy source: mix whatever varies between runs and calls */
+    calls += 1;
+    seed = (size_t) time(NULL) ^ upo_ht_hash_mix((size_t) clock()) ^ upo_ht_hash_mix((size_t) &seed + calls);
+
+    return upo_ht_hash_mix(seed);
+}
+
+uint64_t upo_ht_read64(const unsigned char* p)
+{
+    /* Little-endian decoding; compilers turn it into a single load */
+    return (uint64_t) p[0]
+           | ((uint64_t) p[1] << 8)
+           | ((uint64_t) p[2] << 16)
+           | ((uint64_t) p[3] << 24)
+           | ((uint64_t) p[4] << 32)
+           | ((uint64_t) p[5] << 40)
+           | ((uint64_t) p[6] << 48)
+           | ((uint64_t) p[7] << 56);
+}
+
+uint64_t upo_ht_read32(const unsigned char* p)
+{
+    return (uint64_t) p[0]
+           | ((uint64_t) p[1] << 8)
+           | ((uint64_t) p[2] << 16)
+           | ((uint64_t) p[3] << 24);
+}
+
+uint64_t upo_ht_xx64_round(uint64_t acc, uint64_t input)
+{
+    acc += input*UPO_HT_XX64_PRIME2;
+    acc = UPO_HT_ROTL64(acc, 31);
+    return acc*UPO_HT_XX64_PRIME1;
+}
+
+uint64_t upo_ht_xx64_merge_round(uint64_t acc, uint64_t val)
+{
+    acc ^= upo_ht_xx64_round(0, val);
+    return acc*UPO_HT_XX64_PRIME1 + UPO_HT_XX64_PRIME4;
+}
+
+void upo_ht_sip_rounds(uint64_t v[4], int rounds)
+{
+    int r = 0;
+
+    for (r = 0; r < rounds; ++r)
+    {
+        v[0] += v[1]; v[1] = UPO_HT_ROTL64(v[1], 13); v[1] ^= v[0]; v[0] = UPO_HT_ROTL64(v[0], 32);
+        v[2] += v[3]; v[3] = UPO_HT_ROTL64(v[3], 16); v[3] ^= v[2];
+        v[0] += v[3]; v[3] = UPO_HT_ROTL64(v[3], 21); v[3] ^= v[0];
+        v[2] += v[1]; v[1] = UPO_HT_ROTL64(v[1], 17); v[1] ^= v[2]; v[2] = UPO_HT_ROTL64(v[2], 32);
+    }
+}
+
+size_t upo_ht_sip_key1(size_t seed)
+{
+    return upo_ht_hash_mix(seed ^ (size_t) UPO_HT_GOLDEN_RATIO64);
+}
+
+size_t upo_ht_fold64(uint64_t h)
+{
+    /* Keep the most significant (i.e., best mixed) bits when size_t is
+     * narrower than 64 bits */
+    return (size_t) (h >> (64 - sizeof(size_t)*CHAR_BIT));
+}
+
 /*** END of HASH FUNCTIONS ***/
@@ -0,0 +1,557 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include "hashtable_compact_private.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+
+
+upo_ht_compact_t upo_ht_compact_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_compact_t ht = NULL;
+    size_t n = UPO_HT_COMPACT_DEFAULT_CAPACITY;
+
+    /* preconditions */
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
+
+    ht = malloc(sizeof(struct upo_ht_compact_s));
+    if (ht == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the Compact Hash Table");
+    }
+
+    while (n < m)
+    {
+        n *= 2;
+    }
+    ht->slots = NULL;
+    ht->min_capacity = n;
+    ht->entries = NULL;
+    ht->entries_capacity = 0;
+    ht->num_entries = 0;
+    ht->size = 0;
+    ht->key_hash = key_hash;
+    ht->key_cmp = key_cmp;
+    upo_ht_compact_alloc_slots(ht, n);
+
+    return ht;
+}
+
+void upo_ht_compact_destroy(upo_ht_compact_t ht, int destroy_data)
+{
+    if (ht != NULL)
+    {
+        upo_ht_compact_clear(ht, destroy_data);
+        free(ht->slots);
+        free(ht->entries);
+        free(ht);
+    }
+}
+
+void upo_ht_compact_clear(upo_ht_compact_t ht, int destroy_data)
+{
+    if (ht != NULL)
+    {
+        size_t i = 0;
+
+        if (destroy_data)
+        {
+            for (i = 0; i < ht->num_entries; ++i)
+            {
+                if (ht->entries[i].key != NULL)
+                {
+                    free(ht->entries[i].key);
+                    free(ht->entries[i].value);
+                }
+            }
+        }
+        memset(ht->slots, 0xFF, ht->capacity*ht->slot_width);
+        ht->num_entries = 0;
+        ht->num_dummies = 0;
+        ht->size = 0;
+    }
+}
+
+void* upo_ht_compact_put(upo_ht_compact_t ht, void* key, void* value)
+{
+    size_t hash = 0;
+    size_t slot = 0;
+    size_t e = 0;
+    void* old_value = NULL;
+
+    /* preconditions */
+    assert( ht != NULL );
+    assert( key != NULL );
+
+    /* Removed slots count as well, or they could fill the slots and never let a probe end */
+    if (ht->num_entries == ht->usable || ht->size + ht->num_dummies >= ht->usable)
+    {
+        /* Grow if at least half of the entries are in use, otherwise just reclaim the removed ones */
+        upo_ht_compact_rebuild(ht, (ht->size >= ht->usable/2) ? 2*ht->capacity : ht->capacity);
+    }
+
+    hash = upo_ht_compact_hash(ht, key);
+    e = upo_ht_compact_find(ht, key, hash, &slot);
+    if (e != UPO_HT_COMPACT_EMPTY)
+    {
+        old_value = ht->entries[e].value;
+        ht->entries[e].value = value;
+    }
+    else
+    {
+        upo_ht_compact_append(ht, slot, hash, key, value);
+    }
+
+    return old_value;
+}
+
+void upo_ht_compact_insert(upo_ht_compact_t ht, void* key, void* value)
+{
+    size_t hash = 0;
+    size_t slot = 0;
+
+    /* preconditions */
+    assert( ht != NULL );
+    assert( key != NULL );
+
+    if (ht->num_entries == ht->usable || ht->size + ht->num_dummies >= ht->usable)
+    {
+        upo_ht_compact_rebuild(ht, (ht->size >= ht->usable/2) ? 2*ht->capacity : ht->capacity);
+    }
+
+    hash = upo_ht_compact_hash(ht, key);
+    if (upo_ht_compact_find(ht, key, hash, &slot) == UPO_HT_COMPACT_EMPTY)
+    {
+        upo_ht_compact_append(ht, slot, hash, key, value);
+    }
+}
+
+void* upo_ht_compact_get(const upo_ht_compact_t ht, const void* key)
+{
+    size_t e = 0;
+
+    if (ht == NULL)
+    {
+        return NULL;
+    }
+
+    e = upo_ht_compact_find(ht, key, upo_ht_compact_hash(ht, key), NULL);
+
+    return (e != UPO_HT_COMPACT_EMPTY) ? ht->entries[e].value : NULL;
+}
+
+int upo_ht_compact_contains(const upo_ht_compact_t ht, const void* key)
+{
+    if (ht == NULL)
+    {
+        return 0;
+    }
+
+    return upo_ht_compact_find(ht, key, upo_ht_compact_hash(ht, key), NULL) != UPO_HT_COMPACT_EMPTY ? 1 : 0;
+}
+
+void upo_ht_compact_delete(upo_ht_compact_t ht, const void* key, int destroy_data)
+{
+    size_t slot = 0;
+    size_t e = 0;
+
+    if (ht == NULL)
+    {
+        return;
+    }
+
+    e = upo_ht_compact_find(ht, key, upo_ht_compact_hash(ht, key), &slot);
+    if (e == UPO_HT_COMPACT_EMPTY)
+    {
+        return;
+    }
+
+    if (destroy_data)
+    {
+        free(ht->entries[e].key);
+        free(ht->entries[e].value);
+    }
+    /* The slot must stay non-empty, so that the probe sequences passing through it are not broken */
+    upo_ht_compact_slot_set(ht, slot, UPO_HT_COMPACT_DUMMY);
+    ht->num_dummies += 1;
+    ht->entries[e].key = NULL;
+    ht->entries[e].value = NULL;
+    ht->size -= 1;
+    if (e+1 == ht->num_entries)
+    {
+        /* The last entry can be reused right away */
+        ht->num_entries -= 1;
+    }
+
+    if (ht->size < ht->capacity/8 && ht->capacity/2 >= ht->min_capacity)
+    {
+        upo_ht_compact_rebuild(ht, ht->capacity/2);
+    }
+}
+
+int upo_ht_compact_is_empty(const upo_ht_compact_t ht)
+{
+    return upo_ht_compact_size(ht) == 0 ? 1 : 0;
+}
+
+size_t upo_ht_compact_capacity(const upo_ht_compact_t ht)
+{
+    return (ht != NULL) ? ht->capacity : 0;
+}
+
+size_t upo_ht_compact_size(const upo_ht_compact_t ht)
+{
+    return (ht != NULL) ? ht->size : 0;
+}
+
+double upo_ht_compact_load_factor(const upo_ht_compact_t ht)
+{
+    return upo_ht_compact_size(ht) / (double) upo_ht_compact_capacity(ht);
+}
+
+size_t upo_ht_compact_memory_usage(const upo_ht_compact_t ht)
+{
+    if (ht == NULL)
+    {
+        return 0;
+    }
+
+    return sizeof(struct upo_ht_compact_s)
+           + ht->capacity*ht->slot_width
+           + ht->entries_capacity*sizeof(upo_ht_compact_entry_t);
+}
+
+upo_ht_key_list_t upo_ht_compact_keys(const upo_ht_compact_t ht)
+{
+    upo_ht_key_list_t key_list = NULL;
+
+    if (ht != NULL)
+    {
+        size_t i = ht->num_entries;
+
+        /* Walk backward, so that prepending yields the insertion order */
+        while (i > 0)
+        {
+            --i;
+            if (ht->entries[i].key != NULL)
+            {
+                upo_ht_key_list_node_t* node = malloc(sizeof(upo_ht_key_list_node_t));
+                if (node == NULL)
+                {
+                    upo_throw_sys_error("Unable to allocate memory for the list of keys");
+                }
+                node->key = ht->entries[i].key;
+                node->next = key_list;
+                key_list = node;
+            }
+        }
+    }
+
+    return key_list;
+}
+
+void upo_ht_compact_traverse(const upo_ht_compact_t ht, upo_ht_visitor_t visit, void* visit_arg)
+{
+    if (ht != NULL)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < ht->num_entries; ++i)
+        {
+            if (ht->entries[i].key != NULL)
+            {
+                visit(ht->entries[i].key, ht->entries[i].value, visit_arg);
+            }
+        }
+    }
+}
+
+int upo_ht_compact_cursor_next(const upo_ht_compact_t ht, upo_ht_cursor_t* cursor, void** key, void** value)
+{
+    /* preconditions */
+    assert( cursor != NULL );
+
+    if (ht == NULL)
+    {
+        return 0;
+    }
+
+    while (cursor->index < ht->num_entries && ht->entries[cursor->index].key == NULL)
+    {
+        cursor->index += 1;
+    }
+    if (cursor->index >= ht->num_entries)
+    {
+        return 0;
+    }
+    if (key != NULL)
+    {
+        *key = ht->entries[cursor->index].key;
+    }
+    if (value != NULL)
+    {
+        *value = ht->entries[cursor->index].value;
+    }
+    cursor->index += 1;
+
+    return 1;
+}
+
+size_t upo_ht_compact_keys_into(const upo_ht_compact_t ht, void** keys, size_t n)
+{
+    size_t count = 0;
+    size_t i = 0;
+
+    /* preconditions */
+    assert( keys != NULL || n == 0 );
+
+    if (ht == NULL)
+    {
+        return 0;
+    }
+
+    for (i = 0; i < ht->num_entries && count < n; ++i)
+    {
+        if (ht->entries[i].key != NULL)
+        {
+            keys[count++] = ht->entries[i].key;
+        }
+    }
+
+    return count;
+}
+
+void upo_ht_compact_alloc_slots(upo_ht_compact_t ht, size_t m)
+{
+    /* Entry positions are below the usable size, which is below m, so they never clash with the markers */
+    if (m <= 0x100U)
+    {
+        ht->slot_width = 1;
+    }
+    else if (m <= 0x10000UL)
+    {
+        ht->slot_width = 2;
+    }
+    else if (m-1 <= 0xFFFFFFFFUL)
+    {
+        ht->slot_width = 4;
+    }
+    else
+    {
+        ht->slot_width = sizeof(size_t);
+    }
+
+    free(ht->slots);
+    ht->slots = malloc(m*ht->slot_width);
+    if (ht->slots == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for slots of the Compact Hash Table");
+    }
+    /* All bits set is UPO_HT_COMPACT_EMPTY, whatever the width */
+    memset(ht->slots, 0xFF, m*ht->slot_width);
+    ht->capacity = m;
+    ht->num_dummies = 0;
+    /* Exactly floor(2m/3), without overflowing */
+    ht->usable = 2*(m/3) + (2*(m%3))/3;
+}
+
+size_t upo_ht_compact_slot_get(const upo_ht_compact_t ht, size_t i)
+{
+    size_t e = 0;
+
+    /* Narrow markers are widened by adding the same offset that maps all bits set to UPO_HT_COMPACT_EMPTY */
+    switch (ht->slot_width)
+    {
+        case 1:
+            e = ((const uint8_t*) ht->slots)[i];
+            if (e >= 0xFEU)
+            {
+                e += UPO_HT_COMPACT_EMPTY - 0xFFU;
+            }
+            break;
+        case 2:
+            e = ((const uint16_t*) ht->slots)[i];
+            if (e >= 0xFFFEU)
+            {
+                e += UPO_HT_COMPACT_EMPTY - 0xFFFFU;
+            }
+            break;
+        case 4:
+            e = ((const uint32_t*) ht->slots)[i];
+            if (e >= 0xFFFFFFFEUL)
+            {
+                e += UPO_HT_COMPACT_EMPTY - 0xFFFFFFFFUL;
+            }
+            break;
+        default:
+            e = ((const size_t*) ht->slots)[i];
+    }
+
+    return e;
+}
+
+void upo_ht_compact_slot_set(upo_ht_compact_t ht, size_t i, size_t e)
+{
+    /* Truncation keeps the low bits, so the markers stay all (but the lowest) bits set */
+    switch (ht->slot_width)
+    {
+        case 1:
+            ((uint8_t*) ht->slots)[i] = (uint8_t) e;
+            break;
+        case 2:
+            ((uint16_t*) ht->slots)[i] = (uint16_t) e;
+            break;
+        case 4:
+            ((uint32_t*) ht->slots)[i] = (uint32_t) e;
+            break;
+        default:
+            ((size_t*) ht->slots)[i] = e;
+    }
+}
+
+size_t upo_ht_compact_hash(const upo_ht_compact_t ht, const void* key)
+{
+    /* Slots are chosen by the low bits, so the hash value is mixed first */
+    return upo_ht_hash_mix(ht->key_hash(key, UPO_HT_HASH_FULL_RANGE));
+}
+
+size_t upo_ht_compact_find(const upo_ht_compact_t ht, const void* key, size_t hash, size_t* slot)
+{
+    size_t mask = ht->capacity - 1;
+    size_t free_slot = UPO_HT_COMPACT_EMPTY;
+    size_t i = hash & mask;
+
+    /* At most usable < capacity slots are non-empty (removed ones included), so the probe always ends */
+    for (;;)
+    {
+        size_t e = upo_ht_compact_slot_get(ht, i);
+
+        if (e == UPO_HT_COMPACT_EMPTY)
+        {
+            if (slot != NULL)
+            {
+                *slot = (free_slot != UPO_HT_COMPACT_EMPTY) ? free_slot : i;
+            }
+            return UPO_HT_COMPACT_EMPTY;
+        }
+        if (e == UPO_HT_COMPACT_DUMMY)
+        {
+            if (free_slot == UPO_HT_COMPACT_EMPTY)
+            {
+                free_slot = i;
+            }
+        }
+        else if (ht->entries[e].hash == hash && ht->key_cmp(ht->entries[e].key, key) == 0)
+        {
+            if (slot != NULL)
+            {
+                *slot = i;
+            }
+            return e;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+void upo_ht_compact_append(upo_ht_compact_t ht, size_t slot, size_t hash, void* key, void* value)
+{
+    if (ht->num_entries == ht->entries_capacity)
+    {
+        /* The entries grow geometrically, but never beyond what the slots can address */
+        size_t n = ht->entries_capacity + ht->entries_capacity/2;
+        upo_ht_compact_entry_t* entries = NULL;
+
+        if (n < UPO_HT_COMPACT_MIN_ENTRIES)
+        {
+            n = UPO_HT_COMPACT_MIN_ENTRIES;
+        }
+        if (n > ht->usable)
+        {
+            n = ht->usable;
+        }
+        entries = realloc(ht->entries, n*sizeof(upo_ht_compact_entry_t));
+        if (entries == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for entries of the Compact Hash Table");
+        }
+        ht->entries = entries;
+        ht->entries_capacity = n;
+    }
+
+    if (upo_ht_compact_slot_get(ht, slot) == UPO_HT_COMPACT_DUMMY)
+    {
+        ht->num_dummies -= 1;
+    }
+    ht->entries[ht->num_entries].hash = hash;
+    ht->entries[ht->num_entries].key = key;
+    ht->entries[ht->num_entries].value = value;
+    upo_ht_compact_slot_set(ht, slot, ht->num_entries);
+    ht->num_entries += 1;
+    ht->size += 1;
+}
+
+void upo_ht_compact_rebuild(upo_ht_compact_t ht, size_t m)
+{
+    size_t mask = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    /* Squeeze out the removed entries, preserving the order of the others */
+    for (i = 0; i < ht->num_entries; ++i)
+    {
+        if (ht->entries[i].key != NULL)
+        {
+            ht->entries[j++] = ht->entries[i];
+        }
+    }
+    ht->num_entries = j;
+
+    upo_ht_compact_alloc_slots(ht, m);
+    if (ht->entries_capacity > ht->usable)
+    {
+        upo_ht_compact_entry_t* entries = realloc(ht->entries, ht->usable*sizeof(upo_ht_compact_entry_t));
+
+        /* Failing to shrink is harmless: the old block is still valid */
+        if (entries != NULL)
+        {
+            ht->entries = entries;
+            ht->entries_capacity = ht->usable;
+        }
+    }
+
+    mask = ht->capacity - 1;
+    for (i = 0; i < ht->num_entries; ++i)
+    {
+        size_t k = ht->entries[i].hash & mask;
+
+        while (upo_ht_compact_slot_get(ht, k) != UPO_HT_COMPACT_EMPTY)
+        {
+            k = (k + 1) & mask;
+        }
+        upo_ht_compact_slot_set(ht, k, i);
+    }
+}
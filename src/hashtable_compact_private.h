@@ -0,0 +1,147 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/hashtable_compact_private.h
+ *
+ * \brief Private header for the Compact Hash Table abstract data type.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHTABLE_COMPACT_PRIVATE_H
+#define UPO_HASHTABLE_COMPACT_PRIVATE_H
+
+
+#include <stddef.h>
+#include <upo/hashtable_compact.h>
+
+
+/** \brief Marks a slot that has never been used (all bits set, whatever the slot width). */
+#define UPO_HT_COMPACT_EMPTY ((size_t) -1)
+
+/** \brief Marks a slot whose entry has been removed (all bits but the lowest set). */
+#define UPO_HT_COMPACT_DUMMY ((size_t) -2)
+
+/** \brief Minimum number of entries allocated at once. */
+#define UPO_HT_COMPACT_MIN_ENTRIES 8U
+
+
+/** \brief Type for entries, holding a key-value pair and the hash value of the key. */
+struct upo_ht_compact_entry_s
+{
+    size_t hash; /**< The (mixed) hash value of the key. */
+    void* key; /**< The key (`NULL` if the entry has been removed). */
+    void* value; /**< The value associated to the key. */
+};
+/** \brief Alias for the type for entries. */
+typedef struct upo_ht_compact_entry_s upo_ht_compact_entry_t;
+
+/** \brief Type for compact hash tables. */
+struct upo_ht_compact_s
+{
+    void* slots; /**< The array of slots, each holding the position of an entry, #UPO_HT_COMPACT_EMPTY or #UPO_HT_COMPACT_DUMMY. */
+    size_t capacity; /**< The number of slots (always a power of two). */
+    size_t slot_width; /**< The size (in bytes) of a slot: 1, 2, 4 or `sizeof(size_t)`. */
+    size_t usable; /**< The number of entries that may be appended before the table is rebuilt. */
+    size_t min_capacity; /**< The capacity below which the table never shrinks. */
+    upo_ht_compact_entry_t* entries; /**< The array of entries, in insertion order. */
+    size_t entries_capacity; /**< The number of allocated entries. */
+    size_t num_entries; /**< The number of used entries, removed ones included. */
+    size_t size; /**< The number of stored keys. */
+    size_t num_dummies; /**< The number of slots marked as #UPO_HT_COMPACT_DUMMY. */
+    upo_ht_hasher_t key_hash; /**< The key hash function. */
+    upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+};
+
+
+/**
+ * \brief Allocates the (empty) slots of the given hash table, replacing the
+ *  current ones.
+ *
+ * \param ht The hash table.
+ * \param m The number of slots (a power of two).
+ */
+static void upo_ht_compact_alloc_slots(upo_ht_compact_t ht, size_t m);
+
+/**
+ * \brief Reads a slot.
+ *
+ * \param ht The hash table.
+ * \param i The index of the slot.
+ * \return The position of an entry, #UPO_HT_COMPACT_EMPTY or
+ *  #UPO_HT_COMPACT_DUMMY.
+ */
+static size_t upo_ht_compact_slot_get(const upo_ht_compact_t ht, size_t i);
+
+/**
+ * \brief Writes a slot.
+ *
+ * \param ht The hash table.
+ * \param i The index of the slot.
+ * \param e The position of an entry, #UPO_HT_COMPACT_EMPTY or
+ *  #UPO_HT_COMPACT_DUMMY.
+ */
+static void upo_ht_compact_slot_set(upo_ht_compact_t ht, size_t i, size_t e);
+
+/**
+ * \brief Hashes the given key.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return The mixed hash value of the key.
+ */
+static size_t upo_ht_compact_hash(const upo_ht_compact_t ht, const void* key);
+
+/**
+ * \brief Looks for the given key.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param hash The hash value of the key.
+ * \param slot Where the index of the slot pointing to the key is stored, if
+ *  found, or otherwise the index of the first reusable slot of the probe
+ *  sequence (may be `NULL`).
+ * \return The position of the entry holding the key, or
+ *  #UPO_HT_COMPACT_EMPTY if not found.
+ */
+static size_t upo_ht_compact_find(const upo_ht_compact_t ht, const void* key, size_t hash, size_t* slot);
+
+/**
+ * \brief Appends a new entry and points the given slot to it.
+ *
+ * \param ht The hash table, which must have fewer entries than its usable size.
+ * \param slot The index of a free slot, as returned by upo_ht_compact_find().
+ * \param hash The hash value of the key.
+ * \param key The key.
+ * \param value The value.
+ */
+static void upo_ht_compact_append(upo_ht_compact_t ht, size_t slot, size_t hash, void* key, void* value);
+
+/**
+ * \brief Compacts the entries of the given hash table and rebuilds its slots.
+ *
+ * \param ht The hash table.
+ * \param m The new number of slots (a power of two), large enough for all the
+ *  stored keys.
+ */
+static void upo_ht_compact_rebuild(upo_ht_compact_t ht, size_t m);
+
+
+#endif /* UPO_HASHTABLE_COMPACT_PRIVATE_H */
@@ -0,0 +1,510 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Reader-writer locks are a POSIX extension */
+#define _POSIX_C_SOURCE 200112L
+
+#include <assert.h>
+#include "hashtable_concurrent_private.h"
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <upo/error.h>
+
+
+upo_ht_concurrent_t upo_ht_concurrent_create(size_t m, size_t stripes, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_concurrent_t ht = NULL;
+    size_t stripe_capacity = 1;
+    size_t i = 0;
+
+    /* preconditions */
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
+    assert( stripes > 0 );
+
+    ht = malloc(sizeof(struct upo_ht_concurrent_s));
+    if (ht == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the Concurrent Hash Table");
+    }
+
+    /* Round the number of stripes up to a power of two, so that the stripe
+     * of a key is given by the lowest bits of its hash value */
+    ht->num_stripes = 1;
+    ht->stripe_bits = 0;
+    while (ht->num_stripes < stripes)
+    {
+        ht->num_stripes *= 2;
+        ht->stripe_bits += 1;
+    }
+    while (stripe_capacity*ht->num_stripes < m)
+    {
+        stripe_capacity *= 2;
+    }
+    ht->key_hash = key_hash;
+    ht->key_cmp = key_cmp;
+
+    ht->stripes = malloc(ht->num_stripes*sizeof(upo_ht_concurrent_stripe_t));
+    if (ht->stripes == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for stripes of the Concurrent Hash Table");
+    }
+    for (i = 0; i < ht->num_stripes; ++i)
+    {
+        upo_ht_concurrent_stripe_t* stripe = &ht->stripes[i];
+        size_t j = 0;
+
+        if (pthread_rwlock_init(&stripe->lock, NULL) != 0)
+        {
+            upo_throw_error("Unable to initialize the lock of a stripe of the Concurrent Hash Table");
+        }
+        stripe->heads = malloc(stripe_capacity*sizeof(upo_ht_concurrent_node_t*));
+        if (stripe->heads == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for slots of the Concurrent Hash Table");
+        }
+        for (j = 0; j < stripe_capacity; ++j)
+        {
+            stripe->heads[j] = NULL;
+        }
+        stripe->capacity = stripe_capacity;
+        stripe->min_capacity = stripe_capacity;
+        stripe->size = 0;
+        stripe->nodes = upo_mem_pool_create(sizeof(upo_ht_concurrent_node_t), 0);
+    }
+
+    return ht;
+}
+
+void upo_ht_concurrent_destroy(upo_ht_concurrent_t ht, int destroy_data)
+{
+    if (ht != NULL)
+    {
+        size_t i = 0;
+
+        upo_ht_concurrent_clear(ht, destroy_data);
+        for (i = 0; i < ht->num_stripes; ++i)
+        {
+            upo_mem_pool_destroy(ht->stripes[i].nodes);
+            free(ht->stripes[i].heads);
+            pthread_rwlock_destroy(&ht->stripes[i].lock);
+        }
+        free(ht->stripes);
+        free(ht);
+    }
+}
+
+void upo_ht_concurrent_clear(upo_ht_concurrent_t ht, int destroy_data)
+{
+    if (ht != NULL)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < ht->num_stripes; ++i)
+        {
+            upo_ht_concurrent_stripe_t* stripe = &ht->stripes[i];
+            size_t j = 0;
+
+            upo_ht_concurrent_write_lock(stripe);
+            for (j = 0; j < stripe->capacity; ++j)
+            {
+                if (destroy_data)
+                {
+                    upo_ht_concurrent_node_t* node = NULL;
+
+                    for (node = stripe->heads[j]; node != NULL; node = node->next)
+                    {
+                        free(node->key);
+                        free(node->value);
+                    }
+                }
+                stripe->heads[j] = NULL;
+            }
+            upo_mem_pool_clear(stripe->nodes);
+            stripe->size = 0;
+            upo_ht_concurrent_unlock(stripe);
+        }
+    }
+}
+
+void* upo_ht_concurrent_put(upo_ht_concurrent_t ht, void* key, void* value)
+{
+    void* old_value = NULL;
+    size_t hash = 0;
+    size_t slot = 0;
+    upo_ht_concurrent_stripe_t* stripe = NULL;
+    upo_ht_concurrent_node_t* node = NULL;
+
+    /* preconditions */
+    assert( ht != NULL );
+
+    /* Hashing does not need the lock */
+    hash = upo_ht_concurrent_hash(ht, key);
+    stripe = upo_ht_concurrent_stripe(ht, hash);
+
+    upo_ht_concurrent_write_lock(stripe);
+    slot = upo_ht_concurrent_slot(ht, stripe, hash);
+    node = stripe->heads[slot];
+    while (node != NULL && (node->hash != hash || ht->key_cmp(key, node->key) != 0))
+    {
+        node = node->next;
+    }
+    if (node == NULL)
+    {
+        node = upo_mem_pool_alloc(stripe->nodes);
+        node->key = key;
+        node->value = value;
+        node->hash = hash;
+        node->next = stripe->heads[slot];
+        stripe->heads[slot] = node;
+        stripe->size += 1;
+        if (stripe->size > stripe->capacity)
+        {
+            upo_ht_concurrent_stripe_resize(ht, stripe, 2*stripe->capacity);
+        }
+    }
+    else
+    {
+        old_value = node->value;
+        node->value = value;
+    }
+    upo_ht_concurrent_unlock(stripe);
+
+    return old_value;
+}
+
+int upo_ht_concurrent_insert(upo_ht_concurrent_t ht, void* key, void* value)
+{
+    int inserted = 0;
+    size_t hash = 0;
+    size_t slot = 0;
+    upo_ht_concurrent_stripe_t* stripe = NULL;
+    upo_ht_concurrent_node_t* node = NULL;
+
+    /* preconditions */
+    assert( ht != NULL );
+
+    hash = upo_ht_concurrent_hash(ht, key);
+    stripe = upo_ht_concurrent_stripe(ht, hash);
+
+    upo_ht_concurrent_write_lock(stripe);
+    slot = upo_ht_concurrent_slot(ht, stripe, hash);
+    node = stripe->heads[slot];
+    while (node != NULL && (node->hash != hash || ht->key_cmp(key, node->key) != 0))
+    {
+        node = node->next;
+    }
+    if (node == NULL)
+    {
+        node = upo_mem_pool_alloc(stripe->nodes);
+        node->key = key;
+        node->value = value;
+        node->hash = hash;
+        node->next = stripe->heads[slot];
+        stripe->heads[slot] = node;
+        stripe->size += 1;
+        if (stripe->size > stripe->capacity)
+        {
+            upo_ht_concurrent_stripe_resize(ht, stripe, 2*stripe->capacity);
+        }
+        inserted = 1;
+    }
+    upo_ht_concurrent_unlock(stripe);
+
+    return inserted;
+}
+
+void* upo_ht_concurrent_get(const upo_ht_concurrent_t ht, const void* key)
+{
+    void* value = NULL;
+    size_t hash = 0;
+    upo_ht_concurrent_stripe_t* stripe = NULL;
+    upo_ht_concurrent_node_t* node = NULL;
+
+    /* preconditions */
+    assert( ht != NULL );
+
+    hash = upo_ht_concurrent_hash(ht, key);
+    stripe = upo_ht_concurrent_stripe(ht, hash);
+
+    upo_ht_concurrent_read_lock(stripe);
+    node = stripe->heads[upo_ht_concurrent_slot(ht, stripe, hash)];
+    while (node != NULL && (node->hash != hash || ht->key_cmp(key, node->key) != 0))
+    {
+        node = node->next;
+    }
+    if (node != NULL)
+    {
+        value = node->value;
+    }
+    upo_ht_concurrent_unlock(stripe);
+
+    return value;
+}
+
+int upo_ht_concurrent_contains(const upo_ht_concurrent_t ht, const void* key)
+{
+    return (upo_ht_concurrent_get(ht, key) != NULL) ? 1 : 0;
+}
+
+void upo_ht_concurrent_delete(upo_ht_concurrent_t ht, const void* key, int destroy_data)
+{
+    size_t hash = 0;
+    size_t slot = 0;
+    upo_ht_concurrent_stripe_t* stripe = NULL;
+    upo_ht_concurrent_node_t* node = NULL;
+    upo_ht_concurrent_node_t* prev = NULL;
+
+    /* preconditions */
+    assert( ht != NULL );
+
+    hash = upo_ht_concurrent_hash(ht, key);
+    stripe = upo_ht_concurrent_stripe(ht, hash);
+
+    upo_ht_concurrent_write_lock(stripe);
+    slot = upo_ht_concurrent_slot(ht, stripe, hash);
+    node = stripe->heads[slot];
+    while (node != NULL && (node->hash != hash || ht->key_cmp(key, node->key) != 0))
+    {
+        prev = node;
+        node = node->next;
+    }
+    if (node != NULL)
+    {
+        if (prev == NULL)
+        {
+            stripe->heads[slot] = node->next;
+        }
+        else
+        {
+            prev->next = node->next;
+        }
+        if (destroy_data)
+        {
+            free(node->key);
+            free(node->value);
+        }
+        upo_mem_pool_free(stripe->nodes, node);
+        stripe->size -= 1;
+        if (stripe->size < stripe->capacity/8 && stripe->capacity/2 >= stripe->min_capacity)
+        {
+            upo_ht_concurrent_stripe_resize(ht, stripe, stripe->capacity/2);
+        }
+    }
+    upo_ht_concurrent_unlock(stripe);
+}
+
+int upo_ht_concurrent_is_empty(const upo_ht_concurrent_t ht)
+{
+    return upo_ht_concurrent_size(ht) == 0 ? 1 : 0;
+}
+
+size_t upo_ht_concurrent_capacity(const upo_ht_concurrent_t ht)
+{
+    size_t capacity = 0;
+
+    if (ht != NULL)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < ht->num_stripes; ++i)
+        {
+            upo_ht_concurrent_read_lock(&ht->stripes[i]);
+            capacity += ht->stripes[i].capacity;
+            upo_ht_concurrent_unlock(&ht->stripes[i]);
+        }
+    }
+
+    return capacity;
+}
+
+size_t upo_ht_concurrent_size(const upo_ht_concurrent_t ht)
+{
+    size_t size = 0;
+
+    if (ht != NULL)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < ht->num_stripes; ++i)
+        {
+            upo_ht_concurrent_read_lock(&ht->stripes[i]);
+            size += ht->stripes[i].size;
+            upo_ht_concurrent_unlock(&ht->stripes[i]);
+        }
+    }
+
+    return size;
+}
+
+size_t upo_ht_concurrent_stripes(const upo_ht_concurrent_t ht)
+{
+    return (ht != NULL) ? ht->num_stripes : 0;
+}
+
+double upo_ht_concurrent_load_factor(const upo_ht_concurrent_t ht)
+{
+    return upo_ht_concurrent_size(ht) / (double) upo_ht_concurrent_capacity(ht);
+}
+
+upo_ht_key_list_t upo_ht_concurrent_keys(const upo_ht_concurrent_t ht)
+{
+    upo_ht_key_list_t key_list = NULL;
+
+    if (ht != NULL)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < ht->num_stripes; ++i)
+        {
+            upo_ht_concurrent_stripe_t* stripe = &ht->stripes[i];
+            size_t j = 0;
+
+            upo_ht_concurrent_read_lock(stripe);
+            for (j = 0; j < stripe->capacity; ++j)
+            {
+                upo_ht_concurrent_node_t* node = NULL;
+
+                for (node = stripe->heads[j]; node != NULL; node = node->next)
+                {
+                    upo_ht_key_list_node_t* key_node = malloc(sizeof(upo_ht_key_list_node_t));
+
+                    if (key_node == NULL)
+                    {
+                        upo_throw_sys_error("Unable to allocate memory for the list of keys");
+                    }
+                    key_node->key = node->key;
+                    key_node->next = key_list;
+                    key_list = key_node;
+                }
+            }
+            upo_ht_concurrent_unlock(stripe);
+        }
+    }
+
+    return key_list;
+}
+
+void upo_ht_concurrent_traverse(const upo_ht_concurrent_t ht, upo_ht_visitor_t visit, void* visit_arg)
+{
+    if (ht != NULL)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < ht->num_stripes; ++i)
+        {
+            upo_ht_concurrent_stripe_t* stripe = &ht->stripes[i];
+            size_t j = 0;
+
+            upo_ht_concurrent_read_lock(stripe);
+            for (j = 0; j < stripe->capacity; ++j)
+            {
+                upo_ht_concurrent_node_t* node = NULL;
+
+                for (node = stripe->heads[j]; node != NULL; node = node->next)
+                {
+                    visit(node->key, node->value, visit_arg);
+                }
+            }
+            upo_ht_concurrent_unlock(stripe);
+        }
+    }
+}
+
+size_t upo_ht_concurrent_hash(const upo_ht_concurrent_t ht, const void* key)
+{
+    /* The user hash function may leave the high bits poorly mixed (e.g.,
+     * the division method); since both the stripe and the slot are taken
+     * from the bits of the hash value, mix them all. */
+    return upo_ht_hash_mix(ht->key_hash(key, UPO_HT_HASH_FULL_RANGE));
+}
+
+upo_ht_concurrent_stripe_t* upo_ht_concurrent_stripe(const upo_ht_concurrent_t ht, size_t hash)
+{
+    return &ht->stripes[hash & (ht->num_stripes - 1)];
+}
+
+size_t upo_ht_concurrent_slot(const upo_ht_concurrent_t ht, const upo_ht_concurrent_stripe_t* stripe, size_t hash)
+{
+    return (hash >> ht->stripe_bits) & (stripe->capacity - 1);
+}
+
+void upo_ht_concurrent_stripe_resize(upo_ht_concurrent_t ht, upo_ht_concurrent_stripe_t* stripe, size_t n)
+{
+    upo_ht_concurrent_node_t** heads = NULL;
+    size_t i = 0;
+
+    heads = malloc(n*sizeof(upo_ht_concurrent_node_t*));
+    if (heads == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for slots of the Concurrent Hash Table");
+    }
+    for (i = 0; i < n; ++i)
+    {
+        heads[i] = NULL;
+    }
+
+    /* Nodes keep their hash value, so they are relinked without calling the
+     * hash function while the stripe is locked */
+    for (i = 0; i < stripe->capacity; ++i)
+    {
+        upo_ht_concurrent_node_t* node = stripe->heads[i];
+
+        while (node != NULL)
+        {
+            upo_ht_concurrent_node_t* next = node->next;
+            size_t slot = (node->hash >> ht->stripe_bits) & (n - 1);
+
+            node->next = heads[slot];
+            heads[slot] = node;
+            node = next;
+        }
+    }
+
+    free(stripe->heads);
+    stripe->heads = heads;
+    stripe->capacity = n;
+}
+
+void upo_ht_concurrent_read_lock(upo_ht_concurrent_stripe_t* stripe)
+{
+    if (pthread_rwlock_rdlock(&stripe->lock) != 0)
+    {
+        upo_throw_error("Unable to lock a stripe of the Concurrent Hash Table");
+    }
+}
+
+void upo_ht_concurrent_write_lock(upo_ht_concurrent_stripe_t* stripe)
+{
+    if (pthread_rwlock_wrlock(&stripe->lock) != 0)
+    {
+        upo_throw_error("Unable to lock a stripe of the Concurrent Hash Table");
+    }
+}
+
+void upo_ht_concurrent_unlock(upo_ht_concurrent_stripe_t* stripe)
+{
+    if (pthread_rwlock_unlock(&stripe->lock) != 0)
+    {
+        upo_throw_error("Unable to unlock a stripe of the Concurrent Hash Table");
+    }
+}
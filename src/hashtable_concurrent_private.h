@@ -0,0 +1,141 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/hashtable_concurrent_private.h
+ *
+ * \brief Private header for the Concurrent Hash Table abstract data type.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHTABLE_CONCURRENT_PRIVATE_H
+#define UPO_HASHTABLE_CONCURRENT_PRIVATE_H
+
+
+#include <pthread.h>
+#include <stddef.h>
+#include <upo/hashtable_concurrent.h>
+#include <upo/mem_pool.h>
+
+
+/** \brief The size (in bytes) of a cache line. */
+#define UPO_HT_CONCURRENT_CACHE_LINE 64
+
+
+/** \brief Type for nodes of the lists of collisions. */
+struct upo_ht_concurrent_node_s
+{
+    void* key; /**< Pointer to the user-provided key. */
+    void* value; /**< Pointer to the value associated to the key. */
+    size_t hash; /**< The mixed hash value of the key, kept to resize without rehashing. */
+    struct upo_ht_concurrent_node_s* next; /**< Pointer to the next node in the list. */
+};
+/** \brief Alias for the type for nodes of the lists of collisions. */
+typedef struct upo_ht_concurrent_node_s upo_ht_concurrent_node_t;
+
+/**
+ * \brief Type for stripes, i.e., independently locked and resized
+ *  sub-tables.
+ */
+struct upo_ht_concurrent_stripe_s
+{
+    pthread_rwlock_t lock; /**< The lock protecting all the other fields. */
+    upo_ht_concurrent_node_t** heads; /**< The heads of the lists of collisions. */
+    size_t capacity; /**< The number of slots (always a power of two). */
+    size_t min_capacity; /**< The capacity below which the stripe never shrinks. */
+    size_t size; /**< The number of keys stored in the stripe. */
+    upo_mem_pool_t nodes; /**< The pool the nodes of the stripe are drawn from. */
+    unsigned char pad[UPO_HT_CONCURRENT_CACHE_LINE]; /**< Keeps the locks of adjacent stripes on different cache lines. */
+};
+/** \brief Alias for the type for stripes. */
+typedef struct upo_ht_concurrent_stripe_s upo_ht_concurrent_stripe_t;
+
+/** \brief Type for concurrent hash tables. */
+struct upo_ht_concurrent_s
+{
+    upo_ht_concurrent_stripe_t* stripes; /**< The array of stripes. */
+    size_t num_stripes; /**< The number of stripes (always a power of two). */
+    unsigned int stripe_bits; /**< The base-2 logarithm of the number of stripes. */
+    upo_ht_hasher_t key_hash; /**< The key hash function. */
+    upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+};
+
+
+/**
+ * \brief Computes the mixed hash value of the given key.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return The mixed hash value; its lowest bits select the stripe and the
+ *  following ones select the slot.
+ */
+static size_t upo_ht_concurrent_hash(const upo_ht_concurrent_t ht, const void* key);
+
+/**
+ * \brief Returns the stripe the given hash value belongs to.
+ *
+ * \param ht The hash table.
+ * \param hash The mixed hash value.
+ * \return The stripe.
+ */
+static upo_ht_concurrent_stripe_t* upo_ht_concurrent_stripe(const upo_ht_concurrent_t ht, size_t hash);
+
+/**
+ * \brief Returns the slot index within its stripe of the given hash value.
+ *
+ * \param ht The hash table.
+ * \param stripe The stripe.
+ * \param hash The mixed hash value.
+ * \return The slot index.
+ */
+static size_t upo_ht_concurrent_slot(const upo_ht_concurrent_t ht, const upo_ht_concurrent_stripe_t* stripe, size_t hash);
+
+/**
+ * \brief Resize the given stripe to the given capacity.
+ *
+ * \param ht The hash table.
+ * \param stripe The stripe to resize, locked for writing by the caller.
+ * \param n The new capacity (a power of two).
+ */
+static void upo_ht_concurrent_stripe_resize(upo_ht_concurrent_t ht, upo_ht_concurrent_stripe_t* stripe, size_t n);
+
+/**
+ * \brief Locks the given stripe for reading.
+ *
+ * \param stripe The stripe.
+ */
+static void upo_ht_concurrent_read_lock(upo_ht_concurrent_stripe_t* stripe);
+
+/**
+ * \brief Locks the given stripe for writing.
+ *
+ * \param stripe The stripe.
+ */
+static void upo_ht_concurrent_write_lock(upo_ht_concurrent_stripe_t* stripe);
+
+/**
+ * \brief Unlocks the given stripe.
+ *
+ * \param stripe The stripe.
+ */
+static void upo_ht_concurrent_unlock(upo_ht_concurrent_stripe_t* stripe);
+
+
+#endif /* UPO_HASHTABLE_CONCURRENT_PRIVATE_H */
@@ -0,0 +1,555 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include "hashtable_cuckoo_private.h"
+#include <limits.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+
+
+upo_ht_cuckoo_t upo_ht_cuckoo_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_cuckoo_t ht = NULL;
+    size_t n = 1;
+
+    /* preconditions */
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
+
+    ht = malloc(sizeof(struct upo_ht_cuckoo_s));
+    if (ht == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the Cuckoo Hash Table");
+    }
+
+    while (n*UPO_HT_CUCKOO_BUCKET_SLOTS < m)
+    {
+        n *= 2;
+    }
+    ht->buckets = NULL;
+    ht->buckets_mem = NULL;
+    ht->num_buckets = 0;
+    ht->size = 0;
+    ht->seed1 = (size_t) 0x9E3779B9UL;
+    ht->seed2 = (size_t) 0x7F4A7C15UL;
+    ht->kick_state = 1;
+    ht->stash_size = 0;
+    ht->key_hash = key_hash;
+    ht->key_cmp = key_cmp;
+    upo_ht_cuckoo_alloc_buckets(ht, n);
+
+    return ht;
+}
+
+void upo_ht_cuckoo_destroy(upo_ht_cuckoo_t ht, int destroy_data)
+{
+    if (ht != NULL)
+    {
+        upo_ht_cuckoo_clear(ht, destroy_data);
+        free(ht->buckets_mem);
+        free(ht);
+    }
+}
+
+void upo_ht_cuckoo_clear(upo_ht_cuckoo_t ht, int destroy_data)
+{
+    if (ht != NULL)
+    {
+        size_t i = 0;
+        size_t j = 0;
+
+        for (i = 0; i < ht->num_buckets; ++i)
+        {
+            upo_ht_cuckoo_bucket_t* bucket = &ht->buckets[i];
+
+            for (j = 0; j < UPO_HT_CUCKOO_BUCKET_SLOTS; ++j)
+            {
+                if (destroy_data && bucket->keys[j] != NULL)
+                {
+                    free(bucket->keys[j]);
+                    free(bucket->values[j]);
+                }
+                bucket->keys[j] = NULL;
+                bucket->values[j] = NULL;
+            }
+        }
+        for (i = 0; i < ht->stash_size; ++i)
+        {
+            if (destroy_data)
+            {
+                free(ht->stash_keys[i]);
+                free(ht->stash_values[i]);
+            }
+        }
+        ht->stash_size = 0;
+        ht->size = 0;
+    }
+}
+
+void* upo_ht_cuckoo_put(upo_ht_cuckoo_t ht, void* key, void* value)
+{
+    void** keys = NULL;
+    void** values = NULL;
+    void* old_value = NULL;
+    size_t i = 0;
+
+    /* preconditions */
+    assert( ht != NULL );
+    assert( key != NULL );
+
+    i = upo_ht_cuckoo_find(ht, key, &keys, &values);
+    if (i != (size_t) -1)
+    {
+        old_value = values[i];
+        values[i] = value;
+    }
+    else
+    {
+        upo_ht_cuckoo_insert(ht, key, value);
+    }
+
+    return old_value;
+}
+
+void upo_ht_cuckoo_insert(upo_ht_cuckoo_t ht, void* key, void* value)
+{
+    void** keys = NULL;
+    void** values = NULL;
+
+    /* preconditions */
+    assert( ht != NULL );
+    assert( key != NULL );
+
+    if (upo_ht_cuckoo_find(ht, key, &keys, &values) != (size_t) -1)
+    {
+        return;
+    }
+
+    if ((ht->size + 1) > UPO_HT_CUCKOO_MAX_LOAD_FACTOR*upo_ht_cuckoo_capacity(ht))
+    {
+        /* Grow before the evictions get long */
+        upo_ht_cuckoo_rehash(ht, 2*ht->num_buckets, key, value);
+    }
+    else if (!upo_ht_cuckoo_place(ht, &key, &value))
+    {
+        /* Some pair is left homeless: start over with new hash functions */
+        upo_ht_cuckoo_rehash(ht, ht->num_buckets, key, value);
+    }
+    ht->size += 1;
+}
+
+void* upo_ht_cuckoo_get(const upo_ht_cuckoo_t ht, const void* key)
+{
+    void** keys = NULL;
+    void** values = NULL;
+    size_t i = 0;
+
+    if (ht == NULL)
+    {
+        return NULL;
+    }
+
+    i = upo_ht_cuckoo_find(ht, key, &keys, &values);
+
+    return (i != (size_t) -1) ? values[i] : NULL;
+}
+
+int upo_ht_cuckoo_contains(const upo_ht_cuckoo_t ht, const void* key)
+{
+    void** keys = NULL;
+    void** values = NULL;
+
+    if (ht == NULL)
+    {
+        return 0;
+    }
+
+    return upo_ht_cuckoo_find(ht, key, &keys, &values) != (size_t) -1;
+}
+
+void upo_ht_cuckoo_delete(upo_ht_cuckoo_t ht, const void* key, int destroy_data)
+{
+    void** keys = NULL;
+    void** values = NULL;
+    size_t i = 0;
+
+    if (ht == NULL)
+    {
+        return;
+    }
+
+    i = upo_ht_cuckoo_find(ht, key, &keys, &values);
+    if (i == (size_t) -1)
+    {
+        return;
+    }
+
+    if (destroy_data)
+    {
+        free(keys[i]);
+        free(values[i]);
+    }
+    if (keys == ht->stash_keys)
+    {
+        /* Keep the stash compact */
+        ht->stash_size -= 1;
+        ht->stash_keys[i] = ht->stash_keys[ht->stash_size];
+        ht->stash_values[i] = ht->stash_values[ht->stash_size];
+    }
+    else
+    {
+        size_t j = 0;
+
+        keys[i] = NULL;
+        values[i] = NULL;
+
+        /* Move back a stashed key that belongs to the freed bucket, if any */
+        for (j = 0; j < ht->stash_size; ++j)
+        {
+            size_t b1 = 0;
+            size_t b2 = 0;
+            unsigned char tag = 0;
+
+            upo_ht_cuckoo_buckets_of(ht, ht->stash_keys[j], &b1, &b2, &tag);
+            if (keys == ht->buckets[b1].keys || keys == ht->buckets[b2].keys)
+            {
+                size_t b = (keys == ht->buckets[b1].keys) ? b1 : b2;
+
+                keys[i] = ht->stash_keys[j];
+                values[i] = ht->stash_values[j];
+                ht->buckets[b].tags[i] = tag;
+                ht->stash_size -= 1;
+                ht->stash_keys[j] = ht->stash_keys[ht->stash_size];
+                ht->stash_values[j] = ht->stash_values[ht->stash_size];
+                break;
+            }
+        }
+    }
+    ht->size -= 1;
+}
+
+int upo_ht_cuckoo_is_empty(const upo_ht_cuckoo_t ht)
+{
+    return upo_ht_cuckoo_size(ht) == 0 ? 1 : 0;
+}
+
+size_t upo_ht_cuckoo_capacity(const upo_ht_cuckoo_t ht)
+{
+    return (ht != NULL) ? ht->num_buckets*UPO_HT_CUCKOO_BUCKET_SLOTS : 0;
+}
+
+size_t upo_ht_cuckoo_size(const upo_ht_cuckoo_t ht)
+{
+    return (ht != NULL) ? ht->size : 0;
+}
+
+double upo_ht_cuckoo_load_factor(const upo_ht_cuckoo_t ht)
+{
+    return upo_ht_cuckoo_size(ht) / (double) upo_ht_cuckoo_capacity(ht);
+}
+
+upo_ht_key_list_t upo_ht_cuckoo_keys(const upo_ht_cuckoo_t ht)
+{
+    upo_ht_key_list_t key_list = NULL;
+    size_t i = 0;
+    size_t j = 0;
+
+    if (ht == NULL)
+    {
+        return NULL;
+    }
+
+    for (i = 0; i <= ht->num_buckets; ++i)
+    {
+        /* The last round visits the stash */
+        void** keys = (i < ht->num_buckets) ? ht->buckets[i].keys : ht->stash_keys;
+        size_t n = (i < ht->num_buckets) ? UPO_HT_CUCKOO_BUCKET_SLOTS : ht->stash_size;
+
+        for (j = 0; j < n; ++j)
+        {
+            if (keys[j] != NULL)
+            {
+                upo_ht_key_list_node_t* node = malloc(sizeof(upo_ht_key_list_node_t));
+
+                if (node == NULL)
+                {
+                    upo_throw_sys_error("Unable to allocate memory for the list of keys");
+                }
+                node->key = keys[j];
+                node->next = key_list;
+                key_list = node;
+            }
+        }
+    }
+
+    return key_list;
+}
+
+void upo_ht_cuckoo_traverse(const upo_ht_cuckoo_t ht, upo_ht_visitor_t visit, void* visit_arg)
+{
+    size_t i = 0;
+    size_t j = 0;
+
+    if (ht == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i <= ht->num_buckets; ++i)
+    {
+        /* The last round visits the stash */
+        void** keys = (i < ht->num_buckets) ? ht->buckets[i].keys : ht->stash_keys;
+        void** values = (i < ht->num_buckets) ? ht->buckets[i].values : ht->stash_values;
+        size_t n = (i < ht->num_buckets) ? UPO_HT_CUCKOO_BUCKET_SLOTS : ht->stash_size;
+
+        for (j = 0; j < n; ++j)
+        {
+            if (keys[j] != NULL)
+            {
+                visit(keys[j], values[j], visit_arg);
+            }
+        }
+    }
+}
+
+void upo_ht_cuckoo_alloc_buckets(upo_ht_cuckoo_t ht, size_t n)
+{
+    size_t i = 0;
+    size_t j = 0;
+    size_t addr = 0;
+
+    /* Each bucket must fill exactly one cache line */
+    assert( sizeof(upo_ht_cuckoo_bucket_t) == UPO_HT_CUCKOO_CACHE_LINE );
+
+    /* Over-allocate so that the buckets can start on a cache line */
+    ht->buckets_mem = malloc(n*sizeof(upo_ht_cuckoo_bucket_t) + UPO_HT_CUCKOO_CACHE_LINE - 1);
+    if (ht->buckets_mem == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the buckets of the Cuckoo Hash Table");
+    }
+    addr = (size_t) ht->buckets_mem;
+    addr = (addr + UPO_HT_CUCKOO_CACHE_LINE - 1) & ~((size_t) UPO_HT_CUCKOO_CACHE_LINE - 1);
+    ht->buckets = (upo_ht_cuckoo_bucket_t*) ((char*) ht->buckets_mem + (addr - (size_t) ht->buckets_mem));
+    ht->num_buckets = n;
+
+    for (i = 0; i < n; ++i)
+    {
+        for (j = 0; j < UPO_HT_CUCKOO_BUCKET_SLOTS; ++j)
+        {
+            ht->buckets[i].keys[j] = NULL;
+            ht->buckets[i].values[j] = NULL;
+            ht->buckets[i].tags[j] = 0;
+        }
+    }
+}
+
+void upo_ht_cuckoo_buckets_of(const upo_ht_cuckoo_t ht, const void* key, size_t* b1, size_t* b2, unsigned char* tag)
+{
+    size_t h = ht->key_hash(key, UPO_HT_HASH_FULL_RANGE);
+    size_t mask = ht->num_buckets - 1;
+    size_t h1 = upo_ht_hash_mix(h ^ ht->seed1);
+
+    /* Derive two independent indexes from a single call to the user hasher;
+     * the tag comes from the bits of the first index that the mask drops */
+    *b1 = h1 & mask;
+    *b2 = upo_ht_hash_mix(h ^ ht->seed2) & mask;
+    if (*b2 == *b1)
+    {
+        *b2 = (*b1 + 1) & mask;
+    }
+    *tag = (unsigned char) (h1 >> (sizeof(size_t)*CHAR_BIT - CHAR_BIT));
+}
+
+size_t upo_ht_cuckoo_find(const upo_ht_cuckoo_t ht, const void* key, void*** keys, void*** values)
+{
+    size_t b[2];
+    unsigned char tag = 0;
+    size_t k = 0;
+    size_t i = 0;
+
+    upo_ht_cuckoo_buckets_of(ht, key, &b[0], &b[1], &tag);
+    for (k = 0; k < 2; ++k)
+    {
+        upo_ht_cuckoo_bucket_t* bucket = &ht->buckets[b[k]];
+
+        for (i = 0; i < UPO_HT_CUCKOO_BUCKET_SLOTS; ++i)
+        {
+            /* The tags share the cache line of the bucket, so the stored key
+             * is only dereferenced when the tag matches.
+             * Deletions leave holes, so every slot must be checked. */
+            if (bucket->tags[i] == tag && bucket->keys[i] != NULL && ht->key_cmp(key, bucket->keys[i]) == 0)
+            {
+                *keys = bucket->keys;
+                *values = bucket->values;
+                return i;
+            }
+        }
+    }
+    for (i = 0; i < ht->stash_size; ++i)
+    {
+        if (ht->key_cmp(key, ht->stash_keys[i]) == 0)
+        {
+            *keys = ht->stash_keys;
+            *values = ht->stash_values;
+            return i;
+        }
+    }
+
+    return (size_t) -1;
+}
+
+int upo_ht_cuckoo_place(upo_ht_cuckoo_t ht, void** key, void** value)
+{
+    size_t b1 = 0;
+    size_t b2 = 0;
+    size_t b = 0;
+    unsigned char tag = 0;
+    size_t kicks = 0;
+    size_t i = 0;
+
+    upo_ht_cuckoo_buckets_of(ht, *key, &b1, &b2, &tag);
+    for (i = 0; i < UPO_HT_CUCKOO_BUCKET_SLOTS; ++i)
+    {
+        if (ht->buckets[b1].keys[i] == NULL)
+        {
+            ht->buckets[b1].keys[i] = *key;
+            ht->buckets[b1].values[i] = *value;
+            ht->buckets[b1].tags[i] = tag;
+            return 1;
+        }
+    }
+
+    /* Random walk: evict a random key and move it to its other bucket */
+    b = b2;
+    for (kicks = 0; kicks < UPO_HT_CUCKOO_MAX_KICKS; ++kicks)
+    {
+        void* victim_key = NULL;
+        void* victim_value = NULL;
+
+        for (i = 0; i < UPO_HT_CUCKOO_BUCKET_SLOTS; ++i)
+        {
+            if (ht->buckets[b].keys[i] == NULL)
+            {
+                ht->buckets[b].keys[i] = *key;
+                ht->buckets[b].values[i] = *value;
+                ht->buckets[b].tags[i] = tag;
+                return 1;
+            }
+        }
+
+        ht->kick_state = ht->kick_state*1103515245UL + 12345UL;
+        i = (ht->kick_state >> 16) % UPO_HT_CUCKOO_BUCKET_SLOTS;
+        victim_key = ht->buckets[b].keys[i];
+        victim_value = ht->buckets[b].values[i];
+        ht->buckets[b].keys[i] = *key;
+        ht->buckets[b].values[i] = *value;
+        ht->buckets[b].tags[i] = tag;
+        *key = victim_key;
+        *value = victim_value;
+
+        upo_ht_cuckoo_buckets_of(ht, *key, &b1, &b2, &tag);
+        b = (b == b1) ? b2 : b1;
+    }
+
+    if (ht->stash_size < UPO_HT_CUCKOO_STASH_SLOTS)
+    {
+        ht->stash_keys[ht->stash_size] = *key;
+        ht->stash_values[ht->stash_size] = *value;
+        ht->stash_size += 1;
+        return 1;
+    }
+
+    return 0;
+}
+
+void upo_ht_cuckoo_rehash(upo_ht_cuckoo_t ht, size_t n, void* key, void* value)
+{
+    upo_ht_cuckoo_bucket_t* old_buckets = ht->buckets;
+    void* old_buckets_mem = ht->buckets_mem;
+    size_t old_num_buckets = ht->num_buckets;
+    void* old_stash_keys[UPO_HT_CUCKOO_STASH_SLOTS];
+    void* old_stash_values[UPO_HT_CUCKOO_STASH_SLOTS];
+    size_t old_stash_size = ht->stash_size;
+    size_t attempts = 0;
+    size_t growths = 0;
+    size_t i = 0;
+    size_t j = 0;
+    int ok = 0;
+
+    for (i = 0; i < old_stash_size; ++i)
+    {
+        old_stash_keys[i] = ht->stash_keys[i];
+        old_stash_values[i] = ht->stash_values[i];
+    }
+
+    /*
+     * Pairs are copied from the old buckets, which are left untouched, so a
+     * failed attempt simply discards the new buckets and tries again.
+     */
+    while (!ok)
+    {
+        if (attempts == UPO_HT_CUCKOO_MAX_REHASHES)
+        {
+            if (growths == UPO_HT_CUCKOO_MAX_GROWTHS)
+            {
+                upo_throw_error("Unable to rebuild the Cuckoo Hash Table: too many keys share the same hash value");
+            }
+            growths += 1;
+            n *= 2;
+            attempts = 0;
+        }
+        attempts += 1;
+
+        ht->seed1 = upo_ht_hash_mix(ht->seed1 + (size_t) 0x9E3779B9UL);
+        ht->seed2 = upo_ht_hash_mix(ht->seed2 + (size_t) 0x7F4A7C15UL);
+        ht->stash_size = 0;
+        upo_ht_cuckoo_alloc_buckets(ht, n);
+
+        ok = 1;
+        for (i = 0; i <= old_num_buckets && ok; ++i)
+        {
+            /* The last round moves the old stash and the given pair */
+            void** keys = (i < old_num_buckets) ? old_buckets[i].keys : old_stash_keys;
+            void** values = (i < old_num_buckets) ? old_buckets[i].values : old_stash_values;
+            size_t m = (i < old_num_buckets) ? UPO_HT_CUCKOO_BUCKET_SLOTS : old_stash_size + 1;
+
+            for (j = 0; j < m && ok; ++j)
+            {
+                void* k = (i < old_num_buckets || j < old_stash_size) ? keys[j] : key;
+                void* v = (i < old_num_buckets || j < old_stash_size) ? values[j] : value;
+
+                if (k != NULL)
+                {
+                    ok = upo_ht_cuckoo_place(ht, &k, &v);
+                }
+            }
+        }
+        if (!ok)
+        {
+            free(ht->buckets_mem);
+        }
+    }
+
+    free(old_buckets_mem);
+}
@@ -0,0 +1,143 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/hashtable_cuckoo_private.h
+ *
+ * \brief Private header for the Cuckoo Hash Table abstract data type.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHTABLE_CUCKOO_PRIVATE_H
+#define UPO_HASHTABLE_CUCKOO_PRIVATE_H
+
+
+#include <stddef.h>
+#include <upo/hashtable_cuckoo.h>
+
+
+/** \brief The size (in bytes) of a cache line, to which buckets are aligned. */
+#define UPO_HT_CUCKOO_CACHE_LINE 64U
+
+/** \brief Maximum number of evictions tried by an insertion before stashing. */
+#define UPO_HT_CUCKOO_MAX_KICKS 500U
+
+/** \brief Number of attempts to rebuild a table with new seeds before growing it. */
+#define UPO_HT_CUCKOO_MAX_REHASHES 4U
+
+/**
+ * \brief Number of times a single rebuild may double the number of buckets.
+ *
+ * Only a hasher that returns the same value for too many keys can exhaust it.
+ */
+#define UPO_HT_CUCKOO_MAX_GROWTHS 8U
+
+
+/**
+ * \brief Type for buckets, each filling one cache line.
+ *
+ * Keys and values are kept in separate arrays so that a lookup scans the keys
+ * of a bucket contiguously; the tags share the cache line of the keys, so a
+ * bucket costs a single cache miss.
+ */
+struct upo_ht_cuckoo_bucket_s
+{
+    void* keys[UPO_HT_CUCKOO_BUCKET_SLOTS]; /**< The keys (`NULL` for free slots). */
+    void* values[UPO_HT_CUCKOO_BUCKET_SLOTS]; /**< The values associated to the keys. */
+    unsigned char tags[UPO_HT_CUCKOO_BUCKET_SLOTS]; /**< The tags (a few hash bits) of the keys, checked before the keys themselves. */
+    unsigned char pad[UPO_HT_CUCKOO_CACHE_LINE - UPO_HT_CUCKOO_BUCKET_SLOTS*(2*sizeof(void*) + 1)]; /**< Pads the bucket to a cache line. */
+};
+/** \brief Alias for the type for buckets. */
+typedef struct upo_ht_cuckoo_bucket_s upo_ht_cuckoo_bucket_t;
+
+/** \brief Type for cuckoo hash tables. */
+struct upo_ht_cuckoo_s
+{
+    upo_ht_cuckoo_bucket_t* buckets; /**< The array of buckets, aligned to a cache line. */
+    void* buckets_mem; /**< The memory block the buckets are carved from. */
+    size_t num_buckets; /**< The number of buckets (always a power of two). */
+    size_t size; /**< The number of stored keys (stash included). */
+    size_t seed1; /**< The seed of the first hash function. */
+    size_t seed2; /**< The seed of the second hash function. */
+    size_t kick_state; /**< The state of the generator picking the slot to evict. */
+    void* stash_keys[UPO_HT_CUCKOO_STASH_SLOTS]; /**< The keys that did not fit in their buckets. */
+    void* stash_values[UPO_HT_CUCKOO_STASH_SLOTS]; /**< The values of the stashed keys. */
+    size_t stash_size; /**< The number of stashed keys. */
+    upo_ht_hasher_t key_hash; /**< The key hash function. */
+    upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+};
+
+
+/**
+ * \brief Allocates the (empty) buckets of the given hash table.
+ *
+ * \param ht The hash table.
+ * \param n The number of buckets (a power of two).
+ */
+static void upo_ht_cuckoo_alloc_buckets(upo_ht_cuckoo_t ht, size_t n);
+
+/**
+ * \brief Computes the indexes of the two buckets of the given key, and its tag.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param b1 Where the index of the first bucket is stored.
+ * \param b2 Where the index of the second bucket is stored.
+ * \param tag Where the tag is stored.
+ */
+static void upo_ht_cuckoo_buckets_of(const upo_ht_cuckoo_t ht, const void* key, size_t* b1, size_t* b2, unsigned char* tag);
+
+/**
+ * \brief Looks for the given key.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param keys Where the address of the key array holding the key is stored
+ *  (a bucket or the stash).
+ * \param values Where the address of the corresponding value array is stored.
+ * \return The index of the key in \a keys, or `(size_t) -1` if not found.
+ */
+static size_t upo_ht_cuckoo_find(const upo_ht_cuckoo_t ht, const void* key, void*** keys, void*** values);
+
+/**
+ * \brief Places a key known not to be in the table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ * \return `1` on success, or `0` if the key (or a key evicted on its behalf)
+ *  could be placed neither in a bucket nor in the stash; in the latter case
+ *  the homeless pair is returned through \a key and \a value.
+ */
+static int upo_ht_cuckoo_place(upo_ht_cuckoo_t ht, void** key, void** value);
+
+/**
+ * \brief Rebuilds the given hash table with new seeds and at least the given
+ *  number of buckets, then places the given pair.
+ *
+ * \param ht The hash table.
+ * \param n The minimum number of buckets (a power of two).
+ * \param key The key to place after the rebuild (may be `NULL`).
+ * \param value The value associated to \a key.
+ */
+static void upo_ht_cuckoo_rehash(upo_ht_cuckoo_t ht, size_t n, void* key, void* value);
+
+
+#endif /* UPO_HASHTABLE_CUCKOO_PRIVATE_H */
@@ -0,0 +1,48 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <upo/hashtable.h>
+#include <upo/hashtable_inline.h>
+
+
+/*** BEGIN of INT -> INT ***/
+
+#define UPO_HT_INLINE_NAME(x) upo_ht_int_int_##x
+#define UPO_HT_INLINE_KEY_T int
+#define UPO_HT_INLINE_VALUE_T int
+#define UPO_HT_INLINE_HASH(k) upo_ht_hash_mix((size_t) (unsigned int) (k))
+#include "hashtable_inline_template.h"
+
+/*** END of INT -> INT ***/
+
+
+/*** BEGIN of UINT64 -> POINTER ***/
+
+#define UPO_HT_INLINE_NAME(x) upo_ht_u64_ptr_##x
+#define UPO_HT_INLINE_KEY_T uint64_t
+#define UPO_HT_INLINE_VALUE_T void*
+/* Folding the high half first keeps all the bits where size_t is narrower */
+#define UPO_HT_INLINE_HASH(k) upo_ht_hash_mix((size_t) ((k) ^ ((k) >> 32)))
+#include "hashtable_inline_template.h"
+
+/*** END of UINT64 -> POINTER ***/
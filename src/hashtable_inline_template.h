@@ -0,0 +1,378 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/hashtable_inline_template.h
+ *
+ * \brief Template of the hash tables with keys and values stored inline.
+ *
+ * This file is included once per instantiation, by src/hashtable_inline.c:
+ * each inclusion defines the type and the functions of one hash table, thus
+ * it has no include guard.
+ * The functions are declared in upo/hashtable_inline.h, by means of
+ * #UPO_HT_INLINE_DECLARE.
+ * Before including it, the following macros must be defined (they are
+ * undefined at the end of the header):
+ * - `UPO_HT_INLINE_NAME(x)`, which prefixes \a x with the name of the table
+ *   (e.g., `upo_ht_int_int_##x`);
+ * - `UPO_HT_INLINE_KEY_T`, the type of keys, which must be comparable with
+ *   `==` and convertible from `0`;
+ * - `UPO_HT_INLINE_VALUE_T`, the type of values;
+ * - `UPO_HT_INLINE_HASH(k)`, an expression computing a well-mixed `size_t`
+ *   hash value of the key \a k.
+ * .
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <upo/error.h>
+#include <upo/hashtable_inline.h>
+
+
+#define NAME_ UPO_HT_INLINE_NAME
+#define KEY_T_ UPO_HT_INLINE_KEY_T
+#define VALUE_T_ UPO_HT_INLINE_VALUE_T
+
+
+/** \brief Type for slots, holding a key (`0` if free) and its value. */
+struct NAME_(slot_s)
+{
+    KEY_T_ key; /**< The key. */
+    VALUE_T_ value; /**< The value associated to the key. */
+};
+/** \brief Alias for the type for slots. */
+typedef struct NAME_(slot_s) NAME_(slot_t);
+
+/** \brief Type for hash tables with keys and values stored inline. */
+struct NAME_(s)
+{
+    NAME_(slot_t)* slots; /**< The array of slots. */
+    size_t capacity; /**< The number of slots (always a power of two). */
+    size_t min_capacity; /**< The capacity below which the table never shrinks. */
+    size_t used; /**< The number of occupied slots. */
+    size_t grow_size; /**< The number of occupied slots above which the table grows. */
+    int has_zero; /**< Tells whether key `0`, which cannot be stored in a slot, is present. */
+    VALUE_T_ zero_value; /**< The value associated to key `0`, if present. */
+};
+
+
+/**
+ * \brief Allocates an empty array of slots, replacing the current one.
+ *
+ * \param ht The hash table.
+ * \param n The number of slots (a power of two).
+ */
+static void NAME_(alloc_slots)(NAME_(t) ht, size_t n);
+
+/**
+ * \brief Looks for the given (nonzero) key.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return The index of the slot holding the key, or of the free slot where
+ *  the probe sequence ends.
+ */
+static size_t NAME_(find)(const NAME_(t) ht, KEY_T_ key);
+
+/**
+ * \brief Changes the capacity of the given hash table.
+ *
+ * \param ht The hash table.
+ * \param n The new capacity (a power of two).
+ */
+static void NAME_(resize)(NAME_(t) ht, size_t n);
+
+
+NAME_(t) NAME_(create)(size_t m)
+{
+    NAME_(t) ht = NULL;
+    size_t n = 1;
+
+    ht = malloc(sizeof(struct NAME_(s)));
+    if (ht == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the Hash Table");
+    }
+
+    while (n < m)
+    {
+        n *= 2;
+    }
+    ht->slots = NULL;
+    ht->min_capacity = n;
+    ht->used = 0;
+    ht->has_zero = 0;
+    NAME_(alloc_slots)(ht, n);
+
+    return ht;
+}
+
+void NAME_(destroy)(NAME_(t) ht)
+{
+    if (ht != NULL)
+    {
+        free(ht->slots);
+        free(ht);
+    }
+}
+
+void NAME_(clear)(NAME_(t) ht)
+{
+    if (ht != NULL)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < ht->capacity; ++i)
+        {
+            ht->slots[i].key = 0;
+        }
+        ht->used = 0;
+        ht->has_zero = 0;
+    }
+}
+
+int NAME_(put)(NAME_(t) ht, KEY_T_ key, VALUE_T_ value)
+{
+    size_t i = 0;
+
+    /* preconditions */
+    assert( ht != NULL );
+
+    if (key == 0)
+    {
+        int found = ht->has_zero;
+
+        ht->has_zero = 1;
+        ht->zero_value = value;
+        return found;
+    }
+
+    i = NAME_(find)(ht, key);
+    if (ht->slots[i].key == key)
+    {
+        ht->slots[i].value = value;
+        return 1;
+    }
+
+    ht->slots[i].key = key;
+    ht->slots[i].value = value;
+    ht->used += 1;
+    if (ht->used > ht->grow_size)
+    {
+        NAME_(resize)(ht, 2*ht->capacity);
+    }
+
+    return 0;
+}
+
+int NAME_(get)(const NAME_(t) ht, KEY_T_ key, VALUE_T_* value)
+{
+    size_t i = 0;
+
+    if (ht == NULL)
+    {
+        return 0;
+    }
+
+    if (key == 0)
+    {
+        if (ht->has_zero && value != NULL)
+        {
+            *value = ht->zero_value;
+        }
+        return ht->has_zero;
+    }
+
+    i = NAME_(find)(ht, key);
+    if (ht->slots[i].key != key)
+    {
+        return 0;
+    }
+    if (value != NULL)
+    {
+        *value = ht->slots[i].value;
+    }
+
+    return 1;
+}
+
+int NAME_(contains)(const NAME_(t) ht, KEY_T_ key)
+{
+    return NAME_(get)(ht, key, NULL);
+}
+
+int NAME_(delete)(NAME_(t) ht, KEY_T_ key)
+{
+    size_t mask = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    if (ht == NULL)
+    {
+        return 0;
+    }
+
+    if (key == 0)
+    {
+        int found = ht->has_zero;
+
+        ht->has_zero = 0;
+        return found;
+    }
+
+    i = NAME_(find)(ht, key);
+    if (ht->slots[i].key != key)
+    {
+        return 0;
+    }
+
+    /*
+     * Backward-shift deletion: move back each following key of the cluster
+     * whose home slot does not lie (cyclically) in (i, j], so that no probe
+     * sequence is broken by the freed slot and no tombstone is needed.
+     */
+    mask = ht->capacity - 1;
+    j = i;
+    for (;;)
+    {
+        size_t k = 0;
+
+        j = (j + 1) & mask;
+        if (ht->slots[j].key == 0)
+        {
+            break;
+        }
+        k = UPO_HT_INLINE_HASH(ht->slots[j].key) & mask;
+        if ((j > i) ? (k <= i || k > j) : (k <= i && k > j))
+        {
+            ht->slots[i] = ht->slots[j];
+            i = j;
+        }
+    }
+    ht->slots[i].key = 0;
+    ht->used -= 1;
+
+    if (ht->used < ht->capacity/8 && ht->capacity/2 >= ht->min_capacity)
+    {
+        NAME_(resize)(ht, ht->capacity/2);
+    }
+
+    return 1;
+}
+
+int NAME_(is_empty)(const NAME_(t) ht)
+{
+    return NAME_(size)(ht) == 0 ? 1 : 0;
+}
+
+size_t NAME_(capacity)(const NAME_(t) ht)
+{
+    return (ht != NULL) ? ht->capacity : 0;
+}
+
+size_t NAME_(size)(const NAME_(t) ht)
+{
+    return (ht != NULL) ? ht->used + (size_t) ht->has_zero : 0;
+}
+
+double NAME_(load_factor)(const NAME_(t) ht)
+{
+    return NAME_(size)(ht) / (double) NAME_(capacity)(ht);
+}
+
+void NAME_(traverse)(const NAME_(t) ht, NAME_(visitor_t) visit, void* visit_arg)
+{
+    if (ht != NULL)
+    {
+        size_t i = 0;
+
+        if (ht->has_zero)
+        {
+            visit(0, ht->zero_value, visit_arg);
+        }
+        for (i = 0; i < ht->capacity; ++i)
+        {
+            if (ht->slots[i].key != 0)
+            {
+                visit(ht->slots[i].key, ht->slots[i].value, visit_arg);
+            }
+        }
+    }
+}
+
+void NAME_(alloc_slots)(NAME_(t) ht, size_t n)
+{
+    size_t i = 0;
+
+    ht->slots = malloc(n*sizeof(NAME_(slot_t)));
+    if (ht->slots == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for slots of the Hash Table");
+    }
+    for (i = 0; i < n; ++i)
+    {
+        ht->slots[i].key = 0;
+    }
+    ht->capacity = n;
+    /* Computed once per resize, so that insertions only compare integers */
+    ht->grow_size = (size_t) (UPO_HT_INLINE_MAX_LOAD_FACTOR*n);
+}
+
+size_t NAME_(find)(const NAME_(t) ht, KEY_T_ key)
+{
+    size_t mask = ht->capacity - 1;
+    size_t i = UPO_HT_INLINE_HASH(key) & mask;
+
+    /* The load factor is bounded, so there is always a free slot */
+    while (ht->slots[i].key != key && ht->slots[i].key != 0)
+    {
+        i = (i + 1) & mask;
+    }
+
+    return i;
+}
+
+void NAME_(resize)(NAME_(t) ht, size_t n)
+{
+    NAME_(slot_t)* old_slots = ht->slots;
+    size_t old_capacity = ht->capacity;
+    size_t i = 0;
+
+    NAME_(alloc_slots)(ht, n);
+    for (i = 0; i < old_capacity; ++i)
+    {
+        if (old_slots[i].key != 0)
+        {
+            ht->slots[NAME_(find)(ht, old_slots[i].key)] = old_slots[i];
+        }
+    }
+    free(old_slots);
+}
+
+
+#undef NAME_
+#undef KEY_T_
+#undef VALUE_T_
+#undef UPO_HT_INLINE_NAME
+#undef UPO_HT_INLINE_KEY_T
+#undef UPO_HT_INLINE_VALUE_T
+#undef UPO_HT_INLINE_HASH
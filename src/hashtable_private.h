@@ -29,7 +29,25 @@
 #define UPO_HASHTABLE_PRIVATE_H
 
 
+#include "hashtable_probe_private.h"
+#include <stdint.h>
+#include <upo/filter.h>
 #include <upo/hashtable.h>
+#include <upo/hires_timer.h>
+#include <upo/mem_pool.h>
+
+
+/**
+ * \brief Number of keys that batched lookups hash and prefetch before
+ *  resolving them.
+ *
+ * The group must be large enough to keep several cache misses in flight, but
+ * small enough for the prefetched lines to still be cached when resolved.
+ */
+#define UPO_HT_BATCH_GROUP_SIZE 16U
+
+/** \brief Tells whether the given (nonzero) number is a power of two. */
+#define UPO_HT_IS_POW2(n) (((n) & ((n)-1)) == 0)
 
 
 /*** BEGIN of HASH TABLE with SEPARATE CHAINING ***/
@@ -59,49 +77,245 @@ struct upo_ht_sepchain_s
     upo_ht_sepchain_slot_t* slots; /**< The hash table as array of slots. */
     size_t capacity; /**< The capacity of the hash table. */
     size_t size; /**< The number of elements stored in the hash table. */
-    upo_ht_hasher_t key_hash; /**< The key hash function. */
+    upo_ht_hasher_t key_hash; /**< The key hash function (`NULL` if seeded). */
+    upo_ht_seeded_hasher_t seeded_key_hash; /**< The seeded key hash function (`NULL` if not seeded). */
+    size_t seed; /**< The seed passed to the seeded key hash function. */
     upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+    upo_mem_pool_t nodes; /**< The pool the nodes of the lists of collisions are drawn from. */
+    size_t min_capacity; /**< The capacity below which the hash table never shrinks. */
+    double min_load_factor; /**< The load factor below which the hash table shrinks (0 to disable). */
+    double max_load_factor; /**< The load factor above which the hash table grows (0 to disable). */
+    size_t grow_size; /**< The size above which the hash table grows. */
+    size_t shrink_size; /**< The size below which the hash table shrinks. */
+    size_t resizes; /**< The number of resizes since the creation of the hash table. */
+    double resize_time; /**< The total time (in seconds) spent resizing. */
+    int filter_type; /**< The kind of filter consulted by lookups (see #UPO_HT_FILTER_NONE). */
+    upo_bloom_filter_t bloom; /**< The Bloom filter, if #UPO_HT_FILTER_BLOOM is used. */
+    upo_cuckoo_filter_t cuckoo; /**< The cuckoo filter, if #UPO_HT_FILTER_CUCKOO is used. */
+    size_t filter_capacity; /**< The number of keys the filter was sized for. */
 };
 
 
+/**
+ * \brief Resize the given hash table to the given capacity.
+ *
+ * \param ht The hash table to resize.
+ * \param n The new capacity.
+ *
+ * Nodes are moved to the new slots without being reallocated.
+ */
+static void upo_ht_sepchain_resize(upo_ht_sepchain_t ht, size_t n);
+
+/**
+ * \brief Allocates a new empty hash table, leaving its hash functions unset.
+ *
+ * \param m The initial capacity of the hash table.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash table.
+ */
+static upo_ht_sepchain_t upo_ht_sepchain_alloc(size_t m, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Hashes the given key by means of the (seeded or plain) hash function
+ *  of the given hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param m The number of possible hash values.
+ * \return The hash value.
+ */
+static size_t upo_ht_sepchain_hash(const upo_ht_sepchain_t ht, const void* key, size_t m);
+
+/**
+ * \brief Recomputes the sizes that trigger the automatic resizing of the given
+ *  hash table from its capacity and load factors.
+ *
+ * \param ht The hash table.
+ */
+static void upo_ht_sepchain_update_thresholds(upo_ht_sepchain_t ht);
+
+/**
+ * \brief Replaces the filter of the given hash table with a new one holding
+ *  all the stored keys.
+ *
+ * \param ht The hash table.
+ * \param n The number of keys the new filter must be sized for (at least).
+ */
+static void upo_ht_sepchain_filter_rebuild(upo_ht_sepchain_t ht, size_t n);
+
+/**
+ * \brief Adds a newly stored key to the filter of the given hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ *
+ * The filter is rebuilt, larger, when it cannot take the key.
+ */
+static void upo_ht_sepchain_filter_add(upo_ht_sepchain_t ht, const void* key);
+
+/**
+ * \brief Tells if the filter of the given hash table may contain the given
+ *  key.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return `0` if the key is surely absent, or `1` if it may be present (or
+ *  the table has no filter).
+ */
+static int upo_ht_sepchain_filter_may_contain(const upo_ht_sepchain_t ht, const void* key);
+
+
 /*** END of HASH TABLE with SEPARATE CHAINING ***/
 
 
 /*** BEGIN of HASH TABLE with LINEAR PROBING ***/
 
 
-/** \brief Type for slots of hash tables with linear probing. */
-struct upo_ht_linprob_slot_s
+/**
+ * \brief Type for entries (i.e., key-value pairs) of hash tables with linear
+ *  probing.
+ */
+struct upo_ht_linprob_entry_s
 {
-    void* key; /**< Pointer to the user-provided key. */
+    upo_hprobe_entry_t header; /**< The header of the entry, with the key and its hash value. */
     void* value; /**< Pointer to the value associated to the key. */
-    int tombstone; /**< Flag used to mark this slot as deleted. */
 };
 
-/** \brief Alias for type for slots of hash tables with linear probing. */
-typedef struct upo_ht_linprob_slot_s upo_ht_linprob_slot_t;
+/** \brief Alias for type for entries of hash tables with linear probing. */
+typedef struct upo_ht_linprob_entry_s upo_ht_linprob_entry_t;
 
-/** \brief Type for hash tables with linear probing. */
+/**
+ * \brief Type for hash tables with linear probing.
+ *
+ * Probing, resizing and batched lookups are left to the probing core of
+ * src/hashtable_probe_private.h, the same as hash sets and hash multimaps:
+ * key-value pairs are kept contiguous in its dense array of entries, while
+ * the probed array of slots only stores indexes into it.
+ * Thus iterating over the pairs takes time proportional to the size rather
+ * than to the capacity, and free slots only cost one word each.
+ */
 struct upo_ht_linprob_s
 {
-    upo_ht_linprob_slot_t* slots; /**< The hash table as array of slots. */
-    size_t capacity; /**< The capacity of the hash table. */
-    size_t size; /**< The number of stored key-value pairs. */
-    upo_ht_hasher_t key_hash; /**< The key hash function. */
-    upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+    upo_hprobe_t core; /**< The probing core, whose entries are \c upo_ht_linprob_entry_t. */
 };
 
 
 /**
- * \brief Resize the given hash table to the given capacity.
+ * \brief Allocates a new empty hash table.
  *
- * \param ht The hash table to resize.
- * \param n The new capacity.
+ * \param m The initial capacity of the hash table.
+ * \param key_hash A pointer to the function used to hash keys, or `NULL` if
+ *  \a seeded_key_hash is given.
+ * \param seeded_key_hash A pointer to the seeded function used to hash keys,
+ *  or `NULL` if \a key_hash is given.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash table.
  */
-static void upo_ht_linprob_resize(upo_ht_linprob_t ht, size_t n);
+static upo_ht_linprob_t upo_ht_linprob_alloc(size_t m, upo_ht_hasher_t key_hash, upo_ht_seeded_hasher_t seeded_key_hash, upo_ht_comparator_t key_cmp);
 
 
 /*** END of HASH TABLE with LINEAR PROBING ***/
 
 
+/*** BEGIN of BULK BUILDING ***/
+
+
+/**
+ * \brief Number of slots a partition of keys should span while building a
+ *  hash table in bulk.
+ *
+ * The slots of a partition (and the entries or nodes placed meanwhile) should
+ * fit in the first-level data cache.
+ */
+#define UPO_HT_BUILD_PARTITION_SLOTS 2048U
+
+/** \brief Maximum number of partitions of keys while building a hash table in bulk. */
+#define UPO_HT_BUILD_MAX_PARTITIONS 4096U
+
+/** \brief Type for key-value pairs to be placed in a hash table, along with the hash value of the key. */
+struct upo_ht_build_pair_s
+{
+    size_t hash; /**< The hash value of the key (whose remainder modulo the number of slots is the home slot). */
+    void* key; /**< Pointer to the user-provided key. */
+    void* value; /**< Pointer to the value associated to the key. */
+};
+/** \brief Alias for the type for key-value pairs to be placed in a hash table. */
+typedef struct upo_ht_build_pair_s upo_ht_build_pair_t;
+
+/**
+ * \brief Groups the given key-value pairs by range of home slots.
+ *
+ * \param keys The keys.
+ * \param values The values.
+ * \param hashes The hash values of the keys, whose remainder modulo \a m is
+ *  the home slot.
+ * \param n The number of keys.
+ * \param m The number of slots.
+ * \return A newly allocated array of the key-value pairs, along with their
+ *  hash values, grouped by ranges of (about) #UPO_HT_BUILD_PARTITION_SLOTS
+ *  home slots, in increasing order; within a group, pairs keep their
+ *  original order.
+ */
+static upo_ht_build_pair_t* upo_ht_partition_pairs(void* const* keys, void* const* values, const size_t* hashes, size_t n, size_t m);
+
+
+/*** END of BULK BUILDING ***/
+
+
+/*** BEGIN of HASH FUNCTIONS ***/
+
+
+/** \brief The 64-bit golden ratio constant, that is \f$\lfloor 2^{64} (\sqrt{5}-1)/2 \rfloor\f$. */
+#define UPO_HT_GOLDEN_RATIO64 UINT64_C(0x9E3779B97F4A7C15)
+
+/** \brief First prime of the xxHash64 algorithm. */
+#define UPO_HT_XX64_PRIME1 UINT64_C(0x9E3779B185EBCA87)
+/** \brief Second prime of the xxHash64 algorithm. */
+#define UPO_HT_XX64_PRIME2 UINT64_C(0xC2B2AE3D27D4EB4F)
+/** \brief Third prime of the xxHash64 algorithm. */
+#define UPO_HT_XX64_PRIME3 UINT64_C(0x165667B19E3779F9)
+/** \brief Fourth prime of the xxHash64 algorithm. */
+#define UPO_HT_XX64_PRIME4 UINT64_C(0x85EBCA77C2B2AE63)
+/** \brief Fifth prime of the xxHash64 algorithm. */
+#define UPO_HT_XX64_PRIME5 UINT64_C(0x27D4EB2F165667C5)
+
+/** \brief Rotates the given 64-bit word to the left by \a r bits (with `0 < r < 64`). */
+#define UPO_HT_ROTL64(x,r) (((x) << (r)) | ((x) >> (64-(r))))
+
+/** \brief Reads a 64-bit little-endian word from a possibly unaligned address. */
+static uint64_t upo_ht_read64(const unsigned char* p);
+
+/** \brief Reads a 32-bit little-endian word from a possibly unaligned address. */
+static uint64_t upo_ht_read32(const unsigned char* p);
+
+/** \brief Mixes an input word into an accumulator lane of xxHash64. */
+static uint64_t upo_ht_xx64_round(uint64_t acc, uint64_t input);
+
+/** \brief Merges an accumulator lane into the final xxHash64 state. */
+static uint64_t upo_ht_xx64_merge_round(uint64_t acc, uint64_t val);
+
+/** \brief Number of rounds of SipHash per word of input. */
+#define UPO_HT_SIPHASH_C_ROUNDS 2
+/** \brief Number of rounds of SipHash in the finalization. */
+#define UPO_HT_SIPHASH_D_ROUNDS 4
+
+/** \brief Applies the given number of SipRounds to the state of SipHash. */
+static void upo_ht_sip_rounds(uint64_t v[4], int rounds);
+
+/**
+ * \brief Returns the second half of the SipHash key derived from the seed of
+ *  a seeded hash function (the first half being the seed itself).
+ */
+static size_t upo_ht_sip_key1(size_t seed);
+
+/**
+ * \brief Folds a 64-bit hash value into a `size_t`, keeping its most
+ *  significant bits.
+ */
+size_t upo_ht_fold64(uint64_t h);
+
+
+/*** END of HASH FUNCTIONS ***/
+
+
 #endif /* UPO_HASHTABLE_PRIVATE_H */
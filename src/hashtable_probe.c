@@ -0,0 +1,340 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include "hashtable_probe_private.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+#include <upo/hires_timer.h>
+#include <upo/macro.h>
+
+
+/*** BEGIN of PROBING CORE ***/
+
+
+void upo_hprobe_init(upo_hprobe_t* core, size_t m, size_t entry_size, upo_ht_hasher_t key_hash, upo_ht_seeded_hasher_t seeded_key_hash, upo_ht_comparator_t key_cmp)
+{
+    size_t n = 1;
+    size_t i = 0;
+
+    /* preconditions */
+    assert( m <= ((size_t) -1)/2 + 1 );
+
+    while (n < m)
+    {
+        n *= 2;
+    }
+
+    core->slots = malloc(n*sizeof(size_t));
+    core->entries = malloc(upo_hprobe_entries_for(n)*entry_size);
+    if (core->slots == NULL || core->entries == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for slots of the Hash Table with Linear Probing");
+    }
+    for (i = 0; i < n; ++i)
+    {
+        core->slots[i] = UPO_HPROBE_EMPTY;
+    }
+    core->capacity = n;
+    core->entry_size = entry_size;
+    core->size = 0;
+    core->key_hash = key_hash;
+    core->seeded_key_hash = seeded_key_hash;
+    core->seed = (seeded_key_hash != NULL) ? upo_ht_random_seed() : 0;
+    core->key_cmp = key_cmp;
+    core->resizes = 0;
+    core->resize_time = 0;
+}
+
+void upo_hprobe_free(upo_hprobe_t* core)
+{
+    free(core->slots);
+    free(core->entries);
+}
+
+void upo_hprobe_clear(upo_hprobe_t* core)
+{
+    size_t i = 0;
+
+    for (i = 0; i < core->capacity; ++i)
+    {
+        core->slots[i] = UPO_HPROBE_EMPTY;
+    }
+    core->size = 0;
+}
+
+size_t upo_hprobe_entries_for(size_t capacity)
+{
+    /* The core grows before it gets more than half full */
+    return capacity/2 + 1;
+}
+
+size_t upo_hprobe_hash(const upo_hprobe_t* core, const void* key)
+{
+    if (core->seeded_key_hash != NULL)
+    {
+        return upo_ht_hash_mix(core->seeded_key_hash(key, core->seed, UPO_HT_HASH_FULL_RANGE));
+    }
+
+    return upo_ht_hash_mix(core->key_hash(key, UPO_HT_HASH_FULL_RANGE));
+}
+
+size_t upo_hprobe_find(const upo_hprobe_t* core, const void* key, size_t hash)
+{
+    size_t mask = core->capacity - 1;
+    size_t i = hash & mask;
+
+    while (core->slots[i] != UPO_HPROBE_EMPTY)
+    {
+        const upo_hprobe_entry_t* entry = UPO_HPROBE_ENTRY(core, core->slots[i]);
+
+        /* Most mismatches are told apart without dereferencing the key */
+        if (entry->hash == hash && core->key_cmp(key, entry->key) == 0)
+        {
+            break;
+        }
+        i = (i + 1) & mask;
+    }
+
+    return i;
+}
+
+upo_hprobe_entry_t* upo_hprobe_lookup(const upo_hprobe_t* core, const void* key)
+{
+    size_t i = upo_hprobe_find(core, key, upo_hprobe_hash(core, key));
+
+    return (core->slots[i] != UPO_HPROBE_EMPTY) ? UPO_HPROBE_ENTRY(core, core->slots[i]) : NULL;
+}
+
+size_t upo_hprobe_lookup_batch(const upo_hprobe_t* core, void* const* keys, size_t n, upo_hprobe_entry_t** entries_out)
+{
+    size_t hashes[UPO_HPROBE_BATCH_GROUP_SIZE];
+    size_t mask = core->capacity - 1;
+    size_t found = 0;
+    size_t first = 0;
+
+    for (first = 0; first < n; first += UPO_HPROBE_BATCH_GROUP_SIZE)
+    {
+        size_t group = (n - first < UPO_HPROBE_BATCH_GROUP_SIZE) ? n - first : UPO_HPROBE_BATCH_GROUP_SIZE;
+        size_t i = 0;
+
+        /* Stage 1: hash the keys and prefetch the home slot of each probe */
+        for (i = 0; i < group; ++i)
+        {
+            hashes[i] = upo_hprobe_hash(core, keys[first+i]);
+            UPO_PREFETCH(&core->slots[hashes[i] & mask]);
+        }
+
+        /* Stage 2: prefetch the entry referred to by the home slot */
+        for (i = 0; i < group; ++i)
+        {
+            size_t slot = core->slots[hashes[i] & mask];
+
+            if (slot != UPO_HPROBE_EMPTY)
+            {
+                UPO_PREFETCH(UPO_HPROBE_ENTRY(core, slot));
+            }
+        }
+
+        /* Stage 3: probe, starting from slots and entries that should now be cached */
+        for (i = 0; i < group; ++i)
+        {
+            size_t j = upo_hprobe_find(core, keys[first+i], hashes[i]);
+
+            if (core->slots[j] != UPO_HPROBE_EMPTY)
+            {
+                entries_out[first+i] = UPO_HPROBE_ENTRY(core, core->slots[j]);
+                ++found;
+            }
+            else
+            {
+                entries_out[first+i] = NULL;
+            }
+        }
+    }
+
+    return found;
+}
+
+upo_hprobe_entry_t* upo_hprobe_insert(upo_hprobe_t* core, void* key, size_t hash, int* found)
+{
+    upo_hprobe_entry_t* entry = NULL;
+    size_t i = upo_hprobe_find(core, key, hash);
+
+    if (core->slots[i] != UPO_HPROBE_EMPTY)
+    {
+        *found = 1;
+        return UPO_HPROBE_ENTRY(core, core->slots[i]);
+    }
+
+    *found = 0;
+    if (2*(core->size + 1) > core->capacity)
+    {
+        upo_hprobe_resize(core, 2*core->capacity);
+        i = upo_hprobe_find(core, key, hash);
+    }
+    entry = UPO_HPROBE_ENTRY(core, core->size);
+    entry->key = key;
+    entry->hash = hash;
+    core->slots[i] = core->size;
+    core->size += 1;
+
+    return entry;
+}
+
+void upo_hprobe_remove(upo_hprobe_t* core, upo_hprobe_entry_t* entry)
+{
+    size_t mask = core->capacity - 1;
+    size_t index = ((unsigned char*) entry - core->entries)/core->entry_size;
+    size_t last = core->size - 1;
+    size_t i = entry->hash & mask;
+    size_t j = 0;
+
+    while (core->slots[i] != index)
+    {
+        i = (i + 1) & mask;
+    }
+
+    /*
+     * Backward-shift deletion: move back each following slot of the cluster
+     * whose home slot does not lie (cyclically) in (i, j], so that no probe
+     * sequence is broken by the freed slot and no tombstone is needed.
+     */
+    j = i;
+    for (;;)
+    {
+        size_t k = 0;
+
+        j = (j + 1) & mask;
+        if (core->slots[j] == UPO_HPROBE_EMPTY)
+        {
+            break;
+        }
+        k = UPO_HPROBE_ENTRY(core, core->slots[j])->hash & mask;
+        if ((j > i) ? (k <= i || k > j) : (k <= i && k > j))
+        {
+            core->slots[i] = core->slots[j];
+            i = j;
+        }
+    }
+    core->slots[i] = UPO_HPROBE_EMPTY;
+
+    /* Keep entries dense: move the last one into the hole */
+    if (index != last)
+    {
+        upo_hprobe_entry_t* moved = UPO_HPROBE_ENTRY(core, last);
+
+        i = moved->hash & mask;
+        while (core->slots[i] != last)
+        {
+            i = (i + 1) & mask;
+        }
+        memcpy(entry, moved, core->entry_size);
+        core->slots[i] = index;
+    }
+    core->size -= 1;
+
+    if (core->size <= core->capacity/8 && core->capacity > 1)
+    {
+        upo_hprobe_resize(core, core->capacity/2);
+    }
+}
+
+void upo_hprobe_resize(upo_hprobe_t* core, size_t n)
+{
+    size_t mask = n - 1;
+    size_t* slots = NULL;
+    unsigned char* entries = NULL;
+    upo_hires_timer_t timer = NULL;
+    size_t i = 0;
+
+    timer = upo_hires_timer_create();
+    upo_hires_timer_start(timer);
+
+    slots = malloc(n*sizeof(size_t));
+    entries = realloc(core->entries, upo_hprobe_entries_for(n)*core->entry_size);
+    if (slots == NULL || entries == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for slots of the Hash Table with Linear Probing");
+    }
+    core->entries = entries;
+    for (i = 0; i < n; ++i)
+    {
+        slots[i] = UPO_HPROBE_EMPTY;
+    }
+    /* Entries hold their hash value: the key hash function is not called */
+    for (i = 0; i < core->size; ++i)
+    {
+        size_t j = UPO_HPROBE_ENTRY(core, i)->hash & mask;
+
+        while (slots[j] != UPO_HPROBE_EMPTY)
+        {
+            j = (j + 1) & mask;
+        }
+        slots[j] = i;
+    }
+    free(core->slots);
+    core->slots = slots;
+    core->capacity = n;
+
+    upo_hires_timer_stop(timer);
+    core->resizes += 1;
+    core->resize_time += upo_hires_timer_elapsed(timer);
+    upo_hires_timer_destroy(timer);
+}
+
+void upo_hprobe_stats(const upo_hprobe_t* core, upo_ht_stats_t* stats)
+{
+    size_t mask = core->capacity - 1;
+    size_t probes = 0;
+    size_t i = 0;
+
+    memset(stats, 0, sizeof(upo_ht_stats_t));
+    for (i = 0; i < core->capacity; ++i)
+    {
+        if (core->slots[i] != UPO_HPROBE_EMPTY)
+        {
+            /* The distance from the home slot, wrapping around */
+            size_t len = ((i - UPO_HPROBE_ENTRY(core, core->slots[i])->hash) & mask) + 1;
+
+            stats->histogram[(len <= UPO_HT_STATS_HISTOGRAM_SIZE) ? len-1 : UPO_HT_STATS_HISTOGRAM_SIZE-1] += 1;
+            if (len > stats->max_probe)
+            {
+                stats->max_probe = len;
+            }
+            probes += len;
+        }
+    }
+
+    stats->size = core->size;
+    stats->capacity = core->capacity;
+    stats->slot_bytes = core->capacity*sizeof(size_t);
+    stats->entry_bytes = upo_hprobe_entries_for(core->capacity)*core->entry_size;
+    stats->avg_probe = (core->size > 0) ? probes / (double) core->size : 0;
+    stats->resizes = core->resizes;
+    stats->resize_time = core->resize_time;
+}
+
+
+/*** END of PROBING CORE ***/
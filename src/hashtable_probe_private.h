@@ -0,0 +1,222 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/hashtable_probe_private.h
+ *
+ * \brief Private header for the linear probing core shared by hash tables with
+ *  linear probing, hash sets and hash multimaps.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHTABLE_PROBE_PRIVATE_H
+#define UPO_HASHTABLE_PROBE_PRIVATE_H
+
+
+#include <stddef.h>
+#include <upo/hashtable.h>
+
+
+/*** BEGIN of PROBING CORE ***/
+
+
+/** \brief Marks free slots of the probing core. */
+#define UPO_HPROBE_EMPTY ((size_t) -1)
+
+/** \brief Returns a pointer to the entry of index \a i of the probing core \a core. */
+#define UPO_HPROBE_ENTRY(core,i) ((upo_hprobe_entry_t*) ((core)->entries + (i)*(core)->entry_size))
+
+/** \brief The number of keys whose memory accesses are overlapped by batch lookups. */
+#define UPO_HPROBE_BATCH_GROUP_SIZE 16U
+
+
+/**
+ * \brief Type for the header of entries of the probing core.
+ *
+ * Containers extend it with their own fields, as the first member of their
+ * entries.
+ */
+struct upo_hprobe_entry_s
+{
+    void* key; /**< Pointer to the user-provided key. */
+    size_t hash; /**< The (mixed, unreduced) hash value of the key. */
+};
+/** \brief Alias for the type for the header of entries of the probing core. */
+typedef struct upo_hprobe_entry_s upo_hprobe_entry_t;
+
+/**
+ * \brief Type for the probing core shared by hash tables with linear probing,
+ *  hash sets and hash multimaps.
+ *
+ * The probed array of slots holds indexes into a dense array of entries of
+ * \c entry_size bytes each (or #UPO_HPROBE_EMPTY).
+ * Unlike the rest of this header, the functions below are not static: they
+ * are defined once, in src/hashtable_probe.c, for all the containers.
+ */
+struct upo_hprobe_s
+{
+    size_t* slots; /**< The array of slots. */
+    size_t capacity; /**< The number of slots (always a power of two). */
+    unsigned char* entries; /**< The dense array of entries. */
+    size_t entry_size; /**< The size of each entry. */
+    size_t size; /**< The number of entries in use. */
+    upo_ht_hasher_t key_hash; /**< The key hash function (`NULL` if seeded). */
+    upo_ht_seeded_hasher_t seeded_key_hash; /**< The seeded key hash function (`NULL` if not seeded). */
+    size_t seed; /**< The seed passed to the seeded key hash function. */
+    upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+    size_t resizes; /**< The number of resizes since the creation. */
+    double resize_time; /**< The total time (in seconds) spent resizing. */
+};
+/** \brief Alias for the type for the probing core. */
+typedef struct upo_hprobe_s upo_hprobe_t;
+
+
+/**
+ * \brief Initializes the given probing core, with no entries.
+ *
+ * \param core The probing core.
+ * \param m The initial capacity, rounded up to a power of two (so it must not
+ *  exceed the largest power of two representable as `size_t`).
+ * \param entry_size The size of each entry (at least the size of its header).
+ * \param key_hash A pointer to the function used to hash keys, or `NULL` if
+ *  \a seeded_key_hash is given.
+ * \param seeded_key_hash A pointer to the seeded function used to hash keys,
+ *  with a random seed, or `NULL` if \a key_hash is given.
+ * \param key_cmp A pointer to the function used to compare keys.
+ */
+void upo_hprobe_init(upo_hprobe_t* core, size_t m, size_t entry_size, upo_ht_hasher_t key_hash, upo_ht_seeded_hasher_t seeded_key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Frees the arrays of the given probing core.
+ *
+ * \param core The probing core.
+ */
+void upo_hprobe_free(upo_hprobe_t* core);
+
+/**
+ * \brief Removes all entries from the given probing core.
+ *
+ * \param core The probing core.
+ */
+void upo_hprobe_clear(upo_hprobe_t* core);
+
+/**
+ * \brief Returns the number of entries the given capacity can hold.
+ *
+ * \param capacity The capacity.
+ * \return The size of the array of entries.
+ */
+size_t upo_hprobe_entries_for(size_t capacity);
+
+/**
+ * \brief Returns the hash value of the given key.
+ *
+ * \param core The probing core.
+ * \param key The key.
+ * \return The hash value, mixed over the whole word.
+ */
+size_t upo_hprobe_hash(const upo_hprobe_t* core, const void* key);
+
+/**
+ * \brief Looks for the given key.
+ *
+ * \param core The probing core.
+ * \param key The key.
+ * \param hash The hash value of the key.
+ * \return The index of the slot referring to the entry of the key, or of the
+ *  free slot where the probe sequence ends.
+ */
+size_t upo_hprobe_find(const upo_hprobe_t* core, const void* key, size_t hash);
+
+/**
+ * \brief Returns the entry of the given key.
+ *
+ * \param core The probing core.
+ * \param key The key.
+ * \return The entry, or `NULL` if the key is not present.
+ */
+upo_hprobe_entry_t* upo_hprobe_lookup(const upo_hprobe_t* core, const void* key);
+
+/**
+ * \brief Returns the entries of a batch of keys.
+ *
+ * \param core The probing core.
+ * \param keys The array of keys.
+ * \param n The number of keys.
+ * \param entries_out Where the entry of each key (or `NULL` if the key is not
+ *  present) is stored.
+ * \return The number of keys found.
+ *
+ * All the keys of a group of #UPO_HPROBE_BATCH_GROUP_SIZE are hashed before
+ * any of them is probed, so that the cache misses of the group overlap.
+ */
+size_t upo_hprobe_lookup_batch(const upo_hprobe_t* core, void* const* keys, size_t n, upo_hprobe_entry_t** entries_out);
+
+/**
+ * \brief Returns the entry of the given key, adding it if needed.
+ *
+ * \param core The probing core.
+ * \param key The key.
+ * \param hash The hash value of the key, as returned by upo_hprobe_hash().
+ * \param found Where `1` is stored if the key was already present, or `0`
+ *  otherwise.
+ * \return The entry; only the header of a new entry is initialized.
+ *
+ * Pointers to entries are invalidated, since the core may grow.
+ */
+upo_hprobe_entry_t* upo_hprobe_insert(upo_hprobe_t* core, void* key, size_t hash, int* found);
+
+/**
+ * \brief Removes the given entry.
+ *
+ * \param core The probing core.
+ * \param entry The entry, whose data must have been released already.
+ *
+ * The following slots of the cluster are moved back, and the last entry is
+ * moved into the hole, to keep entries dense.
+ * Pointers to entries are invalidated, since the core may shrink.
+ */
+void upo_hprobe_remove(upo_hprobe_t* core, upo_hprobe_entry_t* entry);
+
+/**
+ * \brief Changes the capacity of the given probing core.
+ *
+ * \param core The probing core.
+ * \param n The new capacity (a power of two, at least twice the size).
+ *
+ * Slots are rebuilt from the hash values stored in the entries.
+ */
+void upo_hprobe_resize(upo_hprobe_t* core, size_t n);
+
+/**
+ * \brief Collects statistics about the given probing core.
+ *
+ * \param core The probing core.
+ * \param stats Where the statistics are stored.
+ *
+ * The overhead of the container is left to the caller.
+ */
+void upo_hprobe_stats(const upo_hprobe_t* core, upo_ht_stats_t* stats);
+
+
+/*** END of PROBING CORE ***/
+
+
+#endif /* UPO_HASHTABLE_PROBE_PRIVATE_H */
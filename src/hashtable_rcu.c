@@ -0,0 +1,572 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Mutexes, posix_memalign() and sched_yield() are POSIX extensions */
+#define _POSIX_C_SOURCE 200112L
+
+/*
+ * Shared fields are accessed through the GCC __atomic builtins:
+ * - lookups load the array of slots, the list links and the values with
+ *   acquire semantics, while writers store them with release semantics, so
+ *   that a lookup that sees a pointer also sees the object it points to;
+ * - reader counters and the epoch are accessed with sequentially consistent
+ *   semantics, and a grace period starts with a full fence, so that either a
+ *   lookup sees an unlink or the grace period sees the lookup.
+ * The reader counter of each thread is remembered in a __thread variable,
+ * another GCC extension.
+ */
+
+#include <assert.h>
+#include "hashtable_rcu_private.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <upo/error.h>
+
+
+/** \brief The reader counter of the calling thread, plus one (`0` until assigned). */
+static __thread size_t upo_ht_rcu_thread_slot = 0;
+
+/** \brief The number of threads that have been assigned a reader counter. */
+static size_t upo_ht_rcu_num_readers = 0;
+
+
+upo_ht_rcu_t upo_ht_rcu_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_rcu_t ht = NULL;
+    void* mem = NULL;
+    size_t capacity = 1;
+    size_t p = 0;
+    size_t i = 0;
+
+    /* preconditions */
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
+
+    if (posix_memalign(&mem, UPO_HT_RCU_CACHE_LINE, sizeof(struct upo_ht_rcu_s)) != 0)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the RCU Hash Table");
+    }
+    ht = mem;
+
+    while (capacity < m)
+    {
+        capacity *= 2;
+    }
+    for (p = 0; p < 2; ++p)
+    {
+        for (i = 0; i < UPO_HT_RCU_READER_SLOTS; ++i)
+        {
+            ht->readers[p][i].count = 0;
+        }
+    }
+    ht->epoch = 0;
+    ht->slots = upo_ht_rcu_slots_create(capacity);
+    ht->size = 0;
+    ht->key_hash = key_hash;
+    ht->key_cmp = key_cmp;
+    if (pthread_mutex_init(&ht->write_lock, NULL) != 0)
+    {
+        upo_throw_error("Unable to initialize the lock of the RCU Hash Table");
+    }
+    ht->nodes = upo_mem_pool_create(sizeof(upo_ht_rcu_node_t), 0);
+    ht->retired_nodes = NULL;
+    ht->num_retired = 0;
+    ht->retired_slots = NULL;
+
+    return ht;
+}
+
+void upo_ht_rcu_destroy(upo_ht_rcu_t ht, int destroy_data)
+{
+    if (ht != NULL)
+    {
+        size_t i = 0;
+
+        /* No lookup can be in progress: free everything right away */
+        upo_ht_rcu_write_lock(ht);
+        upo_ht_rcu_reclaim(ht);
+        if (destroy_data)
+        {
+            for (i = 0; i < ht->slots->capacity; ++i)
+            {
+                upo_ht_rcu_node_t* node = NULL;
+
+                for (node = ht->slots->heads[i]; node != NULL; node = node->next)
+                {
+                    free(node->key);
+                    free(node->value);
+                }
+            }
+        }
+        upo_ht_rcu_write_unlock(ht);
+
+        upo_mem_pool_destroy(ht->nodes);
+        free(ht->slots->heads);
+        free(ht->slots);
+        pthread_mutex_destroy(&ht->write_lock);
+        free(ht);
+    }
+}
+
+void upo_ht_rcu_clear(upo_ht_rcu_t ht, int destroy_data)
+{
+    if (ht != NULL)
+    {
+        upo_ht_rcu_slots_t* old_slots = NULL;
+        size_t i = 0;
+
+        upo_ht_rcu_write_lock(ht);
+
+        old_slots = ht->slots;
+        __atomic_store_n(&ht->slots, upo_ht_rcu_slots_create(old_slots->capacity), __ATOMIC_RELEASE);
+        __atomic_store_n(&ht->size, 0, __ATOMIC_RELAXED);
+
+        for (i = 0; i < old_slots->capacity; ++i)
+        {
+            upo_ht_rcu_node_t* node = NULL;
+
+            for (node = old_slots->heads[i]; node != NULL; node = node->next)
+            {
+                upo_ht_rcu_retire(ht, node, destroy_data);
+            }
+        }
+        old_slots->retired_next = ht->retired_slots;
+        ht->retired_slots = old_slots;
+        upo_ht_rcu_reclaim(ht);
+
+        upo_ht_rcu_write_unlock(ht);
+    }
+}
+
+void* upo_ht_rcu_put(upo_ht_rcu_t ht, void* key, void* value)
+{
+    void* old_value = NULL;
+    size_t hash = 0;
+    upo_ht_rcu_node_t* node = NULL;
+
+    /* preconditions */
+    assert( ht != NULL );
+
+    hash = upo_ht_rcu_hash(ht, key);
+
+    upo_ht_rcu_write_lock(ht);
+    node = ht->slots->heads[hash & (ht->slots->capacity - 1)];
+    while (node != NULL && (node->hash != hash || ht->key_cmp(key, node->key) != 0))
+    {
+        node = node->next;
+    }
+    if (node == NULL)
+    {
+        upo_ht_rcu_link(ht, key, value, hash);
+    }
+    else
+    {
+        old_value = node->value;
+        __atomic_store_n(&node->value, value, __ATOMIC_RELEASE);
+    }
+    upo_ht_rcu_write_unlock(ht);
+
+    return old_value;
+}
+
+int upo_ht_rcu_insert(upo_ht_rcu_t ht, void* key, void* value)
+{
+    int inserted = 0;
+    size_t hash = 0;
+    upo_ht_rcu_node_t* node = NULL;
+
+    /* preconditions */
+    assert( ht != NULL );
+
+    hash = upo_ht_rcu_hash(ht, key);
+
+    upo_ht_rcu_write_lock(ht);
+    node = ht->slots->heads[hash & (ht->slots->capacity - 1)];
+    while (node != NULL && (node->hash != hash || ht->key_cmp(key, node->key) != 0))
+    {
+        node = node->next;
+    }
+    if (node == NULL)
+    {
+        upo_ht_rcu_link(ht, key, value, hash);
+        inserted = 1;
+    }
+    upo_ht_rcu_write_unlock(ht);
+
+    return inserted;
+}
+
+void* upo_ht_rcu_get(const upo_ht_rcu_t ht, const void* key)
+{
+    void* value = NULL;
+    size_t hash = 0;
+    upo_ht_rcu_counter_t* counter = NULL;
+    upo_ht_rcu_slots_t* slots = NULL;
+    upo_ht_rcu_node_t* node = NULL;
+
+    /* preconditions */
+    assert( ht != NULL );
+
+    hash = upo_ht_rcu_hash(ht, key);
+
+    counter = upo_ht_rcu_read_lock(ht);
+    slots = __atomic_load_n(&ht->slots, __ATOMIC_ACQUIRE);
+    node = __atomic_load_n(&slots->heads[hash & (slots->capacity - 1)], __ATOMIC_ACQUIRE);
+    while (node != NULL && (node->hash != hash || ht->key_cmp(key, node->key) != 0))
+    {
+        node = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+    }
+    if (node != NULL)
+    {
+        value = __atomic_load_n(&node->value, __ATOMIC_ACQUIRE);
+    }
+    upo_ht_rcu_read_unlock(counter);
+
+    return value;
+}
+
+int upo_ht_rcu_contains(const upo_ht_rcu_t ht, const void* key)
+{
+    return (upo_ht_rcu_get(ht, key) != NULL) ? 1 : 0;
+}
+
+void upo_ht_rcu_delete(upo_ht_rcu_t ht, const void* key, int destroy_data)
+{
+    size_t hash = 0;
+    size_t slot = 0;
+    upo_ht_rcu_node_t* node = NULL;
+    upo_ht_rcu_node_t* prev = NULL;
+
+    /* preconditions */
+    assert( ht != NULL );
+
+    hash = upo_ht_rcu_hash(ht, key);
+
+    upo_ht_rcu_write_lock(ht);
+    slot = hash & (ht->slots->capacity - 1);
+    node = ht->slots->heads[slot];
+    while (node != NULL && (node->hash != hash || ht->key_cmp(key, node->key) != 0))
+    {
+        prev = node;
+        node = node->next;
+    }
+    if (node != NULL)
+    {
+        /* The node keeps its link, so that lookups standing on it can go on */
+        if (prev == NULL)
+        {
+            __atomic_store_n(&ht->slots->heads[slot], node->next, __ATOMIC_RELEASE);
+        }
+        else
+        {
+            __atomic_store_n(&prev->next, node->next, __ATOMIC_RELEASE);
+        }
+        __atomic_store_n(&ht->size, ht->size - 1, __ATOMIC_RELAXED);
+        upo_ht_rcu_retire(ht, node, destroy_data);
+        if (ht->num_retired >= UPO_HT_RCU_RETIRE_BATCH)
+        {
+            upo_ht_rcu_reclaim(ht);
+        }
+    }
+    upo_ht_rcu_write_unlock(ht);
+}
+
+void upo_ht_rcu_synchronize(upo_ht_rcu_t ht)
+{
+    /* preconditions */
+    assert( ht != NULL );
+
+    upo_ht_rcu_write_lock(ht);
+    upo_ht_rcu_reclaim(ht);
+    upo_ht_rcu_write_unlock(ht);
+}
+
+int upo_ht_rcu_is_empty(const upo_ht_rcu_t ht)
+{
+    return upo_ht_rcu_size(ht) == 0 ? 1 : 0;
+}
+
+size_t upo_ht_rcu_capacity(const upo_ht_rcu_t ht)
+{
+    return (ht != NULL) ? __atomic_load_n(&ht->slots, __ATOMIC_ACQUIRE)->capacity : 0;
+}
+
+size_t upo_ht_rcu_size(const upo_ht_rcu_t ht)
+{
+    return (ht != NULL) ? __atomic_load_n(&ht->size, __ATOMIC_RELAXED) : 0;
+}
+
+double upo_ht_rcu_load_factor(const upo_ht_rcu_t ht)
+{
+    return upo_ht_rcu_size(ht) / (double) upo_ht_rcu_capacity(ht);
+}
+
+upo_ht_key_list_t upo_ht_rcu_keys(const upo_ht_rcu_t ht)
+{
+    upo_ht_key_list_t key_list = NULL;
+
+    if (ht != NULL)
+    {
+        upo_ht_rcu_counter_t* counter = NULL;
+        upo_ht_rcu_slots_t* slots = NULL;
+        size_t i = 0;
+
+        counter = upo_ht_rcu_read_lock(ht);
+        slots = __atomic_load_n(&ht->slots, __ATOMIC_ACQUIRE);
+        for (i = 0; i < slots->capacity; ++i)
+        {
+            upo_ht_rcu_node_t* node = NULL;
+
+            for (node = __atomic_load_n(&slots->heads[i], __ATOMIC_ACQUIRE);
+                 node != NULL;
+                 node = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE))
+            {
+                upo_ht_key_list_node_t* key_node = malloc(sizeof(upo_ht_key_list_node_t));
+
+                if (key_node == NULL)
+                {
+                    upo_throw_sys_error("Unable to allocate memory for the list of keys");
+                }
+                key_node->key = node->key;
+                key_node->next = key_list;
+                key_list = key_node;
+            }
+        }
+        upo_ht_rcu_read_unlock(counter);
+    }
+
+    return key_list;
+}
+
+void upo_ht_rcu_traverse(const upo_ht_rcu_t ht, upo_ht_visitor_t visit, void* visit_arg)
+{
+    if (ht != NULL)
+    {
+        upo_ht_rcu_counter_t* counter = NULL;
+        upo_ht_rcu_slots_t* slots = NULL;
+        size_t i = 0;
+
+        counter = upo_ht_rcu_read_lock(ht);
+        slots = __atomic_load_n(&ht->slots, __ATOMIC_ACQUIRE);
+        for (i = 0; i < slots->capacity; ++i)
+        {
+            upo_ht_rcu_node_t* node = NULL;
+
+            for (node = __atomic_load_n(&slots->heads[i], __ATOMIC_ACQUIRE);
+                 node != NULL;
+                 node = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE))
+            {
+                visit(node->key, __atomic_load_n(&node->value, __ATOMIC_ACQUIRE), visit_arg);
+            }
+        }
+        upo_ht_rcu_read_unlock(counter);
+    }
+}
+
+size_t upo_ht_rcu_hash(const upo_ht_rcu_t ht, const void* key)
+{
+    return upo_ht_hash_mix(ht->key_hash(key, UPO_HT_HASH_FULL_RANGE));
+}
+
+upo_ht_rcu_slots_t* upo_ht_rcu_slots_create(size_t capacity)
+{
+    upo_ht_rcu_slots_t* slots = NULL;
+    size_t i = 0;
+
+    slots = malloc(sizeof(upo_ht_rcu_slots_t));
+    if (slots == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for slots of the RCU Hash Table");
+    }
+    slots->heads = malloc(capacity*sizeof(upo_ht_rcu_node_t*));
+    if (slots->heads == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for slots of the RCU Hash Table");
+    }
+    for (i = 0; i < capacity; ++i)
+    {
+        slots->heads[i] = NULL;
+    }
+    slots->capacity = capacity;
+    slots->retired_next = NULL;
+
+    return slots;
+}
+
+size_t upo_ht_rcu_reader_slot(void)
+{
+    if (upo_ht_rcu_thread_slot == 0)
+    {
+        upo_ht_rcu_thread_slot = __atomic_fetch_add(&upo_ht_rcu_num_readers, 1, __ATOMIC_RELAXED) + 1;
+    }
+
+    return (upo_ht_rcu_thread_slot - 1) & (UPO_HT_RCU_READER_SLOTS - 1);
+}
+
+upo_ht_rcu_counter_t* upo_ht_rcu_read_lock(upo_ht_rcu_t ht)
+{
+    size_t slot = upo_ht_rcu_reader_slot();
+    size_t epoch = __atomic_load_n(&ht->epoch, __ATOMIC_SEQ_CST);
+    upo_ht_rcu_counter_t* counter = &ht->readers[epoch & 1][slot];
+
+    /* Even if the epoch advances right now, the grace period in progress
+     * waits for this counter on its second step */
+    __atomic_fetch_add(&counter->count, 1, __ATOMIC_SEQ_CST);
+
+    return counter;
+}
+
+void upo_ht_rcu_read_unlock(upo_ht_rcu_counter_t* counter)
+{
+    __atomic_fetch_sub(&counter->count, 1, __ATOMIC_RELEASE);
+}
+
+void upo_ht_rcu_write_lock(upo_ht_rcu_t ht)
+{
+    if (pthread_mutex_lock(&ht->write_lock) != 0)
+    {
+        upo_throw_error("Unable to lock the RCU Hash Table");
+    }
+}
+
+void upo_ht_rcu_write_unlock(upo_ht_rcu_t ht)
+{
+    if (pthread_mutex_unlock(&ht->write_lock) != 0)
+    {
+        upo_throw_error("Unable to unlock the RCU Hash Table");
+    }
+}
+
+void upo_ht_rcu_reclaim(upo_ht_rcu_t ht)
+{
+    size_t step = 0;
+
+    /* Make the unlinks visible before looking at the reader counters */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    /* A lookup may have read the epoch just before it advances, and then
+     * registered on the counters of the previous epoch: advancing twice and
+     * draining both parities covers every lookup started before this call.
+     * Lookups starting meanwhile use the other parity, so each wait ends. */
+    for (step = 0; step < 2; ++step)
+    {
+        size_t epoch = __atomic_load_n(&ht->epoch, __ATOMIC_RELAXED);
+        size_t i = 0;
+
+        __atomic_store_n(&ht->epoch, epoch + 1, __ATOMIC_SEQ_CST);
+        for (i = 0; i < UPO_HT_RCU_READER_SLOTS; ++i)
+        {
+            while (__atomic_load_n(&ht->readers[epoch & 1][i].count, __ATOMIC_SEQ_CST) != 0)
+            {
+                sched_yield();
+            }
+        }
+    }
+
+    while (ht->retired_nodes != NULL)
+    {
+        upo_ht_rcu_node_t* node = ht->retired_nodes;
+
+        ht->retired_nodes = node->retired_next;
+        if (node->destroy_data)
+        {
+            free(node->key);
+            free(node->value);
+        }
+        upo_mem_pool_free(ht->nodes, node);
+    }
+    ht->num_retired = 0;
+    while (ht->retired_slots != NULL)
+    {
+        upo_ht_rcu_slots_t* slots = ht->retired_slots;
+
+        ht->retired_slots = slots->retired_next;
+        free(slots->heads);
+        free(slots);
+    }
+}
+
+void upo_ht_rcu_retire(upo_ht_rcu_t ht, upo_ht_rcu_node_t* node, int destroy_data)
+{
+    node->destroy_data = destroy_data;
+    node->retired_next = ht->retired_nodes;
+    ht->retired_nodes = node;
+    ht->num_retired += 1;
+}
+
+void upo_ht_rcu_resize(upo_ht_rcu_t ht, size_t n)
+{
+    upo_ht_rcu_slots_t* old_slots = ht->slots;
+    upo_ht_rcu_slots_t* new_slots = NULL;
+    size_t i = 0;
+
+    /* The new array is private until it is published, so it can be filled
+     * with plain stores */
+    new_slots = upo_ht_rcu_slots_create(n);
+    for (i = 0; i < old_slots->capacity; ++i)
+    {
+        upo_ht_rcu_node_t* node = NULL;
+
+        for (node = old_slots->heads[i]; node != NULL; node = node->next)
+        {
+            upo_ht_rcu_node_t* copy = upo_mem_pool_alloc(ht->nodes);
+            size_t slot = node->hash & (n - 1);
+
+            copy->key = node->key;
+            copy->value = node->value;
+            copy->hash = node->hash;
+            copy->next = new_slots->heads[slot];
+            copy->retired_next = NULL;
+            copy->destroy_data = 0;
+            new_slots->heads[slot] = copy;
+
+            upo_ht_rcu_retire(ht, node, 0);
+        }
+    }
+    __atomic_store_n(&ht->slots, new_slots, __ATOMIC_RELEASE);
+
+    old_slots->retired_next = ht->retired_slots;
+    ht->retired_slots = old_slots;
+    upo_ht_rcu_reclaim(ht);
+}
+
+void upo_ht_rcu_link(upo_ht_rcu_t ht, void* key, void* value, size_t hash)
+{
+    upo_ht_rcu_node_t* node = upo_mem_pool_alloc(ht->nodes);
+    size_t slot = hash & (ht->slots->capacity - 1);
+
+    /* Fill in the node before publishing it */
+    node->key = key;
+    node->value = value;
+    node->hash = hash;
+    node->next = ht->slots->heads[slot];
+    node->retired_next = NULL;
+    node->destroy_data = 0;
+    __atomic_store_n(&ht->slots->heads[slot], node, __ATOMIC_RELEASE);
+    __atomic_store_n(&ht->size, ht->size + 1, __ATOMIC_RELAXED);
+
+    if (ht->size > ht->slots->capacity)
+    {
+        upo_ht_rcu_resize(ht, 2*ht->slots->capacity);
+    }
+}
@@ -0,0 +1,197 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/hashtable_rcu_private.h
+ *
+ * \brief Private header for the RCU Hash Table abstract data type.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHTABLE_RCU_PRIVATE_H
+#define UPO_HASHTABLE_RCU_PRIVATE_H
+
+
+#include <pthread.h>
+#include <stddef.h>
+#include <upo/hashtable_rcu.h>
+#include <upo/mem_pool.h>
+
+
+/** \brief The size (in bytes) of a cache line. */
+#define UPO_HT_RCU_CACHE_LINE 64
+
+/**
+ * \brief Number of reader counters per epoch (a power of two).
+ *
+ * Each thread is assigned a counter on its first lookup, round-robin, so that
+ * concurrent readers update different cache lines even when they look up the
+ * same key; threads share counters only beyond this number.
+ */
+#define UPO_HT_RCU_READER_SLOTS 16U
+
+
+/** \brief Type for nodes of the lists of collisions. */
+struct upo_ht_rcu_node_s
+{
+    void* key; /**< Pointer to the user-provided key (never changes). */
+    void* value; /**< Pointer to the value associated to the key (atomically updated). */
+    size_t hash; /**< The mixed hash value of the key. */
+    struct upo_ht_rcu_node_s* next; /**< Pointer to the next node in the list (atomically updated). */
+    struct upo_ht_rcu_node_s* retired_next; /**< Pointer to the next retired node; kept apart from \c next, which lookups may still follow. */
+    int destroy_data; /**< Tells whether key and value must be freed together with the retired node. */
+};
+/** \brief Alias for the type for nodes of the lists of collisions. */
+typedef struct upo_ht_rcu_node_s upo_ht_rcu_node_t;
+
+/** \brief Type for arrays of slots, replaced as a whole by a resize. */
+struct upo_ht_rcu_slots_s
+{
+    size_t capacity; /**< The number of slots (always a power of two). */
+    upo_ht_rcu_node_t** heads; /**< The heads of the lists of collisions. */
+    struct upo_ht_rcu_slots_s* retired_next; /**< Pointer to the next retired array of slots. */
+};
+/** \brief Alias for the type for arrays of slots. */
+typedef struct upo_ht_rcu_slots_s upo_ht_rcu_slots_t;
+
+/** \brief Type for reader counters, each filling a cache line. */
+struct upo_ht_rcu_counter_s
+{
+    size_t count; /**< The number of lookups in progress. */
+    unsigned char pad[UPO_HT_RCU_CACHE_LINE - sizeof(size_t)]; /**< Keeps adjacent counters on different cache lines. */
+};
+/** \brief Alias for the type for reader counters. */
+typedef struct upo_ht_rcu_counter_s upo_ht_rcu_counter_t;
+
+/**
+ * \brief Type for RCU hash tables.
+ *
+ * Tables are allocated on a cache line boundary, so that each reader counter
+ * occupies a cache line of its own.
+ */
+struct upo_ht_rcu_s
+{
+    upo_ht_rcu_counter_t readers[2][UPO_HT_RCU_READER_SLOTS]; /**< The reader counters of even and odd epochs. */
+    size_t epoch; /**< The current epoch (atomically updated). */
+    upo_ht_rcu_slots_t* slots; /**< The current array of slots (atomically updated). */
+    size_t size; /**< The number of stored keys (atomically updated). */
+    upo_ht_hasher_t key_hash; /**< The key hash function. */
+    upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+    pthread_mutex_t write_lock; /**< The lock serializing the updates. */
+    upo_mem_pool_t nodes; /**< The pool the nodes are drawn from (used by writers only). */
+    upo_ht_rcu_node_t* retired_nodes; /**< The nodes waiting for a grace period. */
+    size_t num_retired; /**< The number of nodes waiting for a grace period. */
+    upo_ht_rcu_slots_t* retired_slots; /**< The arrays of slots waiting for a grace period. */
+};
+
+
+/**
+ * \brief Computes the mixed hash value of the given key.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return The mixed hash value.
+ */
+static size_t upo_ht_rcu_hash(const upo_ht_rcu_t ht, const void* key);
+
+/**
+ * \brief Allocates an empty array of slots.
+ *
+ * \param capacity The number of slots.
+ * \return The array of slots.
+ */
+static upo_ht_rcu_slots_t* upo_ht_rcu_slots_create(size_t capacity);
+
+/**
+ * \brief Returns the index of the reader counters of the calling thread.
+ *
+ * \return The index, assigned on the first call of each thread.
+ */
+static size_t upo_ht_rcu_reader_slot(void);
+
+/**
+ * \brief Enters a read-side critical section.
+ *
+ * \param ht The hash table.
+ * \return The counter to pass to upo_ht_rcu_read_unlock().
+ */
+static upo_ht_rcu_counter_t* upo_ht_rcu_read_lock(upo_ht_rcu_t ht);
+
+/**
+ * \brief Leaves a read-side critical section.
+ *
+ * \param counter The counter returned by upo_ht_rcu_read_lock().
+ */
+static void upo_ht_rcu_read_unlock(upo_ht_rcu_counter_t* counter);
+
+/**
+ * \brief Locks the given hash table for updates.
+ *
+ * \param ht The hash table.
+ */
+static void upo_ht_rcu_write_lock(upo_ht_rcu_t ht);
+
+/**
+ * \brief Unlocks the given hash table for updates.
+ *
+ * \param ht The hash table.
+ */
+static void upo_ht_rcu_write_unlock(upo_ht_rcu_t ht);
+
+/**
+ * \brief Waits until all the read-side critical sections in progress have
+ *  completed, then frees the retired memory.
+ *
+ * \param ht The hash table, locked for updates by the caller.
+ */
+static void upo_ht_rcu_reclaim(upo_ht_rcu_t ht);
+
+/**
+ * \brief Retires the given node, which must already be unlinked.
+ *
+ * \param ht The hash table, locked for updates by the caller.
+ * \param node The node.
+ * \param destroy_data Tells whether the key and the value must be freed too.
+ */
+static void upo_ht_rcu_retire(upo_ht_rcu_t ht, upo_ht_rcu_node_t* node, int destroy_data);
+
+/**
+ * \brief Replaces the array of slots with a copy of the given capacity.
+ *
+ * \param ht The hash table, locked for updates by the caller.
+ * \param n The new capacity (a power of two).
+ *
+ * Lookups in progress may be walking the old lists, so nodes are copied
+ * rather than relinked; old nodes and slots are retired.
+ */
+static void upo_ht_rcu_resize(upo_ht_rcu_t ht, size_t n);
+
+/**
+ * \brief Inserts a new node at the head of its list of collisions.
+ *
+ * \param ht The hash table, locked for updates by the caller.
+ * \param key The key.
+ * \param value The value.
+ * \param hash The mixed hash value of the key.
+ */
+static void upo_ht_rcu_link(upo_ht_rcu_t ht, void* key, void* value, size_t hash);
+
+
+#endif /* UPO_HASHTABLE_RCU_PRIVATE_H */
@@ -0,0 +1,367 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* mmap() and the other file primitives are POSIX extensions */
+#define _POSIX_C_SOURCE 200112L
+
+#include <assert.h>
+#include <fcntl.h>
+#include "hashtable_snapshot_private.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+
+
+int upo_ht_linprob_save(const upo_ht_linprob_t ht, const char* path, upo_ht_hasher_t key_hash, upo_ht_sizer_t key_size, upo_ht_sizer_t value_size)
+{
+    upo_ht_snapshot_header_t header;
+    upo_ht_cursor_t cursor;
+    uint64_t* slots = NULL;
+    upo_ht_snapshot_writer_t writer;
+    char* tmp_path = NULL;
+    void* key = NULL;
+    void* value = NULL;
+    size_t n = 0;
+    size_t m = UPO_HT_SNAPSHOT_MIN_CAPACITY;
+    size_t offset = 0;
+    int ok = 0;
+
+    /* preconditions */
+    assert( ht != NULL );
+    assert( path != NULL );
+    assert( key_hash != NULL );
+    assert( key_size != NULL );
+    assert( value_size != NULL );
+
+    n = upo_ht_linprob_size(ht);
+    /* Keep the load factor at most 1/2, as lookups never pay for a resize */
+    while (m < 2*n)
+    {
+        m *= 2;
+    }
+    slots = calloc(m, sizeof(uint64_t));
+    tmp_path = malloc(strlen(path) + sizeof ".tmp");
+    writer.buffer = malloc(UPO_HT_SNAPSHOT_BUFFER_SIZE);
+    if (slots == NULL || tmp_path == NULL || writer.buffer == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the Hash Table snapshot");
+    }
+
+    /* Lay the records out and place their offsets, before writing anything */
+    offset = sizeof header + m*sizeof(uint64_t);
+    upo_ht_cursor_reset(&cursor);
+    while (upo_ht_linprob_cursor_next(ht, &cursor, &key, &value))
+    {
+        size_t i = key_hash(key, m) & (m - 1);
+
+        while (slots[i] != 0)
+        {
+            i = (i + 1) & (m - 1);
+        }
+        slots[i] = offset;
+        offset += sizeof(upo_ht_snapshot_record_t)
+                  + upo_ht_snapshot_pad(key_size(key))
+                  + upo_ht_snapshot_pad(value != NULL ? value_size(value) : 0);
+    }
+
+    memset(&header, 0, sizeof header);
+    memcpy(header.magic, UPO_HT_SNAPSHOT_MAGIC, sizeof header.magic);
+    header.byte_order = UPO_HT_SNAPSHOT_BYTE_ORDER;
+    header.size = n;
+    header.capacity = m;
+    header.slots_offset = sizeof header;
+    header.data_offset = sizeof header + m*sizeof(uint64_t);
+    header.file_size = offset;
+
+    /*
+     * Write to a temporary file and then rename it, so that the file at the
+     * given path is always a complete snapshot (processes that have mapped the
+     * old file keep using it).
+     */
+    strcpy(tmp_path, path);
+    strcat(tmp_path, ".tmp");
+    writer.fp = fopen(tmp_path, "wb");
+    if (writer.fp != NULL)
+    {
+        writer.length = 0;
+        writer.ok = 1;
+        upo_ht_snapshot_write(&writer, &header, sizeof header);
+        upo_ht_snapshot_flush(&writer);
+        writer.ok = writer.ok && fwrite(slots, sizeof(uint64_t), m, writer.fp) == m;
+
+        /* The cursor visits the pairs in the same order as above */
+        upo_ht_cursor_reset(&cursor);
+        while (writer.ok && upo_ht_linprob_cursor_next(ht, &cursor, &key, &value))
+        {
+            upo_ht_snapshot_record_t record;
+
+            record.key_size = key_size(key);
+            record.value_size = (value != NULL) ? value_size(value) : 0;
+            upo_ht_snapshot_write(&writer, &record, sizeof record);
+            upo_ht_snapshot_write(&writer, key, record.key_size);
+            upo_ht_snapshot_write(&writer, value, record.value_size);
+        }
+        upo_ht_snapshot_flush(&writer);
+
+        ok = writer.ok;
+        if (fclose(writer.fp) != 0)
+        {
+            ok = 0;
+        }
+        if (ok)
+        {
+            ok = rename(tmp_path, path) == 0;
+        }
+        if (!ok)
+        {
+            remove(tmp_path);
+        }
+    }
+
+    free(writer.buffer);
+    free(tmp_path);
+    free(slots);
+
+    return ok;
+}
+
+upo_ht_snapshot_t upo_ht_snapshot_open(const char* path, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_snapshot_t snap = NULL;
+    const upo_ht_snapshot_header_t* header = NULL;
+    struct stat st;
+    void* base = NULL;
+    size_t length = 0;
+    int fd = -1;
+    int valid = 0;
+
+    /* preconditions */
+    assert( path != NULL );
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    if (fstat(fd, &st) != 0
+        || st.st_size < (off_t) sizeof(upo_ht_snapshot_header_t)
+        || (uintmax_t) st.st_size > (uintmax_t) SIZE_MAX)
+    {
+        close(fd);
+        return NULL;
+    }
+    length = (size_t) st.st_size;
+    base = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+    /* The mapping keeps the file open */
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    header = base;
+    valid = memcmp(header->magic, UPO_HT_SNAPSHOT_MAGIC, sizeof header->magic) == 0
+            && header->byte_order == UPO_HT_SNAPSHOT_BYTE_ORDER
+            && header->file_size == length
+            && header->slots_offset == sizeof(upo_ht_snapshot_header_t)
+            && header->capacity >= UPO_HT_SNAPSHOT_MIN_CAPACITY
+            && (header->capacity & (header->capacity - 1)) == 0
+            && header->capacity <= (length - header->slots_offset)/sizeof(uint64_t)
+            && header->data_offset == header->slots_offset + header->capacity*sizeof(uint64_t)
+            && header->size <= header->capacity/2;
+    if (!valid)
+    {
+        munmap(base, length);
+        return NULL;
+    }
+
+    snap = malloc(sizeof(struct upo_ht_snapshot_s));
+    if (snap == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the Hash Table snapshot");
+    }
+    snap->base = base;
+    snap->length = length;
+    snap->slots = (const uint64_t*) (snap->base + header->slots_offset);
+    snap->capacity = (size_t) header->capacity;
+    snap->size = (size_t) header->size;
+    snap->data_offset = (size_t) header->data_offset;
+    snap->key_hash = key_hash;
+    snap->key_cmp = key_cmp;
+
+    return snap;
+}
+
+void upo_ht_snapshot_close(upo_ht_snapshot_t snap)
+{
+    if (snap != NULL)
+    {
+        munmap(snap->base, snap->length);
+        free(snap);
+    }
+}
+
+const void* upo_ht_snapshot_get(const upo_ht_snapshot_t snap, const void* key)
+{
+    if (snap == NULL)
+    {
+        return NULL;
+    }
+
+    return upo_ht_snapshot_find(snap, key);
+}
+
+int upo_ht_snapshot_contains(const upo_ht_snapshot_t snap, const void* key)
+{
+    return upo_ht_snapshot_get(snap, key) != NULL ? 1 : 0;
+}
+
+size_t upo_ht_snapshot_size(const upo_ht_snapshot_t snap)
+{
+    return (snap != NULL) ? snap->size : 0;
+}
+
+size_t upo_ht_snapshot_capacity(const upo_ht_snapshot_t snap)
+{
+    return (snap != NULL) ? snap->capacity : 0;
+}
+
+void upo_ht_snapshot_traverse(const upo_ht_snapshot_t snap, upo_ht_visitor_t visit, void* visit_arg)
+{
+    if (snap != NULL)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < snap->capacity; ++i)
+        {
+            unsigned char* key = NULL;
+            unsigned char* value = NULL;
+
+            if (snap->slots[i] != 0 && upo_ht_snapshot_record(snap, snap->slots[i], &key, &value))
+            {
+                visit(key, value, visit_arg);
+            }
+        }
+    }
+}
+
+size_t upo_ht_snapshot_pad(size_t n)
+{
+    return (n + UPO_HT_SNAPSHOT_ALIGNMENT - 1) & ~((size_t) UPO_HT_SNAPSHOT_ALIGNMENT - 1);
+}
+
+int upo_ht_snapshot_record(const upo_ht_snapshot_t snap, uint64_t offset, unsigned char** key, unsigned char** value)
+{
+    const upo_ht_snapshot_record_t* record = NULL;
+    size_t avail = 0;
+
+    if (offset < snap->data_offset
+        || offset % UPO_HT_SNAPSHOT_ALIGNMENT != 0
+        || offset > snap->length - sizeof(upo_ht_snapshot_record_t))
+    {
+        return 0;
+    }
+    record = (const upo_ht_snapshot_record_t*) (snap->base + offset);
+    avail = snap->length - (size_t) offset - sizeof(upo_ht_snapshot_record_t);
+    if (record->key_size > avail
+        || upo_ht_snapshot_pad(record->key_size) > avail
+        || record->value_size > avail - upo_ht_snapshot_pad(record->key_size))
+    {
+        return 0;
+    }
+
+    *key = snap->base + offset + sizeof(upo_ht_snapshot_record_t);
+    *value = *key + upo_ht_snapshot_pad(record->key_size);
+
+    return 1;
+}
+
+unsigned char* upo_ht_snapshot_find(const upo_ht_snapshot_t snap, const void* key)
+{
+    size_t mask = snap->capacity - 1;
+    size_t i = snap->key_hash(key, snap->capacity) & mask;
+    size_t probes = 0;
+
+    /* The probe count is bounded as well, in case the file is corrupt */
+    for (probes = 0; probes < snap->capacity && snap->slots[i] != 0; ++probes)
+    {
+        unsigned char* skey = NULL;
+        unsigned char* svalue = NULL;
+
+        if (!upo_ht_snapshot_record(snap, snap->slots[i], &skey, &svalue))
+        {
+            return NULL;
+        }
+        if (snap->key_cmp(key, skey) == 0)
+        {
+            return svalue;
+        }
+        i = (i + 1) & mask;
+    }
+
+    return NULL;
+}
+
+void upo_ht_snapshot_write(upo_ht_snapshot_writer_t* writer, const void* p, size_t n)
+{
+    size_t padded = upo_ht_snapshot_pad(n);
+
+    if (writer->length + padded > UPO_HT_SNAPSHOT_BUFFER_SIZE)
+    {
+        upo_ht_snapshot_flush(writer);
+    }
+    if (padded > UPO_HT_SNAPSHOT_BUFFER_SIZE)
+    {
+        /* Too large to be buffered: write it (and its padding) at once */
+        static const unsigned char zeros[UPO_HT_SNAPSHOT_ALIGNMENT] = {0};
+
+        if (writer->ok)
+        {
+            writer->ok = fwrite(p, 1, n, writer->fp) == n
+                         && fwrite(zeros, 1, padded - n, writer->fp) == padded - n;
+        }
+        return;
+    }
+    if (n > 0)
+    {
+        memcpy(writer->buffer + writer->length, p, n);
+    }
+    memset(writer->buffer + writer->length + n, 0, padded - n);
+    writer->length += padded;
+}
+
+void upo_ht_snapshot_flush(upo_ht_snapshot_writer_t* writer)
+{
+    if (writer->ok && writer->length > 0)
+    {
+        writer->ok = fwrite(writer->buffer, 1, writer->length, writer->fp) == writer->length;
+    }
+    writer->length = 0;
+}
@@ -0,0 +1,156 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/hashtable_snapshot_private.h
+ *
+ * \brief Private header for hash table snapshots.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHTABLE_SNAPSHOT_PRIVATE_H
+#define UPO_HASHTABLE_SNAPSHOT_PRIVATE_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <upo/hashtable.h>
+#include <upo/hashtable_snapshot.h>
+
+
+/** \brief The magic number opening snapshot files (the version is its last character). */
+#define UPO_HT_SNAPSHOT_MAGIC "UPOHTSN1"
+
+/** \brief The byte-order mark, whose bytes tell the byte order of the platform that saved a snapshot. */
+#define UPO_HT_SNAPSHOT_BYTE_ORDER UINT64_C(0x0102030405060708)
+
+/** \brief The minimum number of slots of a snapshot. */
+#define UPO_HT_SNAPSHOT_MIN_CAPACITY 16U
+
+/** \brief The alignment (in bytes) of records, keys and values. */
+#define UPO_HT_SNAPSHOT_ALIGNMENT 8U
+
+/** \brief The size of the buffer where records are gathered before being written. */
+#define UPO_HT_SNAPSHOT_BUFFER_SIZE 65536U
+
+
+/** \brief Type for the header of snapshot files. */
+struct upo_ht_snapshot_header_s
+{
+    char magic[8]; /**< The magic number (#UPO_HT_SNAPSHOT_MAGIC, without the terminating null character). */
+    uint64_t byte_order; /**< The byte-order mark (#UPO_HT_SNAPSHOT_BYTE_ORDER). */
+    uint64_t size; /**< The number of keys. */
+    uint64_t capacity; /**< The number of slots (a power of two). */
+    uint64_t slots_offset; /**< The offset of the slots. */
+    uint64_t data_offset; /**< The offset of the first record. */
+    uint64_t file_size; /**< The size of the file. */
+    uint64_t reserved; /**< Reserved for future use (always `0`). */
+};
+/** \brief Alias for the type for the header of snapshot files. */
+typedef struct upo_ht_snapshot_header_s upo_ht_snapshot_header_t;
+
+/** \brief Type for the header of records, followed by the bytes of the key and of the value. */
+struct upo_ht_snapshot_record_s
+{
+    uint64_t key_size; /**< The size of the key, before padding. */
+    uint64_t value_size; /**< The size of the value, before padding. */
+};
+/** \brief Alias for the type for the header of records. */
+typedef struct upo_ht_snapshot_record_s upo_ht_snapshot_record_t;
+
+/** \brief Type for buffers gathering small writes into large ones. */
+struct upo_ht_snapshot_writer_s
+{
+    FILE* fp; /**< The file. */
+    unsigned char* buffer; /**< The buffered bytes. */
+    size_t length; /**< The number of buffered bytes. */
+    int ok; /**< Tells whether no write has failed so far. */
+};
+/** \brief Alias for the type for buffers of writes. */
+typedef struct upo_ht_snapshot_writer_s upo_ht_snapshot_writer_t;
+
+/** \brief Type for opened snapshots. */
+struct upo_ht_snapshot_s
+{
+    unsigned char* base; /**< The address where the file is mapped. */
+    size_t length; /**< The size of the file. */
+    const uint64_t* slots; /**< The slots, inside the mapped file. */
+    size_t capacity; /**< The number of slots (a power of two). */
+    size_t size; /**< The number of keys. */
+    size_t data_offset; /**< The offset of the first record. */
+    upo_ht_hasher_t key_hash; /**< The key hash function. */
+    upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+};
+
+
+/**
+ * \brief Rounds the given size up to a multiple of #UPO_HT_SNAPSHOT_ALIGNMENT.
+ *
+ * \param n The size.
+ * \return The padded size.
+ */
+static size_t upo_ht_snapshot_pad(size_t n);
+
+/**
+ * \brief Locates the key and the value of the record at the given offset.
+ *
+ * \param snap The snapshot.
+ * \param offset The offset of the record, as read from a slot.
+ * \param key Where the address of the key is stored.
+ * \param value Where the address of the value is stored.
+ * \return `1` on success, or `0` if the record does not lie within the file
+ *  (i.e., the file is corrupt).
+ *
+ * Slots are not trusted, so that a corrupt file cannot make lookups read
+ * outside the mapping.
+ */
+static int upo_ht_snapshot_record(const upo_ht_snapshot_t snap, uint64_t offset, unsigned char** key, unsigned char** value);
+
+/**
+ * \brief Finds the record of the given key.
+ *
+ * \param snap The snapshot.
+ * \param key The key.
+ * \return The address of the value of the key, or `NULL` if the key is not
+ *  found.
+ */
+static unsigned char* upo_ht_snapshot_find(const upo_ht_snapshot_t snap, const void* key);
+
+/**
+ * \brief Appends the given bytes, followed by the padding up to the alignment.
+ *
+ * \param writer The buffer of writes.
+ * \param p The bytes.
+ * \param n The number of bytes.
+ *
+ * Each call to `fwrite()` costs about as much as writing a record, hence
+ * records are gathered and written a buffer at a time.
+ */
+static void upo_ht_snapshot_write(upo_ht_snapshot_writer_t* writer, const void* p, size_t n);
+
+/**
+ * \brief Writes the buffered bytes.
+ *
+ * \param writer The buffer of writes.
+ */
+static void upo_ht_snapshot_flush(upo_ht_snapshot_writer_t* writer);
+
+#endif /* UPO_HASHTABLE_SNAPSHOT_PRIVATE_H */
@@ -0,0 +1,173 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include "mem_pool_private.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <upo/error.h>
+
+
+upo_mem_pool_t upo_mem_pool_create(size_t obj_size, size_t objs_per_slab)
+{
+    upo_mem_pool_t pool = NULL;
+    size_t align = sizeof(upo_mem_pool_align_t);
+
+    /* preconditions */
+    assert( obj_size > 0 );
+
+    pool = malloc(sizeof(struct upo_mem_pool_s));
+    if (pool == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the Memory Pool");
+    }
+
+    /* A released object must be able to hold the link of the free list, and
+     * every object must be aligned as upo_mem_pool_align_t */
+    if (obj_size < sizeof(upo_mem_pool_free_obj_t))
+    {
+        obj_size = sizeof(upo_mem_pool_free_obj_t);
+    }
+    pool->obj_size = ((obj_size + align - 1)/align)*align;
+    pool->objs_per_slab = (objs_per_slab > 0) ? objs_per_slab : UPO_MEM_POOL_DEFAULT_OBJS_PER_SLAB;
+    pool->first_objs_per_slab = pool->objs_per_slab;
+    pool->slabs = NULL;
+    pool->bump = NULL;
+    pool->bump_end = NULL;
+    pool->free_list = NULL;
+    pool->size = 0;
+    pool->footprint = 0;
+
+    return pool;
+}
+
+void upo_mem_pool_destroy(upo_mem_pool_t pool)
+{
+    if (pool != NULL)
+    {
+        upo_mem_pool_clear(pool);
+        free(pool);
+    }
+}
+
+void upo_mem_pool_clear(upo_mem_pool_t pool)
+{
+    if (pool != NULL)
+    {
+        while (pool->slabs != NULL)
+        {
+            upo_mem_pool_slab_t* slab = pool->slabs;
+
+            pool->slabs = slab->next;
+            free(slab);
+        }
+        /* Slabs grow again from the first size, as in a new pool */
+        pool->objs_per_slab = pool->first_objs_per_slab;
+        pool->bump = NULL;
+        pool->bump_end = NULL;
+        pool->free_list = NULL;
+        pool->size = 0;
+        pool->footprint = 0;
+    }
+}
+
+void* upo_mem_pool_alloc(upo_mem_pool_t pool)
+{
+    void* obj = NULL;
+
+    /* preconditions */
+    assert( pool != NULL );
+
+    if (pool->free_list != NULL)
+    {
+        obj = pool->free_list;
+        pool->free_list = pool->free_list->next;
+    }
+    else
+    {
+        if (pool->bump == pool->bump_end)
+        {
+            upo_mem_pool_add_slab(pool);
+        }
+        obj = pool->bump;
+        pool->bump += pool->obj_size;
+    }
+    pool->size += 1;
+
+    return obj;
+}
+
+void upo_mem_pool_free(upo_mem_pool_t pool, void* obj)
+{
+    /* preconditions */
+    assert( pool != NULL );
+
+    if (obj != NULL)
+    {
+        upo_mem_pool_free_obj_t* free_obj = obj;
+
+        assert( pool->size > 0 );
+
+        free_obj->next = pool->free_list;
+        pool->free_list = free_obj;
+        pool->size -= 1;
+    }
+}
+
+size_t upo_mem_pool_size(const upo_mem_pool_t pool)
+{
+    return (pool != NULL) ? pool->size : 0;
+}
+
+size_t upo_mem_pool_footprint(const upo_mem_pool_t pool)
+{
+    return (pool != NULL) ? pool->footprint + sizeof(struct upo_mem_pool_s) : 0;
+}
+
+void upo_mem_pool_add_slab(upo_mem_pool_t pool)
+{
+    size_t header_size = offsetof(upo_mem_pool_slab_t, align);
+    size_t slab_size = header_size + pool->objs_per_slab*pool->obj_size;
+    upo_mem_pool_slab_t* slab = NULL;
+
+    slab = malloc(slab_size);
+    if (slab == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for a slab of the Memory Pool");
+    }
+
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->bump = (unsigned char*) slab + header_size;
+    pool->bump_end = pool->bump + pool->objs_per_slab*pool->obj_size;
+    pool->footprint += slab_size;
+
+    /* Geometric growth keeps the number of slabs logarithmic in the number
+     * of objects, up to a maximum slab size */
+    if (pool->objs_per_slab < UPO_MEM_POOL_MAX_OBJS_PER_SLAB)
+    {
+        pool->objs_per_slab *= 2;
+        if (pool->objs_per_slab > UPO_MEM_POOL_MAX_OBJS_PER_SLAB)
+        {
+            pool->objs_per_slab = UPO_MEM_POOL_MAX_OBJS_PER_SLAB;
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/mem_pool_private.h
+ *
+ * \brief Private header for the Memory Pool abstract data type.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_MEM_POOL_PRIVATE_H
+#define UPO_MEM_POOL_PRIVATE_H
+
+
+#include <stddef.h>
+#include <upo/mem_pool.h>
+
+
+/**
+ * \brief Type with the strictest alignment requirement among `long`, `double`
+ *  and pointers, used to align slabs and objects.
+ *
+ * `long double` is left out on purpose: on common platforms it would double
+ * the alignment, and so the padding of small objects.
+ */
+union upo_mem_pool_align_u
+{
+    long l; /**< Alignment of integers. */
+    double d; /**< Alignment of floating-point numbers. */
+    void* p; /**< Alignment of object pointers. */
+    void (*f)(void); /**< Alignment of function pointers. */
+};
+/** \brief Alias for the alignment type. */
+typedef union upo_mem_pool_align_u upo_mem_pool_align_t;
+
+/** \brief Type for slab headers; the objects of a slab follow its header. */
+struct upo_mem_pool_slab_s
+{
+    struct upo_mem_pool_slab_s* next; /**< Pointer to the previously allocated slab. */
+    upo_mem_pool_align_t align; /**< Forces the objects to start at an aligned address. */
+};
+/** \brief Alias for the type for slab headers. */
+typedef struct upo_mem_pool_slab_s upo_mem_pool_slab_t;
+
+/** \brief Type for released objects, linked in the free list. */
+struct upo_mem_pool_free_obj_s
+{
+    struct upo_mem_pool_free_obj_s* next; /**< Pointer to the next released object. */
+};
+/** \brief Alias for the type for released objects. */
+typedef struct upo_mem_pool_free_obj_s upo_mem_pool_free_obj_t;
+
+/** \brief Defines a memory pool. */
+struct upo_mem_pool_s
+{
+    size_t obj_size; /**< The size of objects, rounded up to the alignment. */
+    size_t objs_per_slab; /**< The number of objects of the next slab to allocate. */
+    size_t first_objs_per_slab; /**< The number of objects of the first slab. */
+    upo_mem_pool_slab_t* slabs; /**< The list of slabs, most recent first. */
+    unsigned char* bump; /**< The first never-used object of the current slab. */
+    unsigned char* bump_end; /**< The end of the current slab. */
+    upo_mem_pool_free_obj_t* free_list; /**< The list of released objects. */
+    size_t size; /**< The number of objects currently handed out. */
+    size_t footprint; /**< The number of bytes allocated for slabs. */
+};
+
+
+/**
+ * \brief Allocates a new slab and makes it the current one.
+ *
+ * \param pool The memory pool.
+ */
+static void upo_mem_pool_add_slab(upo_mem_pool_t pool);
+
+
+#endif /* UPO_MEM_POOL_PRIVATE_H */
@@ -0,0 +1,550 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <limits.h>
+#include "mph_private.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+
+
+/*** BEGIN of MINIMAL PERFECT HASH FUNCTIONS ***/
+
+
+upo_mph_t upo_mph_build(void* const* keys, size_t n, upo_ht_hasher_t key_hash)
+{
+    upo_mph_t mph = NULL;
+    size_t* hashes = NULL;
+    size_t* xs = NULL;
+    size_t* order = NULL;
+    size_t* owners = NULL;
+    unsigned char* taken = NULL;
+    size_t attempt = 0;
+    size_t i = 0;
+    int ok = 0;
+
+    /* preconditions */
+    assert( keys != NULL || n == 0 );
+    assert( key_hash != NULL );
+
+    mph = malloc(sizeof(struct upo_mph_s));
+    if (mph == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the Minimal Perfect Hash Function");
+    }
+    mph->n = n;
+    mph->m = n + n/UPO_MPH_SLACK;
+    mph->num_buckets = (n > UPO_MPH_BUCKET_SIZE) ? (n + UPO_MPH_BUCKET_SIZE - 1)/UPO_MPH_BUCKET_SIZE : 1;
+    mph->num_dense_buckets = mph->num_buckets*UPO_MPH_DENSE_BUCKETS/100;
+    if (mph->num_dense_buckets == 0)
+    {
+        mph->num_dense_buckets = 1;
+    }
+    mph->seed = 0;
+    mph->key_hash = key_hash;
+    mph->pilots = calloc(mph->num_buckets, 1);
+    mph->remap = calloc(mph->m - n + 1, sizeof(size_t));
+    if (mph->pilots == NULL || mph->remap == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the Minimal Perfect Hash Function");
+    }
+    if (n == 0)
+    {
+        return mph;
+    }
+
+    hashes = malloc(n*sizeof(size_t));
+    xs = malloc(n*sizeof(size_t));
+    order = malloc(n*sizeof(size_t));
+    owners = malloc(mph->m*sizeof(size_t));
+    taken = malloc((mph->m + CHAR_BIT - 1)/CHAR_BIT);
+    if (hashes == NULL || xs == NULL || order == NULL || owners == NULL || taken == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for building the Minimal Perfect Hash Function");
+    }
+
+    /* The keys are hashed once, whatever the number of seeds tried */
+    for (i = 0; i < n; ++i)
+    {
+        hashes[i] = key_hash(keys[i], UPO_HT_HASH_FULL_RANGE);
+    }
+    for (attempt = 0; attempt < UPO_MPH_MAX_SEEDS && !ok; ++attempt)
+    {
+        mph->seed = upo_ht_hash_mix(attempt + 1);
+        ok = upo_mph_search(mph, hashes, xs, order, owners, taken);
+    }
+
+    free(taken);
+    free(owners);
+    free(order);
+    free(xs);
+    free(hashes);
+
+    if (!ok)
+    {
+        upo_mph_destroy(mph);
+        return NULL;
+    }
+
+    return mph;
+}
+
+void upo_mph_destroy(upo_mph_t mph)
+{
+    if (mph != NULL)
+    {
+        free(mph->remap);
+        free(mph->pilots);
+        free(mph);
+    }
+}
+
+size_t upo_mph_lookup(const upo_mph_t mph, const void* key)
+{
+    size_t x = 0;
+    size_t p = 0;
+
+    /* preconditions */
+    assert( mph != NULL );
+
+    if (mph->n == 0)
+    {
+        return 0;
+    }
+
+    x = upo_mph_mix(mph, mph->key_hash(key, UPO_HT_HASH_FULL_RANGE));
+    p = upo_mph_position(mph, x, upo_ht_hash_mix(mph->pilots[upo_mph_bucket(mph, x)]));
+
+    return (p < mph->n) ? p : mph->remap[p - mph->n];
+}
+
+size_t upo_mph_size(const upo_mph_t mph)
+{
+    return (mph != NULL) ? mph->n : 0;
+}
+
+size_t upo_mph_memory_usage(const upo_mph_t mph)
+{
+    if (mph == NULL)
+    {
+        return 0;
+    }
+
+    return sizeof(struct upo_mph_s)
+           + mph->num_buckets
+           + (mph->m - mph->n + 1)*sizeof(size_t);
+}
+
+size_t upo_mph_mix(const upo_mph_t mph, size_t hash)
+{
+    return upo_ht_hash_mix(hash ^ mph->seed);
+}
+
+size_t upo_mph_bucket(const upo_mph_t mph, size_t x)
+{
+    size_t num_sparse_buckets = mph->num_buckets - mph->num_dense_buckets;
+
+    /* The lowest bits choose the part, the highest ones the bucket within it */
+    if ((x & 0xFFFFU) < UPO_MPH_DENSE_KEYS*0x10000U/100 || num_sparse_buckets == 0)
+    {
+        return upo_ht_reduce_fastrange(x, mph->num_dense_buckets);
+    }
+
+    return mph->num_dense_buckets + upo_ht_reduce_fastrange(x, num_sparse_buckets);
+}
+
+size_t upo_mph_position(const upo_mph_t mph, size_t x, size_t pilot_hash)
+{
+    /* Mixing after the xor makes the positions of different pilots unrelated
+     * (otherwise, if m is a power of two, they would only be permuted) */
+    return upo_ht_reduce_fastrange(upo_ht_hash_mix(x ^ pilot_hash), mph->m);
+}
+
+int upo_mph_search(upo_mph_t mph, const size_t* hashes, size_t* xs, size_t* order, size_t* owners, unsigned char* taken)
+{
+    size_t nb = mph->num_buckets;
+    size_t* starts = NULL;
+    size_t* buckets = NULL;
+    size_t* stack = NULL;
+    size_t* positions = NULL;
+    size_t pilot_hashes[UPO_MPH_MAX_PILOT + 1];
+    size_t recent[UPO_MPH_RECENT];
+    size_t num_recent = 0;
+    size_t next_recent = 0;
+    size_t evictions = 0;
+    size_t max_size = 0;
+    size_t next_free = 0;
+    size_t i = 0;
+    size_t j = 0;
+    int ok = 1;
+
+    starts = calloc(nb + 1, sizeof(size_t));
+    buckets = malloc(nb*sizeof(size_t));
+    stack = malloc(nb*sizeof(size_t));
+    if (starts == NULL || buckets == NULL || stack == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for building the Minimal Perfect Hash Function");
+    }
+
+    /* Group the keys by bucket, by counting sort */
+    for (i = 0; i < mph->n; ++i)
+    {
+        xs[i] = upo_mph_mix(mph, hashes[i]);
+        starts[upo_mph_bucket(mph, xs[i]) + 1] += 1;
+    }
+    for (i = 0; i < nb; ++i)
+    {
+        if (starts[i+1] > max_size)
+        {
+            max_size = starts[i+1];
+        }
+        starts[i+1] += starts[i];
+    }
+    for (i = 0; i < mph->n; ++i)
+    {
+        order[starts[upo_mph_bucket(mph, xs[i])]++] = i;
+    }
+    /* Each start has moved to the next bucket: shift them back */
+    for (i = nb; i > 0; --i)
+    {
+        starts[i] = starts[i-1];
+    }
+    starts[0] = 0;
+
+    /* Sort the buckets by decreasing size, by counting sort again */
+    positions = calloc(max_size + 2, sizeof(size_t));
+    if (positions == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for building the Minimal Perfect Hash Function");
+    }
+    for (i = 0; i < nb; ++i)
+    {
+        positions[max_size - (starts[i+1] - starts[i]) + 1] += 1;
+    }
+    for (i = 0; i <= max_size; ++i)
+    {
+        positions[i+1] += positions[i];
+    }
+    for (i = 0; i < nb; ++i)
+    {
+        buckets[positions[max_size - (starts[i+1] - starts[i])]++] = i;
+    }
+
+    for (i = 0; i <= UPO_MPH_MAX_PILOT; ++i)
+    {
+        pilot_hashes[i] = upo_ht_hash_mix(i);
+    }
+    for (i = 0; i < mph->m; ++i)
+    {
+        owners[i] = UPO_MPH_NO_OWNER;
+    }
+    memset(taken, 0, (mph->m + CHAR_BIT - 1)/CHAR_BIT);
+    for (i = 0; i < nb && ok; ++i)
+    {
+        size_t top = 0;
+
+        if (starts[buckets[i]+1] == starts[buckets[i]])
+        {
+            /* Buckets are sorted by size: the others are empty too */
+            break;
+        }
+
+        stack[top++] = buckets[i];
+        while (top > 0 && ok)
+        {
+            size_t b = stack[--top];
+            size_t size = starts[b+1] - starts[b];
+            const size_t* bucket_keys = order + starts[b];
+            size_t best_pilot = UPO_MPH_MAX_PILOT + 1;
+            size_t best_cost = (size_t) -1;
+            size_t eviction_pilot = UPO_MPH_MAX_PILOT + 1;
+            size_t pilot = 0;
+            size_t k = 0;
+
+            /* Take the first pilot whose positions are all free */
+            for (pilot = 0; pilot <= UPO_MPH_MAX_PILOT && best_pilot > UPO_MPH_MAX_PILOT; ++pilot)
+            {
+                for (j = 0; j < size; ++j)
+                {
+                    positions[j] = upo_mph_position(mph, xs[bucket_keys[j]], pilot_hashes[pilot]);
+                    if (UPO_MPH_BIT_TEST(taken, positions[j]))
+                    {
+                        break;
+                    }
+                    for (k = 0; k < j && positions[k] != positions[j]; ++k)
+                    {
+                    }
+                    if (k < j)
+                    {
+                        break;
+                    }
+                }
+                if (j == size)
+                {
+                    best_pilot = pilot;
+                }
+            }
+
+            /*
+             * Otherwise, take the pilot whose positions are owned by the fewest
+             * (and smallest) buckets, and evict them.
+             * Recently placed buckets are never evicted, to avoid cycles.
+             */
+            for (pilot = 0; pilot <= UPO_MPH_MAX_PILOT && best_pilot > UPO_MPH_MAX_PILOT; ++pilot)
+            {
+                size_t cost = 0;
+
+                for (j = 0; j < size && cost < best_cost; ++j)
+                {
+                    size_t owner = 0;
+
+                    positions[j] = upo_mph_position(mph, xs[bucket_keys[j]], pilot_hashes[pilot]);
+                    for (k = 0; k < j && positions[k] != positions[j]; ++k)
+                    {
+                    }
+                    owner = owners[positions[j]];
+                    if (k < j)
+                    {
+                        cost = (size_t) -1;
+                    }
+                    else if (owner != UPO_MPH_NO_OWNER)
+                    {
+                        size_t r = 0;
+
+                        for (r = 0; r < num_recent && recent[r] != owner; ++r)
+                        {
+                        }
+                        if (r < num_recent)
+                        {
+                            cost = (size_t) -1;
+                        }
+                        else
+                        {
+                            size_t owner_size = starts[owner+1] - starts[owner];
+
+                            cost += owner_size*owner_size;
+                        }
+                    }
+                }
+                if (cost < best_cost)
+                {
+                    best_cost = cost;
+                    eviction_pilot = pilot;
+                }
+            }
+            if (best_pilot > UPO_MPH_MAX_PILOT)
+            {
+                best_pilot = eviction_pilot;
+            }
+            if (best_pilot > UPO_MPH_MAX_PILOT || evictions > UPO_MPH_MAX_EVICTIONS*mph->n)
+            {
+                ok = 0;
+                break;
+            }
+
+            for (j = 0; j < size; ++j)
+            {
+                size_t p = upo_mph_position(mph, xs[bucket_keys[j]], pilot_hashes[best_pilot]);
+                size_t owner = owners[p];
+
+                if (owner != UPO_MPH_NO_OWNER)
+                {
+                    /* Free all the positions of the evicted bucket */
+                    for (k = starts[owner]; k < starts[owner+1]; ++k)
+                    {
+                        size_t q = upo_mph_position(mph, xs[order[k]], pilot_hashes[mph->pilots[owner]]);
+
+                        owners[q] = UPO_MPH_NO_OWNER;
+                        UPO_MPH_BIT_CLEAR(taken, q);
+                    }
+                    stack[top++] = owner;
+                    ++evictions;
+                }
+                owners[p] = b;
+                UPO_MPH_BIT_SET(taken, p);
+            }
+            mph->pilots[b] = (unsigned char) best_pilot;
+            recent[next_recent] = b;
+            next_recent = (next_recent + 1) % UPO_MPH_RECENT;
+            if (num_recent < UPO_MPH_RECENT)
+            {
+                ++num_recent;
+            }
+        }
+    }
+
+    /* Move the keys beyond the first n positions to the free ones */
+    for (i = mph->n; i < mph->m && ok; ++i)
+    {
+        if (owners[i] != UPO_MPH_NO_OWNER)
+        {
+            while (owners[next_free] != UPO_MPH_NO_OWNER)
+            {
+                ++next_free;
+            }
+            mph->remap[i - mph->n] = next_free++;
+        }
+    }
+
+    free(positions);
+    free(stack);
+    free(buckets);
+    free(starts);
+
+    return ok;
+}
+
+/*** END of MINIMAL PERFECT HASH FUNCTIONS ***/
+
+
+/*** BEGIN of STATIC HASH TABLES ***/
+
+
+upo_mph_table_t upo_mph_table_build(void* const* keys, void* const* values, size_t n, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_mph_table_t table = NULL;
+    upo_mph_t mph = NULL;
+    size_t i = 0;
+
+    /* preconditions */
+    assert( keys != NULL || n == 0 );
+    assert( values != NULL || n == 0 );
+    assert( key_cmp != NULL );
+
+    mph = upo_mph_build(keys, n, key_hash);
+    if (mph == NULL)
+    {
+        return NULL;
+    }
+
+    table = malloc(sizeof(struct upo_mph_table_s));
+    /* One more entry, so that lookups in an empty table need no test */
+    if (table != NULL)
+    {
+        table->entries = malloc((n + 1)*sizeof(upo_mph_table_entry_t));
+    }
+    if (table == NULL || table->entries == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the Static Hash Table");
+    }
+    table->mph = mph;
+    table->key_cmp = key_cmp;
+    table->entries[0].key = NULL;
+    table->entries[0].value = NULL;
+    for (i = 0; i < n; ++i)
+    {
+        size_t p = upo_mph_lookup(mph, keys[i]);
+
+        table->entries[p].key = keys[i];
+        table->entries[p].value = values[i];
+    }
+
+    return table;
+}
+
+void upo_mph_table_destroy(upo_mph_table_t table, int destroy_data)
+{
+    if (table != NULL)
+    {
+        if (destroy_data)
+        {
+            size_t i = 0;
+
+            for (i = 0; i < table->mph->n; ++i)
+            {
+                free(table->entries[i].key);
+                free(table->entries[i].value);
+            }
+        }
+        upo_mph_destroy(table->mph);
+        free(table->entries);
+        free(table);
+    }
+}
+
+void* upo_mph_table_get(const upo_mph_table_t table, const void* key)
+{
+    const upo_mph_table_entry_t* entry = NULL;
+
+    if (table == NULL)
+    {
+        return NULL;
+    }
+
+    entry = &table->entries[upo_mph_lookup(table->mph, key)];
+    if (entry->key == NULL || table->key_cmp(key, entry->key) != 0)
+    {
+        return NULL;
+    }
+
+    return entry->value;
+}
+
+int upo_mph_table_contains(const upo_mph_table_t table, const void* key)
+{
+    const upo_mph_table_entry_t* entry = NULL;
+
+    if (table == NULL)
+    {
+        return 0;
+    }
+
+    entry = &table->entries[upo_mph_lookup(table->mph, key)];
+
+    return (entry->key != NULL && table->key_cmp(key, entry->key) == 0) ? 1 : 0;
+}
+
+size_t upo_mph_table_size(const upo_mph_table_t table)
+{
+    return (table != NULL) ? table->mph->n : 0;
+}
+
+size_t upo_mph_table_memory_usage(const upo_mph_table_t table)
+{
+    if (table == NULL)
+    {
+        return 0;
+    }
+
+    return sizeof(struct upo_mph_table_s)
+           + (table->mph->n + 1)*sizeof(upo_mph_table_entry_t)
+           + upo_mph_memory_usage(table->mph);
+}
+
+void upo_mph_table_traverse(const upo_mph_table_t table, upo_ht_visitor_t visit, void* visit_arg)
+{
+    if (table != NULL)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < table->mph->n; ++i)
+        {
+            visit(table->entries[i].key, table->entries[i].value, visit_arg);
+        }
+    }
+}
+
+
+/*** END of STATIC HASH TABLES ***/
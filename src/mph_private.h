@@ -0,0 +1,154 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/mph_private.h
+ *
+ * \brief Private header for minimal perfect hash functions and static hash
+ *  tables.
+ *
+ * \author Your Name
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_MPH_PRIVATE_H
+#define UPO_MPH_PRIVATE_H
+
+
+#include <limits.h>
+#include <stddef.h>
+#include <upo/hashtable.h>
+#include <upo/mph.h>
+
+
+/** \brief The number of keys for each spare position (i.e., positions range over `n + n/UPO_MPH_SLACK` slots). */
+#define UPO_MPH_SLACK 100U
+
+/** \brief The percentage of keys hashed to the dense part of the buckets. */
+#define UPO_MPH_DENSE_KEYS 60U
+
+/** \brief The percentage of buckets in the dense part. */
+#define UPO_MPH_DENSE_BUCKETS 30U
+
+/** \brief The largest pilot (pilots are stored in a byte). */
+#define UPO_MPH_MAX_PILOT 0xFFU
+
+/** \brief The number of recently placed buckets that cannot be evicted. */
+#define UPO_MPH_RECENT 16U
+
+/** \brief The number of evictions per key after which a seed is given up. */
+#define UPO_MPH_MAX_EVICTIONS 64U
+
+/** \brief Tells whether the bit of the given position is set in the given bitmap. */
+#define UPO_MPH_BIT_TEST(bits, i) (((bits)[(i)/CHAR_BIT] >> ((i) % CHAR_BIT)) & 1U)
+
+/** \brief Sets the bit of the given position in the given bitmap. */
+#define UPO_MPH_BIT_SET(bits, i) ((bits)[(i)/CHAR_BIT] |= (unsigned char) (1U << ((i) % CHAR_BIT)))
+
+/** \brief Clears the bit of the given position in the given bitmap. */
+#define UPO_MPH_BIT_CLEAR(bits, i) ((bits)[(i)/CHAR_BIT] &= (unsigned char) ~(1U << ((i) % CHAR_BIT)))
+
+/** \brief Marks a free position. */
+#define UPO_MPH_NO_OWNER ((size_t) -1)
+
+/** \brief The number of seeds tried before giving up. */
+#define UPO_MPH_MAX_SEEDS 16U
+
+
+/** \brief Type for minimal perfect hash functions. */
+struct upo_mph_s
+{
+    size_t n; /**< The number of keys. */
+    size_t m; /**< The number of positions (at least \c n). */
+    size_t num_buckets; /**< The number of buckets. */
+    size_t num_dense_buckets; /**< The number of buckets that the (more numerous) keys of the dense part are hashed to. */
+    size_t seed; /**< The seed mixed with the hash values of keys. */
+    unsigned char* pilots; /**< The pilot of each bucket. */
+    size_t* remap; /**< The free position below \c n of each position from \c n to \c m-1. */
+    upo_ht_hasher_t key_hash; /**< The key hash function. */
+};
+
+/** \brief Type for the slots of static hash tables. */
+struct upo_mph_table_entry_s
+{
+    void* key; /**< The key. */
+    void* value; /**< The value associated to the key. */
+};
+/** \brief Alias for the type for the slots of static hash tables. */
+typedef struct upo_mph_table_entry_s upo_mph_table_entry_t;
+
+/** \brief Type for static hash tables. */
+struct upo_mph_table_s
+{
+    upo_mph_t mph; /**< The minimal perfect hash function of the keys. */
+    upo_mph_table_entry_t* entries; /**< The pairs, each at the position of its key. */
+    upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+};
+
+
+/**
+ * \brief Mixes the hash value of a key with the seed of a function.
+ *
+ * \param mph The minimal perfect hash function.
+ * \param hash The hash value of the key.
+ * \return The mixed value, from which the bucket and the positions of the
+ *  key are computed.
+ */
+static size_t upo_mph_mix(const upo_mph_t mph, size_t hash);
+
+/**
+ * \brief Returns the bucket of a key.
+ *
+ * \param mph The minimal perfect hash function.
+ * \param x The mixed hash value of the key.
+ * \return The bucket.
+ *
+ * Most keys go to the first buckets (the *dense* part), so that there are
+ * many large buckets, placed while most positions are free, and many small
+ * ones, placed last.
+ */
+static size_t upo_mph_bucket(const upo_mph_t mph, size_t x);
+
+/**
+ * \brief Returns the position of a key, before remapping.
+ *
+ * \param mph The minimal perfect hash function.
+ * \param x The mixed hash value of the key.
+ * \param pilot_hash The hash value of the pilot of the bucket of the key.
+ * \return The position, in \f$\{0,\ldots,m-1\}\f$.
+ */
+static size_t upo_mph_position(const upo_mph_t mph, size_t x, size_t pilot_hash);
+
+/**
+ * \brief Searches the pilots of all buckets, with the current seed.
+ *
+ * \param mph The minimal perfect hash function, whose seed is set.
+ * \param hashes The hash values of the keys.
+ * \param xs A scratch array of \c n words.
+ * \param order A scratch array of \c n words.
+ * \param owners A scratch array of \c m words, holding the bucket owning each
+ *  position.
+ * \param taken A scratch bitmap of \c m bits, telling the owned positions (it
+ *  is small enough to stay in cache, unlike \c owners, which is only read
+ *  when buckets have to be evicted).
+ * \return `1` on success, or `0` if the buckets could not be placed.
+ */
+static int upo_mph_search(upo_mph_t mph, const size_t* hashes, size_t* xs, size_t* order, size_t* owners, unsigned char* taken);
+
+
+#endif /* UPO_MPH_PRIVATE_H */
@@ -13,6 +13,7 @@ upo_queue_t upo_queue_create()
     queue->front = NULL;
     queue->back = NULL;
     queue->size = 0;
+    queue->nodes = upo_mem_pool_create(sizeof(struct upo_queue_node_s), 0);
 
     return queue;
 }
@@ -22,6 +23,7 @@ void upo_queue_destroy(upo_queue_t queue, int destroy_data)
     if (queue != NULL)
     {
         upo_queue_clear(queue, destroy_data);
+        upo_mem_pool_destroy(queue->nodes);
         free(queue);
     }
 }
@@ -30,10 +32,18 @@ void upo_queue_clear(upo_queue_t queue, int destroy_data)
 {
     if (queue != NULL)
     {
-        while(queue->front != NULL)
+        /* Nodes are given back all at once by clearing their pool */
+        if (destroy_data)
         {
-            upo_queue_dequeue(queue, destroy_data);
+            upo_queue_node_t* node = NULL;
+
+            for (node = queue->front; node != NULL; node = node->prev)
+                free(node->data);
         }
+        upo_mem_pool_clear(queue->nodes);
+        queue->front = NULL;
+        queue->back = NULL;
+        queue->size = 0;
     }
 }
 
@@ -42,12 +52,7 @@ void upo_queue_enqueue(upo_queue_t queue, void *data)
     upo_queue_node_t* newNode;
     if (queue != NULL)
     {
-        newNode = malloc(sizeof(struct upo_queue_node_s));
-        if (newNode == NULL)
-        {
-            fprintf(stderr, "Unable to create a new node!\n");
-            abort();
-        }
+        newNode = upo_mem_pool_alloc(queue->nodes);
         newNode->data = data;
         newNode->prev = NULL;
         if (queue->front == NULL)
@@ -76,7 +81,7 @@ void upo_queue_dequeue(upo_queue_t queue, int destroy_data)
             queue->front->next = NULL;
         if (destroy_data)
             free(node->data);
-        free(node);
+        upo_mem_pool_free(queue->nodes, node);
         queue->size -= 1;
     }
 }
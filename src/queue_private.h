@@ -2,6 +2,7 @@
 #define UPO_QUEUE_PRIVATE_H
 
 #include <stddef.h>
+#include <upo/mem_pool.h>
 #include <upo/queue.h>
 
 struct upo_queue_node_s {
@@ -16,6 +17,7 @@ struct upo_queue_s {
     upo_queue_node_t* front;
     upo_queue_node_t* back;
     size_t size;
+    upo_mem_pool_t nodes;
 };
 
 #endif /* UPO_QUEUE_PRIVATE_H */
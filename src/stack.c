@@ -35,6 +35,7 @@ upo_stack_t upo_stack_create()
 
     stack->top = NULL;
     stack->size = 0;
+    stack->nodes = upo_mem_pool_create(sizeof(struct upo_stack_node_s), 0);
 
     return stack;
 }
@@ -44,6 +45,7 @@ void upo_stack_destroy(upo_stack_t stack, int destroy_data)
     if (stack != NULL)
     {
         upo_stack_clear(stack, destroy_data);
+        upo_mem_pool_destroy(stack->nodes);
         free(stack);
     }
 }
@@ -53,12 +55,7 @@ void upo_stack_push(upo_stack_t stack, void* data)
     upo_stack_node_t* newNode;
     if (stack != NULL)
     {
-        newNode = malloc(sizeof(struct upo_stack_node_s));
-        if (newNode == NULL)
-        {
-            fprintf(stderr, "Unable to push the element!\n");
-            abort();
-        }
+        newNode = upo_mem_pool_alloc(stack->nodes);
         newNode->data = data;
         newNode->next = stack->top;
         stack->top = newNode;
@@ -74,7 +71,7 @@ void upo_stack_pop(upo_stack_t stack, int destroy_data)
         stack->top = stack->top->next;
         if (destroy_data)
             free(node->data);
-        free(node);
+        upo_mem_pool_free(stack->nodes, node);
         stack->size -= 1;
     }
 }
@@ -112,8 +109,16 @@ void upo_stack_clear(upo_stack_t stack, int destroy_data)
      */
     if (stack != NULL) 
     {
-        while (stack->top != NULL) {
-            upo_stack_pop(stack, destroy_data);
+        /* Nodes are given back all at once by clearing their pool */
+        if (destroy_data)
+        {
+            upo_stack_node_t* node = NULL;
+
+            for (node = stack->top; node != NULL; node = node->next)
+                free(node->data);
         }
+        upo_mem_pool_clear(stack->nodes);
+        stack->top = NULL;
+        stack->size = 0;
     }
 }
@@ -36,6 +36,7 @@
 
 
 #include <stddef.h>
+#include <upo/mem_pool.h>
 #include <upo/stack.h>
 
 
@@ -53,6 +54,7 @@ struct upo_stack_s
 {
     upo_stack_node_t* top; /**< The front of the list. */
     size_t size; /**< The size of the list. This field allows to guarantee a constant complexity for the `size` operation. */
+    upo_mem_pool_t nodes; /**< The pool the nodes of the list are drawn from. */
 };
 
 
@@ -0,0 +1 @@
+test_targets += test_mem_pool
@@ -50,6 +50,10 @@ static void test_height();
 static void test_traversal();
 static void test_null();
 static void test_rank();
+static void test_balanced();
+static void test_select_count_range();
+static void test_cursor();
+static void test_deep();
 
 int int_compare(const void* a, const void* b)
 {
@@ -1051,6 +1055,366 @@ void test_rank()
     upo_bst_destroy(bst, 0);
 }
 
+void test_balanced()
+{
+    int* keys = NULL;
+    size_t n = 100000;
+    size_t i;
+    int zero = 0;
+    int key = 0;
+    upo_bst_t bst;
+    upo_bst_key_list_t key_list = NULL;
+
+    keys = malloc(n*sizeof(int));
+    assert( keys != NULL );
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = 2*(int)i;
+    }
+
+    bst = upo_bst_create_balanced(int_compare, UPO_BST_AVL);
+
+    assert( bst != NULL );
+    assert( upo_bst_height(bst) == 0 );
+
+    /* Sorted insertions would make an unbalanced tree a list */
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_bst_put(bst, &keys[i], &keys[i]) == NULL );
+    }
+    assert( upo_bst_size(bst) == n );
+    /* An AVL tree with 100000 nodes is at most 24 edges high */
+    assert( upo_bst_height(bst) <= 24 );
+    assert( upo_bst_is_bst(bst, &keys[0], &keys[n-1]) );
+
+    /* A replaced value is returned */
+    assert( upo_bst_put(bst, &keys[7], &zero) == &keys[7] );
+    assert( upo_bst_get(bst, &keys[7]) == &zero );
+    upo_bst_insert(bst, &keys[7], &keys[7]);
+    assert( upo_bst_get(bst, &keys[7]) == &zero );
+
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_bst_contains(bst, &keys[i]) );
+    }
+
+    /* Deletions, including of nodes with two children, keep the balance */
+    for (i = 0; i < n; i += 3)
+    {
+        upo_bst_delete(bst, &keys[i], 0);
+    }
+    assert( upo_bst_size(bst) == n - (n+2)/3 );
+    assert( upo_bst_height(bst) <= 24 );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_bst_contains(bst, &keys[i]) == (i % 3 != 0) );
+    }
+    assert( upo_bst_is_bst(bst, &keys[0], &keys[n-1]) );
+
+    /* The extra operations are not affected by rotations */
+    key = 2*3000;
+    assert( *((int*) upo_bst_floor(bst, &key)) == 2*2999 );
+    assert( *((int*) upo_bst_ceiling(bst, &key)) == 2*3001 );
+    key = 2*3000 + 1;
+    assert( *((int*) upo_bst_floor(bst, &key)) == 2*2999 );
+    assert( *((int*) upo_bst_ceiling(bst, &key)) == 2*3001 );
+    assert( upo_bst_rank(bst, &key, int_compare) == 2000 );
+    assert( *((int*) upo_bst_min(bst)) == 2 );
+    assert( *((int*) upo_bst_max(bst)) == 2*(int)(n-2) );
+
+    key = 2*3006;
+    key_list = upo_bst_keys_range(bst, &keys[3000], &key);
+    for (i = 0; key_list != NULL; ++i)
+    {
+        upo_bst_key_list_t old_list = key_list;
+        key_list = key_list->next;
+        free(old_list);
+    }
+    assert( i == 4 );
+
+    upo_bst_delete_min(bst, 0);
+    upo_bst_delete_max(bst, 0);
+    assert( *((int*) upo_bst_min(bst)) == 4 );
+    assert( *((int*) upo_bst_max(bst)) == 2*(int)(n-3) );
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_bst_delete(bst, &keys[i], 0);
+    }
+    assert( upo_bst_is_empty(bst) );
+    assert( upo_bst_height(bst) == 0 );
+
+    upo_bst_destroy(bst, 0);
+    free(keys);
+}
+
+void test_select_count_range()
+{
+    int keys[] = {8,3,1,6,4,7,10,14,13};
+    int sorted[] = {1,3,4,6,7,8,10,13,14};
+    int balances[] = {UPO_BST_UNBALANCED, UPO_BST_AVL};
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t b;
+    size_t i;
+    int lo = 0;
+    int hi = 0;
+    upo_bst_t bst;
+
+    for (b = 0; b < 2; ++b)
+    {
+        bst = upo_bst_create_balanced(int_compare, balances[b]);
+
+        assert( upo_bst_select(bst, 0) == NULL );
+        assert( upo_bst_count_range(bst, &keys[0], &keys[1]) == 0 );
+
+        for (i = 0; i < n; ++i)
+        {
+            upo_bst_put(bst, &keys[i], &keys[i]);
+            assert( upo_bst_size(bst) == i+1 );
+        }
+        /* Duplicates do not change sizes */
+        upo_bst_put(bst, &keys[4], &keys[4]);
+        upo_bst_insert(bst, &keys[5], &keys[5]);
+        assert( upo_bst_size(bst) == n );
+
+        for (i = 0; i < n; ++i)
+        {
+            int* key = upo_bst_select(bst, i);
+
+            assert( key != NULL && *key == sorted[i] );
+            assert( upo_bst_rank(bst, key, int_compare) == i );
+        }
+        assert( upo_bst_select(bst, n) == NULL );
+
+        /* Bounds need not be in the tree */
+        lo = 2; hi = 9;
+        assert( upo_bst_count_range(bst, &lo, &hi) == 5 );
+        lo = 3; hi = 13;
+        assert( upo_bst_count_range(bst, &lo, &hi) == 7 );
+        lo = 0; hi = 100;
+        assert( upo_bst_count_range(bst, &lo, &hi) == n );
+        lo = 11; hi = 12;
+        assert( upo_bst_count_range(bst, &lo, &hi) == 0 );
+        lo = 7; hi = 7;
+        assert( upo_bst_count_range(bst, &lo, &hi) == 1 );
+        lo = 10; hi = 3;
+        assert( upo_bst_count_range(bst, &lo, &hi) == 0 );
+
+        /* Sizes follow deletions, of nodes with two children too */
+        upo_bst_delete(bst, &keys[0], 0);
+        upo_bst_delete(bst, &keys[1], 0);
+        upo_bst_delete_min(bst, 0);
+        assert( upo_bst_size(bst) == n-3 );
+        assert( *((int*) upo_bst_select(bst, 0)) == 4 );
+        assert( *((int*) upo_bst_select(bst, 2)) == 7 );
+        assert( *((int*) upo_bst_select(bst, n-4)) == 14 );
+        lo = 0; hi = 100;
+        assert( upo_bst_count_range(bst, &lo, &hi) == n-3 );
+
+        upo_bst_clear(bst, 0);
+        assert( upo_bst_size(bst) == 0 );
+
+        upo_bst_destroy(bst, 0);
+    }
+
+    assert( upo_bst_select(NULL, 0) == NULL );
+    assert( upo_bst_count_range(NULL, &lo, &hi) == 0 );
+}
+
+void test_cursor()
+{
+    int keys[] = {8,3,1,6,4,7,10,14,13};
+    int sorted[] = {1,3,4,6,7,8,10,13,14};
+    int balances[] = {UPO_BST_UNBALANCED, UPO_BST_AVL};
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t m = 1000;
+    int* many = NULL;
+    size_t b;
+    size_t i;
+    int k = 0;
+    int* key = NULL;
+    int* value = NULL;
+    upo_bst_cursor_t cursor;
+    upo_bst_key_list_t key_list = NULL;
+    upo_bst_t bst;
+
+    for (b = 0; b < 2; ++b)
+    {
+        bst = upo_bst_create_balanced(int_compare, balances[b]);
+
+        upo_bst_cursor_reset(bst, &cursor);
+        assert( !upo_bst_cursor_next(bst, &cursor, NULL, NULL) );
+        assert( !upo_bst_cursor_prev(bst, &cursor, NULL, NULL) );
+
+        for (i = 0; i < n; ++i)
+        {
+            upo_bst_put(bst, &keys[i], &keys[i]);
+        }
+
+        /* Forward, then backward from the end */
+        upo_bst_cursor_reset(bst, &cursor);
+        assert( !upo_bst_cursor_prev(bst, &cursor, NULL, NULL) );
+        for (i = 0; i < n; ++i)
+        {
+            assert( upo_bst_cursor_next(bst, &cursor, (void**) &key, (void**) &value) );
+            assert( *key == sorted[i] && value == key );
+        }
+        assert( !upo_bst_cursor_next(bst, &cursor, (void**) &key, NULL) );
+        upo_bst_cursor_reset_end(bst, &cursor);
+        for (i = n; i > 0; --i)
+        {
+            assert( upo_bst_cursor_prev(bst, &cursor, (void**) &key, NULL) );
+            assert( *key == sorted[i-1] );
+        }
+        assert( !upo_bst_cursor_prev(bst, &cursor, (void**) &key, NULL) );
+        assert( upo_bst_cursor_next(bst, &cursor, (void**) &key, NULL) && *key == 1 );
+
+        /* Seeking a present key, then an absent one */
+        k = 6;
+        assert( upo_bst_cursor_seek(bst, &cursor, &k) );
+        assert( upo_bst_cursor_next(bst, &cursor, (void**) &key, NULL) && *key == 6 );
+        assert( upo_bst_cursor_next(bst, &cursor, (void**) &key, NULL) && *key == 7 );
+        assert( upo_bst_cursor_prev(bst, &cursor, (void**) &key, NULL) && *key == 7 );
+        assert( upo_bst_cursor_prev(bst, &cursor, (void**) &key, NULL) && *key == 6 );
+        assert( upo_bst_cursor_prev(bst, &cursor, (void**) &key, NULL) && *key == 4 );
+        k = 11;
+        assert( upo_bst_cursor_seek(bst, &cursor, &k) );
+        assert( upo_bst_cursor_prev(bst, &cursor, (void**) &key, NULL) && *key == 10 );
+        assert( upo_bst_cursor_next(bst, &cursor, (void**) &key, NULL) && *key == 10 );
+        assert( upo_bst_cursor_next(bst, &cursor, (void**) &key, NULL) && *key == 13 );
+        k = 0;
+        assert( upo_bst_cursor_seek(bst, &cursor, &k) );
+        assert( !upo_bst_cursor_prev(bst, &cursor, NULL, NULL) );
+        k = 15;
+        assert( !upo_bst_cursor_seek(bst, &cursor, &k) );
+        assert( !upo_bst_cursor_next(bst, &cursor, NULL, NULL) );
+        assert( upo_bst_cursor_prev(bst, &cursor, (void**) &key, NULL) && *key == 14 );
+
+        upo_bst_destroy(bst, 0);
+    }
+
+    /* Sorted keys make a list deeper than the path kept by cursors */
+    many = malloc(m*sizeof(int));
+    assert( many != NULL );
+    for (b = 0; b < 2; ++b)
+    {
+        bst = upo_bst_create_balanced(int_compare, balances[b]);
+        for (i = 0; i < m; ++i)
+        {
+            many[i] = (int) i;
+            upo_bst_put(bst, &many[i], &many[i]);
+        }
+
+        upo_bst_cursor_reset(bst, &cursor);
+        for (i = 0; i < m; ++i)
+        {
+            assert( upo_bst_cursor_next(bst, &cursor, (void**) &key, NULL) && *key == (int) i );
+        }
+        assert( !upo_bst_cursor_next(bst, &cursor, NULL, NULL) );
+        for (i = m; i > 0; --i)
+        {
+            assert( upo_bst_cursor_prev(bst, &cursor, (void**) &key, NULL) && *key == (int) i-1 );
+        }
+        assert( !upo_bst_cursor_prev(bst, &cursor, NULL, NULL) );
+        k = 500;
+        assert( upo_bst_cursor_seek(bst, &cursor, &k) );
+        assert( upo_bst_cursor_prev(bst, &cursor, (void**) &key, NULL) && *key == 499 );
+
+        /* Range queries visit only the keys in the range */
+        k = 990;
+        key_list = upo_bst_keys_range(bst, &many[10], &k);
+        for (i = 990; key_list != NULL; --i)
+        {
+            upo_bst_key_list_node_t* node = key_list;
+
+            assert( *((int*) node->key) == (int) i );
+            key_list = node->next;
+            free(node);
+        }
+        assert( i == 9 );
+
+        upo_bst_destroy(bst, 0);
+    }
+    free(many);
+
+    upo_bst_cursor_reset(NULL, &cursor);
+    assert( !upo_bst_cursor_next(NULL, &cursor, NULL, NULL) );
+    assert( !upo_bst_cursor_seek(NULL, &cursor, &k) );
+    assert( upo_bst_keys_range(NULL, &k, &k) == NULL );
+}
+
+void test_deep()
+{
+    size_t n = 5000;
+    size_t i;
+    int k = 0;
+    int* key = NULL;
+    int* prev = NULL;
+    upo_bst_key_list_t key_list = NULL;
+    upo_bst_t bst;
+
+    /* Sorted keys make a path as deep as the tree is large: nothing may
+     * recurse along it */
+    bst = upo_bst_create(int_compare);
+    for (i = 0; i < n; ++i)
+    {
+        key = malloc(sizeof(int));
+        assert( key != NULL );
+        *key = (int) (2*i);
+        upo_bst_put(bst, key, NULL);
+    }
+    assert( upo_bst_height(bst) == n-1 );
+    assert( upo_bst_size(bst) == n );
+
+    k = (int) (2*n - 2);
+    assert( upo_bst_contains(bst, &k) );
+    k = (int) (2*n - 3);
+    assert( !upo_bst_contains(bst, &k) );
+    assert( *((int*) upo_bst_floor(bst, &k)) == k-1 );
+    assert( *((int*) upo_bst_ceiling(bst, &k)) == k+1 );
+    assert( *((int*) upo_bst_max(bst)) == (int) (2*n - 2) );
+    k = -1;
+    assert( upo_bst_is_bst(bst, &k, upo_bst_max(bst)) );
+
+    key_list = upo_bst_keys(bst);
+    for (i = n; key_list != NULL; --i)
+    {
+        upo_bst_key_list_node_t* node = key_list;
+
+        assert( *((int*) node->key) == (int) (2*i - 2) );
+        key_list = node->next;
+        free(node);
+    }
+    assert( i == 0 );
+
+    /* Deleting from the bottom, from the middle and from the top */
+    upo_bst_delete_max(bst, 1);
+    k = (int) n;
+    upo_bst_delete(bst, &k, 1);
+    upo_bst_delete_min(bst, 1);
+    assert( upo_bst_size(bst) == n-3 );
+    assert( upo_bst_height(bst) == n-4 );
+    assert( !upo_bst_contains(bst, &k) );
+    k = (int) n + 2;
+    assert( upo_bst_contains(bst, &k) );
+    key_list = upo_bst_keys(bst);
+    for (i = 0; key_list != NULL; ++i)
+    {
+        upo_bst_key_list_node_t* node = key_list;
+
+        assert( prev == NULL || *((int*) node->key) < *prev );
+        prev = node->key;
+        key_list = node->next;
+        free(node);
+    }
+    assert( i == n-3 );
+
+    upo_bst_clear(bst, 1);
+    assert( upo_bst_is_empty(bst) );
+
+    upo_bst_destroy(bst, 1);
+}
+
 int main()
 {
     printf("Test case 'create/destroy'... ");
@@ -1103,5 +1467,25 @@ int main()
     test_rank();
     printf("OK\n");
 
+    printf("Test case 'balanced'... ");
+    fflush(stdout);
+    test_balanced();
+    printf("OK\n");
+
+    printf("Test case 'select/count range'... ");
+    fflush(stdout);
+    test_select_count_range();
+    printf("OK\n");
+
+    printf("Test case 'cursor'... ");
+    fflush(stdout);
+    test_cursor();
+    printf("OK\n");
+
+    printf("Test case 'deep'... ");
+    fflush(stdout);
+    test_deep();
+    printf("OK\n");
+
     return 0;
 }
@@ -0,0 +1,445 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <upo/btree.h>
+
+
+#define NUM_KEYS 20000
+
+
+static int int_compare(const void* a, const void* b);
+static int* new_int(int i);
+static void check_visit(void* key, void* value, void* state);
+
+static void test_create_destroy();
+static void test_put_get_delete();
+static void test_ordered();
+static void test_rank_select();
+static void test_random();
+static void test_destroy_data();
+static void test_null();
+
+
+int int_compare(const void* a, const void* b)
+{
+    const int* aa = a;
+    const int* bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+int* new_int(int i)
+{
+    int* p = malloc(sizeof(int));
+
+    assert( p != NULL );
+    *p = i;
+
+    return p;
+}
+
+void check_visit(void* key, void* value, void* state)
+{
+    int* expected = state;
+
+    assert( *((int*) key) == *expected );
+    assert( value == key );
+
+    /* Keys are even */
+    *expected += 2;
+}
+
+void test_create_destroy()
+{
+    upo_btree_t tree;
+
+    tree = upo_btree_create(int_compare);
+
+    assert( tree != NULL );
+    assert( upo_btree_is_empty(tree) );
+    assert( upo_btree_size(tree) == 0 );
+    assert( upo_btree_height(tree) == 0 );
+    assert( upo_btree_get_comparator(tree) == int_compare );
+
+    upo_btree_destroy(tree, 0);
+}
+
+void test_put_get_delete()
+{
+    int keys[NUM_KEYS];
+    int values[NUM_KEYS];
+    int k = 0;
+    size_t i;
+    upo_btree_t tree;
+
+    tree = upo_btree_create(int_compare);
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        keys[i] = (int) i;
+        values[i] = (int) i;
+        assert( upo_btree_put(tree, &keys[i], &values[i]) == NULL );
+        assert( upo_btree_size(tree) == i+1 );
+    }
+    /* Sorted insertions do not make the tree deeper than random ones */
+    assert( upo_btree_height(tree) <= 3 );
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        assert( upo_btree_get(tree, &keys[i]) == &values[i] );
+        assert( upo_btree_contains(tree, &keys[i]) );
+    }
+    k = NUM_KEYS;
+    assert( upo_btree_get(tree, &k) == NULL );
+    assert( !upo_btree_contains(tree, &k) );
+
+    /* Duplicates */
+    k = 10;
+    assert( upo_btree_put(tree, &k, &values[11]) == &values[10] );
+    assert( upo_btree_get(tree, &keys[10]) == &values[11] );
+    upo_btree_insert(tree, &k, &values[12]);
+    assert( upo_btree_get(tree, &keys[10]) == &values[11] );
+    assert( upo_btree_size(tree) == NUM_KEYS );
+
+    /* Deleting every other key, then the rest */
+    for (i = 0; i < NUM_KEYS; i += 2)
+    {
+        upo_btree_delete(tree, &keys[i], 0);
+        assert( !upo_btree_contains(tree, &keys[i]) );
+    }
+    k = -1;
+    upo_btree_delete(tree, &k, 0);
+    assert( upo_btree_size(tree) == NUM_KEYS/2 );
+    for (i = 1; i < NUM_KEYS; i += 2)
+    {
+        assert( upo_btree_get(tree, &keys[i]) == &values[i] );
+    }
+    for (i = 1; i < NUM_KEYS; i += 2)
+    {
+        upo_btree_delete(tree, &keys[i], 0);
+        assert( upo_btree_size(tree) == NUM_KEYS/2 - i/2 - 1 );
+    }
+    assert( upo_btree_is_empty(tree) );
+    assert( upo_btree_height(tree) == 0 );
+    assert( upo_btree_get(tree, &keys[1]) == NULL );
+
+    /* The tree can be filled again */
+    for (i = 0; i < 100; ++i)
+    {
+        upo_btree_put(tree, &keys[i], &values[i]);
+    }
+    assert( upo_btree_size(tree) == 100 );
+
+    upo_btree_destroy(tree, 0);
+}
+
+void test_ordered()
+{
+    int keys[NUM_KEYS];
+    int k = 0;
+    int lo = 0;
+    int hi = 0;
+    size_t i;
+    upo_bst_key_list_t key_list = NULL;
+    upo_btree_t tree;
+
+    tree = upo_btree_create(int_compare);
+
+    assert( upo_btree_min(tree) == NULL );
+    assert( upo_btree_max(tree) == NULL );
+    assert( upo_btree_floor(tree, &k) == NULL );
+    assert( upo_btree_keys(tree) == NULL );
+
+    /* Even keys only, inserted from the largest */
+    for (i = NUM_KEYS; i > 0; --i)
+    {
+        keys[i-1] = 2*((int) i-1);
+        upo_btree_put(tree, &keys[i-1], &keys[i-1]);
+    }
+
+    assert( *((int*) upo_btree_min(tree)) == 0 );
+    assert( *((int*) upo_btree_max(tree)) == 2*(NUM_KEYS-1) );
+    k = 101;
+    assert( *((int*) upo_btree_floor(tree, &k)) == 100 );
+    assert( *((int*) upo_btree_ceiling(tree, &k)) == 102 );
+    k = 100;
+    assert( *((int*) upo_btree_floor(tree, &k)) == 100 );
+    assert( *((int*) upo_btree_ceiling(tree, &k)) == 100 );
+    k = -1;
+    assert( upo_btree_floor(tree, &k) == NULL );
+    assert( *((int*) upo_btree_ceiling(tree, &k)) == 0 );
+    k = 2*NUM_KEYS;
+    assert( *((int*) upo_btree_floor(tree, &k)) == 2*(NUM_KEYS-1) );
+    assert( upo_btree_ceiling(tree, &k) == NULL );
+
+    k = 0;
+    upo_btree_traverse_in_order(tree, check_visit, &k);
+    assert( k == 2*NUM_KEYS );
+
+    /* Range bounds need not be in the tree; lists go from the largest key */
+    lo = 999; hi = 5001;
+    key_list = upo_btree_keys_range(tree, &lo, &hi);
+    for (k = 5000; key_list != NULL; k -= 2)
+    {
+        upo_bst_key_list_node_t* node = key_list;
+
+        assert( *((int*) node->key) == k );
+        key_list = node->next;
+        free(node);
+    }
+    assert( k == 998 );
+    lo = 11; hi = 11;
+    assert( upo_btree_keys_range(tree, &lo, &hi) == NULL );
+    lo = 3*NUM_KEYS; hi = 4*NUM_KEYS;
+    assert( upo_btree_keys_range(tree, &lo, &hi) == NULL );
+
+    key_list = upo_btree_keys(tree);
+    for (i = NUM_KEYS; key_list != NULL; --i)
+    {
+        upo_bst_key_list_node_t* node = key_list;
+
+        assert( *((int*) node->key) == 2*((int) i-1) );
+        key_list = node->next;
+        free(node);
+    }
+    assert( i == 0 );
+
+    upo_btree_delete_min(tree, 0);
+    upo_btree_delete_max(tree, 0);
+    assert( *((int*) upo_btree_min(tree)) == 2 );
+    assert( *((int*) upo_btree_max(tree)) == 2*(NUM_KEYS-2) );
+    assert( upo_btree_size(tree) == NUM_KEYS-2 );
+
+    upo_btree_destroy(tree, 0);
+}
+
+void test_rank_select()
+{
+    int keys[NUM_KEYS];
+    int k = 0;
+    int lo = 0;
+    int hi = 0;
+    size_t i;
+    upo_btree_t tree;
+
+    tree = upo_btree_create(int_compare);
+
+    assert( upo_btree_select(tree, 0) == NULL );
+    assert( upo_btree_rank(tree, &k) == 0 );
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        keys[i] = 2*((int) i);
+        upo_btree_put(tree, &keys[i], &keys[i]);
+    }
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        assert( upo_btree_select(tree, i) == &keys[i] );
+        assert( upo_btree_rank(tree, &keys[i]) == i );
+        k = keys[i] + 1;
+        assert( upo_btree_rank(tree, &k) == i+1 );
+    }
+    assert( upo_btree_select(tree, NUM_KEYS) == NULL );
+
+    lo = 3; hi = 9;
+    assert( upo_btree_count_range(tree, &lo, &hi) == 3 );
+    lo = 4; hi = 8;
+    assert( upo_btree_count_range(tree, &lo, &hi) == 3 );
+    lo = -10; hi = 4*NUM_KEYS;
+    assert( upo_btree_count_range(tree, &lo, &hi) == NUM_KEYS );
+    lo = 9; hi = 3;
+    assert( upo_btree_count_range(tree, &lo, &hi) == 0 );
+
+    upo_btree_destroy(tree, 0);
+}
+
+void test_random()
+{
+    int keys[NUM_KEYS];
+    int present[NUM_KEYS];
+    size_t size = 0;
+    size_t i;
+    size_t step;
+    upo_btree_t tree;
+
+    srand(42);
+
+    tree = upo_btree_create(int_compare);
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        keys[i] = (int) i;
+        present[i] = 0;
+    }
+
+    /* Random insertions and deletions, against an array of flags */
+    for (step = 0; step < 20*NUM_KEYS; ++step)
+    {
+        size_t j = (size_t) rand() % NUM_KEYS;
+
+        /* Insertions prevail at first, deletions at last */
+        if (rand() % 20 < (int) (20 - 19*step/(20*NUM_KEYS)) - 5)
+        {
+            upo_btree_put(tree, &keys[j], &keys[j]);
+            size += !present[j];
+            present[j] = 1;
+        }
+        else
+        {
+            upo_btree_delete(tree, &keys[j], 0);
+            size -= present[j];
+            present[j] = 0;
+        }
+        assert( upo_btree_size(tree) == size );
+
+        if (step % (2*NUM_KEYS) == 0)
+        {
+            size_t rank = 0;
+
+            for (i = 0; i < NUM_KEYS; ++i)
+            {
+                assert( upo_btree_contains(tree, &keys[i]) == present[i] );
+                assert( upo_btree_rank(tree, &keys[i]) == rank );
+                if (present[i])
+                {
+                    assert( upo_btree_select(tree, rank) == &keys[i] );
+                    ++rank;
+                }
+            }
+            assert( rank == size );
+        }
+    }
+
+    /* Empty the tree, in an order which is neither increasing nor decreasing */
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        upo_btree_delete(tree, &keys[(i*7919) % NUM_KEYS], 0);
+    }
+    assert( upo_btree_is_empty(tree) );
+    assert( upo_btree_height(tree) == 0 );
+
+    upo_btree_destroy(tree, 0);
+}
+
+void test_destroy_data()
+{
+    int k = 0;
+    int i = 0;
+    upo_btree_t tree;
+
+    tree = upo_btree_create(int_compare);
+
+    for (i = 0; i < 1000; ++i)
+    {
+        upo_btree_put(tree, new_int(i), new_int(i));
+    }
+    /* Keys deleted from internal nodes are replaced by keys from below,
+     * which must not be freed */
+    for (i = 0; i < 1000; i += 3)
+    {
+        k = i;
+        upo_btree_delete(tree, &k, 1);
+    }
+    for (i = 0; i < 1000; ++i)
+    {
+        int* value = NULL;
+
+        k = i;
+        value = upo_btree_get(tree, &k);
+        assert( (i % 3 == 0) ? value == NULL : *value == i );
+    }
+
+    upo_btree_clear(tree, 1);
+    assert( upo_btree_is_empty(tree) );
+
+    for (i = 0; i < 100; ++i)
+    {
+        upo_btree_put(tree, new_int(i), new_int(i));
+    }
+
+    upo_btree_destroy(tree, 1);
+}
+
+void test_null()
+{
+    upo_btree_t tree = NULL;
+    int k = 0;
+
+    assert( upo_btree_size(tree) == 0 );
+    assert( upo_btree_is_empty(tree) );
+    assert( upo_btree_height(tree) == 0 );
+    assert( upo_btree_get(tree, &k) == NULL );
+    assert( !upo_btree_contains(tree, &k) );
+    assert( upo_btree_min(tree) == NULL );
+    assert( upo_btree_floor(tree, &k) == NULL );
+    assert( upo_btree_keys_range(tree, &k, &k) == NULL );
+    assert( upo_btree_rank(tree, &k) == 0 );
+    assert( upo_btree_select(tree, 0) == NULL );
+    assert( upo_btree_get_comparator(tree) == NULL );
+
+    upo_btree_delete(tree, &k, 0);
+    upo_btree_clear(tree, 0);
+    upo_btree_destroy(tree, 0);
+}
+
+
+int main()
+{
+    printf("Test case 'create/destroy'... ");
+    fflush(stdout);
+    test_create_destroy();
+    printf("OK\n");
+
+    printf("Test case 'put/get/delete'... ");
+    fflush(stdout);
+    test_put_get_delete();
+    printf("OK\n");
+
+    printf("Test case 'ordered'... ");
+    fflush(stdout);
+    test_ordered();
+    printf("OK\n");
+
+    printf("Test case 'rank/select'... ");
+    fflush(stdout);
+    test_rank_select();
+    printf("OK\n");
+
+    printf("Test case 'random'... ");
+    fflush(stdout);
+    test_random();
+    printf("OK\n");
+
+    printf("Test case 'destroy data'... ");
+    fflush(stdout);
+    test_destroy_data();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}
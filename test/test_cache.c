@@ -0,0 +1,453 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <upo/cache.h>
+#include <upo/hashtable.h>
+
+
+#define NUM_KEYS 1000
+
+
+static int int_compare(const void* a, const void* b);
+static void count_evict(void* key, void* value, void* arg);
+static int* new_int(int x);
+
+static void test_lru();
+static void test_lru_bytes();
+static void test_clock();
+static void test_s3fifo_scan();
+static void test_s3fifo_ghost();
+static void test_stats();
+static void test_delete_clear();
+static void test_evict_callback();
+static void test_null();
+
+
+static int keys[NUM_KEYS];
+
+
+int int_compare(const void* a, const void* b)
+{
+    const int* aa = a;
+    const int* bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void count_evict(void* key, void* value, void* arg)
+{
+    size_t* counter = arg;
+
+    assert( key == value );
+
+    *counter += 1;
+}
+
+int* new_int(int x)
+{
+    int* p = malloc(sizeof(int));
+
+    assert( p != NULL );
+
+    *p = x;
+
+    return p;
+}
+
+void test_lru()
+{
+    int i = 0;
+    upo_cache_t cache = NULL;
+
+    cache = upo_cache_create(UPO_CACHE_LRU, 10, upo_ht_hash_int_mix, int_compare);
+
+    assert( cache != NULL );
+    assert( upo_cache_capacity(cache) == 10 );
+    assert( upo_cache_size(cache) == 0 );
+
+    for (i = 0; i < 10; ++i)
+    {
+        assert( upo_cache_put(cache, &keys[i], &keys[i], 1) == NULL );
+    }
+    assert( upo_cache_size(cache) == 10 );
+    assert( upo_cache_used(cache) == 10 );
+
+    /* Key 0 becomes the most recently used, so key 1 goes first */
+    assert( upo_cache_get(cache, &keys[0]) == &keys[0] );
+    upo_cache_put(cache, &keys[10], &keys[10], 1);
+    assert( upo_cache_contains(cache, &keys[0]) );
+    assert( !upo_cache_contains(cache, &keys[1]) );
+
+    /* Peeking does not refresh key 2 */
+    assert( upo_cache_peek(cache, &keys[2]) == &keys[2] );
+    upo_cache_put(cache, &keys[11], &keys[11], 1);
+    assert( !upo_cache_contains(cache, &keys[2]) );
+
+    /* Replacing a value refreshes the entry and returns the old value */
+    assert( upo_cache_put(cache, &keys[3], &keys[0], 1) == &keys[3] );
+    upo_cache_put(cache, &keys[12], &keys[12], 1);
+    assert( upo_cache_get(cache, &keys[3]) == &keys[0] );
+    assert( !upo_cache_contains(cache, &keys[4]) );
+    assert( upo_cache_size(cache) == 10 );
+
+    /* Many more keys than the capacity: only the last ones stay */
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        upo_cache_put(cache, &keys[i], &keys[i], 1);
+        assert( upo_cache_size(cache) <= 10 );
+    }
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        assert( upo_cache_contains(cache, &keys[i]) == (i >= NUM_KEYS-10) );
+    }
+
+    upo_cache_destroy(cache, 0);
+}
+
+void test_lru_bytes()
+{
+    int i = 0;
+    upo_cache_t cache = NULL;
+
+    cache = upo_cache_create(UPO_CACHE_LRU, 100, upo_ht_hash_int_mix, int_compare);
+
+    for (i = 0; i < 4; ++i)
+    {
+        upo_cache_put(cache, &keys[i], &keys[i], 25);
+    }
+    assert( upo_cache_used(cache) == 100 );
+
+    /* A large entry evicts as many old entries as needed */
+    upo_cache_put(cache, &keys[4], &keys[4], 60);
+    assert( upo_cache_used(cache) == 85 );
+    assert( upo_cache_size(cache) == 2 );
+    assert( !upo_cache_contains(cache, &keys[2]) );
+    assert( upo_cache_contains(cache, &keys[3]) );
+
+    /* Growing an entry in place evicts the others */
+    upo_cache_put(cache, &keys[4], &keys[4], 100);
+    assert( upo_cache_used(cache) == 100 );
+    assert( upo_cache_size(cache) == 1 );
+
+    /* Shrinking it makes room */
+    upo_cache_put(cache, &keys[4], &keys[4], 10);
+    upo_cache_put(cache, &keys[5], &keys[5], 90);
+    assert( upo_cache_size(cache) == 2 );
+    assert( upo_cache_used(cache) == 100 );
+
+    upo_cache_destroy(cache, 0);
+}
+
+void test_clock()
+{
+    int i = 0;
+    upo_cache_t cache = NULL;
+
+    cache = upo_cache_create(UPO_CACHE_CLOCK, 10, upo_ht_hash_int_mix, int_compare);
+
+    for (i = 0; i < 10; ++i)
+    {
+        upo_cache_put(cache, &keys[i], &keys[i], 1);
+    }
+
+    /* Referenced entries get a second chance, the others go in FIFO order */
+    upo_cache_get(cache, &keys[0]);
+    upo_cache_get(cache, &keys[2]);
+    upo_cache_put(cache, &keys[10], &keys[10], 1);
+    assert( upo_cache_contains(cache, &keys[0]) );
+    assert( !upo_cache_contains(cache, &keys[1]) );
+    upo_cache_put(cache, &keys[11], &keys[11], 1);
+    assert( upo_cache_contains(cache, &keys[2]) );
+    assert( !upo_cache_contains(cache, &keys[3]) );
+
+    /* The second chance is used up */
+    for (i = 12; i < 22; ++i)
+    {
+        upo_cache_put(cache, &keys[i], &keys[i], 1);
+    }
+    assert( !upo_cache_contains(cache, &keys[0]) );
+    assert( !upo_cache_contains(cache, &keys[2]) );
+    assert( upo_cache_size(cache) == 10 );
+
+    upo_cache_destroy(cache, 0);
+}
+
+void test_s3fifo_scan()
+{
+    int policies[] = {UPO_CACHE_LRU, UPO_CACHE_CLOCK, UPO_CACHE_S3FIFO};
+    size_t hot[3];
+    size_t p = 0;
+    int i = 0;
+    int j = 0;
+
+    /* Half of the capacity is hot, then a long scan of one-hit wonders */
+    for (p = 0; p < 3; ++p)
+    {
+        upo_cache_t cache = upo_cache_create(policies[p], 100, upo_ht_hash_int_mix, int_compare);
+
+        for (j = 0; j < 2; ++j)
+        {
+            for (i = 0; i < 50; ++i)
+            {
+                if (upo_cache_get(cache, &keys[i]) == NULL)
+                {
+                    upo_cache_put(cache, &keys[i], &keys[i], 1);
+                }
+            }
+        }
+        for (i = 50; i < NUM_KEYS; ++i)
+        {
+            upo_cache_put(cache, &keys[i], &keys[i], 1);
+            assert( upo_cache_size(cache) <= 100 );
+        }
+        hot[p] = 0;
+        for (i = 0; i < 50; ++i)
+        {
+            hot[p] += (size_t) upo_cache_contains(cache, &keys[i]);
+        }
+
+        upo_cache_destroy(cache, 0);
+    }
+
+    assert( hot[0] == 0 );
+    assert( hot[1] == 0 );
+    assert( hot[2] == 50 );
+}
+
+void test_s3fifo_ghost()
+{
+    int i = 0;
+    upo_cache_t cache = NULL;
+
+    cache = upo_cache_create(UPO_CACHE_S3FIFO, 10, upo_ht_hash_int_mix, int_compare);
+
+    /* Key 0 is never accessed, thus it leaves the small queue */
+    upo_cache_put(cache, &keys[0], &keys[0], 1);
+    for (i = 1; upo_cache_contains(cache, &keys[0]); ++i)
+    {
+        upo_cache_put(cache, &keys[i], &keys[i], 1);
+    }
+    assert( upo_cache_peek(cache, &keys[0]) == NULL );
+    assert( upo_cache_size(cache) == 10 );
+
+    /* Its ghost sends it straight to the main queue when it comes back */
+    upo_cache_put(cache, &keys[0], &keys[0], 1);
+    for (i = 100; i < NUM_KEYS; ++i)
+    {
+        upo_cache_put(cache, &keys[i], &keys[i], 1);
+    }
+    assert( upo_cache_contains(cache, &keys[0]) );
+    assert( upo_cache_size(cache) == 10 );
+
+    upo_cache_destroy(cache, 0);
+}
+
+void test_stats()
+{
+    upo_cache_stats_t stats;
+    upo_cache_t cache = NULL;
+
+    cache = upo_cache_create(UPO_CACHE_LRU, 2, upo_ht_hash_int_mix, int_compare);
+
+    upo_cache_put(cache, &keys[0], &keys[0], 1);
+    upo_cache_put(cache, &keys[1], &keys[1], 1);
+    upo_cache_put(cache, &keys[2], &keys[2], 1);
+    assert( upo_cache_get(cache, &keys[0]) == NULL );
+    assert( upo_cache_get(cache, &keys[1]) == &keys[1] );
+    assert( upo_cache_get(cache, &keys[2]) == &keys[2] );
+    assert( upo_cache_get(cache, &keys[2]) == &keys[2] );
+    upo_cache_peek(cache, &keys[3]);
+    upo_cache_contains(cache, &keys[3]);
+
+    upo_cache_stats(cache, &stats);
+    assert( stats.hits == 3 );
+    assert( stats.misses == 1 );
+    assert( stats.evictions == 1 );
+
+    upo_cache_reset_stats(cache);
+    upo_cache_stats(cache, &stats);
+    assert( stats.hits == 0 && stats.misses == 0 && stats.evictions == 0 );
+
+    upo_cache_destroy(cache, 0);
+}
+
+void test_delete_clear()
+{
+    int policies[] = {UPO_CACHE_LRU, UPO_CACHE_CLOCK, UPO_CACHE_S3FIFO};
+    size_t p = 0;
+    int i = 0;
+
+    for (p = 0; p < 3; ++p)
+    {
+        upo_cache_t cache = upo_cache_create(policies[p], 50, upo_ht_hash_int_mix, int_compare);
+
+        for (i = 0; i < 10; ++i)
+        {
+            upo_cache_put(cache, new_int(i), new_int(i), 1);
+        }
+        for (i = 0; i < 10; ++i)
+        {
+            int* value = upo_cache_peek(cache, &keys[i]);
+
+            assert( value != NULL && *value == i );
+        }
+        for (i = 0; i < 10; i += 2)
+        {
+            assert( upo_cache_delete(cache, &keys[i], 1) );
+            assert( !upo_cache_delete(cache, &keys[i], 1) );
+        }
+        assert( upo_cache_size(cache) == 5 );
+        assert( upo_cache_used(cache) == 5 );
+        for (i = 0; i < 10; ++i)
+        {
+            assert( upo_cache_contains(cache, &keys[i]) == (i % 2) );
+        }
+
+        upo_cache_clear(cache, 1);
+        assert( upo_cache_size(cache) == 0 );
+        assert( upo_cache_used(cache) == 0 );
+
+        /* The cache is usable after clearing */
+        for (i = 0; i < NUM_KEYS; ++i)
+        {
+            upo_cache_put(cache, &keys[i], &keys[i], 1);
+        }
+        assert( upo_cache_size(cache) == 50 );
+
+        upo_cache_destroy(cache, 0);
+    }
+}
+
+void test_evict_callback()
+{
+    int policies[] = {UPO_CACHE_LRU, UPO_CACHE_CLOCK, UPO_CACHE_S3FIFO};
+    upo_cache_stats_t stats;
+    size_t p = 0;
+    int i = 0;
+
+    for (p = 0; p < 3; ++p)
+    {
+        upo_cache_t cache = upo_cache_create(policies[p], 10, upo_ht_hash_int_mix, int_compare);
+        size_t evicted = 0;
+
+        upo_cache_set_evict_callback(cache, count_evict, &evicted);
+        for (i = 0; i < NUM_KEYS; ++i)
+        {
+            upo_cache_put(cache, &keys[i], &keys[i], 1);
+            if (i % 3 == 0)
+            {
+                upo_cache_get(cache, &keys[i/2]);
+            }
+        }
+        upo_cache_stats(cache, &stats);
+        assert( evicted == NUM_KEYS - 10 );
+        assert( stats.evictions == evicted );
+        assert( upo_cache_size(cache) == 10 );
+
+        /* Deletions are not evictions */
+        upo_cache_delete(cache, &keys[NUM_KEYS-1], 0);
+        assert( evicted == NUM_KEYS - 10 );
+
+        upo_cache_destroy(cache, 0);
+    }
+}
+
+void test_null()
+{
+    upo_cache_stats_t stats;
+    upo_cache_t cache = NULL;
+
+    assert( upo_cache_size(cache) == 0 );
+    assert( upo_cache_used(cache) == 0 );
+    assert( upo_cache_capacity(cache) == 0 );
+    assert( upo_cache_peek(cache, &keys[0]) == NULL );
+    assert( !upo_cache_contains(cache, &keys[0]) );
+    assert( !upo_cache_delete(cache, &keys[0], 0) );
+    upo_cache_stats(cache, &stats);
+    assert( stats.hits == 0 );
+
+    upo_cache_reset_stats(cache);
+    upo_cache_clear(cache, 1);
+    upo_cache_destroy(cache, 1);
+}
+
+
+int main()
+{
+    int i = 0;
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        keys[i] = i;
+    }
+
+    printf("Test case 'LRU'... ");
+    fflush(stdout);
+    test_lru();
+    printf("OK\n");
+
+    printf("Test case 'LRU with sizes'... ");
+    fflush(stdout);
+    test_lru_bytes();
+    printf("OK\n");
+
+    printf("Test case 'CLOCK'... ");
+    fflush(stdout);
+    test_clock();
+    printf("OK\n");
+
+    printf("Test case 'S3-FIFO scan'... ");
+    fflush(stdout);
+    test_s3fifo_scan();
+    printf("OK\n");
+
+    printf("Test case 'S3-FIFO ghost'... ");
+    fflush(stdout);
+    test_s3fifo_ghost();
+    printf("OK\n");
+
+    printf("Test case 'stats'... ");
+    fflush(stdout);
+    test_stats();
+    printf("OK\n");
+
+    printf("Test case 'delete/clear'... ");
+    fflush(stdout);
+    test_delete_clear();
+    printf("OK\n");
+
+    printf("Test case 'eviction callback'... ");
+    fflush(stdout);
+    test_evict_callback();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}
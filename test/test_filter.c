@@ -0,0 +1,228 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <upo/filter.h>
+#include <upo/hashtable.h>
+
+
+#define NUM_KEYS 100000
+
+
+static void test_bloom_filter();
+static void test_bloom_filter_small();
+static void test_cuckoo_filter();
+static void test_cuckoo_filter_full();
+static void test_null();
+
+
+void test_bloom_filter()
+{
+    upo_bloom_filter_t filter = NULL;
+    size_t false_positives = 0;
+    size_t i = 0;
+
+    filter = upo_bloom_filter_create(NUM_KEYS, UPO_BLOOM_FILTER_DEFAULT_BITS_PER_ELEMENT);
+
+    assert( filter != NULL );
+    assert( upo_bloom_filter_memory_usage(filter) >= NUM_KEYS*UPO_BLOOM_FILTER_DEFAULT_BITS_PER_ELEMENT/8 );
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        upo_bloom_filter_add(filter, i);
+    }
+
+    /* No false negatives */
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        assert( upo_bloom_filter_may_contain(filter, i) );
+    }
+
+    /* About 1% false positives at 10 bits per element (blocking costs a bit) */
+    for (i = NUM_KEYS; i < 2*NUM_KEYS; ++i)
+    {
+        false_positives += (size_t) upo_bloom_filter_may_contain(filter, i);
+    }
+    assert( false_positives < NUM_KEYS/50 );
+
+    upo_bloom_filter_clear(filter);
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        assert( !upo_bloom_filter_may_contain(filter, i) );
+    }
+
+    upo_bloom_filter_destroy(filter);
+}
+
+void test_bloom_filter_small()
+{
+    upo_bloom_filter_t filter = NULL;
+
+    /* Even an empty filter has one block */
+    filter = upo_bloom_filter_create(0, 1);
+
+    assert( !upo_bloom_filter_may_contain(filter, 42) );
+    upo_bloom_filter_add(filter, 42);
+    assert( upo_bloom_filter_may_contain(filter, 42) );
+
+    upo_bloom_filter_destroy(filter);
+}
+
+void test_cuckoo_filter()
+{
+    upo_cuckoo_filter_t filter = NULL;
+    size_t false_positives = 0;
+    size_t i = 0;
+
+    filter = upo_cuckoo_filter_create(NUM_KEYS);
+
+    assert( filter != NULL );
+    assert( upo_cuckoo_filter_size(filter) == 0 );
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        assert( upo_cuckoo_filter_add(filter, i) );
+    }
+    assert( upo_cuckoo_filter_size(filter) == NUM_KEYS );
+
+    /* No false negatives */
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        assert( upo_cuckoo_filter_may_contain(filter, i) );
+    }
+
+    /* 16-bit fingerprints in two buckets of four give well under 0.1% */
+    for (i = NUM_KEYS; i < 2*NUM_KEYS; ++i)
+    {
+        false_positives += (size_t) upo_cuckoo_filter_may_contain(filter, i);
+    }
+    assert( false_positives < NUM_KEYS/1000 );
+
+    /* Removed elements are forgotten, the others are kept */
+    for (i = 0; i < NUM_KEYS; i += 2)
+    {
+        assert( upo_cuckoo_filter_remove(filter, i) );
+    }
+    assert( upo_cuckoo_filter_size(filter) == NUM_KEYS/2 );
+    for (i = 1; i < NUM_KEYS; i += 2)
+    {
+        assert( upo_cuckoo_filter_may_contain(filter, i) );
+    }
+    false_positives = 0;
+    for (i = 0; i < NUM_KEYS; i += 2)
+    {
+        false_positives += (size_t) upo_cuckoo_filter_may_contain(filter, i);
+    }
+    assert( false_positives < NUM_KEYS/1000 );
+
+    /* Duplicates are counted, and removed, one at a time */
+    assert( upo_cuckoo_filter_add(filter, 1) );
+    assert( upo_cuckoo_filter_remove(filter, 1) );
+    assert( upo_cuckoo_filter_may_contain(filter, 1) );
+
+    upo_cuckoo_filter_clear(filter);
+    assert( upo_cuckoo_filter_size(filter) == 0 );
+    assert( !upo_cuckoo_filter_may_contain(filter, 1) );
+    assert( !upo_cuckoo_filter_remove(filter, 1) );
+
+    upo_cuckoo_filter_destroy(filter);
+}
+
+void test_cuckoo_filter_full()
+{
+    upo_cuckoo_filter_t filter = NULL;
+    size_t added = 0;
+    size_t i = 0;
+
+    filter = upo_cuckoo_filter_create(100);
+
+    /* Adding fails only once the buckets are (nearly) full */
+    while (upo_cuckoo_filter_add(filter, upo_ht_hash_mix(added + 1)))
+    {
+        ++added;
+    }
+    assert( added >= 100 );
+    assert( upo_cuckoo_filter_size(filter) == added );
+    assert( upo_cuckoo_filter_memory_usage(filter) < 4*added*sizeof(size_t) );
+    for (i = 0; i < added; ++i)
+    {
+        assert( upo_cuckoo_filter_may_contain(filter, upo_ht_hash_mix(i + 1)) );
+    }
+
+    /* Removing makes room again */
+    for (i = 0; i < added/2; ++i)
+    {
+        assert( upo_cuckoo_filter_remove(filter, upo_ht_hash_mix(i + 1)) );
+    }
+    assert( upo_cuckoo_filter_add(filter, upo_ht_hash_mix(1)) );
+    assert( upo_cuckoo_filter_may_contain(filter, upo_ht_hash_mix(1)) );
+    for (i = added/2; i < added; ++i)
+    {
+        assert( upo_cuckoo_filter_may_contain(filter, upo_ht_hash_mix(i + 1)) );
+    }
+
+    upo_cuckoo_filter_destroy(filter);
+}
+
+void test_null()
+{
+    assert( upo_bloom_filter_memory_usage(NULL) == 0 );
+    assert( upo_cuckoo_filter_memory_usage(NULL) == 0 );
+    assert( upo_cuckoo_filter_size(NULL) == 0 );
+
+    upo_bloom_filter_clear(NULL);
+    upo_bloom_filter_destroy(NULL);
+    upo_cuckoo_filter_clear(NULL);
+    upo_cuckoo_filter_destroy(NULL);
+}
+
+
+int main()
+{
+    printf("Test case 'Bloom filter'... ");
+    fflush(stdout);
+    test_bloom_filter();
+    printf("OK\n");
+
+    printf("Test case 'Bloom filter (small)'... ");
+    fflush(stdout);
+    test_bloom_filter_small();
+    printf("OK\n");
+
+    printf("Test case 'cuckoo filter'... ");
+    fflush(stdout);
+    test_cuckoo_filter();
+    printf("OK\n");
+
+    printf("Test case 'cuckoo filter (full)'... ");
+    fflush(stdout);
+    test_cuckoo_filter_full();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}
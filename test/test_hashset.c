@@ -0,0 +1,650 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/hashset.h>
+#include <upo/hashtable.h>
+
+
+#define NUM_KEYS 10000
+
+
+static int int_compare(const void* a, const void* b);
+static int str_compare(const void* a, const void* b);
+static size_t colliding_hash(const void* x, size_t m);
+static void sum_visit(void* key, void* value, void* arg);
+static int* new_int(int x);
+
+static void test_hset_insert_delete();
+static void test_hset_resize();
+static void test_hset_collisions();
+static void test_hset_strings();
+static void test_hset_cursor_stats();
+static void test_hmultimap_put_get();
+static void test_hmultimap_delete();
+static void test_hmultimap_traverse_cursor();
+static void test_seeded();
+static void test_batch();
+static void test_destroy_data();
+static void test_null();
+
+
+static int keys[NUM_KEYS];
+
+
+int int_compare(const void* a, const void* b)
+{
+    const int* aa = a;
+    const int* bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+int str_compare(const void* a, const void* b)
+{
+    return strcmp(a, b);
+}
+
+size_t colliding_hash(const void* x, size_t m)
+{
+    const int* ix = x;
+
+    /* Only 8 distinct hash values: long clusters */
+    return (size_t) (*ix % 8) % m;
+}
+
+void sum_visit(void* key, void* value, void* arg)
+{
+    long* sum = arg;
+    int* ikey = key;
+    int* ivalue = value;
+
+    *sum += *ikey + ((ivalue != NULL) ? *ivalue : 0);
+}
+
+int* new_int(int x)
+{
+    int* p = malloc(sizeof(int));
+
+    assert( p != NULL );
+
+    *p = x;
+
+    return p;
+}
+
+void test_hset_insert_delete()
+{
+    int dup = 5;
+    int i = 0;
+    upo_hset_t set = NULL;
+
+    set = upo_hset_create(UPO_HSET_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+
+    assert( set != NULL );
+    assert( upo_hset_is_empty(set) );
+    assert( upo_hset_capacity(set) == UPO_HSET_DEFAULT_CAPACITY );
+
+    for (i = 0; i < 100; ++i)
+    {
+        assert( upo_hset_insert(set, &keys[i]) == 1 );
+        assert( upo_hset_size(set) == (size_t) i+1 );
+    }
+
+    /* Equal keys are not added twice, and the first one is kept */
+    assert( upo_hset_insert(set, &dup) == 0 );
+    assert( upo_hset_get(set, &dup) == &keys[5] );
+    assert( upo_hset_size(set) == 100 );
+
+    for (i = 0; i < 200; ++i)
+    {
+        assert( upo_hset_contains(set, &keys[i]) == (i < 100) );
+    }
+    for (i = 0; i < 100; i += 2)
+    {
+        assert( upo_hset_delete(set, &keys[i], 0) == 1 );
+        assert( upo_hset_delete(set, &keys[i], 0) == 0 );
+    }
+    assert( upo_hset_size(set) == 50 );
+    for (i = 0; i < 100; ++i)
+    {
+        assert( upo_hset_contains(set, &keys[i]) == (i % 2) );
+    }
+
+    upo_hset_clear(set, 0);
+    assert( upo_hset_is_empty(set) );
+    assert( !upo_hset_contains(set, &keys[1]) );
+
+    upo_hset_destroy(set, 0);
+}
+
+void test_hset_resize()
+{
+    int i = 0;
+    upo_hset_t set = NULL;
+
+    set = upo_hset_create(1, upo_ht_hash_int_mix, int_compare);
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        upo_hset_insert(set, &keys[i]);
+        assert( upo_hset_load_factor(set) <= 0.5 );
+    }
+    assert( upo_hset_size(set) == NUM_KEYS );
+
+    /* The set shrinks back as keys are removed */
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        assert( upo_hset_delete(set, &keys[i], 0) );
+        if (i+1 < NUM_KEYS)
+        {
+            assert( upo_hset_contains(set, &keys[NUM_KEYS-1]) );
+            assert( upo_hset_contains(set, &keys[i+1]) );
+        }
+    }
+    assert( upo_hset_is_empty(set) );
+    assert( upo_hset_capacity(set) <= 2 );
+
+    upo_hset_destroy(set, 0);
+}
+
+void test_hset_collisions()
+{
+    int i = 0;
+    int j = 0;
+    upo_hset_t set = NULL;
+
+    /* Deleting any key of long clusters must leave the others reachable */
+    for (j = 0; j < 64; ++j)
+    {
+        set = upo_hset_create(128, colliding_hash, int_compare);
+        for (i = 0; i < 60; ++i)
+        {
+            upo_hset_insert(set, &keys[i]);
+        }
+        for (i = j; i < 60; i += 7)
+        {
+            assert( upo_hset_delete(set, &keys[i], 0) );
+        }
+        for (i = 0; i < 60; ++i)
+        {
+            assert( upo_hset_contains(set, &keys[i]) == (i < j || (i - j) % 7 != 0) );
+        }
+        upo_hset_destroy(set, 0);
+    }
+}
+
+void test_hset_strings()
+{
+    char* words[] = {"alice","bob","charlie","dany","eric","george","john","katy","luke","mark"};
+    char word[] = "dany";
+    size_t n = sizeof words/sizeof words[0];
+    size_t i = 0;
+    upo_hset_t set = NULL;
+
+    set = upo_hset_create(UPO_HSET_DEFAULT_CAPACITY, upo_ht_hash_str_kr2e, str_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_hset_insert(set, words[i]);
+    }
+
+    /* The stored copy of an equal string is returned */
+    assert( upo_hset_get(set, word) == words[3] );
+    assert( !upo_hset_contains(set, "dan") );
+
+    upo_hset_destroy(set, 0);
+}
+
+void test_hset_cursor_stats()
+{
+    upo_ht_cursor_t cursor;
+    upo_ht_stats_t stats;
+    upo_ht_stats_t linprob_stats;
+    upo_ht_linprob_t ht = NULL;
+    upo_hset_t set = NULL;
+    void* key = NULL;
+    long sum = 0;
+    size_t count = 0;
+    size_t i = 0;
+
+    set = upo_hset_create(UPO_HSET_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+    ht = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        upo_hset_insert(set, &keys[i]);
+        upo_ht_linprob_put(ht, &keys[i], &keys[i]);
+    }
+
+    upo_ht_cursor_reset(&cursor);
+    while (upo_hset_cursor_next(set, &cursor, &key))
+    {
+        sum += *((int*) key);
+        ++count;
+    }
+    assert( count == NUM_KEYS );
+    assert( sum == (long) NUM_KEYS*(NUM_KEYS-1)/2 );
+
+    sum = 0;
+    upo_hset_traverse(set, sum_visit, &sum);
+    assert( sum == (long) NUM_KEYS*(NUM_KEYS-1)/2 );
+
+    upo_hset_stats(set, &stats);
+    assert( stats.size == NUM_KEYS );
+    assert( stats.capacity == upo_hset_capacity(set) );
+    assert( stats.tombstones == 0 );
+    assert( stats.max_probe >= 1 );
+    assert( stats.avg_probe >= 1 );
+    count = 0;
+    for (i = 0; i < UPO_HT_STATS_HISTOGRAM_SIZE; ++i)
+    {
+        count += stats.histogram[i];
+    }
+    assert( count == NUM_KEYS );
+
+    /* No value is stored: entries are smaller than those of linear probing */
+    upo_ht_linprob_stats(ht, &linprob_stats);
+    assert( stats.capacity == linprob_stats.capacity );
+    assert( stats.entry_bytes < linprob_stats.entry_bytes );
+
+    upo_ht_linprob_destroy(ht, 0);
+    upo_hset_destroy(set, 0);
+}
+
+void test_hmultimap_put_get()
+{
+    void* const* values = NULL;
+    size_t count = 0;
+    int i = 0;
+    int j = 0;
+    upo_hmultimap_t mm = NULL;
+
+    mm = upo_hmultimap_create(UPO_HMULTIMAP_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+
+    assert( mm != NULL );
+    assert( upo_hmultimap_is_empty(mm) );
+
+    /* Key i gets the values i, i+1, ..., 2i */
+    for (j = 0; j < 100; ++j)
+    {
+        for (i = 0; i < 100; ++i)
+        {
+            if (j <= i)
+            {
+                assert( upo_hmultimap_put(mm, &keys[i], &keys[i+j]) == (j > 0) );
+            }
+        }
+    }
+    assert( upo_hmultimap_size(mm) == 100 );
+    assert( upo_hmultimap_num_values(mm) == 100*101/2 );
+
+    for (i = 0; i < 100; ++i)
+    {
+        values = upo_hmultimap_get(mm, &keys[i], &count);
+        assert( values != NULL );
+        assert( count == (size_t) i+1 );
+        assert( upo_hmultimap_count(mm, &keys[i]) == count );
+        for (j = 0; j <= i; ++j)
+        {
+            assert( values[j] == &keys[i+j] );
+        }
+    }
+
+    values = upo_hmultimap_get(mm, &keys[100], &count);
+    assert( values == NULL && count == 0 );
+    assert( !upo_hmultimap_contains(mm, &keys[100]) );
+    assert( upo_hmultimap_contains(mm, &keys[0]) );
+
+    /* The same value may be put twice */
+    upo_hmultimap_put(mm, &keys[0], &keys[0]);
+    assert( upo_hmultimap_count(mm, &keys[0]) == 2 );
+
+    upo_hmultimap_destroy(mm, 0);
+}
+
+void test_hmultimap_delete()
+{
+    void* const* values = NULL;
+    size_t count = 0;
+    int i = 0;
+    upo_hmultimap_t mm = NULL;
+
+    mm = upo_hmultimap_create(UPO_HMULTIMAP_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        upo_hmultimap_put(mm, &keys[i % 10], &keys[i]);
+    }
+    assert( upo_hmultimap_size(mm) == 10 );
+    assert( upo_hmultimap_num_values(mm) == NUM_KEYS );
+
+    /* Removing single values keeps the order of the others */
+    assert( upo_hmultimap_delete_value(mm, &keys[3], &keys[13], 0) );
+    assert( !upo_hmultimap_delete_value(mm, &keys[3], &keys[13], 0) );
+    assert( !upo_hmultimap_delete_value(mm, &keys[3], &keys[14], 0) );
+    assert( !upo_hmultimap_delete_value(mm, &keys[10], &keys[10], 0) );
+    values = upo_hmultimap_get(mm, &keys[3], &count);
+    assert( count == NUM_KEYS/10 - 1 );
+    assert( values[0] == &keys[3] && values[1] == &keys[23] && values[2] == &keys[33] );
+    assert( upo_hmultimap_num_values(mm) == NUM_KEYS - 1 );
+
+    /* Removing all values removes the key */
+    for (i = 0; i < NUM_KEYS; i += 10)
+    {
+        assert( upo_hmultimap_contains(mm, &keys[0]) );
+        assert( upo_hmultimap_delete_value(mm, &keys[0], &keys[i], 0) );
+    }
+    assert( !upo_hmultimap_contains(mm, &keys[0]) );
+    assert( upo_hmultimap_size(mm) == 9 );
+
+    /* Removing a key removes all its values */
+    assert( upo_hmultimap_delete(mm, &keys[5], 0) );
+    assert( !upo_hmultimap_delete(mm, &keys[5], 0) );
+    assert( upo_hmultimap_size(mm) == 8 );
+    assert( upo_hmultimap_num_values(mm) == NUM_KEYS - 1 - 2*NUM_KEYS/10 );
+    for (i = 1; i < 10; ++i)
+    {
+        assert( upo_hmultimap_contains(mm, &keys[i]) == (i != 5) );
+    }
+
+    upo_hmultimap_clear(mm, 0);
+    assert( upo_hmultimap_is_empty(mm) );
+    assert( upo_hmultimap_num_values(mm) == 0 );
+
+    upo_hmultimap_destroy(mm, 0);
+}
+
+void test_hmultimap_traverse_cursor()
+{
+    upo_ht_cursor_t cursor;
+    upo_ht_stats_t stats;
+    void* const* values = NULL;
+    void* key = NULL;
+    size_t count = 0;
+    size_t total = 0;
+    long sum = 0;
+    int i = 0;
+    upo_hmultimap_t mm = NULL;
+
+    mm = upo_hmultimap_create(UPO_HMULTIMAP_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+
+    for (i = 0; i < 1000; ++i)
+    {
+        upo_hmultimap_put(mm, &keys[i % 100], &keys[i]);
+    }
+
+    /* Each pair is visited: sum of keys (10 times each) plus sum of values */
+    upo_hmultimap_traverse(mm, sum_visit, &sum);
+    assert( sum == 10L*99*100/2 + 999L*1000/2 );
+
+    upo_ht_cursor_reset(&cursor);
+    while (upo_hmultimap_cursor_next(mm, &cursor, &key, &values, &count))
+    {
+        assert( count == 10 );
+        assert( *((int*) values[9]) % 100 == *((int*) key) );
+        total += count;
+    }
+    assert( total == 1000 );
+
+    upo_hmultimap_stats(mm, &stats);
+    assert( stats.size == 100 );
+    assert( stats.entry_bytes >= 1000*sizeof(void*) );
+    assert( stats.total_bytes == stats.slot_bytes + stats.entry_bytes + stats.overhead_bytes );
+
+    upo_hmultimap_destroy(mm, 0);
+}
+
+void test_seeded()
+{
+    int i = 0;
+    long sum = 0;
+    upo_hset_t set = NULL;
+    upo_hmultimap_t mm = NULL;
+
+    set = upo_hset_create_seeded(UPO_HSET_DEFAULT_CAPACITY, upo_ht_hash_int_sip, int_compare);
+    mm = upo_hmultimap_create_seeded(UPO_HMULTIMAP_DEFAULT_CAPACITY, upo_ht_hash_int_sip, int_compare);
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        assert( upo_hset_insert(set, &keys[i]) == 1 );
+        upo_hmultimap_put(mm, &keys[i % 100], &keys[i]);
+    }
+    assert( upo_hset_size(set) == NUM_KEYS );
+    assert( upo_hmultimap_size(mm) == 100 );
+    assert( upo_hmultimap_num_values(mm) == NUM_KEYS );
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        assert( upo_hset_get(set, &keys[i]) == &keys[i] );
+        assert( upo_hmultimap_count(mm, &keys[i]) == ((i < 100) ? (size_t) NUM_KEYS/100 : 0) );
+    }
+    for (i = 0; i < NUM_KEYS; i += 2)
+    {
+        assert( upo_hset_delete(set, &keys[i], 0) == 1 );
+    }
+    upo_hset_traverse(set, sum_visit, &sum);
+    assert( sum == (long) NUM_KEYS/2 * (NUM_KEYS/2) );
+
+    /* Unseeded containers report no seed */
+    upo_hset_destroy(set, 0);
+    set = upo_hset_create(UPO_HSET_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+    assert( upo_hset_seed(set) == 0 );
+
+    upo_hset_destroy(set, 0);
+    upo_hmultimap_destroy(mm, 0);
+}
+
+void test_batch()
+{
+    void* lookups[3*UPO_HSET_DEFAULT_CAPACITY+1];
+    void* found[3*UPO_HSET_DEFAULT_CAPACITY+1];
+    void* const* values[3*UPO_HSET_DEFAULT_CAPACITY+1];
+    size_t counts[3*UPO_HSET_DEFAULT_CAPACITY+1];
+    size_t n = sizeof lookups/sizeof lookups[0];
+    int missing = -1;
+    size_t i = 0;
+    upo_hset_t set = NULL;
+    upo_hmultimap_t mm = NULL;
+
+    set = upo_hset_create(UPO_HSET_DEFAULT_CAPACITY, colliding_hash, int_compare);
+    mm = upo_hmultimap_create(UPO_HMULTIMAP_DEFAULT_CAPACITY, colliding_hash, int_compare);
+
+    /* Batches span several groups, and half of the keys are missing */
+    for (i = 0; i < 1000; i += 2)
+    {
+        upo_hset_insert(set, &keys[i]);
+        upo_hmultimap_put(mm, &keys[i], &keys[i]);
+        upo_hmultimap_put(mm, &keys[i], &keys[i+1]);
+    }
+    for (i = 0; i < n; ++i)
+    {
+        lookups[i] = (i+1 < n) ? (void*) &keys[7*i] : (void*) &missing;
+    }
+
+    assert( upo_hset_get_batch(set, lookups, 0, NULL) == 0 );
+    assert( upo_hset_get_batch(set, lookups, n, found) == (n-1)/2 );
+    assert( upo_hmultimap_get_batch(mm, lookups, n, values, counts) == (n-1)/2 );
+    for (i = 0; i < n; ++i)
+    {
+        size_t count = 0;
+
+        assert( found[i] == upo_hset_get(set, lookups[i]) );
+        assert( values[i] == upo_hmultimap_get(mm, lookups[i], &count) );
+        assert( counts[i] == count );
+    }
+    assert( upo_hmultimap_get_batch(mm, lookups, n, values, NULL) == (n-1)/2 );
+
+    upo_hset_destroy(set, 0);
+    upo_hmultimap_destroy(mm, 0);
+}
+
+void test_destroy_data()
+{
+    int i = 0;
+    int j = 0;
+    upo_hset_t set = NULL;
+    upo_hmultimap_t mm = NULL;
+
+    set = upo_hset_create(UPO_HSET_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+    mm = upo_hmultimap_create(UPO_HMULTIMAP_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+
+    for (i = 0; i < 100; ++i)
+    {
+        upo_hset_insert(set, new_int(i));
+        upo_hmultimap_put(mm, new_int(i), new_int(i));
+        for (j = 0; j < i % 4; ++j)
+        {
+            int* key = new_int(i);
+
+            /* The key is already stored: the copy still belongs to us */
+            assert( upo_hmultimap_put(mm, key, new_int(j)) == 1 );
+            free(key);
+        }
+    }
+    for (i = 0; i < 100; i += 3)
+    {
+        void* const* values = upo_hmultimap_get(mm, &keys[i], NULL);
+
+        assert( upo_hset_delete(set, &keys[i], 1) );
+        assert( upo_hmultimap_delete_value(mm, &keys[i], values[0], 1) );
+    }
+    for (i = 0; i < 100; i += 5)
+    {
+        upo_hmultimap_delete(mm, &keys[i], 1);
+    }
+    upo_hset_clear(set, 1);
+    upo_hmultimap_clear(mm, 1);
+    for (i = 0; i < 10; ++i)
+    {
+        upo_hset_insert(set, new_int(i));
+        upo_hmultimap_put(mm, new_int(i), new_int(i));
+    }
+
+    upo_hset_destroy(set, 1);
+    upo_hmultimap_destroy(mm, 1);
+}
+
+void test_null()
+{
+    upo_ht_cursor_t cursor;
+    upo_hset_t set = NULL;
+    upo_hmultimap_t mm = NULL;
+    size_t count = 1;
+
+    assert( upo_hset_size(set) == 0 );
+    assert( upo_hset_is_empty(set) );
+    assert( upo_hset_capacity(set) == 0 );
+    assert( !upo_hset_contains(set, &keys[0]) );
+    assert( upo_hset_get(set, &keys[0]) == NULL );
+    assert( !upo_hset_delete(set, &keys[0], 0) );
+    upo_ht_cursor_reset(&cursor);
+    assert( !upo_hset_cursor_next(set, &cursor, NULL) );
+    upo_hset_clear(set, 1);
+    upo_hset_destroy(set, 1);
+
+    assert( upo_hmultimap_size(mm) == 0 );
+    assert( upo_hmultimap_num_values(mm) == 0 );
+    assert( upo_hmultimap_is_empty(mm) );
+    assert( upo_hmultimap_get(mm, &keys[0], &count) == NULL && count == 0 );
+    assert( !upo_hmultimap_delete(mm, &keys[0], 0) );
+    assert( !upo_hmultimap_delete_value(mm, &keys[0], &keys[0], 0) );
+    assert( !upo_hmultimap_cursor_next(mm, &cursor, NULL, NULL, NULL) );
+    upo_hmultimap_clear(mm, 1);
+    upo_hmultimap_destroy(mm, 1);
+}
+
+
+int main()
+{
+    int i = 0;
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        keys[i] = i;
+    }
+
+    printf("Test case 'set insert/delete'... ");
+    fflush(stdout);
+    test_hset_insert_delete();
+    printf("OK\n");
+
+    printf("Test case 'set resize'... ");
+    fflush(stdout);
+    test_hset_resize();
+    printf("OK\n");
+
+    printf("Test case 'set collisions'... ");
+    fflush(stdout);
+    test_hset_collisions();
+    printf("OK\n");
+
+    printf("Test case 'set strings'... ");
+    fflush(stdout);
+    test_hset_strings();
+    printf("OK\n");
+
+    printf("Test case 'set cursor/stats'... ");
+    fflush(stdout);
+    test_hset_cursor_stats();
+    printf("OK\n");
+
+    printf("Test case 'multimap put/get'... ");
+    fflush(stdout);
+    test_hmultimap_put_get();
+    printf("OK\n");
+
+    printf("Test case 'multimap delete'... ");
+    fflush(stdout);
+    test_hmultimap_delete();
+    printf("OK\n");
+
+    printf("Test case 'multimap traverse/cursor'... ");
+    fflush(stdout);
+    test_hmultimap_traverse_cursor();
+    printf("OK\n");
+
+    printf("Test case 'seeded'... ");
+    fflush(stdout);
+    test_seeded();
+    printf("OK\n");
+
+    printf("Test case 'batch'... ");
+    fflush(stdout);
+    test_batch();
+    printf("OK\n");
+
+    printf("Test case 'destroy data'... ");
+    fflush(stdout);
+    test_destroy_data();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,524 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <upo/error.h>
+#include <upo/hashtable_compact.h>
+
+
+#define NUM_KEYS 100000
+
+
+static int int_compare(const void* a, const void* b);
+static size_t int_hash_bad(const void* x, size_t m);
+static void record_key_visit(void* key, void* value, void* info);
+
+static void test_create_destroy();
+static void test_put_get_delete();
+static void test_insert();
+static void test_clear();
+static void test_order();
+static void test_resize();
+static void test_collisions();
+static void test_churn();
+static void test_memory_usage();
+static void test_null();
+
+
+int int_compare(const void* a, const void* b)
+{
+    const int* aa = a;
+    const int* bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+size_t int_hash_bad(const void* x, size_t m)
+{
+    const int* ix = x;
+
+    /* Groups of ten consecutive keys share the same hash value */
+    return ((size_t) *ix / 10) % m;
+}
+
+void record_key_visit(void* key, void* value, void* info)
+{
+    void*** next = info;
+
+    assert( key == value );
+
+    **next = key;
+    *next += 1;
+}
+
+void test_create_destroy()
+{
+    upo_ht_compact_t ht;
+
+    ht = upo_ht_compact_create(UPO_HT_COMPACT_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    assert( ht != NULL );
+    assert( upo_ht_compact_capacity(ht) == UPO_HT_COMPACT_DEFAULT_CAPACITY );
+    assert( upo_ht_compact_is_empty(ht) );
+
+    upo_ht_compact_destroy(ht, 0);
+
+    /* The capacity is rounded up to a power of two */
+    ht = upo_ht_compact_create(100, upo_ht_hash_int_div, int_compare);
+
+    assert( ht != NULL );
+    assert( upo_ht_compact_capacity(ht) == 128 );
+
+    upo_ht_compact_destroy(ht, 0);
+}
+
+void test_put_get_delete()
+{
+    int keys[] = {0,1,2,3,4,5,6,7,8,9,10,20,30,40,50};
+    int values[] = {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14};
+    int values_upd[] = {14,13,12,11,10,9,8,7,6,5,4,3,2,1,0};
+    int missing = 100;
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    upo_ht_compact_t ht;
+
+    ht = upo_ht_compact_create(4, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_compact_put(ht, &keys[i], &values[i]) == NULL );
+        assert( upo_ht_compact_size(ht) == i+1 );
+    }
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_compact_get(ht, &keys[i]) == &values[i] );
+        assert( upo_ht_compact_contains(ht, &keys[i]) );
+    }
+    assert( upo_ht_compact_get(ht, &missing) == NULL );
+    assert( !upo_ht_compact_contains(ht, &missing) );
+
+    /* Duplicates replace the value */
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_compact_put(ht, &keys[i], &values_upd[i]) == &values[i] );
+        assert( upo_ht_compact_get(ht, &keys[i]) == &values_upd[i] );
+    }
+    assert( upo_ht_compact_size(ht) == n );
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_compact_delete(ht, &keys[i], 0);
+        assert( !upo_ht_compact_contains(ht, &keys[i]) );
+        assert( upo_ht_compact_size(ht) == n-i-1 );
+    }
+    upo_ht_compact_delete(ht, &missing, 0);
+    assert( upo_ht_compact_is_empty(ht) );
+
+    upo_ht_compact_destroy(ht, 0);
+}
+
+void test_insert()
+{
+    int keys[] = {0,1,2,3,4,5,6,7,8,9,10,20,30,40,50};
+    int values[] = {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14};
+    int values_upd[] = {14,13,12,11,10,9,8,7,6,5,4,3,2,1,0};
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    upo_ht_compact_t ht;
+
+    ht = upo_ht_compact_create(UPO_HT_COMPACT_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_compact_insert(ht, &keys[i], &values[i]);
+    }
+    /* Duplicates are ignored */
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_compact_insert(ht, &keys[i], &values_upd[i]);
+        assert( upo_ht_compact_get(ht, &keys[i]) == &values[i] );
+    }
+    assert( upo_ht_compact_size(ht) == n );
+
+    upo_ht_compact_destroy(ht, 0);
+}
+
+void test_clear()
+{
+    size_t n = 100;
+    size_t i = 0;
+    upo_ht_compact_t ht;
+
+    ht = upo_ht_compact_create(UPO_HT_COMPACT_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        int* key = malloc(sizeof(int));
+        int* value = malloc(sizeof(int));
+
+        if (key == NULL || value == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for key-value pairs");
+        }
+        *key = (int) i;
+        *value = (int) i;
+        upo_ht_compact_put(ht, key, value);
+    }
+    assert( upo_ht_compact_size(ht) == n );
+
+    /* Removed entries are freed as well, and are not freed again by the clear */
+    for (i = 0; i < n; i += 3)
+    {
+        int key = (int) i;
+
+        upo_ht_compact_delete(ht, &key, 1);
+    }
+
+    upo_ht_compact_clear(ht, 1);
+
+    assert( upo_ht_compact_is_empty(ht) );
+    for (i = 0; i < n; ++i)
+    {
+        int key = (int) i;
+
+        assert( !upo_ht_compact_contains(ht, &key) );
+    }
+
+    upo_ht_compact_destroy(ht, 0);
+}
+
+void test_order()
+{
+    int keys[1000];
+    void* out[1000];
+    void* visited[1000];
+    void** next = visited;
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    size_t count = 0;
+    void* key = NULL;
+    void* value = NULL;
+    upo_ht_cursor_t cursor;
+    upo_ht_key_list_t key_list = NULL;
+    upo_ht_compact_t ht;
+
+    ht = upo_ht_compact_create(UPO_HT_COMPACT_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+        upo_ht_compact_put(ht, &keys[i], &keys[i]);
+    }
+    /* Neither updates nor removals (and the compactions they cause) reorder the other keys */
+    for (i = 0; i < n; i += 2)
+    {
+        upo_ht_compact_put(ht, &keys[i], &keys[i]);
+    }
+    for (i = 0; i < n; ++i)
+    {
+        if (i % 4 != 1)
+        {
+            upo_ht_compact_delete(ht, &keys[i], 0);
+        }
+    }
+    for (i = 1; i < n; i += 4)
+    {
+        upo_ht_compact_delete(ht, &keys[i], 0);
+        upo_ht_compact_put(ht, &keys[i], &keys[i]);
+        assert( upo_ht_compact_size(ht) == n/4 );
+    }
+    /* Re-inserted keys go last, in their new order */
+    for (i = 0; i < n; i += 4)
+    {
+        upo_ht_compact_put(ht, &keys[n-1-i], &keys[n-1-i]);
+    }
+
+    count = 0;
+    key_list = upo_ht_compact_keys(ht);
+    while (key_list != NULL)
+    {
+        upo_ht_key_list_node_t* node = key_list;
+
+        if (count < n/4)
+        {
+            assert( *((int*) node->key) == (int) (4*count + 1) );
+        }
+        else
+        {
+            assert( *((int*) node->key) == (int) (n - 1 - 4*(count - n/4)) );
+        }
+        ++count;
+        key_list = key_list->next;
+        free(node);
+    }
+    assert( count == upo_ht_compact_size(ht) );
+
+    count = 0;
+    upo_ht_cursor_reset(&cursor);
+    while (upo_ht_compact_cursor_next(ht, &cursor, &key, &value))
+    {
+        assert( key == value );
+        ++count;
+    }
+    assert( count == upo_ht_compact_size(ht) );
+
+    assert( upo_ht_compact_keys_into(ht, out, n) == count );
+    upo_ht_compact_traverse(ht, record_key_visit, &next);
+    assert( (size_t) (next - visited) == count );
+    for (i = 0; i < count; ++i)
+    {
+        assert( visited[i] == out[i] );
+    }
+    assert( *((int*) out[0]) == 1 );
+    assert( *((int*) out[count-1]) == (int) (n - 1 - 4*(n/4 - 1)) );
+    assert( upo_ht_compact_keys_into(ht, out, 3) == 3 );
+    assert( *((int*) out[2]) == 9 );
+
+    upo_ht_compact_destroy(ht, 0);
+}
+
+void test_resize()
+{
+    int* keys = NULL;
+    size_t i = 0;
+    upo_ht_compact_t ht;
+
+    keys = malloc(NUM_KEYS*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        keys[i] = (int) (i*7919);
+    }
+
+    /* Enough keys to widen the slots from 8 to 16 and then to 32 bits */
+    ht = upo_ht_compact_create(4, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        upo_ht_compact_put(ht, &keys[i], &keys[i]);
+        assert( upo_ht_compact_load_factor(ht) <= UPO_HT_COMPACT_MAX_LOAD_FACTOR );
+    }
+    assert( upo_ht_compact_size(ht) == NUM_KEYS );
+    assert( upo_ht_compact_capacity(ht) > 0x10000 );
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        assert( upo_ht_compact_get(ht, &keys[i]) == &keys[i] );
+    }
+
+    /* The table shrinks back, narrowing the slots, as keys are removed */
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        upo_ht_compact_delete(ht, &keys[i], 0);
+        if (i % 1000 == 0 && i+1 < NUM_KEYS)
+        {
+            assert( upo_ht_compact_get(ht, &keys[i+1]) == &keys[i+1] );
+            assert( upo_ht_compact_get(ht, &keys[NUM_KEYS-1]) == &keys[NUM_KEYS-1] );
+        }
+    }
+    assert( upo_ht_compact_is_empty(ht) );
+    assert( upo_ht_compact_capacity(ht) == UPO_HT_COMPACT_DEFAULT_CAPACITY );
+
+    upo_ht_compact_destroy(ht, 0);
+    free(keys);
+}
+
+void test_collisions()
+{
+    int keys[1000];
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    upo_ht_compact_t ht;
+
+    ht = upo_ht_compact_create(4, int_hash_bad, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+        upo_ht_compact_put(ht, &keys[i], &keys[i]);
+    }
+    assert( upo_ht_compact_size(ht) == n );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_compact_get(ht, &keys[i]) == &keys[i] );
+    }
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_compact_delete(ht, &keys[i], 0);
+        assert( !upo_ht_compact_contains(ht, &keys[i]) );
+        if (i+1 < n)
+        {
+            assert( upo_ht_compact_get(ht, &keys[i+1]) == &keys[i+1] );
+        }
+    }
+    assert( upo_ht_compact_is_empty(ht) );
+
+    upo_ht_compact_destroy(ht, 0);
+}
+
+void test_churn()
+{
+    int* keys = NULL;
+    int key = -1;
+    size_t i = 0;
+    upo_ht_compact_t ht;
+
+    keys = malloc(NUM_KEYS*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    ht = upo_ht_compact_create(0, upo_ht_hash_int_div, int_compare);
+
+    /* Every put/delete pair of a new key leaves a removed slot behind */
+    upo_ht_compact_put(ht, &key, &key);
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        keys[i] = (int) i;
+        assert( upo_ht_compact_put(ht, &keys[i], &keys[i]) == NULL );
+        assert( upo_ht_compact_size(ht) == 2 );
+        upo_ht_compact_delete(ht, &keys[i], 0);
+        assert( !upo_ht_compact_contains(ht, &keys[i]) );
+        assert( upo_ht_compact_get(ht, &key) == &key );
+    }
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        upo_ht_compact_insert(ht, &keys[i], &keys[i]);
+        upo_ht_compact_delete(ht, &keys[i], 0);
+    }
+    assert( upo_ht_compact_size(ht) == 1 );
+    assert( upo_ht_compact_capacity(ht) == UPO_HT_COMPACT_DEFAULT_CAPACITY );
+
+    upo_ht_compact_destroy(ht, 0);
+    free(keys);
+}
+
+void test_memory_usage()
+{
+    int* keys = NULL;
+    size_t i = 0;
+    size_t bytes = 0;
+    upo_ht_compact_t ht;
+
+    keys = malloc(NUM_KEYS*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    ht = upo_ht_compact_create(UPO_HT_COMPACT_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        keys[i] = (int) i;
+        upo_ht_compact_put(ht, &keys[i], &keys[i]);
+    }
+
+    /* At most 3/2 of the needed entries, and 4-byte slots at a load factor above 1/3 */
+    bytes = upo_ht_compact_memory_usage(ht);
+    assert( bytes >= NUM_KEYS*3*sizeof(void*) );
+    assert( bytes <= NUM_KEYS*(3*3*sizeof(void*)/2 + 3*4) + 1024 );
+
+    upo_ht_compact_destroy(ht, 0);
+    free(keys);
+}
+
+void test_null()
+{
+    upo_ht_compact_t ht = NULL;
+    upo_ht_cursor_t cursor;
+    int key = 0;
+
+    assert( upo_ht_compact_size(ht) == 0 );
+    assert( upo_ht_compact_is_empty(ht) );
+    assert( upo_ht_compact_get(ht, &key) == NULL );
+    assert( !upo_ht_compact_contains(ht, &key) );
+    assert( upo_ht_compact_keys(ht) == NULL );
+    assert( upo_ht_compact_memory_usage(ht) == 0 );
+    upo_ht_cursor_reset(&cursor);
+    assert( !upo_ht_compact_cursor_next(ht, &cursor, NULL, NULL) );
+
+    upo_ht_compact_delete(ht, &key, 0);
+    upo_ht_compact_clear(ht, 0);
+    upo_ht_compact_destroy(ht, 0);
+}
+
+
+int main()
+{
+    printf("Test case 'create/destroy'... ");
+    fflush(stdout);
+    test_create_destroy();
+    printf("OK\n");
+
+    printf("Test case 'put/get/delete'... ");
+    fflush(stdout);
+    test_put_get_delete();
+    printf("OK\n");
+
+    printf("Test case 'insert'... ");
+    fflush(stdout);
+    test_insert();
+    printf("OK\n");
+
+    printf("Test case 'clear'... ");
+    fflush(stdout);
+    test_clear();
+    printf("OK\n");
+
+    printf("Test case 'insertion order'... ");
+    fflush(stdout);
+    test_order();
+    printf("OK\n");
+
+    printf("Test case 'resize'... ");
+    fflush(stdout);
+    test_resize();
+    printf("OK\n");
+
+    printf("Test case 'collisions'... ");
+    fflush(stdout);
+    test_collisions();
+    printf("OK\n");
+
+    printf("Test case 'put/delete churn'... ");
+    fflush(stdout);
+    test_churn();
+    printf("OK\n");
+
+    printf("Test case 'memory usage'... ");
+    fflush(stdout);
+    test_memory_usage();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,550 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <assert.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/error.h>
+#include <upo/hashtable_concurrent.h>
+
+
+#define NUM_THREADS 8
+#define KEYS_PER_THREAD 5000
+
+
+/** \brief Defines the work of a thread of the multi-threaded tests. */
+typedef struct {
+            upo_ht_concurrent_t ht;
+            int* keys;
+            size_t n;
+            size_t count; /* Failed lookups or successful insertions */
+        } thread_arg_t;
+
+
+static int int_compare(const void* a, const void* b);
+static void count_key_visit(void* key, void* value, void* info);
+static void* insert_thread(void* arg);
+static void* read_thread(void* arg);
+static void* delete_thread(void* arg);
+static void* race_thread(void* arg);
+
+static void test_create_destroy();
+static void test_put_get_delete();
+static void test_insert();
+static void test_clear();
+static void test_resize();
+static void test_keys_traverse();
+static void test_parallel_insert();
+static void test_parallel_mixed();
+static void test_parallel_race();
+static void test_null();
+
+
+int int_compare(const void* a, const void* b)
+{
+    const int* aa = a;
+    const int* bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void count_key_visit(void* key, void* value, void* info)
+{
+    size_t* counter = info;
+
+    assert( key == value );
+
+    *counter += 1;
+}
+
+void* insert_thread(void* arg)
+{
+    thread_arg_t* targ = arg;
+    size_t i = 0;
+
+    for (i = 0; i < targ->n; ++i)
+    {
+        upo_ht_concurrent_put(targ->ht, &targ->keys[i], &targ->keys[i]);
+    }
+
+    return NULL;
+}
+
+void* read_thread(void* arg)
+{
+    thread_arg_t* targ = arg;
+    size_t r = 0;
+
+    /* The keys of the reader are never deleted: they must always be found */
+    for (r = 0; r < 5; ++r)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < targ->n; ++i)
+        {
+            if (upo_ht_concurrent_get(targ->ht, &targ->keys[i]) != &targ->keys[i])
+            {
+                targ->count += 1;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+void* delete_thread(void* arg)
+{
+    thread_arg_t* targ = arg;
+    size_t i = 0;
+
+    for (i = 0; i < targ->n; ++i)
+    {
+        upo_ht_concurrent_delete(targ->ht, &targ->keys[i], 0);
+    }
+
+    return NULL;
+}
+
+void* race_thread(void* arg)
+{
+    thread_arg_t* targ = arg;
+    size_t i = 0;
+
+    /* All threads try to insert the same keys: each key must be inserted
+     * exactly once */
+    for (i = 0; i < targ->n; ++i)
+    {
+        targ->count += upo_ht_concurrent_insert(targ->ht, &targ->keys[i], &targ->keys[i]);
+    }
+
+    return NULL;
+}
+
+void test_create_destroy()
+{
+    upo_ht_concurrent_t ht;
+
+    ht = upo_ht_concurrent_create(UPO_HT_CONCURRENT_DEFAULT_CAPACITY, UPO_HT_CONCURRENT_DEFAULT_STRIPES, upo_ht_hash_int_div, int_compare);
+
+    assert( ht != NULL );
+    assert( upo_ht_concurrent_stripes(ht) == UPO_HT_CONCURRENT_DEFAULT_STRIPES );
+    assert( upo_ht_concurrent_capacity(ht) >= UPO_HT_CONCURRENT_DEFAULT_CAPACITY );
+    assert( upo_ht_concurrent_is_empty(ht) );
+
+    upo_ht_concurrent_destroy(ht, 0);
+
+    /* Stripes are rounded up to a power of two */
+    ht = upo_ht_concurrent_create(10, 3, upo_ht_hash_int_div, int_compare);
+
+    assert( ht != NULL );
+    assert( upo_ht_concurrent_stripes(ht) == 4 );
+    assert( upo_ht_concurrent_capacity(ht) >= 10 );
+
+    upo_ht_concurrent_destroy(ht, 1);
+}
+
+void test_put_get_delete()
+{
+    int keys[] = {0,1,2,3,4,5,6,7,8,9,10,20,30,40,50};
+    int values[] = {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14};
+    int values_upd[] = {14,13,12,11,10,9,8,7,6,5,4,3,2,1,0};
+    int missing = 100;
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    upo_ht_concurrent_t ht;
+
+    ht = upo_ht_concurrent_create(UPO_HT_CONCURRENT_DEFAULT_CAPACITY, UPO_HT_CONCURRENT_DEFAULT_STRIPES, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_concurrent_put(ht, &keys[i], &values[i]) == NULL );
+        assert( upo_ht_concurrent_size(ht) == i+1 );
+    }
+    for (i = 0; i < n; ++i)
+    {
+        int* value = upo_ht_concurrent_get(ht, &keys[i]);
+
+        assert( value != NULL );
+        assert( *value == values[i] );
+        assert( upo_ht_concurrent_contains(ht, &keys[i]) );
+    }
+    assert( upo_ht_concurrent_get(ht, &missing) == NULL );
+    assert( !upo_ht_concurrent_contains(ht, &missing) );
+
+    /* Update */
+    for (i = 0; i < n; ++i)
+    {
+        int* old_value = upo_ht_concurrent_put(ht, &keys[i], &values_upd[i]);
+
+        assert( old_value != NULL );
+        assert( *old_value == values[i] );
+    }
+    assert( upo_ht_concurrent_size(ht) == n );
+    for (i = 0; i < n; ++i)
+    {
+        int* value = upo_ht_concurrent_get(ht, &keys[i]);
+
+        assert( value != NULL );
+        assert( *value == values_upd[i] );
+    }
+
+    /* Removal */
+    upo_ht_concurrent_delete(ht, &missing, 0);
+    assert( upo_ht_concurrent_size(ht) == n );
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_concurrent_delete(ht, &keys[i], 0);
+
+        assert( !upo_ht_concurrent_contains(ht, &keys[i]) );
+        assert( upo_ht_concurrent_size(ht) == n-i-1 );
+    }
+    assert( upo_ht_concurrent_is_empty(ht) );
+
+    upo_ht_concurrent_destroy(ht, 0);
+}
+
+void test_insert()
+{
+    int keys[] = {0,1,2,3,4};
+    int values[] = {0,1,2,3,4};
+    int values_upd[] = {4,3,2,1,0};
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    upo_ht_concurrent_t ht;
+
+    ht = upo_ht_concurrent_create(UPO_HT_CONCURRENT_DEFAULT_CAPACITY, UPO_HT_CONCURRENT_DEFAULT_STRIPES, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_concurrent_insert(ht, &keys[i], &values[i]) == 1 );
+    }
+    /* Duplicates are ignored */
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_concurrent_insert(ht, &keys[i], &values_upd[i]) == 0 );
+        assert( upo_ht_concurrent_get(ht, &keys[i]) == &values[i] );
+    }
+    assert( upo_ht_concurrent_size(ht) == n );
+
+    upo_ht_concurrent_destroy(ht, 0);
+}
+
+void test_clear()
+{
+    size_t n = 100;
+    size_t i = 0;
+    upo_ht_concurrent_t ht;
+
+    ht = upo_ht_concurrent_create(16, 4, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        int* key = malloc(sizeof(int));
+        int* value = malloc(sizeof(int));
+
+        assert( key != NULL );
+        assert( value != NULL );
+
+        *key = (int) i;
+        *value = (int) i;
+        upo_ht_concurrent_put(ht, key, value);
+    }
+    assert( upo_ht_concurrent_size(ht) == n );
+
+    upo_ht_concurrent_clear(ht, 1);
+
+    assert( upo_ht_concurrent_is_empty(ht) );
+
+    upo_ht_concurrent_destroy(ht, 0);
+}
+
+void test_resize()
+{
+    int keys[2000];
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t m = 16;
+    size_t i = 0;
+    upo_ht_concurrent_t ht;
+
+    ht = upo_ht_concurrent_create(m, 4, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+        upo_ht_concurrent_put(ht, &keys[i], &keys[i]);
+    }
+    assert( upo_ht_concurrent_capacity(ht) > m );
+    assert( upo_ht_concurrent_load_factor(ht) <= 1 );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_concurrent_get(ht, &keys[i]) == &keys[i] );
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_concurrent_delete(ht, &keys[i], 0);
+    }
+    assert( upo_ht_concurrent_capacity(ht) == m );
+    assert( upo_ht_concurrent_is_empty(ht) );
+
+    upo_ht_concurrent_destroy(ht, 0);
+}
+
+void test_keys_traverse()
+{
+    int keys[] = {0,1,2,3,4,5,6,7,8,9};
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t count = 0;
+    size_t i = 0;
+    upo_ht_key_list_t key_list = NULL;
+    upo_ht_concurrent_t ht;
+
+    ht = upo_ht_concurrent_create(UPO_HT_CONCURRENT_DEFAULT_CAPACITY, UPO_HT_CONCURRENT_DEFAULT_STRIPES, upo_ht_hash_int_div, int_compare);
+
+    assert( upo_ht_concurrent_keys(ht) == NULL );
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_concurrent_put(ht, &keys[i], &keys[i]);
+    }
+
+    key_list = upo_ht_concurrent_keys(ht);
+    while (key_list != NULL)
+    {
+        upo_ht_key_list_t next = key_list->next;
+        int* key = key_list->key;
+
+        assert( key >= keys && key < keys+n );
+        ++count;
+        free(key_list);
+        key_list = next;
+    }
+    assert( count == n );
+
+    count = 0;
+    upo_ht_concurrent_traverse(ht, count_key_visit, &count);
+    assert( count == n );
+
+    upo_ht_concurrent_destroy(ht, 0);
+}
+
+void test_parallel_insert()
+{
+    static int keys[NUM_THREADS*KEYS_PER_THREAD];
+    pthread_t threads[NUM_THREADS];
+    thread_arg_t args[NUM_THREADS];
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    upo_ht_concurrent_t ht;
+
+    /* Start small, so that stripes are resized while other threads work */
+    ht = upo_ht_concurrent_create(16, 8, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+    for (i = 0; i < NUM_THREADS; ++i)
+    {
+        args[i].ht = ht;
+        args[i].keys = keys + i*KEYS_PER_THREAD;
+        args[i].n = KEYS_PER_THREAD;
+        args[i].count = 0;
+        assert( pthread_create(&threads[i], NULL, insert_thread, &args[i]) == 0 );
+    }
+    for (i = 0; i < NUM_THREADS; ++i)
+    {
+        assert( pthread_join(threads[i], NULL) == 0 );
+    }
+
+    assert( upo_ht_concurrent_size(ht) == n );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_concurrent_get(ht, &keys[i]) == &keys[i] );
+    }
+
+    upo_ht_concurrent_destroy(ht, 0);
+}
+
+void test_parallel_mixed()
+{
+    static int keys[NUM_THREADS*KEYS_PER_THREAD];
+    pthread_t threads[NUM_THREADS];
+    thread_arg_t args[NUM_THREADS];
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    upo_ht_concurrent_t ht;
+
+    ht = upo_ht_concurrent_create(16, 8, upo_ht_hash_int_div, int_compare);
+
+    /* Even threads own keys that are never removed and keep reading them;
+     * odd threads insert and then remove their own keys */
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+    for (i = 0; i < NUM_THREADS; i += 2)
+    {
+        size_t j = 0;
+
+        for (j = 0; j < KEYS_PER_THREAD; ++j)
+        {
+            upo_ht_concurrent_put(ht, &keys[i*KEYS_PER_THREAD+j], &keys[i*KEYS_PER_THREAD+j]);
+        }
+    }
+    for (i = 0; i < NUM_THREADS; ++i)
+    {
+        args[i].ht = ht;
+        args[i].keys = keys + i*KEYS_PER_THREAD;
+        args[i].n = KEYS_PER_THREAD;
+        args[i].count = 0;
+        assert( pthread_create(&threads[i], NULL, (i % 2 == 0) ? read_thread : insert_thread, &args[i]) == 0 );
+    }
+    for (i = 1; i < NUM_THREADS; i += 2)
+    {
+        assert( pthread_join(threads[i], NULL) == 0 );
+        assert( pthread_create(&threads[i], NULL, delete_thread, &args[i]) == 0 );
+    }
+    for (i = 0; i < NUM_THREADS; ++i)
+    {
+        assert( pthread_join(threads[i], NULL) == 0 );
+        assert( args[i].count == 0 );
+    }
+
+    assert( upo_ht_concurrent_size(ht) == n/2 );
+    for (i = 0; i < n; ++i)
+    {
+        int owner_reads = ((i / KEYS_PER_THREAD) % 2 == 0);
+
+        assert( upo_ht_concurrent_contains(ht, &keys[i]) == owner_reads );
+    }
+
+    upo_ht_concurrent_destroy(ht, 0);
+}
+
+void test_parallel_race()
+{
+    static int keys[KEYS_PER_THREAD];
+    pthread_t threads[NUM_THREADS];
+    thread_arg_t args[NUM_THREADS];
+    size_t inserted = 0;
+    size_t i = 0;
+    upo_ht_concurrent_t ht;
+
+    ht = upo_ht_concurrent_create(16, 4, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < KEYS_PER_THREAD; ++i)
+    {
+        keys[i] = (int) i;
+    }
+    for (i = 0; i < NUM_THREADS; ++i)
+    {
+        args[i].ht = ht;
+        args[i].keys = keys;
+        args[i].n = KEYS_PER_THREAD;
+        args[i].count = 0;
+        assert( pthread_create(&threads[i], NULL, race_thread, &args[i]) == 0 );
+    }
+    for (i = 0; i < NUM_THREADS; ++i)
+    {
+        assert( pthread_join(threads[i], NULL) == 0 );
+        inserted += args[i].count;
+    }
+
+    assert( inserted == KEYS_PER_THREAD );
+    assert( upo_ht_concurrent_size(ht) == KEYS_PER_THREAD );
+
+    upo_ht_concurrent_destroy(ht, 0);
+}
+
+void test_null()
+{
+    upo_ht_concurrent_t ht = NULL;
+
+    assert( upo_ht_concurrent_size(ht) == 0 );
+    assert( upo_ht_concurrent_is_empty(ht) );
+    assert( upo_ht_concurrent_stripes(ht) == 0 );
+    assert( upo_ht_concurrent_keys(ht) == NULL );
+
+    upo_ht_concurrent_clear(ht, 0);
+    upo_ht_concurrent_destroy(ht, 0);
+}
+
+
+int main()
+{
+    printf("Test case 'create/destroy'... ");
+    fflush(stdout);
+    test_create_destroy();
+    printf("OK\n");
+
+    printf("Test case 'put/get/delete'... ");
+    fflush(stdout);
+    test_put_get_delete();
+    printf("OK\n");
+
+    printf("Test case 'insert'... ");
+    fflush(stdout);
+    test_insert();
+    printf("OK\n");
+
+    printf("Test case 'clear'... ");
+    fflush(stdout);
+    test_clear();
+    printf("OK\n");
+
+    printf("Test case 'resize'... ");
+    fflush(stdout);
+    test_resize();
+    printf("OK\n");
+
+    printf("Test case 'keys/traverse'... ");
+    fflush(stdout);
+    test_keys_traverse();
+    printf("OK\n");
+
+    printf("Test case 'parallel insert'... ");
+    fflush(stdout);
+    test_parallel_insert();
+    printf("OK\n");
+
+    printf("Test case 'parallel mixed'... ");
+    fflush(stdout);
+    test_parallel_mixed();
+    printf("OK\n");
+
+    printf("Test case 'parallel race'... ");
+    fflush(stdout);
+    test_parallel_race();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}
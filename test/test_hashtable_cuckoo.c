@@ -0,0 +1,377 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <upo/error.h>
+#include <upo/hashtable_cuckoo.h>
+
+
+#define NUM_KEYS 20000
+
+
+static int int_compare(const void* a, const void* b);
+static size_t int_hash_bad(const void* x, size_t m);
+static void count_key_visit(void* key, void* value, void* info);
+
+static void test_create_destroy();
+static void test_put_get_delete();
+static void test_insert();
+static void test_clear();
+static void test_resize();
+static void test_collisions();
+static void test_keys_traverse();
+static void test_null();
+
+
+int int_compare(const void* a, const void* b)
+{
+    const int* aa = a;
+    const int* bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+size_t int_hash_bad(const void* x, size_t m)
+{
+    const int* ix = x;
+
+    /* Groups of six consecutive keys share the same hash value */
+    return ((size_t) *ix / 6) % m;
+}
+
+void count_key_visit(void* key, void* value, void* info)
+{
+    size_t* counter = info;
+
+    assert( key == value );
+
+    *counter += 1;
+}
+
+void test_create_destroy()
+{
+    upo_ht_cuckoo_t ht;
+
+    ht = upo_ht_cuckoo_create(UPO_HT_CUCKOO_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    assert( ht != NULL );
+    assert( upo_ht_cuckoo_capacity(ht) == UPO_HT_CUCKOO_DEFAULT_CAPACITY );
+    assert( upo_ht_cuckoo_is_empty(ht) );
+
+    upo_ht_cuckoo_destroy(ht, 0);
+
+    /* The number of buckets is rounded up to a power of two */
+    ht = upo_ht_cuckoo_create(10, upo_ht_hash_int_div, int_compare);
+
+    assert( ht != NULL );
+    assert( upo_ht_cuckoo_capacity(ht) == 4*UPO_HT_CUCKOO_BUCKET_SLOTS );
+
+    upo_ht_cuckoo_destroy(ht, 1);
+}
+
+void test_put_get_delete()
+{
+    int keys[] = {0,1,2,3,4,5,6,7,8,9,10,20,30,40,50};
+    int values[] = {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14};
+    int values_upd[] = {14,13,12,11,10,9,8,7,6,5,4,3,2,1,0};
+    int missing = 100;
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    upo_ht_cuckoo_t ht;
+
+    ht = upo_ht_cuckoo_create(4, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_cuckoo_put(ht, &keys[i], &values[i]) == NULL );
+        assert( upo_ht_cuckoo_size(ht) == i+1 );
+    }
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_cuckoo_get(ht, &keys[i]) == &values[i] );
+        assert( upo_ht_cuckoo_contains(ht, &keys[i]) );
+    }
+    assert( upo_ht_cuckoo_get(ht, &missing) == NULL );
+    assert( !upo_ht_cuckoo_contains(ht, &missing) );
+
+    /* Duplicates replace the value */
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_cuckoo_put(ht, &keys[i], &values_upd[i]) == &values[i] );
+        assert( upo_ht_cuckoo_get(ht, &keys[i]) == &values_upd[i] );
+    }
+    assert( upo_ht_cuckoo_size(ht) == n );
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_cuckoo_delete(ht, &keys[i], 0);
+        assert( !upo_ht_cuckoo_contains(ht, &keys[i]) );
+        assert( upo_ht_cuckoo_size(ht) == n-i-1 );
+    }
+    upo_ht_cuckoo_delete(ht, &missing, 0);
+    assert( upo_ht_cuckoo_is_empty(ht) );
+
+    upo_ht_cuckoo_destroy(ht, 0);
+}
+
+void test_insert()
+{
+    int keys[] = {0,1,2,3,4,5,6,7,8,9,10,20,30,40,50};
+    int values[] = {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14};
+    int values_upd[] = {14,13,12,11,10,9,8,7,6,5,4,3,2,1,0};
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    upo_ht_cuckoo_t ht;
+
+    ht = upo_ht_cuckoo_create(UPO_HT_CUCKOO_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_cuckoo_insert(ht, &keys[i], &values[i]);
+    }
+    /* Duplicates are ignored */
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_cuckoo_insert(ht, &keys[i], &values_upd[i]);
+        assert( upo_ht_cuckoo_get(ht, &keys[i]) == &values[i] );
+    }
+    assert( upo_ht_cuckoo_size(ht) == n );
+
+    upo_ht_cuckoo_destroy(ht, 0);
+}
+
+void test_clear()
+{
+    size_t n = 100;
+    size_t i = 0;
+    upo_ht_cuckoo_t ht;
+
+    ht = upo_ht_cuckoo_create(UPO_HT_CUCKOO_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        int* key = malloc(sizeof(int));
+        int* value = malloc(sizeof(int));
+
+        if (key == NULL || value == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for key-value pairs");
+        }
+        *key = (int) i;
+        *value = (int) i;
+        upo_ht_cuckoo_put(ht, key, value);
+    }
+    assert( upo_ht_cuckoo_size(ht) == n );
+
+    upo_ht_cuckoo_clear(ht, 1);
+
+    assert( upo_ht_cuckoo_is_empty(ht) );
+    for (i = 0; i < n; ++i)
+    {
+        int key = (int) i;
+
+        assert( !upo_ht_cuckoo_contains(ht, &key) );
+    }
+
+    upo_ht_cuckoo_destroy(ht, 0);
+}
+
+void test_resize()
+{
+    int* keys = NULL;
+    size_t i = 0;
+    upo_ht_cuckoo_t ht;
+
+    keys = malloc(NUM_KEYS*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        keys[i] = (int) (i*7919);
+    }
+
+    ht = upo_ht_cuckoo_create(4, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        upo_ht_cuckoo_put(ht, &keys[i], &keys[i]);
+        assert( upo_ht_cuckoo_load_factor(ht) <= UPO_HT_CUCKOO_MAX_LOAD_FACTOR );
+    }
+    assert( upo_ht_cuckoo_size(ht) == NUM_KEYS );
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        assert( upo_ht_cuckoo_get(ht, &keys[i]) == &keys[i] );
+    }
+
+    /* Delete every other key and check the remaining ones */
+    for (i = 0; i < NUM_KEYS; i += 2)
+    {
+        upo_ht_cuckoo_delete(ht, &keys[i], 0);
+    }
+    assert( upo_ht_cuckoo_size(ht) == NUM_KEYS/2 );
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        assert( upo_ht_cuckoo_contains(ht, &keys[i]) == (int) (i % 2) );
+    }
+
+    upo_ht_cuckoo_destroy(ht, 0);
+    free(keys);
+}
+
+void test_collisions()
+{
+    int keys[1000];
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    upo_ht_cuckoo_t ht;
+
+    /* Each hash value is shared by six keys, which all compete for the same
+     * two buckets: evictions, stashing and rebuilds are exercised heavily */
+    ht = upo_ht_cuckoo_create(4, int_hash_bad, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_cuckoo_put(ht, &keys[i], &keys[i]);
+    }
+    assert( upo_ht_cuckoo_size(ht) == n );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_cuckoo_get(ht, &keys[i]) == &keys[i] );
+    }
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_cuckoo_delete(ht, &keys[i], 0);
+        assert( !upo_ht_cuckoo_contains(ht, &keys[i]) );
+        if (i+1 < n)
+        {
+            assert( upo_ht_cuckoo_get(ht, &keys[i+1]) == &keys[i+1] );
+        }
+    }
+    assert( upo_ht_cuckoo_is_empty(ht) );
+
+    upo_ht_cuckoo_destroy(ht, 0);
+}
+
+void test_keys_traverse()
+{
+    int keys[] = {0,1,2,3,4,5,6,7,8,9,10,20,30,40,50};
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    size_t count = 0;
+    upo_ht_key_list_t key_list = NULL;
+    upo_ht_cuckoo_t ht;
+
+    ht = upo_ht_cuckoo_create(UPO_HT_CUCKOO_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_cuckoo_put(ht, &keys[i], &keys[i]);
+    }
+
+    key_list = upo_ht_cuckoo_keys(ht);
+    while (key_list != NULL)
+    {
+        upo_ht_key_list_node_t* node = key_list;
+
+        assert( upo_ht_cuckoo_contains(ht, node->key) );
+        ++count;
+        key_list = key_list->next;
+        free(node);
+    }
+    assert( count == n );
+
+    count = 0;
+    upo_ht_cuckoo_traverse(ht, count_key_visit, &count);
+    assert( count == n );
+
+    upo_ht_cuckoo_destroy(ht, 0);
+}
+
+void test_null()
+{
+    upo_ht_cuckoo_t ht = NULL;
+    int key = 0;
+
+    assert( upo_ht_cuckoo_size(ht) == 0 );
+    assert( upo_ht_cuckoo_is_empty(ht) );
+    assert( upo_ht_cuckoo_get(ht, &key) == NULL );
+    assert( !upo_ht_cuckoo_contains(ht, &key) );
+    assert( upo_ht_cuckoo_keys(ht) == NULL );
+
+    upo_ht_cuckoo_delete(ht, &key, 0);
+    upo_ht_cuckoo_clear(ht, 0);
+    upo_ht_cuckoo_destroy(ht, 0);
+}
+
+
+int main()
+{
+    printf("Test case 'create/destroy'... ");
+    fflush(stdout);
+    test_create_destroy();
+    printf("OK\n");
+
+    printf("Test case 'put/get/delete'... ");
+    fflush(stdout);
+    test_put_get_delete();
+    printf("OK\n");
+
+    printf("Test case 'insert'... ");
+    fflush(stdout);
+    test_insert();
+    printf("OK\n");
+
+    printf("Test case 'clear'... ");
+    fflush(stdout);
+    test_clear();
+    printf("OK\n");
+
+    printf("Test case 'resize'... ");
+    fflush(stdout);
+    test_resize();
+    printf("OK\n");
+
+    printf("Test case 'collisions'... ");
+    fflush(stdout);
+    test_collisions();
+    printf("OK\n");
+
+    printf("Test case 'keys/traverse'... ");
+    fflush(stdout);
+    test_keys_traverse();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}
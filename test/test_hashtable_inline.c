@@ -0,0 +1,333 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <upo/hashtable_inline.h>
+
+
+#define NUM_KEYS 10000
+
+
+static void sum_int_int_visit(int key, int value, void* info);
+static void count_u64_ptr_visit(uint64_t key, void* value, void* info);
+
+static void test_int_int_create_destroy();
+static void test_int_int_put_get_delete();
+static void test_int_int_zero_key();
+static void test_int_int_resize();
+static void test_int_int_clustered_delete();
+static void test_int_int_traverse();
+static void test_u64_ptr();
+static void test_null();
+
+
+void sum_int_int_visit(int key, int value, void* info)
+{
+    long* sum = info;
+
+    assert( value == 2*key );
+
+    *sum += key;
+}
+
+void count_u64_ptr_visit(uint64_t key, void* value, void* info)
+{
+    size_t* counter = info;
+    uint64_t* ivalue = value;
+
+    assert( *ivalue == key );
+
+    *counter += 1;
+}
+
+void test_int_int_create_destroy()
+{
+    upo_ht_int_int_t ht;
+
+    ht = upo_ht_int_int_create(UPO_HT_INLINE_DEFAULT_CAPACITY);
+
+    assert( ht != NULL );
+    assert( upo_ht_int_int_capacity(ht) == UPO_HT_INLINE_DEFAULT_CAPACITY );
+    assert( upo_ht_int_int_is_empty(ht) );
+
+    upo_ht_int_int_destroy(ht);
+
+    /* The capacity is rounded up to a power of two */
+    ht = upo_ht_int_int_create(10);
+
+    assert( ht != NULL );
+    assert( upo_ht_int_int_capacity(ht) == 16 );
+
+    upo_ht_int_int_destroy(ht);
+}
+
+void test_int_int_put_get_delete()
+{
+    int keys[] = {1,2,3,4,5,6,7,8,9,10,20,30,40,50,-1,-100};
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    int value = 0;
+    upo_ht_int_int_t ht;
+
+    ht = upo_ht_int_int_create(UPO_HT_INLINE_DEFAULT_CAPACITY);
+
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_int_int_put(ht, keys[i], keys[i]*10) == 0 );
+        assert( upo_ht_int_int_size(ht) == i+1 );
+    }
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_int_int_get(ht, keys[i], &value) );
+        assert( value == keys[i]*10 );
+        assert( upo_ht_int_int_contains(ht, keys[i]) );
+    }
+    assert( !upo_ht_int_int_get(ht, 1000, &value) );
+    assert( value == keys[n-1]*10 );
+    assert( !upo_ht_int_int_contains(ht, 1000) );
+
+    /* Duplicates replace the value */
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_int_int_put(ht, keys[i], keys[i]) == 1 );
+        assert( upo_ht_int_int_get(ht, keys[i], &value) && value == keys[i] );
+    }
+    assert( upo_ht_int_int_size(ht) == n );
+
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_int_int_delete(ht, keys[i]) );
+        assert( !upo_ht_int_int_contains(ht, keys[i]) );
+        assert( upo_ht_int_int_size(ht) == n-i-1 );
+    }
+    assert( !upo_ht_int_int_delete(ht, 1000) );
+    assert( upo_ht_int_int_is_empty(ht) );
+
+    upo_ht_int_int_destroy(ht);
+}
+
+void test_int_int_zero_key()
+{
+    int value = 0;
+    upo_ht_int_int_t ht;
+
+    ht = upo_ht_int_int_create(UPO_HT_INLINE_DEFAULT_CAPACITY);
+
+    /* Key 0 marks free slots, but can be stored nonetheless */
+    assert( !upo_ht_int_int_contains(ht, 0) );
+    assert( upo_ht_int_int_put(ht, 0, 42) == 0 );
+    assert( upo_ht_int_int_put(ht, 1, 1) == 0 );
+    assert( upo_ht_int_int_size(ht) == 2 );
+    assert( upo_ht_int_int_get(ht, 0, &value) && value == 42 );
+    assert( upo_ht_int_int_put(ht, 0, 7) == 1 );
+    assert( upo_ht_int_int_get(ht, 0, &value) && value == 7 );
+    assert( upo_ht_int_int_delete(ht, 0) );
+    assert( !upo_ht_int_int_contains(ht, 0) );
+    assert( upo_ht_int_int_contains(ht, 1) );
+    assert( upo_ht_int_int_size(ht) == 1 );
+
+    upo_ht_int_int_put(ht, 0, 0);
+    upo_ht_int_int_clear(ht);
+    assert( upo_ht_int_int_is_empty(ht) );
+    assert( !upo_ht_int_int_contains(ht, 0) );
+
+    upo_ht_int_int_destroy(ht);
+}
+
+void test_int_int_resize()
+{
+    int i = 0;
+    int value = 0;
+    upo_ht_int_int_t ht;
+
+    ht = upo_ht_int_int_create(2);
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        upo_ht_int_int_put(ht, i*7919 + 1, i);
+        assert( upo_ht_int_int_load_factor(ht) <= UPO_HT_INLINE_MAX_LOAD_FACTOR );
+    }
+    assert( upo_ht_int_int_size(ht) == NUM_KEYS );
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        assert( upo_ht_int_int_get(ht, i*7919 + 1, &value) && value == i );
+    }
+
+    /* The table shrinks back as keys are removed */
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        assert( upo_ht_int_int_delete(ht, i*7919 + 1) );
+        if (i+1 < NUM_KEYS)
+        {
+            assert( upo_ht_int_int_get(ht, (i+1)*7919 + 1, &value) && value == i+1 );
+        }
+    }
+    assert( upo_ht_int_int_is_empty(ht) );
+    assert( upo_ht_int_int_capacity(ht) <= 8 );
+
+    upo_ht_int_int_destroy(ht);
+}
+
+void test_int_int_clustered_delete()
+{
+    int i = 0;
+    int j = 0;
+    upo_ht_int_int_t ht;
+
+    /* Near the maximum load factor clusters are long: deleting any key must
+     * leave the others reachable */
+    for (j = 0; j < 64; ++j)
+    {
+        ht = upo_ht_int_int_create(64);
+        for (i = 1; i <= 40; ++i)
+        {
+            upo_ht_int_int_put(ht, i, i);
+        }
+        assert( upo_ht_int_int_delete(ht, j % 40 + 1) );
+        for (i = 1; i <= 40; ++i)
+        {
+            assert( upo_ht_int_int_contains(ht, i) == (i != j % 40 + 1) );
+        }
+        upo_ht_int_int_destroy(ht);
+    }
+}
+
+void test_int_int_traverse()
+{
+    int i = 0;
+    long sum = 0;
+    upo_ht_int_int_t ht;
+
+    ht = upo_ht_int_int_create(UPO_HT_INLINE_DEFAULT_CAPACITY);
+
+    for (i = 0; i < 100; ++i)
+    {
+        upo_ht_int_int_put(ht, i, 2*i);
+    }
+    upo_ht_int_int_traverse(ht, sum_int_int_visit, &sum);
+    assert( sum == 99*100/2 );
+
+    upo_ht_int_int_destroy(ht);
+}
+
+void test_u64_ptr()
+{
+    uint64_t values[NUM_KEYS];
+    void* value = NULL;
+    size_t count = 0;
+    size_t i = 0;
+    upo_ht_u64_ptr_t ht;
+
+    ht = upo_ht_u64_ptr_create(UPO_HT_INLINE_DEFAULT_CAPACITY);
+
+    /* Keys differing only in their high half must not collide */
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        values[i] = ((uint64_t) i << 40) | (i % 2);
+        assert( upo_ht_u64_ptr_put(ht, values[i], &values[i]) == 0 );
+    }
+    assert( upo_ht_u64_ptr_size(ht) == NUM_KEYS );
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        assert( upo_ht_u64_ptr_get(ht, values[i], &value) && value == &values[i] );
+    }
+    assert( !upo_ht_u64_ptr_contains(ht, UINT64_C(1) << 63) );
+
+    upo_ht_u64_ptr_traverse(ht, count_u64_ptr_visit, &count);
+    assert( count == NUM_KEYS );
+
+    for (i = 0; i < NUM_KEYS; i += 2)
+    {
+        assert( upo_ht_u64_ptr_delete(ht, values[i]) );
+    }
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        assert( upo_ht_u64_ptr_contains(ht, values[i]) == (int) (i % 2) );
+    }
+
+    upo_ht_u64_ptr_clear(ht);
+    assert( upo_ht_u64_ptr_is_empty(ht) );
+
+    upo_ht_u64_ptr_destroy(ht);
+}
+
+void test_null()
+{
+    upo_ht_int_int_t ht = NULL;
+    int value = 0;
+
+    assert( upo_ht_int_int_size(ht) == 0 );
+    assert( upo_ht_int_int_is_empty(ht) );
+    assert( !upo_ht_int_int_get(ht, 1, &value) );
+    assert( !upo_ht_int_int_delete(ht, 1) );
+
+    upo_ht_int_int_clear(ht);
+    upo_ht_int_int_destroy(ht);
+}
+
+
+int main()
+{
+    printf("Test case 'int->int create/destroy'... ");
+    fflush(stdout);
+    test_int_int_create_destroy();
+    printf("OK\n");
+
+    printf("Test case 'int->int put/get/delete'... ");
+    fflush(stdout);
+    test_int_int_put_get_delete();
+    printf("OK\n");
+
+    printf("Test case 'int->int zero key'... ");
+    fflush(stdout);
+    test_int_int_zero_key();
+    printf("OK\n");
+
+    printf("Test case 'int->int resize'... ");
+    fflush(stdout);
+    test_int_int_resize();
+    printf("OK\n");
+
+    printf("Test case 'int->int clustered delete'... ");
+    fflush(stdout);
+    test_int_int_clustered_delete();
+    printf("OK\n");
+
+    printf("Test case 'int->int traverse'... ");
+    fflush(stdout);
+    test_int_int_traverse();
+    printf("OK\n");
+
+    printf("Test case 'uint64->pointer'... ");
+    fflush(stdout);
+    test_u64_ptr();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}
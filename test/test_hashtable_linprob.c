@@ -29,10 +29,13 @@
 
 
 #define MAX(x,y) ((x) > (y) ? (x) : (y))
+#define IS_POW2(x) ((x) > 0 && ((x) & ((x)-1)) == 0)
+#define SEEDED_BLOCKS 10
 
 
 static int str_compare(const void* a, const void* b);
 static int int_compare(const void* a, const void* b);
+static size_t int_hash_low4(const void* x, size_t m);
 
 static void test_create_destroy();
 static void test_put_get_delete();
@@ -41,7 +44,14 @@ static void test_clear();
 static void test_empty();
 static void test_size();
 static void test_resize();
+static void test_get_batch();
+static void test_cursor_keys_into();
+static void test_build_from_arrays();
+static void test_stats();
+static void test_tombstones();
+static void test_seeded();
 static void test_hash_funcs();
+static void test_reduce();
 static void test_null();
 
 
@@ -67,6 +77,14 @@ int int_compare(const void* a, const void* b)
     return (*aa > *bb) - (*aa < *bb);
 }
 
+size_t int_hash_low4(const void* x, size_t m)
+{
+    assert( x != NULL );
+
+    /* Keys equal modulo 16 collide, whatever the capacity and however the hash value is mixed */
+    return ((size_t) *((const int*) x) & 15U) % m;
+}
+
 void test_create_destroy()
 {
     upo_ht_linprob_t ht;
@@ -1005,6 +1023,7 @@ void test_resize()
         upo_ht_linprob_put(ht, &keys[i], &values[i]);
 
         assert( upo_ht_linprob_size(ht) <= upo_ht_linprob_capacity(ht) );
+        assert( IS_POW2(upo_ht_linprob_capacity(ht)) );
     }
 
     /* Removal */
@@ -1013,8 +1032,368 @@ void test_resize()
         upo_ht_linprob_delete(ht, &keys[i], 0);
 
         assert( upo_ht_linprob_size(ht) <= upo_ht_linprob_capacity(ht) );
+        assert( IS_POW2(upo_ht_linprob_capacity(ht)) );
+    }
+
+    upo_ht_linprob_destroy(ht, 0);
+
+    /* Capacities are rounded up to a power of two */
+
+    ht = upo_ht_linprob_create(UPO_HT_SEPCHAIN_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    assert( ht != NULL );
+    assert( upo_ht_linprob_capacity(ht) == 1024 );
+
+    upo_ht_linprob_destroy(ht, 0);
+}
+
+void test_get_batch()
+{
+    int keys[100];
+    int missing[100];
+    void* batch_keys[200];
+    void* values[200];
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    upo_ht_linprob_t ht = NULL;
+
+    ht = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    assert( ht != NULL );
+
+    /* Empty batch */
+    assert( upo_ht_linprob_get_batch(ht, NULL, 0, NULL) == 0 );
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) (3*i);
+        missing[i] = (int) (3*i+1);
+        upo_ht_linprob_put(ht, &keys[i], &keys[i]);
+    }
+    upo_ht_linprob_delete(ht, &keys[0], 0);
+
+    /* Interleave present and missing keys, over several groups */
+    for (i = 0; i < n; ++i)
+    {
+        batch_keys[2*i] = &keys[i];
+        batch_keys[2*i+1] = &missing[i];
     }
 
+    assert( upo_ht_linprob_get_batch(ht, batch_keys, 2*n, values) == n-1 );
+    for (i = 0; i < 2*n; ++i)
+    {
+        assert( values[i] == upo_ht_linprob_get(ht, batch_keys[i]) );
+    }
+
+    /* A batch whose size is not a multiple of the group size */
+    assert( upo_ht_linprob_get_batch(ht, batch_keys+2, 5, values) == 3 );
+    assert( values[0] == &keys[1] );
+    assert( values[1] == NULL );
+    assert( values[4] == &keys[3] );
+
+    upo_ht_linprob_destroy(ht, 0);
+}
+
+void test_cursor_keys_into()
+{
+    int keys[100];
+    void* out[100];
+    int seen[100];
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t count = 0;
+    size_t i = 0;
+    void* key = NULL;
+    void* value = NULL;
+    upo_ht_cursor_t cursor;
+    upo_ht_linprob_t ht = NULL;
+
+    ht = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    assert( ht != NULL );
+
+    /* Empty table */
+    upo_ht_cursor_reset(&cursor);
+    assert( !upo_ht_linprob_cursor_next(ht, &cursor, &key, &value) );
+    assert( upo_ht_linprob_keys_into(ht, out, n) == 0 );
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+        seen[i] = 0;
+        upo_ht_linprob_put(ht, &keys[i], &keys[i]);
+    }
+    for (i = 0; i < n; i += 3)
+    {
+        upo_ht_linprob_delete(ht, &keys[i], 0);
+    }
+
+    /* Each remaining pair is enumerated exactly once */
+    upo_ht_cursor_reset(&cursor);
+    while (upo_ht_linprob_cursor_next(ht, &cursor, &key, &value))
+    {
+        assert( key == value );
+        assert( *((int*) key) % 3 != 0 );
+        seen[*((int*) key)] += 1;
+        ++count;
+    }
+    assert( count == upo_ht_linprob_size(ht) );
+    for (i = 0; i < n; ++i)
+    {
+        assert( seen[i] == (i % 3 != 0) );
+    }
+    /* An exhausted cursor stays exhausted */
+    assert( !upo_ht_linprob_cursor_next(ht, &cursor, NULL, NULL) );
+
+    /* Bulk export, into a large enough array and into a shorter one */
+    assert( upo_ht_linprob_keys_into(ht, out, n) == count );
+    for (i = 0; i < count; ++i)
+    {
+        assert( upo_ht_linprob_contains(ht, out[i]) );
+    }
+    assert( upo_ht_linprob_keys_into(ht, out, 10) == 10 );
+    assert( upo_ht_linprob_keys_into(ht, NULL, 0) == 0 );
+
+    upo_ht_linprob_destroy(ht, 0);
+}
+
+void test_build_from_arrays()
+{
+    int keys[5000];
+    int dups[10];
+    void* key_ptrs[5010];
+    void* value_ptrs[5010];
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    upo_ht_linprob_t ht = NULL;
+    upo_ht_linprob_t ref = NULL;
+
+    /* Empty input */
+    ht = upo_ht_linprob_build_from_arrays(NULL, NULL, 0, upo_ht_hash_int_div, int_compare);
+    assert( ht != NULL );
+    assert( upo_ht_linprob_is_empty(ht) );
+    upo_ht_linprob_destroy(ht, 0);
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) (i*7919);
+        key_ptrs[i] = &keys[i];
+        value_ptrs[i] = &keys[n-1-i];
+    }
+    /* Duplicates (equal keys at distinct addresses): the last value wins, as with repeated puts */
+    for (i = 0; i < 10; ++i)
+    {
+        dups[i] = keys[i*100];
+        key_ptrs[n+i] = &dups[i];
+        value_ptrs[n+i] = &dups[i];
+    }
+
+    ht = upo_ht_linprob_build_from_arrays(key_ptrs, value_ptrs, n+10, upo_ht_hash_int_div, int_compare);
+    ref = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+    for (i = 0; i < n+10; ++i)
+    {
+        upo_ht_linprob_put(ref, key_ptrs[i], value_ptrs[i]);
+    }
+
+    assert( upo_ht_linprob_size(ht) == n );
+    assert( upo_ht_linprob_capacity(ht) == upo_ht_linprob_capacity(ref) );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_linprob_get(ht, &keys[i]) == upo_ht_linprob_get(ref, &keys[i]) );
+    }
+    for (i = 0; i < 10; ++i)
+    {
+        assert( upo_ht_linprob_get(ht, &keys[i*100]) == &dups[i] );
+    }
+
+    /* The built table behaves like any other */
+    for (i = 0; i < n; i += 2)
+    {
+        upo_ht_linprob_delete(ht, &keys[i], 0);
+    }
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_linprob_contains(ht, &keys[i]) == (int) (i % 2) );
+    }
+    upo_ht_linprob_put(ht, &keys[0], &keys[0]);
+    assert( upo_ht_linprob_get(ht, &keys[0]) == &keys[0] );
+
+    upo_ht_linprob_destroy(ref, 0);
+    upo_ht_linprob_destroy(ht, 0);
+}
+
+void test_stats()
+{
+    int keys[] = {0,16,32,5};
+    int more[100];
+    size_t i = 0;
+    upo_ht_stats_t stats;
+    upo_ht_linprob_t ht = NULL;
+
+    ht = upo_ht_linprob_create(16, int_hash_low4, int_compare);
+
+    /* Keys 0, 16 and 32 share their home slot, so their probes are 1, 2 and 3 slots long */
+    for (i = 0; i < 4; ++i)
+    {
+        upo_ht_linprob_put(ht, &keys[i], &keys[i]);
+    }
+    upo_ht_linprob_stats(ht, &stats);
+    assert( stats.size == 4 );
+    assert( stats.capacity == 16 );
+    assert( stats.histogram[0] == 2 );
+    assert( stats.histogram[1] == 1 );
+    assert( stats.histogram[2] == 1 );
+    assert( stats.max_probe == 3 );
+    assert( stats.avg_probe == 7/4.0 );
+    assert( stats.tombstones == 0 );
+    assert( stats.slot_bytes == 16*sizeof(size_t) );
+    assert( stats.entry_bytes >= 4*2*sizeof(void*) );
+    assert( stats.total_bytes == stats.slot_bytes + stats.entry_bytes + stats.overhead_bytes );
+    assert( stats.resizes == 0 );
+    assert( stats.resize_time == 0 );
+
+    /* Removing 16 leaves no tombstone: 32 is moved back next to 0 */
+    upo_ht_linprob_delete(ht, &keys[1], 0);
+    upo_ht_linprob_stats(ht, &stats);
+    assert( stats.tombstones == 0 );
+    assert( stats.max_probe == 2 );
+    assert( upo_ht_linprob_get(ht, &keys[2]) == &keys[2] );
+
+    for (i = 0; i < 100; ++i)
+    {
+        more[i] = (int) (100 + i);
+        upo_ht_linprob_put(ht, &more[i], &more[i]);
+    }
+    upo_ht_linprob_stats(ht, &stats);
+    assert( stats.size == 103 );
+    assert( stats.resizes > 0 );
+    assert( stats.resize_time >= 0 );
+    assert( stats.tombstones == 0 );
+
+    upo_ht_linprob_destroy(ht, 0);
+
+    upo_ht_linprob_stats(NULL, &stats);
+    assert( stats.size == 0 && stats.total_bytes == 0 && stats.avg_probe == 0 );
+}
+
+void test_tombstones()
+{
+    int keys[2000];
+    int missing = -1;
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t live = 100;
+    size_t i = 0;
+    size_t resizes = 0;
+    upo_ht_stats_t stats;
+    upo_ht_linprob_t ht = NULL;
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+
+    ht = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    /* A sliding window of keys: the size stays the same, and deletions never leave tombstones */
+    for (i = 0; i < live; ++i)
+    {
+        upo_ht_linprob_put(ht, &keys[i], &keys[i]);
+    }
+    for (i = live; i < n; ++i)
+    {
+        upo_ht_linprob_delete(ht, &keys[i-live], 0);
+        upo_ht_linprob_put(ht, &keys[i], &keys[i]);
+
+        upo_ht_linprob_stats(ht, &stats);
+        assert( stats.size == live );
+        assert( stats.tombstones == 0 );
+        assert( 2*stats.size <= stats.capacity );
+        assert( stats.capacity <= 512 );
+        assert( upo_ht_linprob_get(ht, &keys[i-live+1]) == &keys[i-live+1] );
+        assert( !upo_ht_linprob_contains(ht, &keys[i-live]) );
+        assert( !upo_ht_linprob_contains(ht, &missing) );
+    }
+
+    /* Explicit compaction rebuilds the slots and keeps every key */
+    for (i = n-live; i < n; i += 2)
+    {
+        upo_ht_linprob_delete(ht, &keys[i], 0);
+    }
+    upo_ht_linprob_stats(ht, &stats);
+    resizes = stats.resizes;
+    upo_ht_linprob_compact(ht);
+    upo_ht_linprob_stats(ht, &stats);
+    assert( stats.tombstones == 0 );
+    assert( stats.resizes == resizes+1 );
+    assert( stats.size == live/2 );
+    for (i = n-live; i < n; ++i)
+    {
+        assert( upo_ht_linprob_contains(ht, &keys[i]) == (int) (i % 2) );
+    }
+
+    upo_ht_linprob_destroy(ht, 0);
+}
+
+void test_seeded()
+{
+    /* Strings made of blocks "ab" and "bA" all have the same djb2 hash value,
+     * since 'a'*33 + 'b' == 'b'*33 + 'A' */
+    char strs[1 << SEEDED_BLOCKS][2*SEEDED_BLOCKS + 1];
+    size_t n = 1 << SEEDED_BLOCKS;
+    size_t i = 0;
+    size_t j = 0;
+    upo_ht_stats_t stats;
+    upo_ht_linprob_t ht = NULL;
+    upo_ht_linprob_t other = NULL;
+
+    for (i = 0; i < n; ++i)
+    {
+        for (j = 0; j < SEEDED_BLOCKS; ++j)
+        {
+            strs[i][2*j] = ((i >> j) & 1) ? 'b' : 'a';
+            strs[i][2*j+1] = ((i >> j) & 1) ? 'A' : 'b';
+        }
+        strs[i][2*SEEDED_BLOCKS] = '\0';
+        assert( upo_ht_hash_str_djb2(strs[i], UPO_HT_HASH_FULL_RANGE) == upo_ht_hash_str_djb2(strs[0], UPO_HT_HASH_FULL_RANGE) );
+    }
+
+    /* Without a seed, all the strings pile up in a single cluster */
+    ht = upo_ht_linprob_create(16, upo_ht_hash_str_djb2, str_compare);
+    assert( upo_ht_linprob_seed(ht) == 0 );
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_linprob_put(ht, strs[i], strs[i]);
+    }
+    upo_ht_linprob_stats(ht, &stats);
+    assert( stats.max_probe == n );
+    upo_ht_linprob_destroy(ht, 0);
+
+    /* With a random seed and SipHash they are spread like random keys */
+    ht = upo_ht_linprob_create_seeded(16, upo_ht_hash_str_sip, str_compare);
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_linprob_put(ht, strs[i], strs[i]) == NULL );
+    }
+    upo_ht_linprob_stats(ht, &stats);
+    assert( stats.size == n );
+    assert( stats.max_probe < 32 );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_linprob_get(ht, strs[i]) == strs[i] );
+    }
+    for (i = 0; i < n; i += 2)
+    {
+        upo_ht_linprob_delete(ht, strs[i], 0);
+    }
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_linprob_contains(ht, strs[i]) == (int) (i % 2) );
+    }
+
+    /* Each table draws its own seed */
+    other = upo_ht_linprob_create_seeded(16, upo_ht_hash_int_sip, int_compare);
+    assert( upo_ht_linprob_seed(other) != upo_ht_linprob_seed(ht) );
+    upo_ht_linprob_destroy(other, 0);
+
     upo_ht_linprob_destroy(ht, 0);
 }
 
@@ -1109,6 +1488,27 @@ void test_hash_funcs()
     upo_ht_linprob_destroy(ht, 0);
 }
 
+void test_reduce()
+{
+    size_t hs[] = {0,1,2,15,16,17,997,1024,123456789,(size_t) -1};
+    size_t ms[] = {1,2,16,997,1024};
+    size_t i = 0;
+    size_t j = 0;
+
+    for (i = 0; i < sizeof hs/sizeof hs[0]; ++i)
+    {
+        for (j = 0; j < sizeof ms/sizeof ms[0]; ++j)
+        {
+            assert( upo_ht_reduce(hs[i], ms[j]) == hs[i] % ms[j] );
+            assert( upo_ht_reduce_fastrange(hs[i], ms[j]) < ms[j] );
+        }
+    }
+
+    assert( upo_ht_reduce_fastrange(0, 997) == 0 );
+    assert( upo_ht_reduce_fastrange((size_t) -1, 997) == 996 );
+    assert( upo_ht_reduce_fastrange(((size_t) -1)/2 + 1, 1024) == 512 );
+}
+
 void test_null()
 {
     upo_ht_linprob_t ht = NULL;
@@ -1162,11 +1562,46 @@ int main()
     test_resize();
     printf("OK\n");
 
+    printf("Test case 'get_batch'... ");
+    fflush(stdout);
+    test_get_batch();
+    printf("OK\n");
+
+    printf("Test case 'cursor/keys_into'... ");
+    fflush(stdout);
+    test_cursor_keys_into();
+    printf("OK\n");
+
+    printf("Test case 'build_from_arrays'... ");
+    fflush(stdout);
+    test_build_from_arrays();
+    printf("OK\n");
+
+    printf("Test case 'stats'... ");
+    fflush(stdout);
+    test_stats();
+    printf("OK\n");
+
+    printf("Test case 'tombstones'... ");
+    fflush(stdout);
+    test_tombstones();
+    printf("OK\n");
+
+    printf("Test case 'seeded'... ");
+    fflush(stdout);
+    test_seeded();
+    printf("OK\n");
+
     printf("Test case 'hash_funcs'... ");
     fflush(stdout);
     test_hash_funcs();
     printf("OK\n");
 
+    printf("Test case 'reduce'... ");
+    fflush(stdout);
+    test_reduce();
+    printf("OK\n");
+
     printf("Test case 'null'... ");
     fflush(stdout);
     test_null();
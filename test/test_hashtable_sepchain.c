@@ -29,6 +29,7 @@
 
 
 #define MAX(x,y) ((x) > (y) ? (x) : (y))
+#define SEEDED_BLOCKS 10
 
 
 static int str_compare(const void* a, const void* b);
@@ -40,7 +41,16 @@ static void test_insert_get_delete();
 static void test_clear();
 static void test_empty();
 static void test_size();
+static void test_resize();
+static void test_reserve();
+static void test_get_batch();
+static void test_cursor_keys_into();
+static void test_build_from_arrays();
+static void test_stats();
+static void test_filter();
+static void test_seeded();
 static void test_hash_funcs();
+static void test_hash_values();
 static void test_null();
 
 
@@ -979,6 +989,512 @@ void test_size()
     upo_ht_sepchain_destroy(ht, 0);
 }
 
+void test_resize()
+{
+    int keys[1000];
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t m = 4;
+    size_t i = 0;
+    upo_ht_sepchain_t ht = NULL;
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+
+    ht = upo_ht_sepchain_create(m, upo_ht_hash_int_div, int_compare);
+
+    assert( ht != NULL );
+
+    /* Growth */
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_sepchain_put(ht, &keys[i], &keys[i]);
+
+        assert( upo_ht_sepchain_size(ht) == i+1 );
+        assert( upo_ht_sepchain_load_factor(ht) <= UPO_HT_SEPCHAIN_DEFAULT_MAX_LOAD_FACTOR );
+    }
+    assert( upo_ht_sepchain_capacity(ht) > m );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_sepchain_get(ht, &keys[i]) == &keys[i] );
+    }
+
+    /* Shrink, never below the initial capacity */
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_sepchain_delete(ht, &keys[i], 0);
+
+        assert( !upo_ht_sepchain_contains(ht, &keys[i]) );
+        assert( upo_ht_sepchain_capacity(ht) >= m );
+        if (i+1 < n && upo_ht_sepchain_capacity(ht) > m)
+        {
+            assert( upo_ht_sepchain_load_factor(ht) >= UPO_HT_SEPCHAIN_DEFAULT_MIN_LOAD_FACTOR );
+        }
+    }
+    assert( upo_ht_sepchain_capacity(ht) == m );
+    assert( upo_ht_sepchain_is_empty(ht) );
+
+    /* Custom load factors */
+    upo_ht_sepchain_set_load_factors(ht, 0, 4);
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_sepchain_insert(ht, &keys[i], &keys[i]);
+
+        assert( upo_ht_sepchain_load_factor(ht) <= 4 );
+        assert( upo_ht_sepchain_load_factor(ht) > 1 || upo_ht_sepchain_capacity(ht) == m );
+    }
+    upo_ht_sepchain_set_load_factors(ht, 0.25, 1);
+    assert( upo_ht_sepchain_load_factor(ht) <= 1 );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_sepchain_get(ht, &keys[i]) == &keys[i] );
+    }
+
+    /* Disabled growth */
+    upo_ht_sepchain_clear(ht, 0);
+    upo_ht_sepchain_set_load_factors(ht, 0, 0);
+    m = upo_ht_sepchain_capacity(ht);
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_sepchain_put(ht, &keys[i], &keys[i]);
+    }
+    assert( upo_ht_sepchain_capacity(ht) == m );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_sepchain_get(ht, &keys[i]) == &keys[i] );
+    }
+
+    upo_ht_sepchain_destroy(ht, 0);
+}
+
+void test_reserve()
+{
+    int keys[1000];
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t m = 0;
+    size_t i = 0;
+    upo_ht_sepchain_t ht = NULL;
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+
+    ht = upo_ht_sepchain_create(8, upo_ht_hash_int_div, int_compare);
+
+    assert( ht != NULL );
+
+    upo_ht_sepchain_reserve(ht, n);
+    m = upo_ht_sepchain_capacity(ht);
+
+    assert( m >= n );
+
+    /* No resize takes place while filling up the reserved room */
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_sepchain_put(ht, &keys[i], &keys[i]);
+
+        assert( upo_ht_sepchain_capacity(ht) == m );
+    }
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_sepchain_get(ht, &keys[i]) == &keys[i] );
+    }
+
+    /* Reserving never shrinks */
+    upo_ht_sepchain_reserve(ht, 1);
+
+    assert( upo_ht_sepchain_capacity(ht) == m );
+
+    upo_ht_sepchain_destroy(ht, 0);
+}
+
+void test_get_batch()
+{
+    int keys[100];
+    int missing[100];
+    void* batch_keys[200];
+    void* values[200];
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    upo_ht_sepchain_t ht = NULL;
+
+    ht = upo_ht_sepchain_create(UPO_HT_SEPCHAIN_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    assert( ht != NULL );
+
+    /* Empty batch */
+    assert( upo_ht_sepchain_get_batch(ht, NULL, 0, NULL) == 0 );
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) (3*i);
+        missing[i] = (int) (3*i+1);
+        upo_ht_sepchain_put(ht, &keys[i], &keys[i]);
+    }
+    upo_ht_sepchain_delete(ht, &keys[0], 0);
+
+    /* Interleave present and missing keys, over several groups */
+    for (i = 0; i < n; ++i)
+    {
+        batch_keys[2*i] = &keys[i];
+        batch_keys[2*i+1] = &missing[i];
+    }
+
+    assert( upo_ht_sepchain_get_batch(ht, batch_keys, 2*n, values) == n-1 );
+    for (i = 0; i < 2*n; ++i)
+    {
+        assert( values[i] == upo_ht_sepchain_get(ht, batch_keys[i]) );
+    }
+
+    /* A batch whose size is not a multiple of the group size */
+    assert( upo_ht_sepchain_get_batch(ht, batch_keys+2, 5, values) == 3 );
+    assert( values[0] == &keys[1] );
+    assert( values[1] == NULL );
+    assert( values[4] == &keys[3] );
+
+    upo_ht_sepchain_destroy(ht, 0);
+}
+
+void test_cursor_keys_into()
+{
+    int keys[100];
+    void* out[100];
+    int seen[100];
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t count = 0;
+    size_t i = 0;
+    void* key = NULL;
+    void* value = NULL;
+    upo_ht_cursor_t cursor;
+    upo_ht_sepchain_t ht = NULL;
+
+    ht = upo_ht_sepchain_create(UPO_HT_SEPCHAIN_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    assert( ht != NULL );
+
+    /* Empty table */
+    upo_ht_cursor_reset(&cursor);
+    assert( !upo_ht_sepchain_cursor_next(ht, &cursor, &key, &value) );
+    assert( upo_ht_sepchain_keys_into(ht, out, n) == 0 );
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+        seen[i] = 0;
+        upo_ht_sepchain_put(ht, &keys[i], &keys[i]);
+    }
+    for (i = 0; i < n; i += 3)
+    {
+        upo_ht_sepchain_delete(ht, &keys[i], 0);
+    }
+
+    /* Each remaining pair is enumerated exactly once */
+    upo_ht_cursor_reset(&cursor);
+    while (upo_ht_sepchain_cursor_next(ht, &cursor, &key, &value))
+    {
+        assert( key == value );
+        assert( *((int*) key) % 3 != 0 );
+        seen[*((int*) key)] += 1;
+        ++count;
+    }
+    assert( count == upo_ht_sepchain_size(ht) );
+    for (i = 0; i < n; ++i)
+    {
+        assert( seen[i] == (i % 3 != 0) );
+    }
+    /* An exhausted cursor stays exhausted */
+    assert( !upo_ht_sepchain_cursor_next(ht, &cursor, NULL, NULL) );
+
+    /* Bulk export, into a large enough array and into a shorter one */
+    assert( upo_ht_sepchain_keys_into(ht, out, n) == count );
+    for (i = 0; i < count; ++i)
+    {
+        assert( upo_ht_sepchain_contains(ht, out[i]) );
+    }
+    assert( upo_ht_sepchain_keys_into(ht, out, 10) == 10 );
+    assert( upo_ht_sepchain_keys_into(ht, NULL, 0) == 0 );
+
+    upo_ht_sepchain_destroy(ht, 0);
+}
+
+void test_build_from_arrays()
+{
+    int keys[5000];
+    int dups[10];
+    void* key_ptrs[5010];
+    void* value_ptrs[5010];
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    upo_ht_sepchain_t ht = NULL;
+    upo_ht_sepchain_t ref = NULL;
+
+    /* Empty input */
+    ht = upo_ht_sepchain_build_from_arrays(NULL, NULL, 0, upo_ht_hash_int_div, int_compare);
+    assert( ht != NULL );
+    assert( upo_ht_sepchain_is_empty(ht) );
+    upo_ht_sepchain_destroy(ht, 0);
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) (i*7919);
+        key_ptrs[i] = &keys[i];
+        value_ptrs[i] = &keys[n-1-i];
+    }
+    /* Duplicates (equal keys at distinct addresses): the last value wins, as with repeated puts */
+    for (i = 0; i < 10; ++i)
+    {
+        dups[i] = keys[i*100];
+        key_ptrs[n+i] = &dups[i];
+        value_ptrs[n+i] = &dups[i];
+    }
+
+    ht = upo_ht_sepchain_build_from_arrays(key_ptrs, value_ptrs, n+10, upo_ht_hash_int_div, int_compare);
+    ref = upo_ht_sepchain_create(UPO_HT_SEPCHAIN_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+    for (i = 0; i < n+10; ++i)
+    {
+        upo_ht_sepchain_put(ref, key_ptrs[i], value_ptrs[i]);
+    }
+
+    assert( upo_ht_sepchain_size(ht) == n );
+    assert( upo_ht_sepchain_capacity(ht) == upo_ht_sepchain_capacity(ref) );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_sepchain_get(ht, &keys[i]) == upo_ht_sepchain_get(ref, &keys[i]) );
+    }
+    for (i = 0; i < 10; ++i)
+    {
+        assert( upo_ht_sepchain_get(ht, &keys[i*100]) == &dups[i] );
+    }
+
+    /* The built table behaves like any other */
+    for (i = 0; i < n; i += 2)
+    {
+        upo_ht_sepchain_delete(ht, &keys[i], 0);
+    }
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_sepchain_contains(ht, &keys[i]) == (int) (i % 2) );
+    }
+    upo_ht_sepchain_put(ht, &keys[0], &keys[0]);
+    assert( upo_ht_sepchain_get(ht, &keys[0]) == &keys[0] );
+
+    upo_ht_sepchain_destroy(ref, 0);
+    upo_ht_sepchain_destroy(ht, 0);
+}
+
+void test_stats()
+{
+    int keys[] = {0,5,10,1};
+    int more[100];
+    size_t i = 0;
+    upo_ht_stats_t stats;
+    upo_ht_sepchain_t ht = NULL;
+
+    ht = upo_ht_sepchain_create(5, upo_ht_hash_int_div, int_compare);
+
+    /* Keys 0, 5 and 10 share a list of three, key 1 is alone */
+    for (i = 0; i < 4; ++i)
+    {
+        upo_ht_sepchain_put(ht, &keys[i], &keys[i]);
+    }
+    upo_ht_sepchain_stats(ht, &stats);
+    assert( stats.size == 4 );
+    assert( stats.capacity == 5 );
+    assert( stats.histogram[0] == 3 );
+    assert( stats.histogram[1] == 1 );
+    assert( stats.histogram[2] == 0 );
+    assert( stats.histogram[3] == 1 );
+    assert( stats.max_probe == 3 );
+    assert( stats.avg_probe == 7/4.0 );
+    assert( stats.tombstones == 0 );
+    assert( stats.slot_bytes == 5*sizeof(void*) );
+    assert( stats.entry_bytes >= 4*3*sizeof(void*) );
+    assert( stats.total_bytes == stats.slot_bytes + stats.entry_bytes + stats.overhead_bytes );
+    assert( stats.resizes == 0 );
+    assert( stats.resize_time == 0 );
+
+    for (i = 0; i < 100; ++i)
+    {
+        more[i] = (int) (100 + i);
+        upo_ht_sepchain_put(ht, &more[i], &more[i]);
+    }
+    upo_ht_sepchain_stats(ht, &stats);
+    assert( stats.size == 104 );
+    assert( stats.resizes > 0 );
+    assert( stats.resize_time >= 0 );
+
+    upo_ht_sepchain_destroy(ht, 0);
+
+    upo_ht_sepchain_stats(NULL, &stats);
+    assert( stats.size == 0 && stats.total_bytes == 0 && stats.avg_probe == 0 );
+}
+
+void test_filter()
+{
+    int types[] = {UPO_HT_FILTER_BLOOM, UPO_HT_FILTER_CUCKOO};
+    int* keys = NULL;
+    void* values[64];
+    size_t n = 5000;
+    size_t i = 0;
+    size_t t = 0;
+    upo_ht_stats_t stats;
+    upo_ht_sepchain_t ht = NULL;
+
+    keys = malloc(2*n*sizeof(int));
+    assert( keys != NULL );
+    for (i = 0; i < 2*n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+
+    for (t = 0; t < sizeof types/sizeof types[0]; ++t)
+    {
+        ht = upo_ht_sepchain_create(UPO_HT_SEPCHAIN_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+
+        /* Keys stored before the filter is set are added when it is built */
+        for (i = 0; i < n/2; ++i)
+        {
+            upo_ht_sepchain_put(ht, &keys[i], &keys[i]);
+        }
+        upo_ht_sepchain_set_filter(ht, types[t]);
+        /* Keys stored afterwards are added as they come, across resizes */
+        for (i = n/2; i < n; ++i)
+        {
+            upo_ht_sepchain_insert(ht, &keys[i], &keys[i]);
+        }
+        for (i = 0; i < 2*n; ++i)
+        {
+            assert( upo_ht_sepchain_get(ht, &keys[i]) == ((i < n) ? &keys[i] : NULL) );
+        }
+        assert( upo_ht_sepchain_get_batch(ht, (void* const*) keys, 0, values) == 0 );
+        for (i = 0; i + 64 <= 2*n; i += 64)
+        {
+            void* batch[64];
+            size_t j = 0;
+
+            for (j = 0; j < 64; ++j)
+            {
+                batch[j] = &keys[i+j];
+            }
+            upo_ht_sepchain_get_batch(ht, batch, 64, values);
+            for (j = 0; j < 64; ++j)
+            {
+                assert( values[j] == ((i+j < n) ? &keys[i+j] : NULL) );
+            }
+        }
+
+        /* Removed keys are reported absent, remaining ones present */
+        for (i = 0; i < n; i += 2)
+        {
+            upo_ht_sepchain_delete(ht, &keys[i], 0);
+        }
+        for (i = 0; i < n; ++i)
+        {
+            assert( upo_ht_sepchain_contains(ht, &keys[i]) == (int) (i % 2) );
+        }
+
+        upo_ht_sepchain_stats(ht, &stats);
+        assert( stats.overhead_bytes > sizeof(void*)*8 );
+
+        upo_ht_sepchain_clear(ht, 0);
+        for (i = 0; i < n; ++i)
+        {
+            assert( !upo_ht_sepchain_contains(ht, &keys[i]) );
+        }
+
+        /* A table that never grows rebuilds its filter as keys pile up */
+        upo_ht_sepchain_set_load_factors(ht, 0, 0);
+        for (i = 0; i < 2*n; ++i)
+        {
+            upo_ht_sepchain_put(ht, &keys[i], &keys[i]);
+        }
+        for (i = 0; i < 2*n; ++i)
+        {
+            assert( upo_ht_sepchain_contains(ht, &keys[i]) );
+        }
+
+        upo_ht_sepchain_set_filter(ht, UPO_HT_FILTER_NONE);
+        assert( upo_ht_sepchain_contains(ht, &keys[0]) );
+
+        upo_ht_sepchain_destroy(ht, 0);
+    }
+
+    free(keys);
+}
+
+void test_seeded()
+{
+    /* Strings made of blocks "ab" and "bA" all have the same djb2 hash value,
+     * since 'a'*33 + 'b' == 'b'*33 + 'A' */
+    char strs[1 << SEEDED_BLOCKS][2*SEEDED_BLOCKS + 1];
+    size_t n = 1 << SEEDED_BLOCKS;
+    size_t i = 0;
+    size_t j = 0;
+    upo_ht_stats_t stats;
+    upo_ht_sepchain_t ht = NULL;
+    upo_ht_sepchain_t other = NULL;
+
+    for (i = 0; i < n; ++i)
+    {
+        for (j = 0; j < SEEDED_BLOCKS; ++j)
+        {
+            strs[i][2*j] = ((i >> j) & 1) ? 'b' : 'a';
+            strs[i][2*j+1] = ((i >> j) & 1) ? 'A' : 'b';
+        }
+        strs[i][2*SEEDED_BLOCKS] = '\0';
+        assert( upo_ht_hash_str_djb2(strs[i], UPO_HT_HASH_FULL_RANGE) == upo_ht_hash_str_djb2(strs[0], UPO_HT_HASH_FULL_RANGE) );
+    }
+
+    /* Without a seed, all the strings pile up in a single list */
+    ht = upo_ht_sepchain_create(16, upo_ht_hash_str_djb2, str_compare);
+    assert( upo_ht_sepchain_seed(ht) == 0 );
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_sepchain_put(ht, strs[i], strs[i]);
+    }
+    upo_ht_sepchain_stats(ht, &stats);
+    assert( stats.max_probe == n );
+    upo_ht_sepchain_destroy(ht, 0);
+
+    /* With a random seed and SipHash they are spread like random keys */
+    ht = upo_ht_sepchain_create_seeded(16, upo_ht_hash_str_sip, str_compare);
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_sepchain_put(ht, strs[i], strs[i]) == NULL );
+    }
+    upo_ht_sepchain_stats(ht, &stats);
+    assert( stats.size == n );
+    assert( stats.max_probe < 32 );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_sepchain_get(ht, strs[i]) == strs[i] );
+    }
+    for (i = 0; i < n; i += 2)
+    {
+        upo_ht_sepchain_delete(ht, strs[i], 0);
+    }
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_sepchain_contains(ht, strs[i]) == (int) (i % 2) );
+    }
+
+    /* Filters are fed with the seeded hash values as well */
+    upo_ht_sepchain_set_filter(ht, UPO_HT_FILTER_CUCKOO);
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_sepchain_contains(ht, strs[i]) == (int) (i % 2) );
+    }
+
+    /* Each table draws its own seed */
+    other = upo_ht_sepchain_create_seeded(16, upo_ht_hash_int_sip, int_compare);
+    assert( upo_ht_sepchain_seed(other) != upo_ht_sepchain_seed(ht) );
+    upo_ht_sepchain_destroy(other, 0);
+
+    upo_ht_sepchain_destroy(ht, 0);
+}
+
 void test_hash_funcs()
 {
     int int_keys[] = {0,1,2,3,4,5,6,7,8,9};
@@ -1067,9 +1583,110 @@ void test_hash_funcs()
         assert( *value == values[i] );
     }
 
+    upo_ht_sepchain_destroy(ht, 0);
+    /* HT with integer keys and with a multiply-xorshift hash function */
+
+    ht = upo_ht_sepchain_create(UPO_HT_SEPCHAIN_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+
+    assert( ht != NULL );
+
+    n = sizeof int_keys/sizeof int_keys[0];
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_sepchain_put(ht, &int_keys[i], &values[i]);
+    }
+    for (i = 0; i < n; ++i)
+    {
+        int* value = upo_ht_sepchain_get(ht, &int_keys[i]);
+
+        assert( value != NULL );
+        assert( *value == values[i] );
+    }
+
+    upo_ht_sepchain_destroy(ht, 0);
+
+    /* HT with string keys and with xxHash64 as hash function */
+
+    ht = upo_ht_sepchain_create(UPO_HT_SEPCHAIN_DEFAULT_CAPACITY, upo_ht_hash_str_xx64, str_compare);
+
+    assert( ht != NULL );
+
+    n = sizeof str_keys/sizeof str_keys[0];
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_sepchain_put(ht, str_keys[i], &values[i]);
+    }
+    for (i = 0; i < n; ++i)
+    {
+        int* value = upo_ht_sepchain_get(ht, str_keys[i]);
+
+        assert( value != NULL );
+        assert( *value == values[i] );
+    }
+
     upo_ht_sepchain_destroy(ht, 0);
 }
 
+void test_hash_values()
+{
+    const char* strs[] = {"", "a", "abc", "alice", "0123456789abcdefghijklmnopqrstuvwxyz"};
+    size_t ms[] = {1, 16, 997, 1024};
+    int int_keys[] = {-1, 0, 1, 2, 1000, 1024};
+    size_t i = 0;
+    size_t j = 0;
+
+    /* Reference values of xxHash64 with zero seed */
+    if (sizeof(size_t) >= 8)
+    {
+        assert( upo_ht_hash_bytes_xx64("", 0, 0) == (size_t) 0xEF46DB3751D8E999UL );
+        assert( upo_ht_hash_bytes_xx64("a", 1, 0) == (size_t) 0xD24EC4F1A98C6E5BUL );
+        assert( upo_ht_hash_bytes_xx64("abc", 3, 0) == (size_t) 0x44BC2CF5AD770999UL );
+    }
+
+    /* Reference values of SipHash-2-4 with key 00 01 ... 0F */
+    if (sizeof(size_t) >= 8)
+    {
+        const char* bytes = "\x00\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0A\x0B\x0C\x0D\x0E";
+        size_t k0 = (size_t) 0x0706050403020100UL;
+        size_t k1 = (size_t) 0x0F0E0D0C0B0A0908UL;
+
+        assert( upo_ht_hash_bytes_sip(bytes, 0, k0, k1) == (size_t) 0x726FDB47DD0E0E31UL );
+        assert( upo_ht_hash_bytes_sip(bytes, 15, k0, k1) == (size_t) 0xA129CA6149BE45E5UL );
+    }
+
+    /* The seed matters */
+    assert( upo_ht_hash_bytes_xx64("abc", 3, 0) != upo_ht_hash_bytes_xx64("abc", 3, 1) );
+    assert( upo_ht_hash_bytes_sip("abc", 3, 0, 0) != upo_ht_hash_bytes_sip("abc", 3, 1, 0) );
+    assert( upo_ht_hash_bytes_sip("abc", 3, 0, 0) != upo_ht_hash_bytes_sip("abc", 3, 0, 1) );
+    assert( upo_ht_hash_str_sip("abc", 1, UPO_HT_HASH_FULL_RANGE) != upo_ht_hash_str_sip("abc", 2, UPO_HT_HASH_FULL_RANGE) );
+
+    /* Hash values are in range */
+    for (j = 0; j < sizeof ms/sizeof ms[0]; ++j)
+    {
+        for (i = 0; i < sizeof strs/sizeof strs[0]; ++i)
+        {
+            assert( upo_ht_hash_str_xx64(strs[i], ms[j]) < ms[j] );
+            assert( upo_ht_hash_str_djb2(strs[i], ms[j]) < ms[j] );
+            assert( upo_ht_hash_str_djb2a(strs[i], ms[j]) < ms[j] );
+            assert( upo_ht_hash_str_sip(strs[i], 42, ms[j]) < ms[j] );
+        }
+        for (i = 0; i < sizeof int_keys/sizeof int_keys[0]; ++i)
+        {
+            assert( upo_ht_hash_int_mix(&int_keys[i], ms[j]) < ms[j] );
+            assert( upo_ht_hash_int_mult_knuth(&int_keys[i], ms[j]) < ms[j] );
+            assert( upo_ht_hash_int_mult(&int_keys[i], 0.618, ms[j]) < ms[j] );
+            assert( upo_ht_hash_int_mix_seeded(&int_keys[i], 42, ms[j]) < ms[j] );
+            assert( upo_ht_hash_int_sip(&int_keys[i], 42, ms[j]) < ms[j] );
+        }
+    }
+
+    /* The mixer is a bijection: distinct inputs give distinct outputs */
+    for (i = 0; i < 1000; ++i)
+    {
+        assert( upo_ht_hash_mix(i) != upo_ht_hash_mix(i+1) );
+    }
+}
+
 void test_null()
 {
     upo_ht_sepchain_t ht = NULL;
@@ -1118,11 +1735,56 @@ int main()
     test_size();
     printf("OK\n");
 
+    printf("Test case 'resize'... ");
+    fflush(stdout);
+    test_resize();
+    printf("OK\n");
+
+    printf("Test case 'reserve'... ");
+    fflush(stdout);
+    test_reserve();
+    printf("OK\n");
+
+    printf("Test case 'get_batch'... ");
+    fflush(stdout);
+    test_get_batch();
+    printf("OK\n");
+
+    printf("Test case 'cursor/keys_into'... ");
+    fflush(stdout);
+    test_cursor_keys_into();
+    printf("OK\n");
+
+    printf("Test case 'build_from_arrays'... ");
+    fflush(stdout);
+    test_build_from_arrays();
+    printf("OK\n");
+
+    printf("Test case 'stats'... ");
+    fflush(stdout);
+    test_stats();
+    printf("OK\n");
+
+    printf("Test case 'filter'... ");
+    fflush(stdout);
+    test_filter();
+    printf("OK\n");
+
+    printf("Test case 'seeded'... ");
+    fflush(stdout);
+    test_seeded();
+    printf("OK\n");
+
     printf("Test case 'hash_funcs'... ");
     fflush(stdout);
     test_hash_funcs();
     printf("OK\n");
 
+    printf("Test case 'hash_values'... ");
+    fflush(stdout);
+    test_hash_values();
+    printf("OK\n");
+
     printf("Test case 'null'... ");
     fflush(stdout);
     test_null();
@@ -0,0 +1,292 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <upo/hashtable.h>
+#include <upo/hashtable_snapshot.h>
+
+
+#define NUM_KEYS 10000
+#define SNAPSHOT_PATH "test_hashtable_snapshot.snap"
+
+
+static int int_compare(const void* a, const void* b);
+static int str_compare(const void* a, const void* b);
+static size_t int_size(const void* p);
+static size_t str_size(const void* p);
+static void sum_visit(void* key, void* value, void* info);
+
+static void test_int_keys();
+static void test_str_keys();
+static void test_empty();
+static void test_invalid_files();
+static void test_null();
+
+
+int int_compare(const void* a, const void* b)
+{
+    const int* aa = a;
+    const int* bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+int str_compare(const void* a, const void* b)
+{
+    return strcmp(a, b);
+}
+
+size_t int_size(const void* p)
+{
+    (void) p;
+
+    return sizeof(int);
+}
+
+size_t str_size(const void* p)
+{
+    return strlen(p) + 1;
+}
+
+void sum_visit(void* key, void* value, void* info)
+{
+    long* sum = info;
+    int* ikey = key;
+    int* ivalue = value;
+
+    assert( *ivalue == 2*(*ikey) );
+
+    *sum += *ikey;
+}
+
+void test_int_keys()
+{
+    int keys[NUM_KEYS];
+    int values[NUM_KEYS];
+    upo_ht_linprob_t ht = NULL;
+    upo_ht_snapshot_t snap = NULL;
+    const int* value = NULL;
+    long sum = 0;
+    int absent = -1;
+    int i = 0;
+
+    ht = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        keys[i] = i*7919;
+        values[i] = 2*keys[i];
+        upo_ht_linprob_put(ht, &keys[i], &values[i]);
+    }
+
+    assert( upo_ht_linprob_save(ht, SNAPSHOT_PATH, upo_ht_hash_int_mix, int_size, int_size) );
+    upo_ht_linprob_destroy(ht, 0);
+
+    /* The snapshot does not depend on the memory of the table */
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        values[i] = 0;
+    }
+
+    snap = upo_ht_snapshot_open(SNAPSHOT_PATH, upo_ht_hash_int_mix, int_compare);
+    assert( snap != NULL );
+    assert( upo_ht_snapshot_size(snap) == NUM_KEYS );
+    assert( upo_ht_snapshot_capacity(snap) >= 2*NUM_KEYS );
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        value = upo_ht_snapshot_get(snap, &keys[i]);
+        assert( value != NULL );
+        assert( *value == 2*keys[i] );
+        assert( upo_ht_snapshot_contains(snap, &keys[i]) );
+    }
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        int key = i*7919 + 1;
+
+        assert( upo_ht_snapshot_get(snap, &key) == NULL );
+    }
+    assert( !upo_ht_snapshot_contains(snap, &absent) );
+
+    upo_ht_snapshot_traverse(snap, sum_visit, &sum);
+    assert( sum == 7919L*(NUM_KEYS-1)*NUM_KEYS/2 );
+
+    upo_ht_snapshot_close(snap);
+    remove(SNAPSHOT_PATH);
+}
+
+void test_str_keys()
+{
+    char* keys[] = {"one", "two", "three", "four", "five", "six", "seven", "eight", "nine", "ten", "a much longer key, spanning several words"};
+    char* values[] = {"1", "2", "3", "4", "5", "6", "7", "8", "9", "10", ""};
+    size_t n = sizeof keys/sizeof keys[0];
+    upo_ht_linprob_t ht = NULL;
+    upo_ht_snapshot_t snap = NULL;
+    size_t i = 0;
+
+    ht = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_str_djb2a, str_compare);
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_linprob_put(ht, keys[i], values[i]);
+    }
+    /* A NULL value is saved as an empty one */
+    upo_ht_linprob_put(ht, "null", NULL);
+
+    assert( upo_ht_linprob_save(ht, SNAPSHOT_PATH, upo_ht_hash_str_djb2a, str_size, str_size) );
+    upo_ht_linprob_destroy(ht, 0);
+
+    snap = upo_ht_snapshot_open(SNAPSHOT_PATH, upo_ht_hash_str_djb2a, str_compare);
+    assert( snap != NULL );
+    assert( upo_ht_snapshot_size(snap) == n+1 );
+    for (i = 0; i < n; ++i)
+    {
+        const char* value = upo_ht_snapshot_get(snap, keys[i]);
+
+        assert( value != NULL );
+        assert( strcmp(value, values[i]) == 0 );
+        /* Keys and values are aligned in the file */
+        assert( ((size_t) value) % 8 == 0 );
+    }
+    assert( upo_ht_snapshot_contains(snap, "null") );
+    assert( !upo_ht_snapshot_contains(snap, "eleven") );
+    assert( !upo_ht_snapshot_contains(snap, "") );
+
+    upo_ht_snapshot_close(snap);
+    remove(SNAPSHOT_PATH);
+}
+
+void test_empty()
+{
+    upo_ht_linprob_t ht = NULL;
+    upo_ht_snapshot_t snap = NULL;
+    long sum = 0;
+    int key = 1;
+
+    ht = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+    assert( upo_ht_linprob_save(ht, SNAPSHOT_PATH, upo_ht_hash_int_mix, int_size, int_size) );
+    upo_ht_linprob_destroy(ht, 0);
+
+    snap = upo_ht_snapshot_open(SNAPSHOT_PATH, upo_ht_hash_int_mix, int_compare);
+    assert( snap != NULL );
+    assert( upo_ht_snapshot_size(snap) == 0 );
+    assert( upo_ht_snapshot_get(snap, &key) == NULL );
+    upo_ht_snapshot_traverse(snap, sum_visit, &sum);
+    assert( sum == 0 );
+
+    upo_ht_snapshot_close(snap);
+    remove(SNAPSHOT_PATH);
+}
+
+void test_invalid_files()
+{
+    upo_ht_linprob_t ht = NULL;
+    upo_ht_snapshot_t snap = NULL;
+    FILE* fp = NULL;
+    long size = 0;
+    int key = 1;
+
+    assert( upo_ht_snapshot_open("no/such/file.snap", upo_ht_hash_int_mix, int_compare) == NULL );
+
+    /* Saving into a missing directory fails without leaving files around */
+    ht = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+    upo_ht_linprob_put(ht, &key, &key);
+    assert( !upo_ht_linprob_save(ht, "no/such/file.snap", upo_ht_hash_int_mix, int_size, int_size) );
+
+    /* Not a snapshot */
+    fp = fopen(SNAPSHOT_PATH, "wb");
+    assert( fp != NULL );
+    fputs("This is not a hash table snapshot, although it is long enough to hold a header.\n", fp);
+    fclose(fp);
+    assert( upo_ht_snapshot_open(SNAPSHOT_PATH, upo_ht_hash_int_mix, int_compare) == NULL );
+
+    /* Too short */
+    fp = fopen(SNAPSHOT_PATH, "wb");
+    assert( fp != NULL );
+    fputs("UPOHTSN1", fp);
+    fclose(fp);
+    assert( upo_ht_snapshot_open(SNAPSHOT_PATH, upo_ht_hash_int_mix, int_compare) == NULL );
+
+    /* Truncated */
+    assert( upo_ht_linprob_save(ht, SNAPSHOT_PATH, upo_ht_hash_int_mix, int_size, int_size) );
+    fp = fopen(SNAPSHOT_PATH, "rb");
+    assert( fp != NULL );
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fclose(fp);
+    snap = upo_ht_snapshot_open(SNAPSHOT_PATH, upo_ht_hash_int_mix, int_compare);
+    assert( snap != NULL );
+    upo_ht_snapshot_close(snap);
+    fp = fopen(SNAPSHOT_PATH, "r+b");
+    assert( fp != NULL );
+    /* Changing the recorded size of the file is as good as truncating it */
+    fseek(fp, 48, SEEK_SET);
+    size -= 8;
+    fwrite(&size, 1, 1, fp);
+    fclose(fp);
+    assert( upo_ht_snapshot_open(SNAPSHOT_PATH, upo_ht_hash_int_mix, int_compare) == NULL );
+
+    upo_ht_linprob_destroy(ht, 0);
+    remove(SNAPSHOT_PATH);
+}
+
+void test_null()
+{
+    upo_ht_snapshot_t snap = NULL;
+    int key = 1;
+
+    assert( upo_ht_snapshot_get(snap, &key) == NULL );
+    assert( !upo_ht_snapshot_contains(snap, &key) );
+    assert( upo_ht_snapshot_size(snap) == 0 );
+    assert( upo_ht_snapshot_capacity(snap) == 0 );
+    upo_ht_snapshot_close(snap);
+}
+
+
+int main()
+{
+    printf("Test case 'int keys'... ");
+    fflush(stdout);
+    test_int_keys();
+    printf("OK\n");
+
+    printf("Test case 'string keys'... ");
+    fflush(stdout);
+    test_str_keys();
+    printf("OK\n");
+
+    printf("Test case 'empty'... ");
+    fflush(stdout);
+    test_empty();
+    printf("OK\n");
+
+    printf("Test case 'invalid files'... ");
+    fflush(stdout);
+    test_invalid_files();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,215 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <upo/error.h>
+#include <upo/mem_pool.h>
+
+
+static void test_create_destroy();
+static void test_alloc_free();
+static void test_clear();
+static void test_alignment();
+static void test_null();
+
+
+void test_create_destroy()
+{
+    upo_mem_pool_t pool;
+
+    pool = upo_mem_pool_create(sizeof(int), 0);
+
+    assert( pool != NULL );
+    assert( upo_mem_pool_size(pool) == 0 );
+
+    upo_mem_pool_destroy(pool);
+
+    /* Objects smaller than a pointer */
+    pool = upo_mem_pool_create(1, 1);
+
+    assert( pool != NULL );
+
+    upo_mem_pool_destroy(pool);
+}
+
+void test_alloc_free()
+{
+    const size_t n = 1000;
+    int* objs[1000];
+    size_t i;
+    upo_mem_pool_t pool;
+
+    pool = upo_mem_pool_create(sizeof(int), 4);
+
+    assert( pool != NULL );
+
+    /* Allocation: objects are distinct and writable */
+    for (i = 0; i < n; ++i)
+    {
+        objs[i] = upo_mem_pool_alloc(pool);
+
+        assert( objs[i] != NULL );
+
+        *objs[i] = (int) i;
+
+        assert( upo_mem_pool_size(pool) == i+1 );
+    }
+    for (i = 0; i < n; ++i)
+    {
+        assert( *objs[i] == (int) i );
+    }
+
+    /* Release: the last released object is reused first */
+    upo_mem_pool_free(pool, objs[10]);
+    upo_mem_pool_free(pool, objs[20]);
+
+    assert( upo_mem_pool_size(pool) == n-2 );
+    assert( upo_mem_pool_alloc(pool) == objs[20] );
+    assert( upo_mem_pool_alloc(pool) == objs[10] );
+    assert( upo_mem_pool_size(pool) == n );
+
+    /* Releasing NULL is a no-op */
+    upo_mem_pool_free(pool, NULL);
+
+    assert( upo_mem_pool_size(pool) == n );
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_mem_pool_free(pool, objs[i]);
+    }
+
+    assert( upo_mem_pool_size(pool) == 0 );
+
+    upo_mem_pool_destroy(pool);
+}
+
+void test_clear()
+{
+    const size_t n = 500;
+    size_t i;
+    size_t footprint;
+    size_t first_slab;
+    upo_mem_pool_t pool;
+
+    pool = upo_mem_pool_create(3*sizeof(void*), 0);
+
+    assert( pool != NULL );
+
+    footprint = upo_mem_pool_footprint(pool);
+    upo_mem_pool_alloc(pool);
+    first_slab = upo_mem_pool_footprint(pool);
+
+    for (i = 1; i < n; ++i)
+    {
+        void** obj = upo_mem_pool_alloc(pool);
+
+        obj[0] = obj[1] = obj[2] = NULL;
+    }
+
+    assert( upo_mem_pool_size(pool) == n );
+    assert( upo_mem_pool_footprint(pool) >= footprint + n*3*sizeof(void*) );
+
+    upo_mem_pool_clear(pool);
+
+    assert( upo_mem_pool_size(pool) == 0 );
+    assert( upo_mem_pool_footprint(pool) == footprint );
+
+    /* The pool is usable after being cleared, and starts again from a slab
+     * of the first size */
+    upo_mem_pool_alloc(pool);
+    assert( upo_mem_pool_footprint(pool) == first_slab );
+    for (i = 1; i < n; ++i)
+    {
+        void** obj = upo_mem_pool_alloc(pool);
+
+        obj[0] = obj[1] = obj[2] = NULL;
+    }
+
+    assert( upo_mem_pool_size(pool) == n );
+
+    upo_mem_pool_destroy(pool);
+}
+
+void test_alignment()
+{
+    size_t i;
+    upo_mem_pool_t pool;
+
+    pool = upo_mem_pool_create(3, 0);
+
+    assert( pool != NULL );
+
+    for (i = 0; i < 100; ++i)
+    {
+        double* d = upo_mem_pool_alloc(pool);
+
+        assert( ((size_t) d) % sizeof(void*) == 0 );
+
+        *d = 1.0;
+    }
+
+    upo_mem_pool_destroy(pool);
+}
+
+void test_null()
+{
+    upo_mem_pool_t pool = NULL;
+
+    assert( upo_mem_pool_size(pool) == 0 );
+
+    upo_mem_pool_clear(pool);
+
+    upo_mem_pool_destroy(pool);
+}
+
+
+int main()
+{
+    printf("Test case 'create/destroy'... ");
+    fflush(stdout);
+    test_create_destroy();
+    printf("OK\n");
+
+    printf("Test case 'alloc/free'... ");
+    fflush(stdout);
+    test_alloc_free();
+    printf("OK\n");
+
+    printf("Test case 'clear'... ");
+    fflush(stdout);
+    test_clear();
+    printf("OK\n");
+
+    printf("Test case 'alignment'... ");
+    fflush(stdout);
+    test_alignment();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}
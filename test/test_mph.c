@@ -0,0 +1,338 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/hashtable.h>
+#include <upo/mph.h>
+
+
+#define NUM_KEYS 100000
+
+
+static int int_compare(const void* a, const void* b);
+static int str_compare(const void* a, const void* b);
+static void sum_visit(void* key, void* value, void* info);
+
+static void test_mph_bijection();
+static void test_mph_small_sets();
+static void test_mph_duplicates();
+static void test_mph_memory_usage();
+static void test_table_int_keys();
+static void test_table_str_keys();
+static void test_table_empty();
+static void test_null();
+
+
+int int_compare(const void* a, const void* b)
+{
+    const int* aa = a;
+    const int* bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+int str_compare(const void* a, const void* b)
+{
+    return strcmp(a, b);
+}
+
+void sum_visit(void* key, void* value, void* info)
+{
+    long* sum = info;
+    int* ikey = key;
+    int* ivalue = value;
+
+    assert( *ivalue == 2*(*ikey) );
+
+    *sum += *ikey;
+}
+
+void test_mph_bijection()
+{
+    int* keys = NULL;
+    void** pkeys = NULL;
+    unsigned char* seen = NULL;
+    upo_mph_t mph = NULL;
+    size_t i = 0;
+
+    keys = malloc(NUM_KEYS*sizeof(int));
+    pkeys = malloc(NUM_KEYS*sizeof(void*));
+    seen = calloc(NUM_KEYS, 1);
+    assert( keys != NULL && pkeys != NULL && seen != NULL );
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        keys[i] = (int) (i*7919);
+        pkeys[i] = &keys[i];
+    }
+
+    mph = upo_mph_build(pkeys, NUM_KEYS, upo_ht_hash_int_mix);
+    assert( mph != NULL );
+    assert( upo_mph_size(mph) == NUM_KEYS );
+
+    /* Each key gets a distinct position, so all the positions are used */
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        size_t p = upo_mph_lookup(mph, &keys[i]);
+
+        assert( p < NUM_KEYS );
+        assert( !seen[p] );
+        seen[p] = 1;
+    }
+    /* Other keys are mapped in range too */
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        int key = (int) (i*7919 + 1);
+
+        assert( upo_mph_lookup(mph, &key) < NUM_KEYS );
+    }
+
+    upo_mph_destroy(mph);
+    free(seen);
+    free(pkeys);
+    free(keys);
+}
+
+void test_mph_small_sets()
+{
+    int keys[64];
+    void* pkeys[64];
+    unsigned char seen[64];
+    size_t n = 0;
+    size_t i = 0;
+
+    for (i = 0; i < 64; ++i)
+    {
+        keys[i] = (int) i - 32;
+        pkeys[i] = &keys[i];
+    }
+    for (n = 0; n <= 64; ++n)
+    {
+        upo_mph_t mph = upo_mph_build(pkeys, n, upo_ht_hash_int_mix);
+
+        assert( mph != NULL );
+        assert( upo_mph_size(mph) == n );
+        memset(seen, 0, sizeof seen);
+        for (i = 0; i < n; ++i)
+        {
+            size_t p = upo_mph_lookup(mph, &keys[i]);
+
+            assert( p < n );
+            assert( !seen[p] );
+            seen[p] = 1;
+        }
+        upo_mph_destroy(mph);
+    }
+}
+
+void test_mph_duplicates()
+{
+    int keys[] = {1, 2, 3, 4, 5, 3};
+    void* pkeys[6];
+    size_t i = 0;
+
+    for (i = 0; i < 6; ++i)
+    {
+        pkeys[i] = &keys[i];
+    }
+
+    assert( upo_mph_build(pkeys, 6, upo_ht_hash_int_mix) == NULL );
+    assert( upo_mph_table_build(pkeys, pkeys, 6, upo_ht_hash_int_mix, int_compare) == NULL );
+}
+
+void test_mph_memory_usage()
+{
+    int* keys = NULL;
+    void** pkeys = NULL;
+    upo_mph_t mph = NULL;
+    size_t i = 0;
+
+    keys = malloc(NUM_KEYS*sizeof(int));
+    pkeys = malloc(NUM_KEYS*sizeof(void*));
+    assert( keys != NULL && pkeys != NULL );
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        keys[i] = (int) i;
+        pkeys[i] = &keys[i];
+    }
+
+    mph = upo_mph_build(pkeys, NUM_KEYS, upo_ht_hash_int_mix);
+    assert( mph != NULL );
+    /* About 3 bits per key, whatever the keys */
+    assert( upo_mph_memory_usage(mph)*8 < 4*NUM_KEYS );
+
+    upo_mph_destroy(mph);
+    free(pkeys);
+    free(keys);
+}
+
+void test_table_int_keys()
+{
+    int* keys = NULL;
+    int* values = NULL;
+    void** pkeys = NULL;
+    void** pvalues = NULL;
+    upo_mph_table_t table = NULL;
+    long sum = 0;
+    size_t i = 0;
+
+    keys = malloc(NUM_KEYS*sizeof(int));
+    values = malloc(NUM_KEYS*sizeof(int));
+    pkeys = malloc(NUM_KEYS*sizeof(void*));
+    pvalues = malloc(NUM_KEYS*sizeof(void*));
+    assert( keys != NULL && values != NULL && pkeys != NULL && pvalues != NULL );
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        keys[i] = (int) i;
+        values[i] = 2*keys[i];
+        pkeys[i] = &keys[i];
+        pvalues[i] = &values[i];
+    }
+
+    table = upo_mph_table_build(pkeys, pvalues, NUM_KEYS, upo_ht_hash_int_mix, int_compare);
+    assert( table != NULL );
+    assert( upo_mph_table_size(table) == NUM_KEYS );
+    assert( upo_mph_table_memory_usage(table) > NUM_KEYS*2*sizeof(void*) );
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        int key = (int) i;
+
+        assert( upo_mph_table_get(table, &key) == &values[i] );
+        assert( upo_mph_table_contains(table, &key) );
+    }
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        int key = (int) (NUM_KEYS + i);
+
+        assert( upo_mph_table_get(table, &key) == NULL );
+        assert( !upo_mph_table_contains(table, &key) );
+    }
+
+    upo_mph_table_traverse(table, sum_visit, &sum);
+    assert( sum == (long) NUM_KEYS*(NUM_KEYS-1)/2 );
+
+    upo_mph_table_destroy(table, 0);
+    free(pvalues);
+    free(pkeys);
+    free(values);
+    free(keys);
+}
+
+void test_table_str_keys()
+{
+    char* keys[] = {"rock", "pop", "jazz", "blues", "classical", "folk", "metal", "punk", "reggae", "soul"};
+    char* values[] = {"0", "1", "2", "3", "4", "5", "6", "7", "8", "9"};
+    size_t n = sizeof keys/sizeof keys[0];
+    upo_mph_table_t table = NULL;
+    size_t i = 0;
+
+    table = upo_mph_table_build((void* const*) keys, (void* const*) values, n, upo_ht_hash_str_xx64, str_compare);
+    assert( table != NULL );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_mph_table_get(table, keys[i]) == values[i] );
+    }
+    assert( upo_mph_table_get(table, "disco") == NULL );
+    assert( upo_mph_table_get(table, "") == NULL );
+
+    upo_mph_table_destroy(table, 0);
+}
+
+void test_table_empty()
+{
+    upo_mph_table_t table = NULL;
+    int key = 1;
+    long sum = 0;
+
+    table = upo_mph_table_build(NULL, NULL, 0, upo_ht_hash_int_mix, int_compare);
+    assert( table != NULL );
+    assert( upo_mph_table_size(table) == 0 );
+    assert( upo_mph_table_get(table, &key) == NULL );
+    assert( !upo_mph_table_contains(table, &key) );
+    upo_mph_table_traverse(table, sum_visit, &sum);
+    assert( sum == 0 );
+
+    upo_mph_table_destroy(table, 1);
+}
+
+void test_null()
+{
+    upo_mph_table_t table = NULL;
+    int key = 1;
+
+    assert( upo_mph_size(NULL) == 0 );
+    assert( upo_mph_memory_usage(NULL) == 0 );
+    assert( upo_mph_table_size(table) == 0 );
+    assert( upo_mph_table_memory_usage(table) == 0 );
+    assert( upo_mph_table_get(table, &key) == NULL );
+    assert( !upo_mph_table_contains(table, &key) );
+    upo_mph_table_destroy(table, 0);
+    upo_mph_destroy(NULL);
+}
+
+
+int main()
+{
+    printf("Test case 'MPH bijection'... ");
+    fflush(stdout);
+    test_mph_bijection();
+    printf("OK\n");
+
+    printf("Test case 'MPH small sets'... ");
+    fflush(stdout);
+    test_mph_small_sets();
+    printf("OK\n");
+
+    printf("Test case 'MPH duplicates'... ");
+    fflush(stdout);
+    test_mph_duplicates();
+    printf("OK\n");
+
+    printf("Test case 'MPH memory usage'... ");
+    fflush(stdout);
+    test_mph_memory_usage();
+    printf("OK\n");
+
+    printf("Test case 'static table int keys'... ");
+    fflush(stdout);
+    test_table_int_keys();
+    printf("OK\n");
+
+    printf("Test case 'static table string keys'... ");
+    fflush(stdout);
+    test_table_str_keys();
+    printf("OK\n");
+
+    printf("Test case 'static table empty'... ");
+    fflush(stdout);
+    test_table_empty();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}